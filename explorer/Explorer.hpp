@@ -23,12 +23,14 @@
 #include "ExplorerFunctions.hpp"
 #include "FileHandler.hpp"
 #include "List.hpp"
+#include "../format/glob.hpp"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Namespace 'ext' for external utilities and extensions.
@@ -58,6 +60,35 @@ class Explorer : public fs::directory_entry {
       return *this;
    }
 
+   /**
+    * @brief Gets the path of the directory in generic format, ending with a
+    * separator.
+    */
+   std::string rootPrefix() const {
+      std::string root{fs::path(*this).generic_string()};
+      if (!root.empty() && root.back() != '/') {
+         root.push_back('/');
+      }
+
+      return root;
+   }
+
+   /**
+    * @brief Gets the part of a generic path after the directory prefix.
+    *
+    * @param root_ The prefix returned by rootPrefix().
+    * @param path_ The generic path of an item in the directory.
+    */
+   static std::string_view relativePath(std::string const &root_,
+                                        std::string const &path_) {
+      std::string_view relative{path_};
+      if (relative.compare(0, root_.size(), root_) == 0) {
+         relative.remove_prefix(root_.size());
+      }
+
+      return relative;
+   }
+
  public:
    /**
     * @brief Default constructor for an Explorer object.
@@ -338,6 +369,51 @@ class Explorer : public fs::directory_entry {
       return list;
    }
 
+   /**
+    * @brief Retrieves the list of the files and directories in the directory
+    * and its subdirectories whose relative path satisfies a predicate.
+    *
+    * @tparam Predicate A callable taking a std::string_view, such as a glob.
+    * @param filter_ The predicate, called with the path relative to the
+    * directory in generic format (e.g. "src/main.cpp").
+    * @return A List object containing the accepted items.
+    */
+   template <class Predicate>
+   List getChildrens(Predicate const &filter_) const {
+      List list;
+      std::string const root{rootPrefix()};
+
+      for (auto children : fs::recursive_directory_iterator(*this)) {
+         if (filter_(relativePath(root, children.path().generic_string()))) {
+            list.pushBack(children);
+         }
+      }
+
+      return list;
+   }
+
+   /**
+    * @brief Retrieves the list of immediate files and directories in the
+    * directory whose name satisfies a predicate.
+    *
+    * @tparam Predicate A callable taking a std::string_view, such as a glob.
+    * @param filter_ The predicate, called with the name of each item.
+    * @return A List object containing the accepted items.
+    */
+   template <class Predicate>
+   List getImediateChildrens(Predicate const &filter_) const {
+      List list;
+      std::string const root{rootPrefix()};
+
+      for (auto children : fs::directory_iterator(*this)) {
+         if (filter_(relativePath(root, children.path().generic_string()))) {
+            list.pushBack(children);
+         }
+      }
+
+      return list;
+   }
+
    /**
     * @brief Creates a new directory within the current directory.
     *
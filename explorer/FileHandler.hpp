@@ -13,6 +13,7 @@
 #define FILE_HANDLER_HPP_
 
 #include "ExplorerFunctions.hpp"
+#include "../format/fstring_view.hpp"
 #include <bitset>
 #include <filesystem>
 #include <fstream>
@@ -511,6 +512,18 @@ class FileHandler : public fs::path {
     */
    size_t size() const { return fs::file_size(*this); }
 
+   /**
+    * @brief Map the file into memory for read-only access, without copying
+    * it.
+    * @param hint_ How the file is going to be read (default is
+    * access_hint::sequential).
+    * @return A view of the whole file.
+    * @throw std::system_error if the file cannot be opened or mapped.
+    */
+   fstring_view view(access_hint hint_ = access_hint::sequential) const {
+      return fstring_view(*this, hint_);
+   }
+
    /**
     * @brief Get the modification time of the file.
     * @return The modification time of the file as a fs::file_time_type.
@@ -0,0 +1,544 @@
+/**
+ * @file ansi.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Scanning, stripping and parsing of ANSI escape sequences.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * A small state machine recognizes CSI sequences ("\33[" up to a final byte
+ * from '@' to '~'), OSC sequences ("\33]" up to BEL or "\33\\") and two
+ * character escapes. Plain text between sequences is located with a vector
+ * search for the escape byte (32 bytes at a time with AVX2, 16 with SSE2), so
+ * a text is read once and copied run by run. The state survives between
+ * calls, which lets a stream be stripped in chunks that cut a sequence in two.
+ * Stripping writes into a caller-provided buffer and never allocates.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef ANSI_HPP_
+#define ANSI_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "style.hpp"
+#include "styled_text.hpp"
+#include "utf.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief ANSI escape sequence namespace
+ *
+ * This namespace holds the escape sequence scanner shared by the stripping,
+ * splitting and width functions, and the parser of SGR parameters.
+ */
+namespace ansi {
+using size_type = std::size_t;
+
+/**
+ * @brief Finds the first escape byte of a text.
+ *
+ * @param data_ The bytes of the text.
+ * @param size_ The number of bytes.
+ * @return The position of the escape byte, size_ if there is none.
+ */
+inline size_type find_escape(char const *data_, size_type size_) {
+   size_type pos{0};
+
+#if defined(__AVX2__)
+   __m256i const escape_32{_mm256_set1_epi8(0x1B)};
+   for (; size_ - pos >= 32; pos += 32) {
+      unsigned const mask{static_cast<unsigned>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+              _mm256_loadu_si256(
+                  reinterpret_cast<__m256i const *>(data_ + pos)),
+              escape_32)))};
+
+      if (mask != 0) {
+         return pos + static_cast<size_type>(__builtin_ctz(mask));
+      }
+   }
+#endif
+
+#if defined(__SSE2__)
+   __m128i const escape_16{_mm_set1_epi8(0x1B)};
+   for (; size_ - pos >= 16; pos += 16) {
+      unsigned const mask{static_cast<unsigned>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(
+              _mm_loadu_si128(reinterpret_cast<__m128i const *>(data_ + pos)),
+              escape_16)))};
+
+      if (mask != 0) {
+         return pos + static_cast<size_type>(__builtin_ctz(mask));
+      }
+   }
+#endif
+
+   while (pos != size_ && data_[pos] != '\33') {
+      ++pos;
+   }
+   return pos;
+}
+
+/**
+ * @brief Finds the first escape character of a text.
+ *
+ * @param first_ The beginning of the text.
+ * @param last_ The end of the text.
+ * @return The escape character, last_ if there is none.
+ */
+template <typename CharType>
+CharType const *next_escape(CharType const *first_, CharType const *last_) {
+   if constexpr (sizeof(CharType) == 1) {
+      return first_ + find_escape(reinterpret_cast<char const *>(first_),
+                                  static_cast<size_type>(last_ - first_));
+   } else {
+      return std::find(first_, last_, CharType(0x1B));
+   }
+}
+
+/**
+ * @brief Where the scanner stands relative to an escape sequence.
+ */
+enum class state : unsigned char {
+   ground,     ///< Plain text.
+   escape,     ///< After the escape character.
+   csi,        ///< Inside a CSI sequence, before its final byte.
+   osc,        ///< Inside an OSC sequence.
+   osc_escape, ///< After an escape character inside an OSC sequence.
+};
+
+/**
+ * @brief A resumable scanner of escape sequences.
+ * @tparam CharType The character type used in the text.
+ */
+template <typename CharType = char> class basic_scanner {
+ public:
+   using view_type = std::basic_string_view<CharType>;
+
+   /**
+    * @brief Constructs a scanner.
+    *
+    * @param state_ The initial state (default is plain text).
+    */
+   explicit basic_scanner(ansi::state state_ = ansi::state::ground)
+       : m_state(state_) {}
+
+   /**
+    * @brief Gets the state left by the last call.
+    */
+   ansi::state state() const { return m_state; }
+
+   /**
+    * @brief Checks if the last call stopped inside an escape sequence.
+    */
+   bool pending() const { return m_state != ansi::state::ground; }
+
+   /**
+    * @brief Forgets a sequence left open by the last call.
+    */
+   void reset() { m_state = ansi::state::ground; }
+
+   /**
+    * @brief Consumes the characters of an escape sequence that is already
+    * open, up to the end of the sequence.
+    *
+    * @param first_ The first character to read.
+    * @param last_ The end of the text.
+    * @return The first character after the sequence, last_ if the sequence
+    * goes on past the text.
+    */
+   CharType const *close(CharType const *first_, CharType const *last_) {
+      for (; first_ != last_ && m_state != ansi::state::ground; ++first_) {
+         char32_t const unit{utf::unit(*first_)};
+
+         switch (m_state) {
+         case ansi::state::escape:
+            m_state = unit == '['   ? ansi::state::csi
+                      : unit == ']' ? ansi::state::osc
+                                    : ansi::state::ground;
+            break;
+         case ansi::state::csi:
+            if (unit >= 0x40 && unit <= 0x7E) {
+               m_state = ansi::state::ground;
+            }
+            break;
+         case ansi::state::osc:
+         case ansi::state::osc_escape:
+            if (unit == 0x07 ||
+                (unit == '\\' && m_state == ansi::state::osc_escape)) {
+               m_state = ansi::state::ground;
+            } else {
+               m_state = unit == 0x1B ? ansi::state::osc_escape
+                                      : ansi::state::osc;
+            }
+            break;
+         case ansi::state::ground:
+            break;
+         }
+      }
+
+      return first_;
+   }
+
+   /**
+    * @brief Scans a chunk of text, reporting its plain runs.
+    *
+    * @param chunk_ The chunk, which may begin or end inside a sequence.
+    * @param plain_ Called with each run of plain text, as a view_type.
+    */
+   template <class Function> void scan(view_type chunk_, Function &&plain_) {
+      CharType const *it{chunk_.data()};
+      CharType const *const last{it + chunk_.size()};
+
+      while (it != last) {
+         if (m_state != ansi::state::ground) {
+            it = close(it, last);
+            continue;
+         }
+
+         CharType const *const escape{next_escape(it, last)};
+         if (escape != it) {
+            plain_(view_type(it, static_cast<size_type>(escape - it)));
+         }
+         if (escape == last) {
+            break;
+         }
+
+         m_state = ansi::state::escape;
+         it = escape + 1;
+      }
+   }
+
+   /**
+    * @brief Copies a chunk of text without its escape sequences.
+    *
+    * @param chunk_ The chunk, which may begin or end inside a sequence.
+    * @param out_ Receives the plain text; it must hold chunk_.size()
+    * characters and may be chunk_.data() itself.
+    * @return The number of characters written.
+    */
+   size_type strip(view_type chunk_, CharType *out_) {
+      CharType *it{out_};
+
+      scan(chunk_, [&it](view_type run_) {
+         std::char_traits<CharType>::move(it, run_.data(), run_.size());
+         it += run_.size();
+      });
+
+      return static_cast<size_type>(it - out_);
+   }
+
+ private:
+   ansi::state m_state; ///< State after the last call.
+};
+
+using scanner = basic_scanner<char>; ///< Scanner of UTF-8 text.
+
+/**
+ * @brief Skips an escape sequence. A sequence cut by the end of the text runs
+ * to the end.
+ *
+ * @param first_ The escape character.
+ * @param last_ The end of the text.
+ * @return The first character after the sequence.
+ */
+template <typename CharType>
+CharType const *skip(CharType const *first_, CharType const *last_) {
+   basic_scanner<CharType> scanner{state::escape};
+   return scanner.close(first_ + 1, last_);
+}
+
+/**
+ * @brief Copies a text without its escape sequences.
+ *
+ * @param text_ The text.
+ * @param out_ Receives the plain text; it must hold text_.size() characters
+ * and may be text_.data() itself.
+ * @return The number of characters written.
+ */
+template <typename CharType>
+size_type strip(std::basic_string_view<CharType> text_, CharType *out_) {
+   return basic_scanner<CharType>{}.strip(text_, out_);
+}
+
+/**
+ * @brief Copies a text without its escape sequences.
+ *
+ * @param text_ The text.
+ * @param out_ Receives the plain text; it must hold text_.size() characters.
+ * @return The number of characters written.
+ */
+inline size_type strip(std::string_view text_, char *out_) {
+   return strip<char>(text_, out_);
+}
+
+/**
+ * @brief Gets a text without its escape sequences.
+ *
+ * @param text_ The text.
+ * @return The plain text.
+ */
+inline std::string strip(std::string_view text_) {
+   std::string out(text_.size(), '\0');
+   out.resize(strip<char>(text_, &out[0]));
+   return out;
+}
+
+/**
+ * @brief A run of plain text or a whole escape sequence.
+ * @tparam CharType The character type used in the text.
+ */
+template <typename CharType> struct basic_segment {
+   std::basic_string_view<CharType> text; ///< The characters of the segment.
+   bool escape;                           ///< True for an escape sequence.
+
+   /**
+    * @brief Checks if the segment is an SGR sequence, such as "\33[31m".
+    */
+   bool sgr() const {
+      return escape && text.size() >= 3 && text[1] == CharType('[') &&
+             text.back() == CharType('m');
+   }
+};
+
+/**
+ * @brief A lazy, non-owning range of the segments of a text, alternating
+ * plain runs and escape sequences.
+ * @tparam CharType The character type used in the text.
+ */
+template <typename CharType = char> class basic_segment_view {
+ public:
+   using view_type = std::basic_string_view<CharType>;
+   using segment = basic_segment<CharType>;
+
+   /**
+    * @brief Forward iterator over the segments of a basic_segment_view.
+    */
+   class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = segment;
+      using difference_type = std::ptrdiff_t;
+      using pointer = value_type const *;
+      using reference = value_type;
+
+      /**
+       * @brief Default constructor, equal to the end iterator.
+       */
+      iterator() : m_first(nullptr), m_next(nullptr), m_last(nullptr) {}
+
+      /**
+       * @brief Gets the current segment.
+       */
+      value_type operator*() const {
+         return {view_type(m_first, static_cast<size_type>(m_next - m_first)),
+                 *m_first == CharType(0x1B)};
+      }
+
+      /**
+       * @brief Moves to the next segment.
+       *
+       * @return A reference to this iterator.
+       */
+      iterator &operator++() {
+         m_first = m_next;
+         find();
+         return *this;
+      }
+
+      /**
+       * @brief Moves to the next segment.
+       *
+       * @return A copy of this iterator before the increment.
+       */
+      iterator operator++(int) {
+         iterator copy{*this};
+         ++*this;
+         return copy;
+      }
+
+      /**
+       * @brief Checks if two iterators point to the same segment.
+       */
+      bool operator==(iterator const &rhs_) const {
+         return m_first == rhs_.m_first;
+      }
+
+      /**
+       * @brief Checks if two iterators point to different segments.
+       */
+      bool operator!=(iterator const &rhs_) const { return !(*this == rhs_); }
+
+    private:
+      friend class basic_segment_view;
+
+      /**
+       * @brief Constructs an iterator at the first segment of a text.
+       */
+      iterator(CharType const *first_, CharType const *last_)
+          : m_first(first_), m_next(first_), m_last(last_) {
+         find();
+      }
+
+      /**
+       * @brief Finds the end of the segment that starts at m_first.
+       */
+      void find() {
+         if (m_first == m_last) {
+            m_first = m_next = m_last = nullptr;
+         } else if (*m_first == CharType(0x1B)) {
+            m_next = skip(m_first, m_last);
+         } else {
+            m_next = next_escape(m_first, m_last);
+         }
+      }
+
+      CharType const *m_first; ///< Beginning of the segment.
+      CharType const *m_next;  ///< End of the segment.
+      CharType const *m_last;  ///< End of the text.
+   };
+
+   /**
+    * @brief Constructs a range over the segments of a text.
+    *
+    * @param text_ The text, which must outlive the range.
+    */
+   explicit basic_segment_view(view_type text_) : m_text(text_) {}
+
+   /**
+    * @brief Gets an iterator to the first segment.
+    */
+   iterator begin() const {
+      return iterator(m_text.data(), m_text.data() + m_text.size());
+   }
+
+   /**
+    * @brief Gets the end iterator.
+    */
+   iterator end() const { return iterator(); }
+
+ private:
+   view_type m_text; ///< The text.
+};
+
+using segment = basic_segment<char>;           ///< Segment of UTF-8 text.
+using segment_view = basic_segment_view<char>; ///< Segments of UTF-8 text.
+
+/**
+ * @brief Gets a lazy range over the plain runs and escape sequences of a
+ * text.
+ *
+ * @param text_ The text, which must outlive the range.
+ */
+inline segment_view segments(std::string_view text_) {
+   return segment_view(text_);
+}
+
+/**
+ * @brief Reads the parameters of an SGR sequence. An empty parameter reads
+ * as 0, and so does a sequence without parameters.
+ *
+ * @param sequence_ The sequence, such as "\33[31;1m".
+ * @param code_ Called with each parameter, as a short.
+ * @return False if the sequence is not an SGR sequence, true otherwise.
+ */
+template <class Function>
+bool for_each_code(std::string_view sequence_, Function &&code_) {
+   if (sequence_.size() < 3 || sequence_[0] != '\33' || sequence_[1] != '[' ||
+       sequence_.back() != 'm') {
+      return false;
+   }
+
+   short value{0};
+   for (char char_ : sequence_.substr(2)) {
+      if (char_ >= '0' && char_ <= '9') {
+         value = static_cast<short>(
+             std::min(value * 10 + (char_ - '0'), 9999));
+      } else if (char_ == ';' || char_ == ':' || char_ == 'm') {
+         code_(value);
+         value = 0;
+      } else {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+/**
+ * @brief Applies the parameters of an SGR sequence to a style.
+ *
+ * 0 resets the style, the codes of cfg, cbg and stl set an attribute, 39 and
+ * 49 clear the colors and 22 to 29 clear the matching style. Extended colors
+ * (38 and 48, with 5;n or 2;r;g;b) and other codes are skipped.
+ *
+ * @param sequence_ The sequence, such as "\33[31;1m".
+ * @param style_ The style to update.
+ * @return False if the sequence is not an SGR sequence (and the style is
+ * left unchanged), true otherwise.
+ */
+inline bool parse_sgr(std::string_view sequence_, text_style &style_) {
+   text_style result{style_};
+   int skipped{0}; // Parameters of an extended color still to skip
+
+   bool const valid{for_each_code(sequence_, [&](short code_) {
+      if (skipped < 0) {
+         skipped = code_ == 5 ? 1 : code_ == 2 ? 3 : 0;
+         return;
+      }
+      if (skipped > 0) {
+         --skipped;
+         return;
+      }
+
+      unsigned char const kind{sgr::kind_of(code_)};
+      if (code_ == 0) {
+         result = text_style{};
+      } else if (code_ == 38 || code_ == 48) {
+         skipped = -1;
+      } else if (code_ == 39) {
+         result.foreground = cfg::none;
+      } else if (code_ == 49) {
+         result.background = cbg::none;
+      } else if (kind & sgr::foreground) {
+         result.foreground = code_;
+      } else if (kind & sgr::background) {
+         result.background = code_;
+      } else if (kind & sgr::style) {
+         result.style = code_;
+      } else if (code_ >= 22 && code_ <= 29) {
+         // Each of these clears the style it was set with, 22 both weights
+         short const cleared{code_ == 22 ? stl::bold
+                             : code_ == 24
+                                 ? stl::underline
+                                 : static_cast<short>(code_ - 20)};
+         if (result.style == cleared ||
+             (code_ == 22 && result.style == stl::faint) ||
+             (code_ == 24 && result.style == stl::doubly_underlined)) {
+            result.style = stl::none;
+         }
+      }
+   })};
+
+   if (valid) {
+      style_ = result;
+   }
+   return valid;
+}
+} // namespace ansi
+} // namespace ext
+
+#endif // ANSI_HPP_
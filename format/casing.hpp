@@ -0,0 +1,834 @@
+/**
+ * @file casing.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Case conversion and case-insensitive comparison of UTF text.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * Letters are converted with the simple case mappings of Unicode 14 and
+ * compared with its simple case folding, so every code point maps to exactly
+ * one code point and no locale is involved. The mappings are sorted runs of
+ * code points that move by the same distance, either all of them or every
+ * other one, as upper and lower case alternate in most Latin, Greek and
+ * Cyrillic blocks. Runs of ASCII are converted and compared 16 or 32 bytes at
+ * a time with SSE2 or AVX2, chosen at compile time, and only the other
+ * characters search the tables. In UTF-8 a few letters change their length
+ * with their case (such as U+023A and U+2C65), so the conversions report how
+ * far they got when a converted letter does not fit.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef CASING_HPP_
+#define CASING_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "utf.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Letter case namespace
+ *
+ * This namespace holds the case tables and the kernels behind to_lower(),
+ * to_upper(), iequals(), icompare() and icontains().
+ */
+namespace casing {
+using size_type = std::size_t;
+
+inline constexpr size_type npos{std::string_view::npos}; ///< Not found.
+
+/**
+ * @brief A run of code points that map to the code points a fixed distance
+ * away.
+ */
+struct mapping {
+   char32_t first;       ///< First code point.
+   char32_t last;        ///< Last code point.
+   std::int32_t delta;   ///< The distance to the mapped code point.
+   std::uint32_t stride; ///< 1 if every code point maps, 2 if every other.
+};
+
+/**
+ * @brief Code points that change with the simple lowercase mapping.
+ */
+inline constexpr mapping lower_map[]{
+    {0x0041, 0x005A, 32, 1},     {0x00C0, 0x00D6, 32, 1},
+    {0x00D8, 0x00DE, 32, 1},     {0x0100, 0x012E, 1, 2},
+    {0x0130, 0x0130, -199, 1},   {0x0132, 0x0136, 1, 2},
+    {0x0139, 0x0147, 1, 2},      {0x014A, 0x0176, 1, 2},
+    {0x0178, 0x0178, -121, 1},   {0x0179, 0x017D, 1, 2},
+    {0x0181, 0x0181, 210, 1},    {0x0182, 0x0184, 1, 2},
+    {0x0186, 0x0186, 206, 1},    {0x0187, 0x0187, 1, 1},
+    {0x0189, 0x018A, 205, 1},    {0x018B, 0x018B, 1, 1},
+    {0x018E, 0x018E, 79, 1},     {0x018F, 0x018F, 202, 1},
+    {0x0190, 0x0190, 203, 1},    {0x0191, 0x0191, 1, 1},
+    {0x0193, 0x0193, 205, 1},    {0x0194, 0x0194, 207, 1},
+    {0x0196, 0x0196, 211, 1},    {0x0197, 0x0197, 209, 1},
+    {0x0198, 0x0198, 1, 1},      {0x019C, 0x019C, 211, 1},
+    {0x019D, 0x019D, 213, 1},    {0x019F, 0x019F, 214, 1},
+    {0x01A0, 0x01A4, 1, 2},      {0x01A6, 0x01A6, 218, 1},
+    {0x01A7, 0x01A7, 1, 1},      {0x01A9, 0x01A9, 218, 1},
+    {0x01AC, 0x01AC, 1, 1},      {0x01AE, 0x01AE, 218, 1},
+    {0x01AF, 0x01AF, 1, 1},      {0x01B1, 0x01B2, 217, 1},
+    {0x01B3, 0x01B5, 1, 2},      {0x01B7, 0x01B7, 219, 1},
+    {0x01B8, 0x01B8, 1, 1},      {0x01BC, 0x01BC, 1, 1},
+    {0x01C4, 0x01C4, 2, 1},      {0x01C5, 0x01C5, 1, 1},
+    {0x01C7, 0x01C7, 2, 1},      {0x01C8, 0x01C8, 1, 1},
+    {0x01CA, 0x01CA, 2, 1},      {0x01CB, 0x01DB, 1, 2},
+    {0x01DE, 0x01EE, 1, 2},      {0x01F1, 0x01F1, 2, 1},
+    {0x01F2, 0x01F4, 1, 2},      {0x01F6, 0x01F6, -97, 1},
+    {0x01F7, 0x01F7, -56, 1},    {0x01F8, 0x021E, 1, 2},
+    {0x0220, 0x0220, -130, 1},   {0x0222, 0x0232, 1, 2},
+    {0x023A, 0x023A, 10795, 1},  {0x023B, 0x023B, 1, 1},
+    {0x023D, 0x023D, -163, 1},   {0x023E, 0x023E, 10792, 1},
+    {0x0241, 0x0241, 1, 1},      {0x0243, 0x0243, -195, 1},
+    {0x0244, 0x0244, 69, 1},     {0x0245, 0x0245, 71, 1},
+    {0x0246, 0x024E, 1, 2},      {0x0370, 0x0372, 1, 2},
+    {0x0376, 0x0376, 1, 1},      {0x037F, 0x037F, 116, 1},
+    {0x0386, 0x0386, 38, 1},     {0x0388, 0x038A, 37, 1},
+    {0x038C, 0x038C, 64, 1},     {0x038E, 0x038F, 63, 1},
+    {0x0391, 0x03A1, 32, 1},     {0x03A3, 0x03AB, 32, 1},
+    {0x03CF, 0x03CF, 8, 1},      {0x03D8, 0x03EE, 1, 2},
+    {0x03F4, 0x03F4, -60, 1},    {0x03F7, 0x03F7, 1, 1},
+    {0x03F9, 0x03F9, -7, 1},     {0x03FA, 0x03FA, 1, 1},
+    {0x03FD, 0x03FF, -130, 1},   {0x0400, 0x040F, 80, 1},
+    {0x0410, 0x042F, 32, 1},     {0x0460, 0x0480, 1, 2},
+    {0x048A, 0x04BE, 1, 2},      {0x04C0, 0x04C0, 15, 1},
+    {0x04C1, 0x04CD, 1, 2},      {0x04D0, 0x052E, 1, 2},
+    {0x0531, 0x0556, 48, 1},     {0x10A0, 0x10C5, 7264, 1},
+    {0x10C7, 0x10C7, 7264, 1},   {0x10CD, 0x10CD, 7264, 1},
+    {0x13A0, 0x13EF, 38864, 1},  {0x13F0, 0x13F5, 8, 1},
+    {0x1C90, 0x1CBA, -3008, 1},  {0x1CBD, 0x1CBF, -3008, 1},
+    {0x1E00, 0x1E94, 1, 2},      {0x1E9E, 0x1E9E, -7615, 1},
+    {0x1EA0, 0x1EFE, 1, 2},      {0x1F08, 0x1F0F, -8, 1},
+    {0x1F18, 0x1F1D, -8, 1},     {0x1F28, 0x1F2F, -8, 1},
+    {0x1F38, 0x1F3F, -8, 1},     {0x1F48, 0x1F4D, -8, 1},
+    {0x1F59, 0x1F5F, -8, 2},     {0x1F68, 0x1F6F, -8, 1},
+    {0x1F88, 0x1F8F, -8, 1},     {0x1F98, 0x1F9F, -8, 1},
+    {0x1FA8, 0x1FAF, -8, 1},     {0x1FB8, 0x1FB9, -8, 1},
+    {0x1FBA, 0x1FBB, -74, 1},    {0x1FBC, 0x1FBC, -9, 1},
+    {0x1FC8, 0x1FCB, -86, 1},    {0x1FCC, 0x1FCC, -9, 1},
+    {0x1FD8, 0x1FD9, -8, 1},     {0x1FDA, 0x1FDB, -100, 1},
+    {0x1FE8, 0x1FE9, -8, 1},     {0x1FEA, 0x1FEB, -112, 1},
+    {0x1FEC, 0x1FEC, -7, 1},     {0x1FF8, 0x1FF9, -128, 1},
+    {0x1FFA, 0x1FFB, -126, 1},   {0x1FFC, 0x1FFC, -9, 1},
+    {0x2126, 0x2126, -7517, 1},  {0x212A, 0x212A, -8383, 1},
+    {0x212B, 0x212B, -8262, 1},  {0x2132, 0x2132, 28, 1},
+    {0x2160, 0x216F, 16, 1},     {0x2183, 0x2183, 1, 1},
+    {0x24B6, 0x24CF, 26, 1},     {0x2C00, 0x2C2F, 48, 1},
+    {0x2C60, 0x2C60, 1, 1},      {0x2C62, 0x2C62, -10743, 1},
+    {0x2C63, 0x2C63, -3814, 1},  {0x2C64, 0x2C64, -10727, 1},
+    {0x2C67, 0x2C6B, 1, 2},      {0x2C6D, 0x2C6D, -10780, 1},
+    {0x2C6E, 0x2C6E, -10749, 1}, {0x2C6F, 0x2C6F, -10783, 1},
+    {0x2C70, 0x2C70, -10782, 1}, {0x2C72, 0x2C72, 1, 1},
+    {0x2C75, 0x2C75, 1, 1},      {0x2C7E, 0x2C7F, -10815, 1},
+    {0x2C80, 0x2CE2, 1, 2},      {0x2CEB, 0x2CED, 1, 2},
+    {0x2CF2, 0x2CF2, 1, 1},      {0xA640, 0xA66C, 1, 2},
+    {0xA680, 0xA69A, 1, 2},      {0xA722, 0xA72E, 1, 2},
+    {0xA732, 0xA76E, 1, 2},      {0xA779, 0xA77B, 1, 2},
+    {0xA77D, 0xA77D, -35332, 1}, {0xA77E, 0xA786, 1, 2},
+    {0xA78B, 0xA78B, 1, 1},      {0xA78D, 0xA78D, -42280, 1},
+    {0xA790, 0xA792, 1, 2},      {0xA796, 0xA7A8, 1, 2},
+    {0xA7AA, 0xA7AA, -42308, 1}, {0xA7AB, 0xA7AB, -42319, 1},
+    {0xA7AC, 0xA7AC, -42315, 1}, {0xA7AD, 0xA7AD, -42305, 1},
+    {0xA7AE, 0xA7AE, -42308, 1}, {0xA7B0, 0xA7B0, -42258, 1},
+    {0xA7B1, 0xA7B1, -42282, 1}, {0xA7B2, 0xA7B2, -42261, 1},
+    {0xA7B3, 0xA7B3, 928, 1},    {0xA7B4, 0xA7C2, 1, 2},
+    {0xA7C4, 0xA7C4, -48, 1},    {0xA7C5, 0xA7C5, -42307, 1},
+    {0xA7C6, 0xA7C6, -35384, 1}, {0xA7C7, 0xA7C9, 1, 2},
+    {0xA7D0, 0xA7D0, 1, 1},      {0xA7D6, 0xA7D8, 1, 2},
+    {0xA7F5, 0xA7F5, 1, 1},      {0xFF21, 0xFF3A, 32, 1},
+    {0x10400, 0x10427, 40, 1},   {0x104B0, 0x104D3, 40, 1},
+    {0x10570, 0x1057A, 39, 1},   {0x1057C, 0x1058A, 39, 1},
+    {0x1058C, 0x10592, 39, 1},   {0x10594, 0x10595, 39, 1},
+    {0x10C80, 0x10CB2, 64, 1},   {0x118A0, 0x118BF, 32, 1},
+    {0x16E40, 0x16E5F, 32, 1},   {0x1E900, 0x1E921, 34, 1}};
+
+/**
+ * @brief Code points that change with the simple uppercase mapping.
+ */
+inline constexpr mapping upper_map[]{
+    {0x0061, 0x007A, -32, 1},    {0x00B5, 0x00B5, 743, 1},
+    {0x00E0, 0x00F6, -32, 1},    {0x00F8, 0x00FE, -32, 1},
+    {0x00FF, 0x00FF, 121, 1},    {0x0101, 0x012F, -1, 2},
+    {0x0131, 0x0131, -232, 1},   {0x0133, 0x0137, -1, 2},
+    {0x013A, 0x0148, -1, 2},     {0x014B, 0x0177, -1, 2},
+    {0x017A, 0x017E, -1, 2},     {0x017F, 0x017F, -300, 1},
+    {0x0180, 0x0180, 195, 1},    {0x0183, 0x0185, -1, 2},
+    {0x0188, 0x0188, -1, 1},     {0x018C, 0x018C, -1, 1},
+    {0x0192, 0x0192, -1, 1},     {0x0195, 0x0195, 97, 1},
+    {0x0199, 0x0199, -1, 1},     {0x019A, 0x019A, 163, 1},
+    {0x019E, 0x019E, 130, 1},    {0x01A1, 0x01A5, -1, 2},
+    {0x01A8, 0x01A8, -1, 1},     {0x01AD, 0x01AD, -1, 1},
+    {0x01B0, 0x01B0, -1, 1},     {0x01B4, 0x01B6, -1, 2},
+    {0x01B9, 0x01B9, -1, 1},     {0x01BD, 0x01BD, -1, 1},
+    {0x01BF, 0x01BF, 56, 1},     {0x01C5, 0x01C5, -1, 1},
+    {0x01C6, 0x01C6, -2, 1},     {0x01C8, 0x01C8, -1, 1},
+    {0x01C9, 0x01C9, -2, 1},     {0x01CB, 0x01CB, -1, 1},
+    {0x01CC, 0x01CC, -2, 1},     {0x01CE, 0x01DC, -1, 2},
+    {0x01DD, 0x01DD, -79, 1},    {0x01DF, 0x01EF, -1, 2},
+    {0x01F2, 0x01F2, -1, 1},     {0x01F3, 0x01F3, -2, 1},
+    {0x01F5, 0x01F5, -1, 1},     {0x01F9, 0x021F, -1, 2},
+    {0x0223, 0x0233, -1, 2},     {0x023C, 0x023C, -1, 1},
+    {0x023F, 0x0240, 10815, 1},  {0x0242, 0x0242, -1, 1},
+    {0x0247, 0x024F, -1, 2},     {0x0250, 0x0250, 10783, 1},
+    {0x0251, 0x0251, 10780, 1},  {0x0252, 0x0252, 10782, 1},
+    {0x0253, 0x0253, -210, 1},   {0x0254, 0x0254, -206, 1},
+    {0x0256, 0x0257, -205, 1},   {0x0259, 0x0259, -202, 1},
+    {0x025B, 0x025B, -203, 1},   {0x025C, 0x025C, 42319, 1},
+    {0x0260, 0x0260, -205, 1},   {0x0261, 0x0261, 42315, 1},
+    {0x0263, 0x0263, -207, 1},   {0x0265, 0x0265, 42280, 1},
+    {0x0266, 0x0266, 42308, 1},  {0x0268, 0x0268, -209, 1},
+    {0x0269, 0x0269, -211, 1},   {0x026A, 0x026A, 42308, 1},
+    {0x026B, 0x026B, 10743, 1},  {0x026C, 0x026C, 42305, 1},
+    {0x026F, 0x026F, -211, 1},   {0x0271, 0x0271, 10749, 1},
+    {0x0272, 0x0272, -213, 1},   {0x0275, 0x0275, -214, 1},
+    {0x027D, 0x027D, 10727, 1},  {0x0280, 0x0280, -218, 1},
+    {0x0282, 0x0282, 42307, 1},  {0x0283, 0x0283, -218, 1},
+    {0x0287, 0x0287, 42282, 1},  {0x0288, 0x0288, -218, 1},
+    {0x0289, 0x0289, -69, 1},    {0x028A, 0x028B, -217, 1},
+    {0x028C, 0x028C, -71, 1},    {0x0292, 0x0292, -219, 1},
+    {0x029D, 0x029D, 42261, 1},  {0x029E, 0x029E, 42258, 1},
+    {0x0345, 0x0345, 84, 1},     {0x0371, 0x0373, -1, 2},
+    {0x0377, 0x0377, -1, 1},     {0x037B, 0x037D, 130, 1},
+    {0x03AC, 0x03AC, -38, 1},    {0x03AD, 0x03AF, -37, 1},
+    {0x03B1, 0x03C1, -32, 1},    {0x03C2, 0x03C2, -31, 1},
+    {0x03C3, 0x03CB, -32, 1},    {0x03CC, 0x03CC, -64, 1},
+    {0x03CD, 0x03CE, -63, 1},    {0x03D0, 0x03D0, -62, 1},
+    {0x03D1, 0x03D1, -57, 1},    {0x03D5, 0x03D5, -47, 1},
+    {0x03D6, 0x03D6, -54, 1},    {0x03D7, 0x03D7, -8, 1},
+    {0x03D9, 0x03EF, -1, 2},     {0x03F0, 0x03F0, -86, 1},
+    {0x03F1, 0x03F1, -80, 1},    {0x03F2, 0x03F2, 7, 1},
+    {0x03F3, 0x03F3, -116, 1},   {0x03F5, 0x03F5, -96, 1},
+    {0x03F8, 0x03F8, -1, 1},     {0x03FB, 0x03FB, -1, 1},
+    {0x0430, 0x044F, -32, 1},    {0x0450, 0x045F, -80, 1},
+    {0x0461, 0x0481, -1, 2},     {0x048B, 0x04BF, -1, 2},
+    {0x04C2, 0x04CE, -1, 2},     {0x04CF, 0x04CF, -15, 1},
+    {0x04D1, 0x052F, -1, 2},     {0x0561, 0x0586, -48, 1},
+    {0x10D0, 0x10FA, 3008, 1},   {0x10FD, 0x10FF, 3008, 1},
+    {0x13F8, 0x13FD, -8, 1},     {0x1C80, 0x1C80, -6254, 1},
+    {0x1C81, 0x1C81, -6253, 1},  {0x1C82, 0x1C82, -6244, 1},
+    {0x1C83, 0x1C84, -6242, 1},  {0x1C85, 0x1C85, -6243, 1},
+    {0x1C86, 0x1C86, -6236, 1},  {0x1C87, 0x1C87, -6181, 1},
+    {0x1C88, 0x1C88, 35266, 1},  {0x1D79, 0x1D79, 35332, 1},
+    {0x1D7D, 0x1D7D, 3814, 1},   {0x1D8E, 0x1D8E, 35384, 1},
+    {0x1E01, 0x1E95, -1, 2},     {0x1E9B, 0x1E9B, -59, 1},
+    {0x1EA1, 0x1EFF, -1, 2},     {0x1F00, 0x1F07, 8, 1},
+    {0x1F10, 0x1F15, 8, 1},      {0x1F20, 0x1F27, 8, 1},
+    {0x1F30, 0x1F37, 8, 1},      {0x1F40, 0x1F45, 8, 1},
+    {0x1F51, 0x1F57, 8, 2},      {0x1F60, 0x1F67, 8, 1},
+    {0x1F70, 0x1F71, 74, 1},     {0x1F72, 0x1F75, 86, 1},
+    {0x1F76, 0x1F77, 100, 1},    {0x1F78, 0x1F79, 128, 1},
+    {0x1F7A, 0x1F7B, 112, 1},    {0x1F7C, 0x1F7D, 126, 1},
+    {0x1F80, 0x1F87, 8, 1},      {0x1F90, 0x1F97, 8, 1},
+    {0x1FA0, 0x1FA7, 8, 1},      {0x1FB0, 0x1FB1, 8, 1},
+    {0x1FB3, 0x1FB3, 9, 1},      {0x1FBE, 0x1FBE, -7205, 1},
+    {0x1FC3, 0x1FC3, 9, 1},      {0x1FD0, 0x1FD1, 8, 1},
+    {0x1FE0, 0x1FE1, 8, 1},      {0x1FE5, 0x1FE5, 7, 1},
+    {0x1FF3, 0x1FF3, 9, 1},      {0x214E, 0x214E, -28, 1},
+    {0x2170, 0x217F, -16, 1},    {0x2184, 0x2184, -1, 1},
+    {0x24D0, 0x24E9, -26, 1},    {0x2C30, 0x2C5F, -48, 1},
+    {0x2C61, 0x2C61, -1, 1},     {0x2C65, 0x2C65, -10795, 1},
+    {0x2C66, 0x2C66, -10792, 1}, {0x2C68, 0x2C6C, -1, 2},
+    {0x2C73, 0x2C73, -1, 1},     {0x2C76, 0x2C76, -1, 1},
+    {0x2C81, 0x2CE3, -1, 2},     {0x2CEC, 0x2CEE, -1, 2},
+    {0x2CF3, 0x2CF3, -1, 1},     {0x2D00, 0x2D25, -7264, 1},
+    {0x2D27, 0x2D27, -7264, 1},  {0x2D2D, 0x2D2D, -7264, 1},
+    {0xA641, 0xA66D, -1, 2},     {0xA681, 0xA69B, -1, 2},
+    {0xA723, 0xA72F, -1, 2},     {0xA733, 0xA76F, -1, 2},
+    {0xA77A, 0xA77C, -1, 2},     {0xA77F, 0xA787, -1, 2},
+    {0xA78C, 0xA78C, -1, 1},     {0xA791, 0xA793, -1, 2},
+    {0xA794, 0xA794, 48, 1},     {0xA797, 0xA7A9, -1, 2},
+    {0xA7B5, 0xA7C3, -1, 2},     {0xA7C8, 0xA7CA, -1, 2},
+    {0xA7D1, 0xA7D1, -1, 1},     {0xA7D7, 0xA7D9, -1, 2},
+    {0xA7F6, 0xA7F6, -1, 1},     {0xAB53, 0xAB53, -928, 1},
+    {0xAB70, 0xABBF, -38864, 1}, {0xFF41, 0xFF5A, -32, 1},
+    {0x10428, 0x1044F, -40, 1},  {0x104D8, 0x104FB, -40, 1},
+    {0x10597, 0x105A1, -39, 1},  {0x105A3, 0x105B1, -39, 1},
+    {0x105B3, 0x105B9, -39, 1},  {0x105BB, 0x105BC, -39, 1},
+    {0x10CC0, 0x10CF2, -64, 1},  {0x118C0, 0x118DF, -32, 1},
+    {0x16E60, 0x16E7F, -32, 1},  {0x1E922, 0x1E943, -34, 1}};
+
+/**
+ * @brief Code points that change with the simple case folding.
+ */
+inline constexpr mapping fold_map[]{
+    {0x0041, 0x005A, 32, 1},     {0x00B5, 0x00B5, 775, 1},
+    {0x00C0, 0x00D6, 32, 1},     {0x00D8, 0x00DE, 32, 1},
+    {0x0100, 0x012E, 1, 2},      {0x0132, 0x0136, 1, 2},
+    {0x0139, 0x0147, 1, 2},      {0x014A, 0x0176, 1, 2},
+    {0x0178, 0x0178, -121, 1},   {0x0179, 0x017D, 1, 2},
+    {0x017F, 0x017F, -268, 1},   {0x0181, 0x0181, 210, 1},
+    {0x0182, 0x0184, 1, 2},      {0x0186, 0x0186, 206, 1},
+    {0x0187, 0x0187, 1, 1},      {0x0189, 0x018A, 205, 1},
+    {0x018B, 0x018B, 1, 1},      {0x018E, 0x018E, 79, 1},
+    {0x018F, 0x018F, 202, 1},    {0x0190, 0x0190, 203, 1},
+    {0x0191, 0x0191, 1, 1},      {0x0193, 0x0193, 205, 1},
+    {0x0194, 0x0194, 207, 1},    {0x0196, 0x0196, 211, 1},
+    {0x0197, 0x0197, 209, 1},    {0x0198, 0x0198, 1, 1},
+    {0x019C, 0x019C, 211, 1},    {0x019D, 0x019D, 213, 1},
+    {0x019F, 0x019F, 214, 1},    {0x01A0, 0x01A4, 1, 2},
+    {0x01A6, 0x01A6, 218, 1},    {0x01A7, 0x01A7, 1, 1},
+    {0x01A9, 0x01A9, 218, 1},    {0x01AC, 0x01AC, 1, 1},
+    {0x01AE, 0x01AE, 218, 1},    {0x01AF, 0x01AF, 1, 1},
+    {0x01B1, 0x01B2, 217, 1},    {0x01B3, 0x01B5, 1, 2},
+    {0x01B7, 0x01B7, 219, 1},    {0x01B8, 0x01B8, 1, 1},
+    {0x01BC, 0x01BC, 1, 1},      {0x01C4, 0x01C4, 2, 1},
+    {0x01C5, 0x01C5, 1, 1},      {0x01C7, 0x01C7, 2, 1},
+    {0x01C8, 0x01C8, 1, 1},      {0x01CA, 0x01CA, 2, 1},
+    {0x01CB, 0x01DB, 1, 2},      {0x01DE, 0x01EE, 1, 2},
+    {0x01F1, 0x01F1, 2, 1},      {0x01F2, 0x01F4, 1, 2},
+    {0x01F6, 0x01F6, -97, 1},    {0x01F7, 0x01F7, -56, 1},
+    {0x01F8, 0x021E, 1, 2},      {0x0220, 0x0220, -130, 1},
+    {0x0222, 0x0232, 1, 2},      {0x023A, 0x023A, 10795, 1},
+    {0x023B, 0x023B, 1, 1},      {0x023D, 0x023D, -163, 1},
+    {0x023E, 0x023E, 10792, 1},  {0x0241, 0x0241, 1, 1},
+    {0x0243, 0x0243, -195, 1},   {0x0244, 0x0244, 69, 1},
+    {0x0245, 0x0245, 71, 1},     {0x0246, 0x024E, 1, 2},
+    {0x0345, 0x0345, 116, 1},    {0x0370, 0x0372, 1, 2},
+    {0x0376, 0x0376, 1, 1},      {0x037F, 0x037F, 116, 1},
+    {0x0386, 0x0386, 38, 1},     {0x0388, 0x038A, 37, 1},
+    {0x038C, 0x038C, 64, 1},     {0x038E, 0x038F, 63, 1},
+    {0x0391, 0x03A1, 32, 1},     {0x03A3, 0x03AB, 32, 1},
+    {0x03C2, 0x03C2, 1, 1},      {0x03CF, 0x03CF, 8, 1},
+    {0x03D0, 0x03D0, -30, 1},    {0x03D1, 0x03D1, -25, 1},
+    {0x03D5, 0x03D5, -15, 1},    {0x03D6, 0x03D6, -22, 1},
+    {0x03D8, 0x03EE, 1, 2},      {0x03F0, 0x03F0, -54, 1},
+    {0x03F1, 0x03F1, -48, 1},    {0x03F4, 0x03F4, -60, 1},
+    {0x03F5, 0x03F5, -64, 1},    {0x03F7, 0x03F7, 1, 1},
+    {0x03F9, 0x03F9, -7, 1},     {0x03FA, 0x03FA, 1, 1},
+    {0x03FD, 0x03FF, -130, 1},   {0x0400, 0x040F, 80, 1},
+    {0x0410, 0x042F, 32, 1},     {0x0460, 0x0480, 1, 2},
+    {0x048A, 0x04BE, 1, 2},      {0x04C0, 0x04C0, 15, 1},
+    {0x04C1, 0x04CD, 1, 2},      {0x04D0, 0x052E, 1, 2},
+    {0x0531, 0x0556, 48, 1},     {0x10A0, 0x10C5, 7264, 1},
+    {0x10C7, 0x10C7, 7264, 1},   {0x10CD, 0x10CD, 7264, 1},
+    {0x13F8, 0x13FD, -8, 1},     {0x1C80, 0x1C80, -6222, 1},
+    {0x1C81, 0x1C81, -6221, 1},  {0x1C82, 0x1C82, -6212, 1},
+    {0x1C83, 0x1C84, -6210, 1},  {0x1C85, 0x1C85, -6211, 1},
+    {0x1C86, 0x1C86, -6204, 1},  {0x1C87, 0x1C87, -6180, 1},
+    {0x1C88, 0x1C88, 35267, 1},  {0x1C90, 0x1CBA, -3008, 1},
+    {0x1CBD, 0x1CBF, -3008, 1},  {0x1E00, 0x1E94, 1, 2},
+    {0x1E9B, 0x1E9B, -58, 1},    {0x1E9E, 0x1E9E, -7615, 1},
+    {0x1EA0, 0x1EFE, 1, 2},      {0x1F08, 0x1F0F, -8, 1},
+    {0x1F18, 0x1F1D, -8, 1},     {0x1F28, 0x1F2F, -8, 1},
+    {0x1F38, 0x1F3F, -8, 1},     {0x1F48, 0x1F4D, -8, 1},
+    {0x1F59, 0x1F5F, -8, 2},     {0x1F68, 0x1F6F, -8, 1},
+    {0x1F88, 0x1F8F, -8, 1},     {0x1F98, 0x1F9F, -8, 1},
+    {0x1FA8, 0x1FAF, -8, 1},     {0x1FB8, 0x1FB9, -8, 1},
+    {0x1FBA, 0x1FBB, -74, 1},    {0x1FBC, 0x1FBC, -9, 1},
+    {0x1FBE, 0x1FBE, -7173, 1},  {0x1FC8, 0x1FCB, -86, 1},
+    {0x1FCC, 0x1FCC, -9, 1},     {0x1FD8, 0x1FD9, -8, 1},
+    {0x1FDA, 0x1FDB, -100, 1},   {0x1FE8, 0x1FE9, -8, 1},
+    {0x1FEA, 0x1FEB, -112, 1},   {0x1FEC, 0x1FEC, -7, 1},
+    {0x1FF8, 0x1FF9, -128, 1},   {0x1FFA, 0x1FFB, -126, 1},
+    {0x1FFC, 0x1FFC, -9, 1},     {0x2126, 0x2126, -7517, 1},
+    {0x212A, 0x212A, -8383, 1},  {0x212B, 0x212B, -8262, 1},
+    {0x2132, 0x2132, 28, 1},     {0x2160, 0x216F, 16, 1},
+    {0x2183, 0x2183, 1, 1},      {0x24B6, 0x24CF, 26, 1},
+    {0x2C00, 0x2C2F, 48, 1},     {0x2C60, 0x2C60, 1, 1},
+    {0x2C62, 0x2C62, -10743, 1}, {0x2C63, 0x2C63, -3814, 1},
+    {0x2C64, 0x2C64, -10727, 1}, {0x2C67, 0x2C6B, 1, 2},
+    {0x2C6D, 0x2C6D, -10780, 1}, {0x2C6E, 0x2C6E, -10749, 1},
+    {0x2C6F, 0x2C6F, -10783, 1}, {0x2C70, 0x2C70, -10782, 1},
+    {0x2C72, 0x2C72, 1, 1},      {0x2C75, 0x2C75, 1, 1},
+    {0x2C7E, 0x2C7F, -10815, 1}, {0x2C80, 0x2CE2, 1, 2},
+    {0x2CEB, 0x2CED, 1, 2},      {0x2CF2, 0x2CF2, 1, 1},
+    {0xA640, 0xA66C, 1, 2},      {0xA680, 0xA69A, 1, 2},
+    {0xA722, 0xA72E, 1, 2},      {0xA732, 0xA76E, 1, 2},
+    {0xA779, 0xA77B, 1, 2},      {0xA77D, 0xA77D, -35332, 1},
+    {0xA77E, 0xA786, 1, 2},      {0xA78B, 0xA78B, 1, 1},
+    {0xA78D, 0xA78D, -42280, 1}, {0xA790, 0xA792, 1, 2},
+    {0xA796, 0xA7A8, 1, 2},      {0xA7AA, 0xA7AA, -42308, 1},
+    {0xA7AB, 0xA7AB, -42319, 1}, {0xA7AC, 0xA7AC, -42315, 1},
+    {0xA7AD, 0xA7AD, -42305, 1}, {0xA7AE, 0xA7AE, -42308, 1},
+    {0xA7B0, 0xA7B0, -42258, 1}, {0xA7B1, 0xA7B1, -42282, 1},
+    {0xA7B2, 0xA7B2, -42261, 1}, {0xA7B3, 0xA7B3, 928, 1},
+    {0xA7B4, 0xA7C2, 1, 2},      {0xA7C4, 0xA7C4, -48, 1},
+    {0xA7C5, 0xA7C5, -42307, 1}, {0xA7C6, 0xA7C6, -35384, 1},
+    {0xA7C7, 0xA7C9, 1, 2},      {0xA7D0, 0xA7D0, 1, 1},
+    {0xA7D6, 0xA7D8, 1, 2},      {0xA7F5, 0xA7F5, 1, 1},
+    {0xAB70, 0xABBF, -38864, 1}, {0xFF21, 0xFF3A, 32, 1},
+    {0x10400, 0x10427, 40, 1},   {0x104B0, 0x104D3, 40, 1},
+    {0x10570, 0x1057A, 39, 1},   {0x1057C, 0x1058A, 39, 1},
+    {0x1058C, 0x10592, 39, 1},   {0x10594, 0x10595, 39, 1},
+    {0x10C80, 0x10CB2, 64, 1},   {0x118A0, 0x118BF, 32, 1},
+    {0x16E40, 0x16E5F, 32, 1},   {0x1E900, 0x1E921, 34, 1}};
+
+/**
+ * @brief Maps a code point with a table.
+ */
+template <size_type Size>
+char32_t apply(mapping const (&table_)[Size], char32_t code_) {
+   if (code_ > table_[Size - 1].last) {
+      return code_;
+   }
+
+   mapping const *const after{std::upper_bound(
+       table_, table_ + Size, code_,
+       [](char32_t code, mapping const &entry) { return code < entry.first; })};
+   if (after == table_) {
+      return code_;
+   }
+
+   mapping const &entry{after[-1]};
+   if (code_ > entry.last || (code_ - entry.first) % entry.stride != 0) {
+      return code_;
+   }
+   return static_cast<char32_t>(static_cast<std::int32_t>(code_) +
+                                entry.delta);
+}
+
+/**
+ * @brief Gets the simple lowercase mapping of a code point.
+ */
+inline char32_t to_lower(char32_t code_) {
+   if (code_ < 0x80) {
+      return code_ >= 'A' && code_ <= 'Z' ? code_ + 0x20 : code_;
+   }
+   return apply(lower_map, code_);
+}
+
+/**
+ * @brief Gets the simple uppercase mapping of a code point.
+ */
+inline char32_t to_upper(char32_t code_) {
+   if (code_ < 0x80) {
+      return code_ >= 'a' && code_ <= 'z' ? code_ - 0x20 : code_;
+   }
+   return apply(upper_map, code_);
+}
+
+/**
+ * @brief Gets the simple case folding of a code point, which is the same for
+ * all the cases of a letter.
+ */
+inline char32_t fold(char32_t code_) {
+   if (code_ < 0x80) {
+      return code_ >= 'A' && code_ <= 'Z' ? code_ + 0x20 : code_;
+   }
+   return apply(fold_map, code_);
+}
+
+/**
+ * @brief Lowercases an ASCII byte.
+ */
+inline unsigned char lower_ascii(unsigned char byte_) {
+   return byte_ >= 'A' && byte_ <= 'Z' ? byte_ ^ 0x20 : byte_;
+}
+
+#if defined(__AVX2__)
+/**
+ * @brief Flips the case of the bytes strictly between two bounds.
+ */
+inline __m256i flip_case(__m256i bytes_, char below_, char above_) {
+   __m256i const letters{
+       _mm256_and_si256(_mm256_cmpgt_epi8(bytes_, _mm256_set1_epi8(below_)),
+                        _mm256_cmpgt_epi8(_mm256_set1_epi8(above_), bytes_))};
+   return _mm256_xor_si256(
+       bytes_, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+#if defined(__SSE2__)
+/**
+ * @brief Flips the case of the bytes strictly between two bounds.
+ */
+inline __m128i flip_case(__m128i bytes_, char below_, char above_) {
+   __m128i const letters{
+       _mm_and_si128(_mm_cmpgt_epi8(bytes_, _mm_set1_epi8(below_)),
+                     _mm_cmpgt_epi8(_mm_set1_epi8(above_), bytes_))};
+   return _mm_xor_si128(bytes_,
+                        _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+#endif
+
+/**
+ * @brief Converts the run of ASCII bytes at the start of a text.
+ *
+ * @tparam Upper True to uppercase, false to lowercase.
+ * @param in_ The bytes.
+ * @param size_ The number of bytes.
+ * @param out_ Receives the converted bytes; it may be in_, or before it.
+ * @return The number of bytes converted, up to the first non-ASCII byte.
+ */
+template <bool Upper>
+size_type ascii_case(unsigned char const *in_, size_type size_,
+                     unsigned char *out_) {
+   constexpr char below{Upper ? 'a' - 1 : 'A' - 1};
+   constexpr char above{Upper ? 'z' + 1 : 'Z' + 1};
+   size_type pos{0};
+
+#if defined(__AVX2__)
+   for (; size_ - pos >= 32; pos += 32) {
+      __m256i const bytes{
+          _mm256_loadu_si256(reinterpret_cast<__m256i const *>(in_ + pos))};
+      if (_mm256_movemask_epi8(bytes) != 0) {
+         break;
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out_ + pos),
+                          flip_case(bytes, below, above));
+   }
+#endif
+
+#if defined(__SSE2__)
+   for (; size_ - pos >= 16; pos += 16) {
+      __m128i const bytes{
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(in_ + pos))};
+      if (_mm_movemask_epi8(bytes) != 0) {
+         break;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out_ + pos),
+                       flip_case(bytes, below, above));
+   }
+#endif
+
+   for (; pos != size_ && in_[pos] < 0x80; ++pos) {
+      unsigned char const byte{in_[pos]};
+      out_[pos] = byte > below && byte < above ? byte ^ 0x20 : byte;
+   }
+   return pos;
+}
+
+/**
+ * @brief Compares the runs of ASCII bytes at the start of two texts,
+ * ignoring case.
+ *
+ * @param left_ The bytes of the first text.
+ * @param right_ The bytes of the second text.
+ * @param size_ The number of bytes to compare.
+ * @return The number of leading bytes that are ASCII in both texts and equal
+ * ignoring case.
+ */
+inline size_type ascii_iequal(unsigned char const *left_,
+                              unsigned char const *right_, size_type size_) {
+   size_type pos{0};
+
+#if defined(__AVX2__)
+   for (; size_ - pos >= 32; pos += 32) {
+      __m256i const left{
+          _mm256_loadu_si256(reinterpret_cast<__m256i const *>(left_ + pos))};
+      __m256i const right{_mm256_loadu_si256(
+          reinterpret_cast<__m256i const *>(right_ + pos))};
+      if (_mm256_movemask_epi8(_mm256_or_si256(left, right)) != 0) {
+         break;
+      }
+
+      unsigned const same{static_cast<unsigned>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+              flip_case(left, 'A' - 1, 'Z' + 1),
+              flip_case(right, 'A' - 1, 'Z' + 1))))};
+      if (same != 0xFFFFFFFFu) {
+         return pos + static_cast<size_type>(__builtin_ctz(~same));
+      }
+   }
+#endif
+
+#if defined(__SSE2__)
+   for (; size_ - pos >= 16; pos += 16) {
+      __m128i const left{
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(left_ + pos))};
+      __m128i const right{
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(right_ + pos))};
+      if (_mm_movemask_epi8(_mm_or_si128(left, right)) != 0) {
+         break;
+      }
+
+      unsigned const same{static_cast<unsigned>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(flip_case(left, 'A' - 1, 'Z' + 1),
+                         flip_case(right, 'A' - 1, 'Z' + 1))))};
+      if (same != 0xFFFFu) {
+         return pos + static_cast<size_type>(__builtin_ctz(~same));
+      }
+   }
+#endif
+
+   while (pos != size_ && (left_[pos] | right_[pos]) < 0x80 &&
+          lower_ascii(left_[pos]) == lower_ascii(right_[pos])) {
+      ++pos;
+   }
+   return pos;
+}
+
+/**
+ * @brief Finds an ASCII pattern in a text, ignoring case, with a vector
+ * filter on the first and the last byte of the pattern.
+ *
+ * @param text_ The bytes of the text.
+ * @param size_ The number of bytes of the text.
+ * @param pattern_ The ASCII pattern, not empty.
+ * @param count_ The number of bytes of the pattern.
+ * @param pos_ The position to start the search.
+ * @return The position of the first match, or npos.
+ */
+inline size_type find_ascii(unsigned char const *text_, size_type size_,
+                            unsigned char const *pattern_, size_type count_,
+                            size_type pos_) {
+   if (count_ > size_ || pos_ > size_ - count_) {
+      return npos;
+   }
+
+   size_type const last{size_ - count_ + 1}; // End of the candidates
+   unsigned char const first_byte{lower_ascii(pattern_[0])};
+   unsigned char const last_byte{lower_ascii(pattern_[count_ - 1])};
+   size_type start{pos_};
+
+#if defined(__AVX2__)
+   for (; last - start >= 32; start += 32) {
+      __m256i const head{flip_case(
+          _mm256_loadu_si256(reinterpret_cast<__m256i const *>(text_ + start)),
+          'A' - 1, 'Z' + 1)};
+      __m256i const tail{
+          flip_case(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(
+                        text_ + start + count_ - 1)),
+                    'A' - 1, 'Z' + 1)};
+      unsigned mask{static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+          _mm256_cmpeq_epi8(head,
+                            _mm256_set1_epi8(static_cast<char>(first_byte))),
+          _mm256_cmpeq_epi8(tail,
+                            _mm256_set1_epi8(static_cast<char>(last_byte))))))};
+
+      for (; mask != 0; mask &= mask - 1) {
+         size_type const candidate{start +
+                                   static_cast<size_type>(__builtin_ctz(mask))};
+         if (ascii_iequal(text_ + candidate, pattern_, count_) == count_) {
+            return candidate;
+         }
+      }
+   }
+#endif
+
+#if defined(__SSE2__)
+   for (; last - start >= 16; start += 16) {
+      __m128i const head{flip_case(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(text_ + start)),
+          'A' - 1, 'Z' + 1)};
+      __m128i const tail{
+          flip_case(_mm_loadu_si128(reinterpret_cast<__m128i const *>(
+                        text_ + start + count_ - 1)),
+                    'A' - 1, 'Z' + 1)};
+      unsigned mask{static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+          _mm_cmpeq_epi8(head, _mm_set1_epi8(static_cast<char>(first_byte))),
+          _mm_cmpeq_epi8(tail, _mm_set1_epi8(static_cast<char>(last_byte))))))};
+
+      for (; mask != 0; mask &= mask - 1) {
+         size_type const candidate{start +
+                                   static_cast<size_type>(__builtin_ctz(mask))};
+         if (ascii_iequal(text_ + candidate, pattern_, count_) == count_) {
+            return candidate;
+         }
+      }
+   }
+#endif
+
+   for (; start != last; ++start) {
+      if (lower_ascii(text_[start]) == first_byte &&
+          ascii_iequal(text_ + start, pattern_, count_) == count_) {
+         return start;
+      }
+   }
+   return npos;
+}
+
+/**
+ * @brief How far a conversion got.
+ */
+struct progress {
+   size_type read;    ///< Code units read.
+   size_type written; ///< Code units written.
+};
+
+/**
+ * @brief Converts the case of a text. Invalid sequences are copied as they
+ * are.
+ *
+ * @tparam Upper True to uppercase, false to lowercase.
+ * @param in_ The text.
+ * @param size_ The number of code units of the text.
+ * @param out_ Receives the converted text; it may be in_, to convert in
+ * place.
+ * @param room_ The number of code units out_ holds, at least size_.
+ * @return How far the conversion got: all of the text, or up to the first
+ * letter that does not fit because its other case is longer (so never for
+ * UTF-16 and UTF-32). Half as much room again as the text always fits.
+ */
+template <bool Upper, typename CharType>
+progress convert(CharType const *in_, size_type size_, CharType *out_,
+                 size_type room_) {
+   size_type const slack{room_ - size_};
+   size_type read{0};
+   size_type written{0};
+
+   while (read != size_) {
+      if constexpr (sizeof(CharType) == 1) {
+         size_type const ascii{ascii_case<Upper>(
+             reinterpret_cast<unsigned char const *>(in_ + read), size_ - read,
+             reinterpret_cast<unsigned char *>(out_ + written))};
+         read += ascii;
+         written += ascii;
+         if (read == size_) {
+            break;
+         }
+      }
+
+      CharType const *next{in_ + read};
+      char32_t const code{utf::decode(next, in_ + size_)};
+      size_type const size{
+          code == utf::invalid ? 1 : static_cast<size_type>(next - in_) - read};
+
+      CharType converted[4];
+      CharType const *mapped{in_ + read};
+      size_type mapped_size{size};
+      if (code != utf::invalid) {
+         char32_t const other{Upper ? to_upper(code) : to_lower(code)};
+         if (other != code) {
+            mapped = converted;
+            mapped_size = static_cast<size_type>(
+                utf::encode(other, converted) - converted);
+         }
+      }
+
+      if (written + mapped_size > read + size + slack) {
+         break; // It would overwrite the text not read yet
+      }
+      if (mapped != out_ + written) {
+         std::char_traits<CharType>::move(out_ + written, mapped, mapped_size);
+      }
+      read += size;
+      written += mapped_size;
+   }
+
+   return {read, written};
+}
+
+/**
+ * @brief Decodes and folds the code point at the start of a text. An invalid
+ * code unit is taken alone and only matches itself.
+ *
+ * @param first_ The first code unit, moved past the code point.
+ * @param last_ The end of the text (must not be first_).
+ */
+template <typename CharType>
+char32_t next_folded(CharType const *&first_, CharType const *last_) {
+   char32_t const code{utf::decode(first_, last_)};
+   if (code != utf::invalid) {
+      return fold(code);
+   }
+
+   char32_t const unit{utf::unit(*first_++)};
+   // Invalid bytes are moved past the code points they would be confused with
+   return sizeof(CharType) == 1 ? 0x110000 + unit : unit;
+}
+
+/**
+ * @brief Compares two texts code point by code point, after case folding.
+ *
+ * @return A negative value if the first text sorts before the second, 0 if
+ * they are equal ignoring case, and a positive value otherwise.
+ */
+template <typename CharType>
+int compare(std::basic_string_view<CharType> left_,
+            std::basic_string_view<CharType> right_) {
+   CharType const *left{left_.data()};
+   CharType const *right{right_.data()};
+   CharType const *const left_end{left + left_.size()};
+   CharType const *const right_end{right + right_.size()};
+
+   while (true) {
+      if constexpr (sizeof(CharType) == 1) {
+         size_type const same{ascii_iequal(
+             reinterpret_cast<unsigned char const *>(left),
+             reinterpret_cast<unsigned char const *>(right),
+             static_cast<size_type>(
+                 std::min(left_end - left, right_end - right)))};
+         left += same;
+         right += same;
+      }
+      if (left == left_end || right == right_end) {
+         break;
+      }
+
+      char32_t const left_code{next_folded(left, left_end)};
+      char32_t const right_code{next_folded(right, right_end)};
+      if (left_code != right_code) {
+         return left_code < right_code ? -1 : 1;
+      }
+   }
+
+   return static_cast<int>(left != left_end) -
+          static_cast<int>(right != right_end);
+}
+
+/**
+ * @brief Finds a pattern in a text, ignoring case.
+ *
+ * An ASCII pattern without 'k' or 's' can only match ASCII text, as only the
+ * Kelvin sign and the long s fold into ASCII letters, so it is searched with
+ * the vector filter of find_ascii(). Other patterns are compared code point by
+ * code point at each character of the text.
+ *
+ * @param text_ The text.
+ * @param pattern_ The pattern.
+ * @param pos_ The position to start the search.
+ * @return The position of the first match, or npos.
+ */
+template <typename CharType>
+size_type find(std::basic_string_view<CharType> text_,
+               std::basic_string_view<CharType> pattern_, size_type pos_ = 0) {
+   if (pos_ > text_.size()) {
+      return npos;
+   }
+   if (pattern_.empty()) {
+      return pos_;
+   }
+
+   if constexpr (sizeof(CharType) == 1) {
+      unsigned char const *const pattern{
+          reinterpret_cast<unsigned char const *>(pattern_.data())};
+      if (utf::ascii_prefix(pattern, pattern_.size()) == pattern_.size() &&
+          pattern_.find_first_of("KkSs") == std::string_view::npos) {
+         return find_ascii(
+             reinterpret_cast<unsigned char const *>(text_.data()),
+             text_.size(), pattern, pattern_.size(), pos_);
+      }
+   }
+
+   CharType const *const end{text_.data() + text_.size()};
+   CharType const *const pattern_end{pattern_.data() + pattern_.size()};
+
+   for (CharType const *start{text_.data() + pos_}; start != end;) {
+      CharType const *text{start};
+      CharType const *pattern{pattern_.data()};
+      bool same{true};
+
+      while (same && pattern != pattern_end) {
+         same = text != end &&
+                next_folded(text, end) == next_folded(pattern, pattern_end);
+      }
+      if (same) {
+         return static_cast<size_type>(start - text_.data());
+      }
+
+      if (utf::decode(start, end) == utf::invalid) {
+         ++start;
+      }
+   }
+   return npos;
+}
+} // namespace casing
+} // namespace ext
+
+#endif // CASING_HPP_
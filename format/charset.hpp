@@ -0,0 +1,363 @@
+/**
+ * @file charset.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A precompiled set of characters with vectorized scanning kernels.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The set is a 256-bit bitmap laid out as two 16-byte nibble tables, so the
+ * same storage serves the scalar lookup and the SSSE3/AVX2 shuffle kernels
+ * (a byte is split into its low nibble, used as the shuffle index, and its
+ * high nibble, used to select the bit). The vector kernels are chosen at
+ * compile time (-mssse3, -mavx2 or -march=native) and fall back to a scalar
+ * loop otherwise or for character types wider than one byte.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef CHARSET_HPP_
+#define CHARSET_HPP_
+
+#include <cstddef>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A set of code units below 256, built once and scanned without
+ * allocating.
+ *
+ * Code units of wider character types that are 256 or above are never
+ * members of the set.
+ */
+class charset {
+ public:
+   using size_type = std::size_t;
+
+   static constexpr size_type npos{static_cast<size_type>(-1)}; ///< Not found
+
+   /**
+    * @brief Default constructor, creates an empty set.
+    */
+   constexpr charset() : m_table{} {}
+
+   /**
+    * @brief Constructs a set from a null-terminated list of characters.
+    *
+    * @param chars_ The characters in the set.
+    */
+   constexpr explicit charset(char const *chars_) : m_table{} {
+      for (; *chars_ != '\0'; ++chars_) {
+         insert(static_cast<unsigned char>(*chars_));
+      }
+   }
+
+   /**
+    * @brief Constructs a set from a sequence of characters.
+    *
+    * @tparam CharType The character type of the sequence.
+    * @param chars_ The characters in the set (those above 255 are ignored).
+    */
+   template <typename CharType>
+   constexpr explicit charset(std::basic_string_view<CharType> chars_)
+       : m_table{} {
+      for (CharType char_ : chars_) {
+         if (code(char_) < 256) {
+            insert(static_cast<unsigned char>(code(char_)));
+         }
+      }
+   }
+
+   /**
+    * @brief Gets the set of whitespace characters (" \t\n\r\f\v").
+    *
+    * @return The whitespace set.
+    */
+   static constexpr charset whitespace() { return charset(" \t\n\r\f\v"); }
+
+   /**
+    * @brief Adds a byte to the set.
+    *
+    * @param byte_ The byte to add.
+    * @return A reference to the modified set.
+    */
+   constexpr charset &insert(unsigned char byte_) {
+      m_table[index(byte_)] |= static_cast<unsigned char>(1u << bit(byte_));
+      return *this;
+   }
+
+   /**
+    * @brief Checks if a character belongs to the set.
+    *
+    * @tparam CharType The character type.
+    * @param char_ The character to check.
+    * @return True if the character is in the set, false otherwise.
+    */
+   template <typename CharType> constexpr bool contains(CharType char_) const {
+      if (code(char_) >= 256) {
+         return false;
+      }
+
+      unsigned char const byte{static_cast<unsigned char>(code(char_))};
+      return (m_table[index(byte)] >> bit(byte)) & 1u;
+   }
+
+   /**
+    * @brief Finds the first character in the set.
+    *
+    * @tparam CharType The character type.
+    * @param data_ The characters to scan.
+    * @param size_ The number of characters to scan.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The position of the character, or npos if there is none.
+    */
+   template <typename CharType>
+   size_type find_first_of(CharType const *data_, size_type size_,
+                           size_type pos_ = 0) const {
+      return find_first(data_, size_, pos_, true);
+   }
+
+   /**
+    * @brief Finds the first character not in the set.
+    *
+    * @tparam CharType The character type.
+    * @param data_ The characters to scan.
+    * @param size_ The number of characters to scan.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The position of the character, or npos if there is none.
+    */
+   template <typename CharType>
+   size_type find_first_not_of(CharType const *data_, size_type size_,
+                               size_type pos_ = 0) const {
+      return find_first(data_, size_, pos_, false);
+   }
+
+   /**
+    * @brief Finds the last character not in the set.
+    *
+    * @tparam CharType The character type.
+    * @param data_ The characters to scan.
+    * @param size_ The number of characters to scan.
+    * @return The position of the character, or npos if there is none.
+    */
+   template <typename CharType>
+   size_type find_last_not_of(CharType const *data_, size_type size_) const {
+      size_type end{size_};
+
+      if constexpr (sizeof(CharType) == 1) {
+         size_type const found{vector_last_not_of(
+             reinterpret_cast<unsigned char const *>(data_), end)};
+         if (found != npos) {
+            return found;
+         }
+      }
+
+      while (end != 0) {
+         --end;
+         if (!contains(data_[end])) {
+            return end;
+         }
+      }
+
+      return npos;
+   }
+
+ private:
+   /**
+    * @brief Gets the unsigned code of a character.
+    *
+    * @tparam CharType The character type.
+    * @param char_ The character.
+    * @return The code unit as an unsigned value.
+    */
+   template <typename CharType>
+   static constexpr unsigned long code(CharType char_) {
+      if constexpr (sizeof(CharType) == 1) {
+         return static_cast<unsigned char>(char_);
+      } else {
+         return static_cast<unsigned long>(char_);
+      }
+   }
+
+   /**
+    * @brief Gets the table entry of a byte: its low nibble, in the upper or
+    * lower table depending on the byte's high bit.
+    */
+   static constexpr size_type index(unsigned char byte_) {
+      return ((byte_ >> 7) << 4) | (byte_ & 0x0F);
+   }
+
+   /**
+    * @brief Gets the bit of a byte inside its table entry: the three lower
+    * bits of its high nibble.
+    */
+   static constexpr unsigned bit(unsigned char byte_) {
+      return (byte_ >> 4) & 0x07;
+   }
+
+   /**
+    * @brief Scalar and vector search for the first member or non-member.
+    */
+   template <typename CharType>
+   size_type find_first(CharType const *data_, size_type size_,
+                        size_type pos_, bool member_) const {
+      if constexpr (sizeof(CharType) == 1) {
+         size_type const found{
+             vector_first(reinterpret_cast<unsigned char const *>(data_),
+                          size_, pos_, member_)};
+         if (found != npos) {
+            return found;
+         }
+      }
+
+      for (; pos_ < size_; ++pos_) {
+         if (contains(data_[pos_]) == member_) {
+            return pos_;
+         }
+      }
+
+      return npos;
+   }
+
+#if defined(__AVX2__)
+   /**
+    * @brief Computes a bit mask of the set members among 32 bytes.
+    */
+   unsigned members(__m256i bytes_) const {
+      __m256i const lower{_mm256_broadcastsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(m_table)))};
+      __m256i const upper{_mm256_broadcastsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(m_table + 16)))};
+      __m256i const bits{_mm256_setr_epi8(
+          1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4,
+          8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)};
+      __m256i const nibble{_mm256_set1_epi8(0x0F)};
+
+      __m256i const low{_mm256_and_si256(bytes_, nibble)};
+      __m256i const high{
+          _mm256_and_si256(_mm256_srli_epi16(bytes_, 4), nibble)};
+      __m256i const in_upper{_mm256_cmpgt_epi8(high, _mm256_set1_epi8(7))};
+      __m256i const row{_mm256_blendv_epi8(_mm256_shuffle_epi8(lower, low),
+                                           _mm256_shuffle_epi8(upper, low),
+                                           in_upper)};
+      __m256i const hit{_mm256_and_si256(row, _mm256_shuffle_epi8(bits, high))};
+
+      return ~static_cast<unsigned>(_mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(hit, _mm256_setzero_si256())));
+   }
+
+   static constexpr size_type block{32}; ///< Bytes per vector step.
+
+   /**
+    * @brief Loads one vector of bytes and gets its member mask.
+    */
+   unsigned members_at(unsigned char const *data_) const {
+      return members(
+          _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data_)));
+   }
+#elif defined(__SSSE3__)
+   /**
+    * @brief Computes a bit mask of the set members among 16 bytes.
+    */
+   unsigned members(__m128i bytes_) const {
+      __m128i const lower{
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(m_table))};
+      __m128i const upper{
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(m_table + 16))};
+      __m128i const bits{_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4,
+                                       8, 16, 32, 64, -128)};
+      __m128i const nibble{_mm_set1_epi8(0x0F)};
+
+      __m128i const low{_mm_and_si128(bytes_, nibble)};
+      __m128i const high{_mm_and_si128(_mm_srli_epi16(bytes_, 4), nibble)};
+      __m128i const in_upper{_mm_cmpgt_epi8(high, _mm_set1_epi8(7))};
+      __m128i const row{
+          _mm_or_si128(_mm_andnot_si128(in_upper, _mm_shuffle_epi8(lower, low)),
+                       _mm_and_si128(in_upper, _mm_shuffle_epi8(upper, low)))};
+      __m128i const hit{_mm_and_si128(row, _mm_shuffle_epi8(bits, high))};
+
+      return ~static_cast<unsigned>(_mm_movemask_epi8(
+                 _mm_cmpeq_epi8(hit, _mm_setzero_si128()))) &
+             0xFFFFu;
+   }
+
+   static constexpr size_type block{16}; ///< Bytes per vector step.
+
+   /**
+    * @brief Loads one vector of bytes and gets its member mask.
+    */
+   unsigned members_at(unsigned char const *data_) const {
+      return members(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(data_)));
+   }
+#endif
+
+   /**
+    * @brief Vector part of find_first.
+    *
+    * @param pos_ The search start, advanced past the scanned blocks.
+    * @return The position found, or npos if the scalar loop must continue.
+    */
+   size_type vector_first(unsigned char const *data_, size_type size_,
+                          size_type &pos_, bool member_) const {
+#if defined(__AVX2__) || defined(__SSSE3__)
+      unsigned const full{block == 32 ? ~0u : 0xFFFFu};
+
+      for (; pos_ + block <= size_; pos_ += block) {
+         unsigned mask{members_at(data_ + pos_)};
+         if (!member_) {
+            mask = ~mask & full;
+         }
+
+         if (mask != 0) {
+            return pos_ + static_cast<size_type>(__builtin_ctz(mask));
+         }
+      }
+#else
+      (void)data_;
+      (void)size_;
+      (void)pos_;
+      (void)member_;
+#endif
+      return npos;
+   }
+
+   /**
+    * @brief Vector part of find_last_not_of.
+    *
+    * @param end_ The search end, moved back before the scanned blocks.
+    * @return The position found, or npos if the scalar loop must continue.
+    */
+   size_type vector_last_not_of(unsigned char const *data_,
+                                size_type &end_) const {
+#if defined(__AVX2__) || defined(__SSSE3__)
+      unsigned const full{block == 32 ? ~0u : 0xFFFFu};
+
+      for (; end_ >= block; end_ -= block) {
+         unsigned const mask{~members_at(data_ + end_ - block) & full};
+
+         if (mask != 0) {
+            return end_ - block + 31 -
+                   static_cast<size_type>(__builtin_clz(mask));
+         }
+      }
+#else
+      (void)data_;
+      (void)end_;
+#endif
+      return npos;
+   }
+
+   unsigned char m_table[32]; ///< Bitmap, two 16-entry nibble tables.
+};
+
+} // namespace ext
+
+#endif // CHARSET_HPP_
@@ -0,0 +1,476 @@
+/**
+ * @file concat.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Concatenation and joining that allocate the result once.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * Each "+" of two strings builds a temporary string, so a path or a log line
+ * put together from N pieces allocates and copies up to N times. cat() and
+ * join() measure every piece first, allocate the result once and copy the
+ * pieces into it. Both use a concat, which holds views of the pieces and
+ * never outlives the call, so the texts may be temporaries. The "+" of an
+ * fstring measures its two operands the same way and, as with std::string,
+ * returns a new fstring. Pieces are texts (strings, string views and
+ * null-terminated arrays) and characters; cat() and join() also take
+ * numbers, written with std::to_chars.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef CONCAT_HPP_
+#define CONCAT_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Concatenation piece namespace
+ *
+ * This namespace holds how each operand of cat(), join() and the "+" of an
+ * fstring is measured and copied: texts become string views, characters stay
+ * characters and numbers are written to a small buffer.
+ */
+namespace piece {
+using size_type = std::size_t;
+
+/**
+ * @brief Checks if a type is a text of some character type.
+ */
+template <typename CharType, class Type>
+constexpr bool is_text_v{
+    std::is_convertible_v<Type const &, std::basic_string_view<CharType>>};
+
+/**
+ * @brief Checks if a type is a single character: the character type itself
+ * or a narrow character, which is widened as an unsigned byte.
+ */
+template <typename CharType, class Type>
+constexpr bool is_character_v{std::is_same_v<Type, CharType> ||
+                              std::is_same_v<Type, char> ||
+                              std::is_same_v<Type, signed char> ||
+                              std::is_same_v<Type, unsigned char>};
+
+/**
+ * @brief Checks if a type is a number, other than a character or a boolean.
+ */
+template <typename CharType, class Type>
+constexpr bool is_number_v{std::is_arithmetic_v<Type> &&
+                           !std::is_same_v<Type, bool> &&
+                           !is_character_v<CharType, Type>};
+
+/**
+ * @brief Checks if a type can be an operand of the "+" of a string: a text
+ * or a character.
+ */
+template <typename CharType, class Type>
+constexpr bool is_operand_v{is_text_v<CharType, Type> ||
+                            is_character_v<CharType, Type>};
+
+/**
+ * @brief Gets the character type of a text or a wide character, or void.
+ */
+template <class Type>
+using char_of_t = std::conditional_t<
+    is_text_v<char, Type> || std::is_same_v<Type, char>, char,
+    std::conditional_t<
+        is_text_v<wchar_t, Type> || std::is_same_v<Type, wchar_t>, wchar_t,
+        std::conditional_t<
+            is_text_v<char16_t, Type> || std::is_same_v<Type, char16_t>,
+            char16_t,
+            std::conditional_t<is_text_v<char32_t, Type> ||
+                                   std::is_same_v<Type, char32_t>,
+                               char32_t, void>>>>;
+
+/**
+ * @brief Gets the character type of the first piece that has one, or char.
+ */
+template <class... Types> struct common_char {
+   using type = char;
+};
+
+template <class First, class... Rest> struct common_char<First, Rest...> {
+   using type = std::conditional_t<!std::is_void_v<char_of_t<First>>,
+                                   char_of_t<First>,
+                                   typename common_char<Rest...>::type>;
+};
+
+template <class... Types>
+using common_char_t = typename common_char<Types...>::type;
+
+/**
+ * @brief A number written with std::to_chars.
+ */
+struct number {
+   char digits[64]; ///< The digits, enough for any arithmetic type.
+   size_type size;  ///< The number of digits.
+};
+
+/**
+ * @brief Turns a value into a piece.
+ *
+ * @param value_ A text, a character or a number.
+ * @return A string view of a text, the character, or the written number.
+ */
+template <typename CharType, class Type> auto make(Type const &value_) {
+   static_assert(is_operand_v<CharType, Type> ||
+                     is_number_v<CharType, Type>,
+                 "Only texts, characters and numbers can be concatenated.");
+
+   if constexpr (is_text_v<CharType, Type>) {
+      return std::basic_string_view<CharType>(value_);
+   } else if constexpr (is_character_v<CharType, Type>) {
+      if constexpr (std::is_same_v<Type, CharType>) {
+         return value_;
+      } else {
+         return static_cast<CharType>(static_cast<unsigned char>(value_));
+      }
+   } else {
+      number written;
+      written.size = static_cast<size_type>(
+          std::to_chars(written.digits,
+                        written.digits + sizeof(written.digits), value_)
+              .ptr -
+          written.digits);
+      return written;
+   }
+}
+
+/**
+ * @brief The piece a value of a type turns into.
+ */
+template <typename CharType, class Type>
+using type_t = decltype(make<CharType>(std::declval<Type const &>()));
+
+/**
+ * @brief Gets the number of characters of a piece.
+ */
+template <typename CharType, class Piece>
+size_type size_of(Piece const &piece_) {
+   if constexpr (std::is_same_v<Piece, CharType>) {
+      return 1;
+   } else if constexpr (std::is_same_v<Piece, number>) {
+      return piece_.size;
+   } else {
+      return piece_.size();
+   }
+}
+
+/**
+ * @brief Copies a piece.
+ *
+ * @param out_ Where to copy, with room for the piece.
+ * @param piece_ The piece.
+ * @return The end of the copy.
+ */
+template <typename CharType, class Piece>
+CharType *copy(CharType *out_, Piece const &piece_) {
+   if constexpr (std::is_same_v<Piece, CharType>) {
+      *out_ = piece_;
+      return out_ + 1;
+   } else if constexpr (std::is_same_v<Piece, number>) {
+      return std::copy(piece_.digits, piece_.digits + piece_.size, out_);
+   } else {
+      std::char_traits<CharType>::copy(out_, piece_.data(), piece_.size());
+      return out_ + piece_.size();
+   }
+}
+
+/**
+ * @brief Checks if a text starts with a piece.
+ *
+ * @param text_ The text, at least as long as the piece.
+ * @param piece_ The piece.
+ */
+template <typename CharType, class Piece>
+bool starts(CharType const *text_, Piece const &piece_) {
+   if constexpr (std::is_same_v<Piece, CharType>) {
+      return std::char_traits<CharType>::eq(*text_, piece_);
+   } else if constexpr (std::is_same_v<Piece, number>) {
+      return std::equal(piece_.digits, piece_.digits + piece_.size, text_);
+   } else {
+      return std::char_traits<CharType>::compare(text_, piece_.data(),
+                                                 piece_.size()) == 0;
+   }
+}
+} // namespace piece
+
+/**
+ * @brief A lazy concatenation of pieces, which cat(), cat_to() and the "+"
+ * of an fstring build the result with. The pieces are only measured and
+ * copied when it is converted to a string or appended to one, so the result
+ * grows once. It holds views of its texts, so, as with a std::string_view,
+ * it should not outlive the expression that builds it.
+ *
+ * @tparam String The string type it converts to.
+ * @tparam Pieces The pieces (see piece::make()).
+ */
+template <class String, class... Pieces> class concat {
+ public:
+   using char_type = typename String::value_type;
+   using traits_type = typename String::traits_type;
+   using allocator_type = typename String::allocator_type;
+   using size_type = std::size_t;
+
+   /**
+    * @brief Constructs a concatenation.
+    *
+    * @param alloc_ The allocator of the result.
+    * @param pieces_ The pieces.
+    */
+   concat(allocator_type const &alloc_, std::tuple<Pieces...> pieces_)
+       : m_alloc(alloc_), m_pieces(std::move(pieces_)) {}
+
+   /**
+    * @brief Gets the number of characters of the result.
+    */
+   size_type size() const {
+      return std::apply(
+          [](Pieces const &...pieces_) {
+             return (size_type{0} + ... + piece::size_of<char_type>(pieces_));
+          },
+          m_pieces);
+   }
+
+   /**
+    * @brief Gets the allocator of the result.
+    */
+   allocator_type get_allocator() const { return m_alloc; }
+
+   /**
+    * @brief Gets the pieces.
+    */
+   std::tuple<Pieces...> const &pieces() const { return m_pieces; }
+
+   /**
+    * @brief Appends the pieces to a string, growing it at most once. The
+    * pieces may be views of the string itself.
+    *
+    * @param out_ The string.
+    */
+   template <class Alloc>
+   void append_to(std::basic_string<char_type, traits_type, Alloc> &out_)
+       const {
+      size_type const old_size{out_.size()};
+      size_type const new_size{old_size + size()};
+
+      if (new_size <= out_.capacity()) {
+         out_.resize(new_size);
+         write(out_.data() + old_size);
+         return;
+      }
+
+      // Pieces may point into out_, so they are copied before it is freed
+      std::basic_string<char_type, traits_type, Alloc> grown(
+          out_.get_allocator());
+      grown.reserve(std::max(new_size, 2 * out_.capacity()));
+      grown.append(out_.data(), old_size);
+      grown.resize(new_size);
+      write(grown.data() + old_size);
+      out_.swap(grown);
+   }
+
+   /**
+    * @brief Builds the result with a single allocation.
+    */
+   String str() const {
+      std::basic_string<char_type, traits_type, allocator_type> out(m_alloc);
+      out.resize(size());
+      write(out.data());
+      return String(std::move(out));
+   }
+
+   /**
+    * @brief Converts to the result (see str()).
+    */
+   operator String() const { return str(); }
+
+   /**
+    * @brief Compares the result with a text, without building it.
+    *
+    * @param lhs_ The concatenation.
+    * @param rhs_ The text.
+    * @return True if the result equals the text, false otherwise.
+    */
+   friend bool operator==(concat const &lhs_,
+                          std::basic_string_view<char_type, traits_type> rhs_) {
+      return lhs_.equals(rhs_);
+   }
+
+   /**
+    * @brief Compares a text with the result, without building it.
+    */
+   friend bool operator==(std::basic_string_view<char_type, traits_type> lhs_,
+                          concat const &rhs_) {
+      return rhs_.equals(lhs_);
+   }
+
+   /**
+    * @brief Compares the result with a text, without building it.
+    */
+   friend bool operator!=(concat const &lhs_,
+                          std::basic_string_view<char_type, traits_type> rhs_) {
+      return !lhs_.equals(rhs_);
+   }
+
+   /**
+    * @brief Compares a text with the result, without building it.
+    */
+   friend bool operator!=(std::basic_string_view<char_type, traits_type> lhs_,
+                          concat const &rhs_) {
+      return !rhs_.equals(lhs_);
+   }
+
+   /**
+    * @brief Writes the result to an output stream.
+    *
+    * @param os_ The output stream.
+    * @param rhs_ The concatenation.
+    * @return A reference to the output stream.
+    */
+   friend std::basic_ostream<char_type, traits_type> &
+   operator<<(std::basic_ostream<char_type, traits_type> &os_,
+              concat const &rhs_) {
+      return os_ << rhs_.str();
+   }
+
+ private:
+   /**
+    * @brief Copies the pieces, which must fit.
+    */
+   void write(char_type *out_) const {
+      std::apply(
+          [&out_](Pieces const &...pieces_) {
+             ((out_ = piece::copy(out_, pieces_)), ...);
+          },
+          m_pieces);
+   }
+
+   /**
+    * @brief Checks if the pieces are a text.
+    */
+   bool equals(std::basic_string_view<char_type, traits_type> text_) const {
+      if (text_.size() != size()) {
+         return false;
+      }
+
+      char_type const *it{text_.data()};
+      return std::apply(
+          [&it](Pieces const &...pieces_) {
+             return ((piece::starts(it, pieces_) &&
+                      (it += piece::size_of<char_type>(pieces_), true)) &&
+                     ...);
+          },
+          m_pieces);
+   }
+
+   allocator_type m_alloc;        ///< The allocator of the result.
+   std::tuple<Pieces...> m_pieces; ///< The pieces, in order.
+};
+
+/**
+ * @brief Concatenates texts, characters and numbers with a single
+ * allocation. Numbers are written as std::to_chars does, in base 10 and,
+ * for floating-point numbers, in the shortest form that reads back to the
+ * same value.
+ *
+ * @tparam String The result type (default is the std::basic_string of the
+ * character type of the first text).
+ * @param pieces_ The pieces.
+ * @return The concatenation.
+ */
+template <class String = void, class... Pieces>
+auto cat(Pieces const &...pieces_) {
+   using result = std::conditional_t<
+       std::is_void_v<String>,
+       std::basic_string<piece::common_char_t<Pieces...>>, String>;
+   using char_type = typename result::value_type;
+
+   return concat<result, piece::type_t<char_type, Pieces>...>(
+              typename result::allocator_type(),
+              std::make_tuple(piece::make<char_type>(pieces_)...))
+       .str();
+}
+
+/**
+ * @brief Appends texts, characters and numbers to a string, growing it at
+ * most once (see cat()).
+ *
+ * @param out_ The string.
+ * @param pieces_ The pieces.
+ */
+template <typename CharType, class Traits, class Alloc, class... Pieces>
+void cat_to(std::basic_string<CharType, Traits, Alloc> &out_,
+            Pieces const &...pieces_) {
+   using result = std::basic_string<CharType, Traits, Alloc>;
+
+   concat<result, piece::type_t<CharType, Pieces>...>(
+       out_.get_allocator(), std::make_tuple(piece::make<CharType>(pieces_)...))
+       .append_to(out_);
+}
+
+/**
+ * @brief Joins the elements of a range with a separator, with a single
+ * allocation. The range is read twice, once to measure the elements and once
+ * to copy them, so it must be a forward range.
+ *
+ * @tparam String The result type (default is the std::basic_string of the
+ * character type of the elements).
+ * @param range_ The texts, characters or numbers.
+ * @param separator_ The text, character or number between two elements.
+ * @return The joined elements.
+ */
+template <class String = void, class Range, class Separator>
+auto join(Range const &range_, Separator const &separator_) {
+   using std::begin;
+   using std::end;
+   using element = std::decay_t<decltype(*begin(range_))>;
+   using result = std::conditional_t<
+       std::is_void_v<String>,
+       std::basic_string<piece::common_char_t<element, Separator>>, String>;
+   using char_type = typename result::value_type;
+
+   auto const separator{piece::make<char_type>(separator_)};
+   std::size_t const separator_size{piece::size_of<char_type>(separator)};
+   std::size_t size{0};
+   bool first{true};
+
+   for (auto const &value : range_) {
+      size += piece::size_of<char_type>(piece::make<char_type>(value)) +
+              (first ? 0 : separator_size);
+      first = false;
+   }
+
+   std::basic_string<char_type, typename result::traits_type,
+                     typename result::allocator_type>
+       out;
+   out.resize(size);
+   char_type *it{out.data()};
+   first = true;
+
+   for (auto const &value : range_) {
+      if (!first) {
+         it = piece::copy(it, separator);
+      }
+      it = piece::copy(it, piece::make<char_type>(value));
+      first = false;
+   }
+
+   return result(std::move(out));
+}
+} // namespace ext
+
+#endif // CONCAT_HPP_
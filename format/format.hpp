@@ -0,0 +1,791 @@
+/**
+ * @file format.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Format strings parsed and checked at compile time.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * A format string such as "{:>10} {:<8.2f}" is parsed while compiling, so a
+ * malformed string, a wrong number of arguments or a specification that does
+ * not fit its argument is a compilation error. At run time the output is
+ * reserved once, the literal text is copied as is and the numbers are written
+ * with std::to_chars into a stack buffer, without any stream.
+ *
+ * Each replacement field is "{}" or
+ * "{:[[fill]align][width][.precision][type]}", and "{{" and "}}" stand for
+ * literal braces:
+ * - align is '<', '^' or '>', padding as fstring::align_left, align_center
+ *   and align_right do: the width counts terminal columns (see
+ *   display_width()), and text is never truncated by it. Numbers are right
+ *   aligned by default and everything else is left aligned.
+ * - precision is the number of digits of a floating-point value, or the
+ *   maximum number of columns of a text, which is never cut inside a
+ *   character.
+ * - type is 'd', 'x', 'X', 'o' or 'b' for integers; 'f', 'e', 'g', 'a' (or
+ *   their uppercase forms) for floating-point values; 's' for texts and
+ *   booleans; and 'c' for characters.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef FORMAT_HPP_
+#define FORMAT_HPP_
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "fstring.hpp"
+#include "out_buffer.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Format string namespace
+ *
+ * This namespace holds the compile-time parser of format strings and the
+ * writers used by ext::format.
+ */
+namespace fmt {
+/**
+ * @brief Errors found while parsing a format string.
+ */
+enum error : unsigned char {
+   none,            ///< The format string is valid.
+   unmatched_brace, ///< A brace that is neither part of a field nor escaped.
+   bad_spec,        ///< A field that is not "{}" or "{:spec}".
+};
+
+/**
+ * @brief A replacement field and the literal text before it.
+ */
+struct field {
+   std::size_t literal_first{0}; ///< Start of the literal text before it.
+   std::size_t literal_size{0};  ///< Size of the literal, escapes included.
+   bool escaped{false};          ///< Whether the literal has "{{" or "}}".
+   char fill{' '};               ///< The padding character.
+   char align{'\0'};             ///< '<', '^', '>', or '\0' for the default.
+   std::size_t width{0};         ///< The minimum width.
+   int precision{-1};            ///< The precision, -1 if none.
+   char type{'\0'};              ///< The presentation type, '\0' if none.
+};
+
+/**
+ * @brief A parsed format string.
+ * @tparam Count The number of replacement fields.
+ */
+template <std::size_t Count> struct parsed {
+   std::array<field, Count + 1> fields{}; ///< The fields, then the tail text.
+   error status{none};                    ///< The first error found.
+};
+
+/**
+ * @brief Counts the replacement fields of a format string.
+ *
+ * @param text_ The format string.
+ * @return The number of '{' that do not start a "{{" escape.
+ */
+constexpr std::size_t count(std::string_view text_) {
+   std::size_t fields{0};
+
+   for (std::size_t pos{0}; pos < text_.size(); ++pos) {
+      if (text_[pos] != '{') {
+         continue;
+      }
+
+      if (pos + 1 < text_.size() && text_[pos + 1] == '{') {
+         ++pos;
+      } else {
+         ++fields;
+      }
+   }
+
+   return fields;
+}
+
+/**
+ * @brief Checks if a character is an alignment.
+ */
+constexpr bool is_align(char char_) {
+   return char_ == '<' || char_ == '^' || char_ == '>';
+}
+
+/**
+ * @brief Checks if a character is a decimal digit.
+ */
+constexpr bool is_digit(char char_) { return char_ >= '0' && char_ <= '9'; }
+
+/**
+ * @brief Checks if a character is a presentation type.
+ */
+constexpr bool is_type(char char_) {
+   return std::string_view{"dxXobfFeEgGaAsc"}.find(char_) !=
+          std::string_view::npos;
+}
+
+/**
+ * @brief Finds a character in a format string.
+ *
+ * A plain loop: std::string_view::find() compares pointers, which GCC's
+ * -fsanitize=undefined rejects in constant expressions when the text is a
+ * function-local static array.
+ *
+ * @param text_ The format string.
+ * @param char_ The character.
+ * @param pos_ The position to start at.
+ * @return The position of the character, or std::string_view::npos.
+ */
+constexpr std::size_t find_char(std::string_view text_, char char_,
+                                std::size_t pos_ = 0) {
+   for (; pos_ < text_.size(); ++pos_) {
+      if (text_[pos_] == char_) {
+         return pos_;
+      }
+   }
+
+   return std::string_view::npos;
+}
+
+/**
+ * @brief Parses the specification of a field, the part after ':'.
+ *
+ * @param spec_ The specification.
+ * @param field_ The field to fill.
+ * @return none, or bad_spec if the specification is malformed.
+ */
+constexpr error parse_spec(std::string_view spec_, field &field_) {
+   constexpr std::size_t max_number{1000000};
+   std::size_t pos{0};
+
+   if (spec_.size() >= 2 && is_align(spec_[1])) {
+      field_.fill = spec_[0];
+      field_.align = spec_[1];
+      pos = 2;
+   } else if (!spec_.empty() && is_align(spec_[0])) {
+      field_.align = spec_[0];
+      pos = 1;
+   }
+
+   for (; pos < spec_.size() && is_digit(spec_[pos]); ++pos) {
+      field_.width =
+          field_.width * 10 + static_cast<std::size_t>(spec_[pos] - '0');
+      if (field_.width > max_number) {
+         return bad_spec;
+      }
+   }
+
+   if (pos < spec_.size() && spec_[pos] == '.') {
+      if (++pos == spec_.size() || !is_digit(spec_[pos])) {
+         return bad_spec;
+      }
+
+      field_.precision = 0;
+      for (; pos < spec_.size() && is_digit(spec_[pos]); ++pos) {
+         field_.precision = field_.precision * 10 + (spec_[pos] - '0');
+         if (field_.precision > static_cast<int>(max_number)) {
+            return bad_spec;
+         }
+      }
+   }
+
+   if (pos < spec_.size() && is_type(spec_[pos])) {
+      field_.type = spec_[pos++];
+   }
+
+   return pos == spec_.size() ? none : bad_spec;
+}
+
+/**
+ * @brief Parses a format string.
+ *
+ * @tparam Count The number of replacement fields, as given by count().
+ * @param text_ The format string.
+ * @return The fields and the tail text, with the first error found.
+ */
+template <std::size_t Count>
+constexpr parsed<Count> parse(std::string_view text_) {
+   parsed<Count> result{};
+   std::size_t index{0};
+   std::size_t literal{0};
+   bool escaped{false};
+   std::size_t pos{0};
+
+   while (pos < text_.size()) {
+      char const current{text_[pos]};
+      bool const doubled{pos + 1 < text_.size() && text_[pos + 1] == current};
+
+      if (current != '{' && current != '}') {
+         ++pos;
+         continue;
+      }
+
+      if (doubled) {
+         escaped = true;
+         pos += 2;
+         continue;
+      }
+
+      std::size_t const close{find_char(text_, '}', pos)};
+      if (current == '}' || close == std::string_view::npos) {
+         result.status = unmatched_brace;
+         return result;
+      }
+
+      std::string_view const inner{text_.substr(pos + 1, close - pos - 1)};
+      if (find_char(inner, '{') != std::string_view::npos || index == Count) {
+         result.status = unmatched_brace;
+         return result;
+      }
+
+      field &current_field{result.fields[index++]};
+      current_field.literal_first = literal;
+      current_field.literal_size = pos - literal;
+      current_field.escaped = escaped;
+
+      if (!inner.empty()) {
+         if (inner[0] != ':') {
+            result.status = bad_spec;
+            return result;
+         }
+
+         error const status{parse_spec(inner.substr(1), current_field)};
+         if (status != none) {
+            result.status = status;
+            return result;
+         }
+      }
+
+      literal = close + 1;
+      escaped = false;
+      pos = close + 1;
+   }
+
+   field &tail{result.fields[Count]};
+   tail.literal_first = literal;
+   tail.literal_size = text_.size() - literal;
+   tail.escaped = escaped;
+   return result;
+}
+
+/**
+ * @brief Kinds of arguments, each one with its own presentation types.
+ */
+enum kind : unsigned char {
+   unsupported, ///< Cannot be formatted.
+   boolean,     ///< bool, written as "true" or "false".
+   character,   ///< char.
+   integer,     ///< Any other integral type.
+   floating,    ///< Any floating-point type.
+   text,        ///< Anything convertible to std::string_view.
+};
+
+/**
+ * @brief Gets the kind of an argument type.
+ *
+ * @tparam Type The type of the argument.
+ * @return The kind, unsupported if the type cannot be formatted.
+ */
+template <class Type> constexpr kind kind_of() {
+   if constexpr (std::is_same_v<Type, bool>) {
+      return boolean;
+   } else if constexpr (std::is_same_v<Type, char>) {
+      return character;
+   } else if constexpr (std::is_integral_v<Type>) {
+      return integer;
+   } else if constexpr (std::is_floating_point_v<Type>) {
+      return floating;
+   } else if constexpr (std::is_convertible_v<Type const &, std::string_view>) {
+      return text;
+   } else {
+      return unsupported;
+   }
+}
+
+/**
+ * @brief Checks if an argument kind accepts the specification of a field.
+ *
+ * @param kind_ The kind of the argument.
+ * @param field_ The field.
+ * @return True if the type and the precision fit the kind, false otherwise.
+ */
+constexpr bool accepts(kind kind_, field const &field_) {
+   auto const one_of{[&field_](std::string_view types_) {
+      return field_.type == '\0' ||
+             types_.find(field_.type) != std::string_view::npos;
+   }};
+
+   switch (kind_) {
+   case boolean:
+      return field_.precision < 0 && one_of("s");
+   case character:
+      return field_.precision < 0 && one_of("c");
+   case integer:
+      return field_.precision < 0 && one_of("dxXob");
+   case floating:
+      return one_of("fFeEgGaA");
+   case text:
+      return one_of("s");
+   default:
+      return false;
+   }
+}
+
+/**
+ * @brief Checks every argument against its field.
+ *
+ * @tparam Args The types of the arguments.
+ * @param result_ The parsed format string.
+ * @return True if every argument accepts its field, false otherwise.
+ */
+template <class... Args, std::size_t... Indexes>
+constexpr bool accepts_all(parsed<sizeof...(Args)> const &result_,
+                           std::index_sequence<Indexes...>) {
+   return (accepts(kind_of<Args>(), result_.fields[Indexes]) && ...);
+}
+
+/**
+ * @brief Parses a format string at compile time, failing the compilation if
+ * it does not fit the arguments.
+ *
+ * @tparam Source A type whose static member 'text' is the format string.
+ * @tparam Args The types of the arguments.
+ * @return The parsed format string.
+ */
+template <class Source, class... Args> constexpr auto checked() {
+   constexpr std::size_t arguments{sizeof...(Args)};
+   static_assert(count(Source::text) == arguments,
+                 "The number of arguments must match the number of "
+                 "replacement fields of the format string.");
+   static_assert(((kind_of<Args>() != unsupported) && ...),
+                 "Arguments must be booleans, characters, numbers or "
+                 "convertible to std::string_view.");
+
+   constexpr parsed<arguments> result{parse<arguments>(Source::text)};
+   static_assert(result.status != unmatched_brace,
+                 "Unmatched brace in the format string ('{{' and '}}' are "
+                 "literal braces).");
+   static_assert(result.status != bad_spec,
+                 "Replacement fields must be \"{}\" or "
+                 "\"{:[[fill]align][width][.precision][type]}\".");
+   static_assert(accepts_all<Args...>(result,
+                                      std::make_index_sequence<arguments>()),
+                 "A format specification does not fit its argument.");
+   return result;
+}
+
+/**
+ * @brief Gets the text of a character array or a string view.
+ *
+ * @tparam Format The array or the string view.
+ * @return The text, without the terminating '\0' of an array.
+ */
+template <auto const &Format> constexpr std::string_view text_of() {
+   using type = std::remove_cv_t<std::remove_reference_t<decltype(Format)>>;
+   static_assert(std::is_array_v<type> ||
+                     std::is_same_v<type, std::string_view>,
+                 "Format strings must be character arrays or string views.");
+
+   if constexpr (std::is_array_v<type>) {
+      return std::string_view{Format, std::size(Format) - 1};
+   } else {
+      return Format;
+   }
+}
+
+/**
+ * @brief The format string of a character array or a string view with
+ * static storage duration.
+ */
+template <auto const &Format> struct constant {
+   static constexpr std::string_view text{text_of<Format>()};
+};
+
+#if defined(__cpp_nontype_template_args) &&                                    \
+    __cpp_nontype_template_args >= 201911L
+/**
+ * @brief A string literal usable as a template argument.
+ * @tparam Size The size of the literal, '\0' included.
+ */
+template <std::size_t Size> struct fixed_string {
+   char data[Size]{}; ///< The characters of the literal.
+
+   /**
+    * @brief Copies a string literal.
+    *
+    * @param text_ The literal.
+    */
+   constexpr fixed_string(char const (&text_)[Size]) {
+      for (std::size_t index{0}; index != Size; ++index) {
+         data[index] = text_[index];
+      }
+   }
+};
+
+/**
+ * @brief The format string of a string literal.
+ */
+template <fixed_string Format> struct literal {
+   static constexpr std::string_view text{Format.data,
+                                          sizeof(Format.data) - 1};
+};
+#endif
+
+/**
+ * @brief Gets an upper bound of the size of a formatted argument, used to
+ * reserve the output once.
+ */
+template <class Type>
+std::size_t size_hint(Type const &value_, field const &field_) {
+   std::size_t size{0};
+
+   if constexpr (kind_of<Type>() == text) {
+      // The padding counts columns, which may take fewer bytes than the text
+      size = std::string_view{value_}.size() + field_.width;
+   } else if constexpr (kind_of<Type>() == integer) {
+      size = std::numeric_limits<Type>::digits + 1;
+   } else if constexpr (kind_of<Type>() == floating) {
+      size = 24 + static_cast<std::size_t>(std::max(field_.precision, 0));
+   } else {
+      size = 5;
+   }
+
+   return std::max(size, field_.width);
+}
+
+/**
+ * @brief Appends the literal text before a field, turning "{{" and "}}"
+ * into single braces.
+ *
+ * @tparam String The type of the output string.
+ * @param out_ The string to append to.
+ * @param text_ The format string.
+ * @param field_ The field that follows the literal text.
+ */
+template <class String>
+void put_literal(String &out_, std::string_view text_, field const &field_) {
+   std::string_view const literal{
+       text_.substr(field_.literal_first, field_.literal_size)};
+
+   if (!field_.escaped) {
+      out_.append(literal.data(), literal.size());
+      return;
+   }
+
+   for (std::size_t pos{0}; pos < literal.size(); ++pos) {
+      out_ += literal[pos];
+      if (literal[pos] == '{' || literal[pos] == '}') {
+         ++pos;
+      }
+   }
+}
+
+/**
+ * @brief Appends a text padded to the width of its field, in columns (see
+ * display_width()).
+ *
+ * @tparam String The type of the output string.
+ * @param out_ The string to append to.
+ * @param text_ The text.
+ * @param field_ The field.
+ * @param align_ The alignment used when the field has none.
+ */
+template <class String>
+void put_padded(String &out_, std::string_view text_, field const &field_,
+                char align_) {
+   std::size_t const width{display_width(text_)};
+   if (width >= field_.width) {
+      out_.append(text_.data(), text_.size());
+      return;
+   }
+
+   char const align{field_.align != '\0' ? field_.align : align_};
+   std::size_t const padding{field_.width - width};
+   std::size_t before{0};
+
+   if (align == '>') {
+      before = padding;
+   } else if (align == '^') {
+      before = padding / 2;
+   }
+
+   out_.append(before, field_.fill);
+   out_.append(text_.data(), text_.size());
+   out_.append(padding - before, field_.fill);
+}
+
+/**
+ * @brief Writes a number with std::to_chars as its field asks.
+ *
+ * @return The result of std::to_chars.
+ */
+template <class Type>
+std::to_chars_result to_chars(char *first_, char *last_, Type value_,
+                              field const &field_) {
+   if constexpr (std::is_floating_point_v<Type>) {
+      std::chars_format format{std::chars_format::general};
+
+      switch (field_.type) {
+      case '\0':
+         if (field_.precision < 0) {
+            return std::to_chars(first_, last_, value_);
+         }
+         break;
+      case 'f':
+      case 'F':
+         format = std::chars_format::fixed;
+         break;
+      case 'e':
+      case 'E':
+         format = std::chars_format::scientific;
+         break;
+      case 'a':
+      case 'A':
+         format = std::chars_format::hex;
+         break;
+      default:
+         break;
+      }
+
+      return field_.precision < 0
+                 ? std::to_chars(first_, last_, value_, format)
+                 : std::to_chars(first_, last_, value_, format,
+                                 field_.precision);
+   } else {
+      int base{10};
+
+      switch (field_.type) {
+      case 'x':
+      case 'X':
+         base = 16;
+         break;
+      case 'o':
+         base = 8;
+         break;
+      case 'b':
+         base = 2;
+         break;
+      default:
+         break;
+      }
+
+      return std::to_chars(first_, last_, value_, base);
+   }
+}
+
+/**
+ * @brief Appends a number padded to the width of its field.
+ *
+ * The digits go to a stack buffer; only a fixed notation longer than it
+ * (huge values or precisions) falls back to a heap buffer.
+ *
+ * @tparam String The type of the output string.
+ * @param out_ The string to append to.
+ * @param value_ The number.
+ * @param field_ The field.
+ */
+template <class String, class Type>
+void put_number(String &out_, Type value_, field const &field_) {
+   char buffer[128];
+   char *first{buffer};
+   std::to_chars_result result{
+       to_chars(buffer, buffer + sizeof(buffer), value_, field_)};
+   std::string large;
+
+   while (result.ec != std::errc()) {
+      large.resize(large.empty() ? 2 * sizeof(buffer) : 2 * large.size());
+      first = &large[0];
+      result = to_chars(first, first + large.size(), value_, field_);
+   }
+
+   if (field_.type >= 'A' && field_.type <= 'Z') {
+      for (char *digit{first}; digit != result.ptr; ++digit) {
+         if (*digit >= 'a' && *digit <= 'z') {
+            *digit = static_cast<char>(*digit - 'a' + 'A');
+         }
+      }
+   }
+
+   put_padded(out_, std::string_view(first, static_cast<std::size_t>(
+                                                 result.ptr - first)),
+              field_, '>');
+}
+
+/**
+ * @brief Appends a formatted argument.
+ *
+ * @tparam String The type of the output string.
+ * @param out_ The string to append to.
+ * @param value_ The argument.
+ * @param field_ The field of the argument.
+ */
+template <class String, class Type>
+void put(String &out_, Type const &value_, field const &field_) {
+   if constexpr (kind_of<Type>() == boolean) {
+      put_padded(out_, value_ ? "true" : "false", field_, '<');
+   } else if constexpr (kind_of<Type>() == character) {
+      put_padded(out_, std::string_view(&value_, 1), field_, '<');
+   } else if constexpr (kind_of<Type>() == text) {
+      std::string_view view{value_};
+      if (field_.precision >= 0) {
+         view = view.substr(0, display_prefix(view, static_cast<std::size_t>(
+                                                     field_.precision)));
+      }
+      put_padded(out_, view, field_, '<');
+   } else {
+      put_number(out_, value_, field_);
+   }
+}
+
+/**
+ * @brief Appends a format string with its arguments.
+ *
+ * @tparam Source A type whose static member 'text' is the format string.
+ * @tparam String The type of the output string.
+ * @tparam Args The types of the arguments.
+ * @param out_ The string to append to.
+ * @param args_ The arguments.
+ */
+template <class Source, class String, class... Args, std::size_t... Indexes>
+void format_to(String &out_, std::index_sequence<Indexes...>,
+               Args const &...args_) {
+   constexpr parsed<sizeof...(Args)> result{checked<Source, Args...>()};
+   constexpr std::string_view text{Source::text};
+
+   std::size_t size{out_.size()};
+   for (field const &current : result.fields) {
+      size += current.literal_size;
+   }
+   ((size += size_hint(args_, result.fields[Indexes])), ...);
+   out_.reserve(size);
+
+   ((put_literal(out_, text, result.fields[Indexes]),
+     put(out_, args_, result.fields[Indexes])),
+    ...);
+   put_literal(out_, text, result.fields[sizeof...(Args)]);
+}
+} // namespace fmt
+
+#if defined(__cpp_nontype_template_args) &&                                    \
+    __cpp_nontype_template_args >= 201911L
+/**
+ * @brief Appends a formatted text to a string, growing it at most once.
+ *
+ * The format string is parsed and checked at compile time (e.g.
+ * format_to<"{:>10} {:<8.2f}">(out, name, price)).
+ *
+ * @tparam Format The format string.
+ * @tparam Allocator The allocator of the output string.
+ * @tparam Args The types of the arguments.
+ * @param out_ The string to append to.
+ * @param args_ The arguments, one per replacement field.
+ */
+template <fmt::fixed_string Format, class Allocator, class... Args>
+void format_to(std::basic_string<char, std::char_traits<char>, Allocator> &out_,
+               Args const &...args_) {
+   fmt::format_to<fmt::literal<Format>>(
+       out_, std::index_sequence_for<Args...>(), args_...);
+}
+
+/**
+ * @brief Appends a formatted text to an output buffer (e.g.
+ * format_to<"{:>10} {:<8.2f}">(buffer, name, price)).
+ *
+ * @tparam Format The format string.
+ * @tparam Args The types of the arguments.
+ * @param out_ The buffer to append to.
+ * @param args_ The arguments, one per replacement field.
+ */
+template <fmt::fixed_string Format, class... Args>
+void format_to(out_buffer &out_, Args const &...args_) {
+   fmt::format_to<fmt::literal<Format>>(
+       out_, std::index_sequence_for<Args...>(), args_...);
+}
+
+/**
+ * @brief Formats a text.
+ *
+ * The format string is parsed and checked at compile time (e.g.
+ * format<"{:>10} {:<8.2f}">(name, price)).
+ *
+ * @tparam Format The format string.
+ * @tparam Args The types of the arguments.
+ * @param args_ The arguments, one per replacement field.
+ * @return The formatted fstring.
+ */
+template <fmt::fixed_string Format, class... Args>
+fstring<char> format(Args const &...args_) {
+   fstring<char> out;
+   format_to<Format>(out, args_...);
+   return out;
+}
+#else
+/**
+ * @brief Appends a formatted text to a string, growing it at most once.
+ *
+ * The format string, a character array or a string view with static storage
+ * duration, is parsed and checked at compile time (e.g. with
+ * 'static constexpr char row[]{"{:>10} {:<8.2f}"};',
+ * format_to<row>(out, name, price)).
+ *
+ * @tparam Format The format string.
+ * @tparam Allocator The allocator of the output string.
+ * @tparam Args The types of the arguments.
+ * @param out_ The string to append to.
+ * @param args_ The arguments, one per replacement field.
+ */
+template <auto const &Format, class Allocator, class... Args>
+void format_to(std::basic_string<char, std::char_traits<char>, Allocator> &out_,
+               Args const &...args_) {
+   fmt::format_to<fmt::constant<Format>>(
+       out_, std::index_sequence_for<Args...>(), args_...);
+}
+
+/**
+ * @brief Appends a formatted text to an output buffer (e.g.
+ * format_to<row>(buffer, name, price)).
+ *
+ * @tparam Format The format string.
+ * @tparam Args The types of the arguments.
+ * @param out_ The buffer to append to.
+ * @param args_ The arguments, one per replacement field.
+ */
+template <auto const &Format, class... Args>
+void format_to(out_buffer &out_, Args const &...args_) {
+   fmt::format_to<fmt::constant<Format>>(
+       out_, std::index_sequence_for<Args...>(), args_...);
+}
+
+/**
+ * @brief Formats a text.
+ *
+ * The format string, a character array or a string view with static storage
+ * duration, is parsed and checked at compile time (e.g. with
+ * 'static constexpr char row[]{"{:>10} {:<8.2f}"};',
+ * format<row>(name, price)).
+ *
+ * @tparam Format The format string.
+ * @tparam Args The types of the arguments.
+ * @param args_ The arguments, one per replacement field.
+ * @return The formatted fstring.
+ */
+template <auto const &Format, class... Args>
+fstring<char> format(Args const &...args_) {
+   fstring<char> out;
+   format_to<Format>(out, args_...);
+   return out;
+}
+#endif
+} // namespace ext
+
+#endif // FORMAT_HPP_
@@ -12,11 +12,40 @@
 #define FSTRING_HPP_
 
 #include <algorithm>
-#include <sstream>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "ansi.hpp"
+#include "casing.hpp"
+#include "charset.hpp"
+#include "concat.hpp"
+#include "hash.hpp"
+#include "layout.hpp"
+#include "number.hpp"
+#include "out_buffer.hpp"
+#include "pattern_set.hpp"
+#include "regex.hpp"
+#include "searcher.hpp"
+#include "split_view.hpp"
 #include "style.hpp"
+#include "styled_text.hpp"
+#include "utf.hpp"
+#include "width.hpp"
 
 /**
  * @brief Namespace 'ext' for external utilities and extensions.
@@ -26,36 +55,55 @@ namespace ext {
 /**
  * @brief A custom string class that extends std::basic_string.
  * @tparam CharType The character type used in the string (e.g., char, wchar_t).
+ * @tparam Allocator The allocator used for the characters (e.g.,
+ * std::pmr::polymorphic_allocator, see ext::pmr::fstring).
  */
-template <typename CharType = char>
-class fstring : public std::basic_string<CharType> {
+template <typename CharType = char,
+          typename Allocator = std::allocator<CharType>>
+class fstring
+    : public std::basic_string<CharType, std::char_traits<CharType>,
+                               Allocator> {
  public:
-   using size_type = typename std::basic_string<CharType>::size_type;
-   using difference_type =
-       typename std::basic_string<CharType>::difference_type;
+   using base_type =
+       std::basic_string<CharType, std::char_traits<CharType>, Allocator>;
+   using allocator_type = typename base_type::allocator_type;
+   using size_type = typename base_type::size_type;
+   using difference_type = typename base_type::difference_type;
 
    /**
     * @brief Default constructor for fstring.
     */
-   fstring() : std::basic_string<CharType>() {}
+   fstring() : base_type() {}
+
+   /**
+    * @brief Constructor to create an empty fstring with a specified allocator.
+    * @param alloc_ The allocator to use.
+    */
+   explicit fstring(allocator_type const &alloc_) : base_type(alloc_) {}
 
    /**
     * @brief Constructor to create an fstring with a specified character
     * repeated a number of times.
     * @param count_ The number of times to repeat the character.
     * @param char_ The character to repeat.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
     */
-   fstring(size_type count_, CharType char_)
-       : std::basic_string<CharType>(count_, char_) {}
+   fstring(size_type count_, CharType char_,
+           allocator_type const &alloc_ = allocator_type())
+       : base_type(count_, char_, alloc_) {}
 
    /**
     * @brief Constructor to create an fstring from a substring of another
     * fstring.
     * @param rhs_ The source fstring.
     * @param pos_ The starting position of the substring.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
     */
-   fstring(fstring const &rhs_, size_type pos_)
-       : std::basic_string<CharType>(rhs_, pos_) {}
+   fstring(fstring const &rhs_, size_type pos_,
+           allocator_type const &alloc_ = allocator_type())
+       : base_type(rhs_, pos_, alloc_) {}
 
    /**
     * @brief Constructor to create an fstring from a substring of another
@@ -63,25 +111,34 @@ class fstring : public std::basic_string<CharType> {
     * @param rhs_ The source fstring.
     * @param pos_ The starting position of the substring.
     * @param count_ The length of the substring.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
     */
-   fstring(fstring const &rhs_, size_type pos_, size_type count_)
-       : std::basic_string<CharType>(rhs_, pos_, count_) {}
+   fstring(fstring const &rhs_, size_type pos_, size_type count_,
+           allocator_type const &alloc_ = allocator_type())
+       : base_type(rhs_, pos_, count_, alloc_) {}
 
    /**
     * @brief Constructor to create an fstring from a character array with a
     * specified length.
     * @param rhs_ The character array.
     * @param count_ The length of the character array.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
     */
-   fstring(CharType const *rhs_, size_type count_)
-       : std::basic_string<CharType>(rhs_, count_) {}
+   fstring(CharType const *rhs_, size_type count_,
+           allocator_type const &alloc_ = allocator_type())
+       : base_type(rhs_, count_, alloc_) {}
 
    /**
     * @brief Constructor to create an fstring from a null-terminated character
     * array.
     * @param rhs_ The null-terminated character array.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
     */
-   fstring(CharType const *rhs_) : std::basic_string<CharType>(rhs_) {}
+   fstring(CharType const *rhs_, allocator_type const &alloc_ = allocator_type())
+       : base_type(rhs_, alloc_) {}
 
    /**
     * @brief Constructor to create an fstring from a range of characters defined
@@ -89,28 +146,65 @@ class fstring : public std::basic_string<CharType> {
     * @tparam It Iterator type for character range.
     * @param first_ The iterator to the beginning of the range.
     * @param last_ The iterator to the end of the range.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
     */
    template <class It>
-   fstring(It first_, It last_) : std::basic_string<CharType>(first_, last_) {}
+   fstring(It first_, It last_,
+           allocator_type const &alloc_ = allocator_type())
+       : base_type(first_, last_, alloc_) {}
+
+   /**
+    * @brief Constructor to create an fstring from a string view, with any
+    * allocator.
+    * @param rhs_ The source string view.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
+    */
+   explicit fstring(std::basic_string_view<CharType> rhs_,
+                    allocator_type const &alloc_ = allocator_type())
+       : base_type(rhs_.data(), rhs_.size(), alloc_) {}
 
    /**
     * @brief Constructor to create an fstring from a standard string.
     * @param rhs_ The source standard string.
     */
-   fstring(std::basic_string<CharType> const &rhs_)
-       : std::basic_string<CharType>(rhs_) {}
+   fstring(base_type const &rhs_) : base_type(rhs_) {}
 
    /**
     * @brief Copy constructor for fstring.
     * @param rhs_ The source fstring to be copied.
     */
-   fstring(fstring const &rhs_) : std::basic_string<CharType>(rhs_) {}
+   fstring(fstring const &rhs_) : base_type(rhs_) {}
+
+   /**
+    * @brief Copy constructor for fstring with a specified allocator.
+    * @param rhs_ The source fstring to be copied.
+    * @param alloc_ The allocator to use.
+    */
+   fstring(fstring const &rhs_, allocator_type const &alloc_)
+       : base_type(rhs_, alloc_) {}
+
+   /**
+    * @brief Constructor to take over the contents of a standard string.
+    * @param rhs_ The source standard string to be moved.
+    */
+   fstring(base_type &&rhs_) noexcept : base_type(std::move(rhs_)) {}
 
    /**
     * @brief Move constructor for fstring.
     * @param rhs_ The source fstring to be moved.
     */
-   fstring(fstring const &&rhs_) : std::basic_string<CharType>(rhs_) {}
+   fstring(fstring &&rhs_) noexcept : base_type(std::move(rhs_)) {}
+
+   /**
+    * @brief Move constructor for fstring with a specified allocator; the
+    * characters are copied if the allocators are not equal.
+    * @param rhs_ The source fstring to be moved.
+    * @param alloc_ The allocator to use.
+    */
+   fstring(fstring &&rhs_, allocator_type const &alloc_)
+       : base_type(std::move(rhs_), alloc_) {}
 
    /**
     * @brief Assignment operator for fstring.
@@ -119,40 +213,159 @@ class fstring : public std::basic_string<CharType> {
     */
    fstring &operator=(const fstring &rhs_) {
       if (this != &rhs_) {
-         std::basic_string<CharType>::operator=(rhs_);
+         base_type::operator=(rhs_);
       }
       return *this;
    }
 
+   /**
+    * @brief Move assignment operator for fstring.
+    * @param rhs_ The source fstring to be moved.
+    * @return A reference to the modified fstring.
+    */
+   fstring &operator=(fstring &&rhs_) noexcept(
+       std::allocator_traits<Allocator>::
+           propagate_on_container_move_assignment::value ||
+       std::allocator_traits<Allocator>::is_always_equal::value) {
+      base_type::operator=(std::move(rhs_));
+      return *this;
+   }
+
+   /**
+    * @brief Concatenates an fstring and a text or a character, measuring the
+    * result and allocating it once.
+    * @param lhs_ The fstring.
+    * @param rhs_ The text or character.
+    * @return The concatenation.
+    */
+   template <
+       class Type,
+       std::enable_if_t<piece::is_operand_v<CharType, std::decay_t<Type>> &&
+                            !std::is_same_v<std::decay_t<Type>, fstring>,
+                        bool> = true>
+   friend fstring operator+(fstring const &lhs_, Type &&rhs_) {
+      return concatenate(copied_allocator(lhs_),
+                         std::basic_string_view<CharType>(lhs_), rhs_);
+   }
+
+   /**
+    * @brief Concatenates a text or a character and an fstring, measuring the
+    * result and allocating it once.
+    * @param lhs_ The text or character.
+    * @param rhs_ The fstring.
+    * @return The concatenation.
+    */
+   template <
+       class Type,
+       std::enable_if_t<piece::is_operand_v<CharType, std::decay_t<Type>> &&
+                            !std::is_same_v<std::decay_t<Type>, fstring>,
+                        bool> = true>
+   friend fstring operator+(Type &&lhs_, fstring const &rhs_) {
+      return concatenate(copied_allocator(rhs_), lhs_,
+                         std::basic_string_view<CharType>(rhs_));
+   }
+
+   /**
+    * @brief Concatenates two fstrings, allocating the result once.
+    * @param lhs_ The first fstring.
+    * @param rhs_ The second fstring.
+    * @return The concatenation.
+    */
+   friend fstring operator+(fstring const &lhs_, fstring const &rhs_) {
+      return concatenate(copied_allocator(lhs_),
+                         std::basic_string_view<CharType>(lhs_),
+                         std::basic_string_view<CharType>(rhs_));
+   }
+
+   /**
+    * @brief Appends a text or a character to a temporary fstring, reusing
+    * its storage, as the "+" of std::string does.
+    * @param lhs_ The temporary fstring.
+    * @param rhs_ The text or character.
+    * @return The fstring with the text or character appended.
+    */
+   template <class Type,
+             std::enable_if_t<
+                 piece::is_operand_v<CharType, std::decay_t<Type>>, bool> =
+                 true>
+   friend fstring operator+(fstring &&lhs_, Type &&rhs_) {
+      cat_to(static_cast<base_type &>(lhs_), rhs_);
+      return std::move(lhs_);
+   }
+
    /**
     * @brief Remove leading whitespace characters from the fstring.
+    */
+   void ltrim() { ltrim(charset::whitespace()); }
+
+   /**
+    * @brief Remove leading characters from the fstring.
     *
-    * @param target_ A string containing characters to remove (defaults to "
-    * \t\n\r\f\v").
+    * @param target_ The characters to remove.
     */
-   void ltrim(std::basic_string<CharType> target_ = " \t\n\r\f\v") {
-      this->erase(0, this->find_first_not_of(target_));
+   void ltrim(std::basic_string_view<CharType> target_) {
+      this->erase(0, this->find_first_not_of(target_.data(), 0,
+                                             target_.size()));
+   }
+
+   /**
+    * @brief Remove leading characters from the fstring.
+    *
+    * @param target_ A precompiled set of the characters to remove.
+    */
+   void ltrim(charset const &target_) {
+      this->erase(0, target_.find_first_not_of(this->data(), this->size()));
    }
 
    /**
     * @brief Remove trailing whitespace characters from the fstring.
+    */
+   void rtrim() { rtrim(charset::whitespace()); }
+
+   /**
+    * @brief Remove trailing characters from the fstring.
     *
-    * @param target_ A string containing characters to remove (defaults to "
-    * \t\n\r\f\v").
+    * @param target_ The characters to remove.
     */
-   void rtrim(std::basic_string<CharType> target_ = " \t\n\r\f\v") {
-      this->erase(this->find_last_not_of(target_) + 1, this->size());
+   void rtrim(std::basic_string_view<CharType> target_) {
+      this->erase(this->find_last_not_of(target_.data(),
+                                         base_type::npos,
+                                         target_.size()) +
+                  1);
+   }
+
+   /**
+    * @brief Remove trailing characters from the fstring.
+    *
+    * @param target_ A precompiled set of the characters to remove.
+    */
+   void rtrim(charset const &target_) {
+      this->erase(target_.find_last_not_of(this->data(), this->size()) + 1);
    }
 
    /**
     * @brief Remove leading and trailing whitespace characters from the fstring.
+    */
+   void trim() { trim(charset::whitespace()); }
+
+   /**
+    * @brief Remove leading and trailing characters from the fstring.
     *
-    * @param target_ A string containing characters to remove (defaults to "
-    * \t\n\r\f\v").
+    * @param target_ The characters to remove.
     */
-   void trim(std::basic_string<CharType> target_ = " \t\n\r\f\v") {
+   void trim(std::basic_string_view<CharType> target_) {
+      rtrim(target_);
       ltrim(target_);
+   }
+
+   /**
+    * @brief Remove leading and trailing characters from the fstring.
+    *
+    * @param target_ A precompiled set of the characters to remove.
+    */
+   void trim(charset const &target_) {
       rtrim(target_);
+      ltrim(target_);
    }
 
    /**
@@ -163,12 +376,12 @@ class fstring : public std::basic_string<CharType> {
     * @return An iterator to the first occurrence of the replacement character
     * sequence.
     */
-   typename std::basic_string<CharType>::iterator
-   replace_first(std::basic_string<CharType> const &target_,
-                 std::basic_string<CharType> const &replace_) {
+   typename base_type::iterator
+   replace_first(std::basic_string_view<CharType> target_,
+                 std::basic_string_view<CharType> replace_) {
       size_t search = this->find(target_);
 
-      if (search != std::basic_string<CharType>::npos) {
+      if (search != base_type::npos) {
          this->replace(search, target_.length(), replace_);
          return (this->begin() + search);
       }
@@ -176,29 +389,154 @@ class fstring : public std::basic_string<CharType> {
       return this->end();
    }
 
+   /**
+    * @brief Replaces the first occurrence of a precompiled pattern with a
+    * character sequence.
+    *
+    * @param target_ The searcher of the pattern to be replaced.
+    * @param replace_ The replacement character sequence.
+    * @return An iterator to the first occurrence of the replacement character
+    * sequence, or end() if there is none.
+    */
+   typename base_type::iterator
+   replace_first(searcher const &target_,
+                 std::basic_string_view<CharType> replace_) {
+      size_type const search{target_.find(*this)};
+
+      if (search != base_type::npos) {
+         this->replace(search, target_.size(), replace_);
+         return this->begin() + search;
+      }
+
+      return this->end();
+   }
+
    /**
     * @brief Replaces all occurrences of a character sequence with another.
     *
+    * The occurrences are located in a single left-to-right pass and never
+    * overlap. The result is sized up front, so at most one allocation is made
+    * (none when both sequences have the same length).
+    *
     * @param target_ The character sequence to be replaced.
     * @param replace_ The replacement character sequence.
     * @return An iterator to the last occurrence of the replacement character
-    * sequence.
+    * sequence, or end() if nothing was replaced.
     */
-   typename std::basic_string<CharType>::iterator
-   replace_all(std::basic_string<CharType> const &target_,
-               std::basic_string<CharType> const &replace_) {
-      fstring buffer{*this};
+   typename base_type::iterator
+   replace_all(std::basic_string_view<CharType> target_,
+               std::basic_string_view<CharType> replace_) {
+      return replace_matches(
+          [this, target_](size_type pos_) {
+             return this->find(target_, pos_);
+          },
+          target_.size(), replace_);
+   }
 
-      auto it{this->end()};
-      auto buffer_it{replace_first(target_, replace_)};
+   /**
+    * @brief Replaces all occurrences of a precompiled pattern with a character
+    * sequence, as replace_all() does.
+    *
+    * @param target_ The searcher of the pattern to be replaced.
+    * @param replace_ The replacement character sequence.
+    * @return An iterator to the last occurrence of the replacement character
+    * sequence, or end() if nothing was replaced.
+    */
+   typename base_type::iterator
+   replace_all(searcher const &target_,
+               std::basic_string_view<CharType> replace_) {
+      return replace_matches(
+          [this, &target_](size_type pos_) {
+             return target_.find(*this, pos_);
+          },
+          target_.size(), replace_);
+   }
 
-      while (*this != buffer) {
-         buffer = *this;
-         it = buffer_it;
-         buffer_it = replace_first(target_, replace_);
+   /**
+    * @brief Replaces the occurrences of a set of patterns in a single pass.
+    *
+    * The occurrences are leftmost-longest and never overlap, so a replacement
+    * is never searched again. Pattern sets match bytes, so this and the other
+    * pattern set methods are only available for char.
+    *
+    * @tparam Range A random access range of values convertible to a string
+    * view.
+    * @param targets_ The set of patterns to be replaced.
+    * @param replacements_ One replacement per pattern, in the same order.
+    * @return The number of replaced occurrences.
+    * @throw std::invalid_argument if there is not one replacement per
+    * pattern.
+    */
+   template <class Range>
+   size_type replace_many(pattern_set const &targets_,
+                           Range const &replacements_) {
+      static_assert(sizeof(CharType) == 1,
+                    "Pattern sets match bytes: use them with fstring<char>.");
+      base_type result{this->get_allocator()};
+      size_type const count{
+          targets_.replace_many(*this, replacements_, result)};
+
+      if (count != 0) {
+         this->swap(result);
       }
+      return count;
+   }
 
-      return it;
+   /**
+    * @brief Replaces the occurrences of the keys of a map by their values in
+    * a single pass, as replace_many(pattern_set const &, Range const &) does.
+    *
+    * @tparam Map A range of pairs of values convertible to a string view
+    * (e.g., std::map<std::string, std::string>).
+    * @param replacements_ The patterns and their replacements.
+    * @return The number of replaced occurrences.
+    * @throw std::invalid_argument if a pattern is empty.
+    */
+   template <class Map> size_type replace_many(Map const &replacements_) {
+      static_assert(sizeof(CharType) == 1,
+                    "Pattern sets match bytes: use them with fstring<char>.");
+      std::vector<std::string_view> targets;
+      std::vector<std::string_view> values;
+
+      for (auto const &[target, value] : replacements_) {
+         targets.emplace_back(target);
+         values.emplace_back(value);
+      }
+
+      return replace_many(pattern_set(targets), values);
+   }
+
+   /**
+    * @brief Replaces the occurrences of a list of patterns by their
+    * replacements in a single pass.
+    *
+    * @param replacements_ The patterns and their replacements.
+    * @return The number of replaced occurrences.
+    * @throw std::invalid_argument if a pattern is empty.
+    */
+   size_type replace_many(
+       std::initializer_list<std::pair<std::string_view, std::string_view>>
+           replacements_) {
+      return replace_many<decltype(replacements_)>(replacements_);
+   }
+
+   /**
+    * @brief Replaces every occurrence of a regular expression, as
+    * find_all(regex const &) finds them.
+    *
+    * @param target_ The regular expression to be replaced.
+    * @param replace_ The replacement character sequence, copied as is.
+    * @return The number of replaced occurrences.
+    */
+   size_type replace_regex(regex const &target_,
+                           std::basic_string_view<CharType> replace_) {
+      base_type result{this->get_allocator()};
+      size_type const count{target_.replace(*this, replace_, result)};
+
+      if (count != 0) {
+         this->swap(result);
+      }
+      return count;
    }
 
    /**
@@ -209,14 +547,71 @@ class fstring : public std::basic_string<CharType> {
     * @return A new fstring representing the specified substring.
     */
    fstring sub_fstring(size_type last_, size_type first_ = 0) const {
-      std::ostringstream oss;
+      return fstring(this->data() + first_, last_ - first_,
+                     this->get_allocator());
+   }
 
-      for (size_type index{first_}; index != last_; ++index) {
-         oss << (*this)[index];
-      }
+   /**
+    * @brief Gets a lazy range over the tokens separated by a delimiter.
+    *
+    * The tokens are views into this fstring, which must outlive the range and
+    * stay unmodified while it is used.
+    *
+    * @param delimiter_ The character used as the delimiter (default is a
+    * space).
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty, as in split()).
+    * @return A range of std::basic_string_view tokens.
+    */
+   basic_split_view<CharType>
+   split_view(CharType const &delimiter_ = ' ',
+              split_mode mode_ = split_mode::skip_empty) const {
+      return basic_split_view<CharType>(*this, delimiter_, mode_);
+   }
+
+   /**
+    * @brief Gets a lazy range over the tokens separated by any character of a
+    * set.
+    *
+    * @param delimiters_ The delimiter characters (must outlive the range).
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty, as in split()).
+    * @return A range of std::basic_string_view tokens.
+    */
+   basic_split_view<CharType>
+   split_view(std::basic_string_view<CharType> delimiters_,
+              split_mode mode_ = split_mode::skip_empty) const {
+      return basic_split_view<CharType>(*this, delimiters_, mode_);
+   }
+
+   /**
+    * @brief Gets a lazy range over the tokens separated by any character of a
+    * precompiled set.
+    *
+    * @param delimiters_ The delimiter set.
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty, as in split()).
+    * @return A range of std::basic_string_view tokens.
+    */
+   basic_split_view<CharType>
+   split_view(charset const &delimiters_,
+              split_mode mode_ = split_mode::skip_empty) const {
+      return basic_split_view<CharType>(*this, delimiters_, mode_);
+   }
 
-      return fstring(oss.str());
+   /**
+    * @brief Gets a lazy range over the lines of the fstring.
+    *
+    * Lines end in '\n' or "\r\n", and a final line ending does not produce an
+    * extra empty line.
+    *
+    * @return A range of std::basic_string_view lines.
+    */
+   basic_split_view<CharType> lines() const {
+      return basic_split_view<CharType>(*this, CharType('\n'),
+                                        split_mode::lines);
    }
+
    /**
     * @brief Splits the fstring into substrings based on a specified delimiter
     * and stores them in a container.
@@ -228,22 +623,96 @@ class fstring : public std::basic_string<CharType> {
     */
    template <class Container>
    void split(Container &container_, CharType const &delimiter_ = ' ') const {
-      fstring buffer{*this};
+      auto tokens{split_view(delimiter_, split_mode::skip_empty)};
+      reserve_more(container_, tokens.count(), 0);
 
-      size_type pos{buffer.find_first_not_of(delimiter_)};
+      for (auto token : tokens) {
+         container_.emplace_back(token.data(), token.size());
+      }
+   }
 
-      while (pos != std::basic_string<CharType>::npos) {
-         size_type pos_delimiter{buffer.find_first_of(delimiter_, pos)};
-         if (pos_delimiter == std::basic_string<CharType>::npos) {
-            pos_delimiter = buffer.length();
+   /**
+    * @brief Splits the fstring into substrings separated by any character of a
+    * precompiled set and stores them in a container.
+    *
+    * @tparam Container The type of container to store the resulting substrings.
+    * @param container_ The container to store the resulting substrings.
+    * @param delimiters_ The delimiter set.
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty).
+    */
+   template <class Container>
+   void split(Container &container_, charset const &delimiters_,
+              split_mode mode_ = split_mode::skip_empty) const {
+      auto tokens{split_view(delimiters_, mode_)};
+      reserve_more(container_, tokens.count(), 0);
+
+      for (auto token : tokens) {
+         container_.emplace_back(token.data(), token.size());
+      }
+   }
+
+   /**
+    * @brief Splits the fstring into substrings separated by the occurrences
+    * of a regular expression and stores them in a container.
+    *
+    * Empty occurrences do not split.
+    *
+    * @tparam Container The type of container to store the resulting substrings.
+    * @param container_ The container to store the resulting substrings.
+    * @param delimiter_ The regular expression of the delimiters.
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty, any other mode keeps them).
+    */
+   template <class Container>
+   void split_regex(Container &container_, regex const &delimiter_,
+                    split_mode mode_ = split_mode::skip_empty) const {
+      size_type first{0};
+
+      for (regex::match const &found : delimiter_.find_all(*this)) {
+         if (found.size == 0) {
+            continue;
+         }
+         if (mode_ != split_mode::skip_empty || found.position != first) {
+            container_.emplace_back(this->data() + first,
+                                    found.position - first);
          }
+         first = found.position + found.size;
+      }
 
-         container_.push_back(buffer.sub_fstring(pos_delimiter, pos));
-         buffer.erase(0, pos_delimiter);
-         pos = buffer.find_first_not_of(delimiter_);
+      if (mode_ != split_mode::skip_empty || first != this->size()) {
+         container_.emplace_back(this->data() + first, this->size() - first);
       }
    }
 
+   /**
+    * @brief Splits the fstring into substrings based on a specified delimiter,
+    * with the tokens and the vector holding them allocated from a memory
+    * resource.
+    *
+    * @param delimiter_ The character used as the delimiter.
+    * @param resource_ The memory resource for the tokens and the vector (e.g.
+    * a std::pmr::monotonic_buffer_resource arena).
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty).
+    * @return The tokens, as polymorphic-allocator fstrings.
+    */
+   std::pmr::vector<fstring<CharType, std::pmr::polymorphic_allocator<CharType>>>
+   split(CharType const &delimiter_, std::pmr::memory_resource *resource_,
+         split_mode mode_ = split_mode::skip_empty) const {
+      std::pmr::vector<
+          fstring<CharType, std::pmr::polymorphic_allocator<CharType>>>
+          container{resource_};
+      auto tokens{split_view(delimiter_, mode_)};
+      container.reserve(tokens.count());
+
+      for (auto token : tokens) {
+         container.emplace_back(token.data(), token.size());
+      }
+
+      return container;
+   }
+
    /**
     * @brief Splits the fstring into substrings based on a specified delimiter,
     * allowing empty substrings, and stores them in a container.
@@ -256,27 +725,11 @@ class fstring : public std::basic_string<CharType> {
    template <class Container>
    void split_with_empty(Container &container_,
                          CharType const &delimiter_ = ' ') const {
-      fstring buffer{*this};
+      auto tokens{split_view(delimiter_, split_mode::keep_empty)};
+      reserve_more(container_, tokens.count(), 0);
 
-      bool additional_split{false};
-      if (buffer.find_last_of(delimiter_) == buffer.size() - 1) {
-         additional_split = true;
-      };
-
-      size_type pos{buffer.find_first_of(delimiter_)};
-
-      while (pos != std::basic_string<CharType>::npos) {
-         container_.push_back(buffer.sub_fstring(pos));
-         buffer.erase(0, pos + 1);
-         pos = buffer.find_first_of(delimiter_);
-      }
-
-      if (!buffer.empty()) {
-         container_.push_back(buffer);
-      }
-
-      if (additional_split) {
-         container_.push_back(fstring());
+      for (auto token : tokens) {
+         container_.emplace_back(token.data(), token.size());
       }
    }
 
@@ -286,25 +739,464 @@ class fstring : public std::basic_string<CharType> {
     * @param target_ The character sequence to search for.
     * @return True if the character sequence is found, false otherwise.
     */
-   bool contains(std::basic_string<CharType> const &target_) {
-      return std::search(this->begin(), this->end(), target_.begin(),
-                         target_.end()) != this->end();
+   bool contains(std::basic_string_view<CharType> target_) const {
+      return this->find(target_) != base_type::npos;
+   }
+
+   /**
+    * @brief Checks if the fstring contains a character sequence, ignoring
+    * case.
+    *
+    * Letters match when their Unicode simple case foldings are equal, so 'ß'
+    * does not match "ss", but the Kelvin sign matches 'k'.
+    *
+    * @param target_ The character sequence to search for.
+    * @return True if the character sequence is found, false otherwise.
+    */
+   bool icontains(std::basic_string_view<CharType> target_) const {
+      return ifind(target_) != base_type::npos;
+   }
+
+   /**
+    * @brief Finds a character sequence, ignoring case as icontains() does.
+    *
+    * @param target_ The character sequence to search for.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The position of the first occurrence, or npos if there is none.
+    */
+   size_type ifind(std::basic_string_view<CharType> target_,
+                   size_type pos_ = 0) const {
+      return casing::find(std::basic_string_view<CharType>(*this), target_,
+                          pos_);
+   }
+
+   /**
+    * @brief Checks if the fstring equals a character sequence, ignoring case
+    * as icontains() does.
+    *
+    * @param other_ The character sequence to compare with.
+    * @return True if they are equal ignoring case, false otherwise.
+    */
+   bool iequals(std::basic_string_view<CharType> other_) const {
+      return icompare(other_) == 0;
+   }
+
+   /**
+    * @brief Compares the fstring with a character sequence, ignoring case, by
+    * the code points of their case foldings.
+    *
+    * @param other_ The character sequence to compare with.
+    * @return A negative value if the fstring sorts first, 0 if they are equal
+    * ignoring case, and a positive value otherwise.
+    */
+   int icompare(std::basic_string_view<CharType> other_) const {
+      return casing::compare(std::basic_string_view<CharType>(*this), other_);
+   }
+
+   /**
+    * @brief Checks if the fstring contains a precompiled pattern.
+    *
+    * @param target_ The searcher of the pattern.
+    * @return True if the pattern is found, false otherwise.
+    */
+   bool contains(searcher const &target_) const {
+      return target_.find(*this) != base_type::npos;
+   }
+
+   using base_type::find;
+
+   /**
+    * @brief Finds a precompiled pattern.
+    *
+    * @param target_ The searcher of the pattern.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The position of the first occurrence, or npos if there is none.
+    */
+   size_type find(searcher const &target_, size_type pos_ = 0) const {
+      return target_.find(*this, pos_);
+   }
+
+   /**
+    * @brief Finds the non-overlapping occurrences of a precompiled pattern,
+    * left to right, as replace_all() replaces them.
+    *
+    * @param target_ The searcher of the pattern.
+    * @return The positions of the occurrences.
+    */
+   std::vector<size_type> find_all(searcher const &target_) const {
+      return target_.find_all(*this);
+   }
+
+   /**
+    * @brief Checks if a regular expression matches the whole fstring.
+    *
+    * @param target_ The regular expression.
+    * @return True if the whole fstring matches, false otherwise.
+    */
+   bool matches(regex const &target_) const { return target_.matches(*this); }
+
+   /**
+    * @brief Checks if the fstring contains an occurrence of a regular
+    * expression.
+    *
+    * @param target_ The regular expression.
+    * @return True if there is an occurrence, false otherwise.
+    */
+   bool contains(regex const &target_) const {
+      return target_.contains(*this);
+   }
+
+   /**
+    * @brief Finds the leftmost occurrence of a regular expression.
+    *
+    * @param target_ The regular expression.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The occurrence, false when converted to bool if there is none.
+    */
+   regex::match find(regex const &target_, size_type pos_ = 0) const {
+      return target_.find(*this, pos_);
+   }
+
+   /**
+    * @brief Finds the non-overlapping occurrences of a regular expression,
+    * left to right.
+    *
+    * @param target_ The regular expression.
+    * @return The occurrences.
+    */
+   std::vector<regex::match> find_all(regex const &target_) const {
+      return target_.find_all(*this);
+   }
+
+   /**
+    * @brief Finds the leftmost occurrence of any pattern of a set.
+    *
+    * @param targets_ The set of patterns.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The occurrence, false when converted to bool if there is none.
+    */
+   pattern_set::match find_any(pattern_set const &targets_,
+                               size_type pos_ = 0) const {
+      static_assert(sizeof(CharType) == 1,
+                    "Pattern sets match bytes: use them with fstring<char>.");
+      return targets_.find_any(*this, pos_);
+   }
+
+   /**
+    * @brief Counts the non-overlapping occurrences of the patterns of a set,
+    * as replace_many() replaces them.
+    *
+    * @param targets_ The set of patterns.
+    * @return The number of occurrences.
+    */
+   size_type count_all(pattern_set const &targets_) const {
+      static_assert(sizeof(CharType) == 1,
+                    "Pattern sets match bytes: use them with fstring<char>.");
+      return targets_.count_all(*this);
    }
 
    /**
     * @brief Appends a specified value multiple times to the fstring.
     *
+    * The value is written once, as an output stream would write it but
+    * without one (see out_buffer::print()), and then repeated.
+    *
     * @tparam Type The type of value to append.
     * @param count_ The number of times to append the value.
     * @param value_ The value to be appended.
     */
    template <typename Type> void append(size_type count_, Type value_) {
-      std::ostringstream oss;
-      for (size_type times{0}; times != count_; ++times) {
-         oss << value_;
+      if constexpr (std::is_same_v<Type, CharType>) {
+         base_type::append(count_, value_);
+      } else if (count_ != 0) {
+         out_buffer piece;
+         piece.print(value_);
+
+         std::basic_string_view<CharType> text;
+         base_type converted{this->get_allocator()};
+         if constexpr (sizeof(CharType) == 1) {
+            text = {reinterpret_cast<CharType const *>(piece.data()),
+                    piece.size()};
+         } else {
+            utf::convert(piece.view(), converted);
+            text = converted;
+         }
+
+         this->reserve(this->size() + count_ * text.size());
+         for (size_type times{0}; times != count_; ++times) {
+            base_type::append(text.data(), text.size());
+         }
       }
+   }
 
-      *this += oss.str();
+   /**
+    * @brief Appends an integer, written with std::to_chars.
+    *
+    * @tparam Type An integer type.
+    * @param value_ The integer.
+    * @param base_ The base, from 2 to 36 (default is 10).
+    * @throw std::invalid_argument if the base is out of range.
+    */
+   template <class Type,
+             std::enable_if_t<std::is_integral_v<Type> &&
+                                  !std::is_same_v<Type, bool>,
+                              bool> = true>
+   void append_number(Type value_, int base_ = 10) {
+      if (base_ < 2 || base_ > 36) {
+         throw std::invalid_argument("The base must be from 2 to 36.");
+      }
+
+      char digits[std::numeric_limits<Type>::digits + 2];
+      std::to_chars_result const result{
+          std::to_chars(digits, digits + sizeof(digits), value_, base_)};
+      append_ascii(std::string_view(
+          digits, static_cast<size_type>(result.ptr - digits)));
+   }
+
+   /**
+    * @brief Appends a floating-point number in its shortest form that reads
+    * back to the same value, written with std::to_chars.
+    *
+    * @tparam Type A floating-point type.
+    * @param value_ The number.
+    */
+   template <class Type,
+             std::enable_if_t<std::is_floating_point_v<Type>, bool> = true>
+   void append_number(Type value_) {
+      char digits[64];
+      std::to_chars_result const result{
+          std::to_chars(digits, digits + sizeof(digits), value_)};
+      append_ascii(std::string_view(
+          digits, static_cast<size_type>(result.ptr - digits)));
+   }
+
+   /**
+    * @brief Appends a floating-point number with a format and a precision,
+    * as printf does with "%f", "%e", "%g" or "%a".
+    *
+    * @tparam Type A floating-point type.
+    * @param value_ The number.
+    * @param format_ The notation.
+    * @param precision_ The number of digits.
+    */
+   template <class Type,
+             std::enable_if_t<std::is_floating_point_v<Type>, bool> = true>
+   void append_number(Type value_, std::chars_format format_,
+                      int precision_) {
+      char digits[128];
+      std::to_chars_result const result{std::to_chars(
+          digits, digits + sizeof(digits), value_, format_, precision_)};
+
+      if (result.ec == std::errc()) {
+         append_ascii(std::string_view(
+             digits, static_cast<size_type>(result.ptr - digits)));
+      } else {
+         out_buffer large;
+         large.put_number(value_, format_, precision_);
+         append_ascii(large.view());
+      }
+   }
+
+   /**
+    * @brief Parses the fstring as a number, with std::from_chars.
+    *
+    * The fstring must hold only the number, with optional spaces around it
+    * and a leading '+'. Integers are read in base 10 and floating-point
+    * numbers in fixed or scientific notation.
+    *
+    * @tparam Type An integer or floating-point type.
+    * @param value_ Receives the number; it is left unchanged on error.
+    * @return std::errc() on success, std::errc::invalid_argument if the
+    * fstring is not a number and std::errc::result_out_of_range if it does not
+    * fit.
+    */
+   template <class Type> std::errc parse(Type &value_) const {
+      return on_ascii(*this, [&value_](std::string_view text_) {
+         return num::parse(text_, value_);
+      });
+   }
+
+   /**
+    * @brief Parses the fstring as a number, as parse(Type &) does.
+    *
+    * @tparam Type An integer or floating-point type.
+    * @return The number, or std::nullopt on error.
+    */
+   template <class Type> std::optional<Type> try_parse() const {
+      Type value{};
+      if (parse(value) != std::errc()) {
+         return std::nullopt;
+      }
+      return value;
+   }
+
+   /**
+    * @brief Parses the fstring as a number, as parse(Type &) does.
+    *
+    * @tparam Type An integer or floating-point type.
+    * @return The number.
+    * @throw std::invalid_argument if the fstring is not a number.
+    * @throw std::out_of_range if the number does not fit.
+    */
+   template <class Type> Type parse() const {
+      Type value{};
+      throw_if(parse(value), "The fstring");
+      return value;
+   }
+
+   /**
+    * @brief Parses the fstring as a size in bytes, such as "10G", "512 KiB"
+    * or "1.5MB" (see num::parse_size()).
+    *
+    * @return The number of bytes, or std::nullopt on error.
+    */
+   std::optional<std::uint64_t> parse_size() const {
+      std::uint64_t bytes{0};
+      if (on_ascii(*this, [&bytes](std::string_view text_) {
+             return num::parse_size(text_, bytes);
+          }) != std::errc()) {
+         return std::nullopt;
+      }
+      return bytes;
+   }
+
+   /**
+    * @brief Parses the fstring as a duration, such as "250ms", "1.5s" or
+    * "1h 30m" (see num::parse_duration()).
+    *
+    * @return The duration, or std::nullopt on error.
+    */
+   std::optional<std::chrono::nanoseconds> parse_duration() const {
+      std::chrono::nanoseconds duration{0};
+      if (on_ascii(*this, [&duration](std::string_view text_) {
+             return num::parse_duration(text_, duration);
+          }) != std::errc()) {
+         return std::nullopt;
+      }
+      return duration;
+   }
+
+   /**
+    * @brief Parses every token between delimiters as a number, as
+    * parse(Type &) does. An fstring with only spaces holds no number.
+    *
+    * @tparam Type An integer or floating-point type.
+    * @param delimiter_ The delimiter character (default is ',').
+    * @return The numbers, in order.
+    * @throw std::invalid_argument if a token is not a number.
+    * @throw std::out_of_range if a number does not fit.
+    */
+   template <class Type>
+   std::vector<Type> parse_all(CharType const &delimiter_ = ',') const {
+      std::vector<Type> values;
+      CharType const blanks[]{CharType(' '), CharType('\t')};
+      if (this->find_first_not_of(blanks, 0, 2) == base_type::npos) {
+         return values;
+      }
+
+      values.reserve(static_cast<size_type>(
+                         std::count(this->begin(), this->end(), delimiter_)) +
+                     1);
+      for (std::basic_string_view<CharType> token :
+           basic_split_view<CharType>(*this, delimiter_,
+                                      split_mode::keep_empty)) {
+         Type value{};
+         std::errc const error{
+             on_ascii(token, [&value](std::string_view text_) {
+                return num::parse(text_, value);
+             })};
+         if (error != std::errc()) {
+            throw_if(error, "Token " + std::to_string(values.size()));
+         }
+         values.push_back(value);
+      }
+
+      return values;
+   }
+
+   /**
+    * @brief Creates an fstring from UTF-8 text, converted to the encoding of
+    * the character type (UTF-16 or UTF-32 for wider characters).
+    *
+    * @param text_ The UTF-8 text.
+    * @param alloc_ The allocator to use (default is a default-constructed
+    * one).
+    * @return The converted fstring.
+    * @throw std::invalid_argument if the text is not valid UTF-8.
+    */
+   static fstring from_utf8(std::string_view text_,
+                            allocator_type const &alloc_ = allocator_type()) {
+      fstring result{alloc_};
+      utf::convert(text_, result);
+      return result;
+   }
+
+   /**
+    * @brief Converts the fstring to UTF-8.
+    *
+    * @return The UTF-8 text.
+    * @throw std::invalid_argument if the fstring is not valid in the encoding
+    * of its character type.
+    */
+   std::string to_utf8() const {
+      std::string result;
+      utf::convert(std::basic_string_view<CharType>(*this), result);
+      return result;
+   }
+
+   /**
+    * @brief Checks if the fstring is valid in the encoding of its character
+    * type (UTF-8, UTF-16 or UTF-32).
+    *
+    * @return True if the fstring is valid, false otherwise.
+    */
+   bool valid_utf() const {
+      if constexpr (sizeof(CharType) == 1) {
+         return utf::valid(std::string_view(
+             reinterpret_cast<char const *>(this->data()), this->size()));
+      } else {
+         return utf::valid_units(std::basic_string_view<CharType>(*this));
+      }
+   }
+
+   /**
+    * @brief Converts the fstring to lowercase in place, with the Unicode
+    * simple lowercase mapping.
+    *
+    * Nothing is allocated unless a letter grows, which only U+023A and U+023E
+    * do in UTF-8.
+    */
+   void to_lower() { change_case<false>(*this, *this); }
+
+   /**
+    * @brief Converts the fstring to uppercase in place, with the Unicode
+    * simple uppercase mapping.
+    *
+    * Nothing is allocated unless a letter grows, which only a few letters of
+    * the IPA and Latin Extended blocks do in UTF-8, such as U+0250.
+    */
+   void to_upper() { change_case<true>(*this, *this); }
+
+   /**
+    * @brief Returns a lowercase copy of the fstring (see to_lower()).
+    *
+    * @return The lowercase fstring.
+    */
+   fstring lowercased() const {
+      fstring result(this->size(), CharType(), copied_allocator(*this));
+      change_case<false>(*this, result);
+      return result;
+   }
+
+   /**
+    * @brief Returns an uppercase copy of the fstring (see to_upper()).
+    *
+    * @return The uppercase fstring.
+    */
+   fstring uppercased() const {
+      fstring result(this->size(), CharType(), copied_allocator(*this));
+      change_case<true>(*this, result);
+      return result;
    }
 
    /**
@@ -312,51 +1204,96 @@ class fstring : public std::basic_string<CharType> {
     *
     * @return An fstring enclosed in double quotes.
     */
-   fstring quoted() const { return '"' + *this + '"'; }
+   fstring quoted() const {
+      fstring result(copied_allocator(*this));
+      cat_to(static_cast<base_type &>(result), CharType('"'),
+             std::basic_string_view<CharType>(*this), CharType('"'));
+      return result;
+   }
+
+   /**
+    * @brief Hashes the fstring with a fast non-cryptographic hash of its
+    * code units (see hash_bytes()), which is also what std::hash uses.
+    *
+    * @param seed_ A value that changes every hash (default is 0).
+    * @return The hash, equal to the hash() of an interned copy for char.
+    */
+   std::uint64_t hash(std::uint64_t seed_ = 0) const {
+      return hash_bytes(this->data(), this->size() * sizeof(CharType), seed_);
+   }
+
+   /**
+    * @brief Gets the number of terminal columns the fstring takes, which the
+    * alignment methods pad to.
+    *
+    * Escape sequences take no column, nor do combining marks, while wide East
+    * Asian characters and emoji take two.
+    *
+    * @return The display width of the fstring.
+    */
+   size_type display_width() const {
+      return ext::display_width(std::basic_string_view<CharType>(*this));
+   }
+
    /**
     * @brief Splits the fstring into two parts at the specified size, using a
     * given separator.
     *
-    * @param size_ The size at which the fstring should be split.
+    * @param size_ The width, in columns, at which the fstring should be split
+    * (see display_width()).
     * @param separator_ The character used as the separator (default is a
     * space).
     * @return The remaining part of the fstring after the split.
     */
    fstring split_at(size_type size_, CharType const &separator_ = ' ') {
       if (size_ == 0) {
-         return fstring();
+         return fstring(this->get_allocator());
       }
 
-      std::vector<fstring<CharType>> splitted;
-      this->split_with_empty(splitted, separator_);
-
-      fstring new_fstring;
-      fstring remainder;
+      fstring new_fstring(this->get_allocator());
+      size_type new_width{0};
+      fstring remainder(this->get_allocator());
 
       bool catch_stop{false};
 
-      for (fstring<CharType> _w : splitted) {
+      for (std::basic_string_view<CharType> _w :
+           split_view(separator_, split_mode::keep_empty)) {
          if (!catch_stop) {
-            if (new_fstring.size() + _w.size() + 1 <= size_) {
-               new_fstring += _w + separator_;
-            } else if (new_fstring.size() + _w.size() <= size_) {
+            size_type const width{ext::display_width(_w)};
+
+            if (new_width + width + 1 <= size_) {
+               cat_to(static_cast<base_type &>(new_fstring), _w, separator_);
+               new_width += width + 1;
+            } else if (new_width + width <= size_) {
                new_fstring += _w;
+               new_width += width;
             } else {
                catch_stop = true;
             }
          }
 
          if (new_fstring.empty() && catch_stop) {
-            catch_stop = true;
-            new_fstring = _w.sub_fstring(size_);
-            remainder += _w.sub_fstring(_w.size(), size_);
+            size_type cut{display_prefix(_w, size_)};
+            if (cut == 0) {
+               // A character wider than the size still moves on its own
+               CharType const *next{_w.data()};
+               if (utf::decode(next, _w.data() + _w.size()) == utf::invalid) {
+                  ++next;
+               }
+               cut = static_cast<size_type>(next - _w.data());
+            }
+
+            new_fstring.assign(_w.data(), cut);
+            remainder += _w.substr(cut);
          } else if (catch_stop) {
-            catch_stop = true;
-            remainder += (!remainder.empty() ? separator_ : '\0') + _w;
+            if (!remainder.empty()) {
+               remainder += separator_;
+            }
+            remainder += _w;
          }
       }
 
-      *this = new_fstring;
+      this->swap(new_fstring);
       return remainder;
    }
 
@@ -364,128 +1301,176 @@ class fstring : public std::basic_string<CharType> {
     * @brief Aligns the fstring to the left within a specified size by adding
     * separator characters on the right.
     *
-    * @param new_size_ The new size to which the fstring should be aligned.
+    * @param new_size_ The width, in columns, to which the fstring should be
+    * aligned (see display_width()).
     * @param separator_ The character used to pad the fstring (default is a
     * space).
     */
    void align_left(size_type new_size_, CharType const &separator_ = ' ') {
-      if (new_size_ < this->size()) {
+      size_type const width{display_width()};
+      if (new_size_ < width) {
          return;
       }
 
-      this->append(new_size_ - this->size(), separator_);
+      this->resize(this->size() + (new_size_ - width), separator_);
    }
+
    /**
     * @brief Aligns the fstring to the center within a specified size by adding
     * separator characters on both sides.
     *
-    * @param new_size_ The new size to which the fstring should be aligned.
+    * @param new_size_ The width, in columns, to which the fstring should be
+    * aligned (see display_width()).
     * @param separator_ The character used to pad the fstring (default is a
     * space).
     */
    void align_center(size_type new_size_, CharType const &separator_ = ' ') {
-      if (new_size_ < this->size()) {
+      size_type const width{display_width()};
+      if (new_size_ < width) {
          return;
       }
 
-      fstring add_space;
-      add_space.append((new_size_ - this->size()) / 2, separator_);
-
-      std::ostringstream oss;
-      oss << add_space << *this << add_space;
-
-      if (oss.str().size() < new_size_) {
-         oss << separator_;
-      }
-
-      *this = oss.str();
+      shift_right((new_size_ - width) / 2, new_size_ - width, separator_);
    }
 
    /**
     * @brief Aligns the fstring to the right within a specified size by adding
     * separator characters on the left.
     *
-    * @param new_size_ The new size to which the fstring should be aligned.
+    * @param new_size_ The width, in columns, to which the fstring should be
+    * aligned (see display_width()).
     * @param separator_ The character used to pad the fstring (default is a
     * space).
     */
    void align_right(size_type new_size_, CharType const &separator_ = ' ') {
-      if (new_size_ < this->size()) {
+      size_type const width{display_width()};
+      if (new_size_ < width) {
          return;
       }
 
-      fstring add_space;
-      add_space.append(new_size_ - this->size(), separator_);
-
-      std::ostringstream oss;
-      oss << add_space << *this;
-
-      *this = oss.str();
+      shift_right(new_size_ - width, new_size_ - width, separator_);
    }
 
    /**
     * @brief Aligns the fstring using a justified style within a specified size
     * by distributing separator characters.
     *
-    * @param new_size_ The new size to which the fstring should be aligned.
+    * @param new_size_ The width, in columns, to which the fstring should be
+    * aligned (see display_width()).
     * @param separator_ The character used to pad the fstring (default is a
     * space).
     */
    void align_justify(size_type new_size_, CharType const &separator_ = ' ') {
-      if (new_size_ < this->size()) {
+      size_type const width{display_width()};
+      if (new_size_ < width) {
          return;
       }
 
-      std::vector<fstring<CharType>> splitted;
-      split_with_empty(splitted, separator_);
+      size_type const words_with_space{static_cast<size_type>(
+          std::count(this->begin(), this->end(), separator_))};
 
-      size_type words_with_space{splitted.size() - 1};
-
-      if (words_with_space <= 0) {
+      if (words_with_space == 0) {
          align_left(new_size_, separator_);
          return;
       }
 
-      size_type spaces{(new_size_ - this->size()) + words_with_space};
-      size_type spaces_per_word{spaces / words_with_space};
-      size_type spaces_truncated{spaces % words_with_space};
+      size_type const old_size{this->size()};
+      size_type const new_length{old_size + (new_size_ - width)};
+      size_type const spaces{(new_size_ - width) + words_with_space};
+      size_type const spaces_per_word{spaces / words_with_space};
+      size_type const spaces_truncated{spaces % words_with_space};
 
-      std::ostringstream oss;
-      for (auto &word : splitted) {
-         oss << word;
+      this->resize(new_length);
 
-         if (&word != &splitted.back()) {
-            oss << fstring(spaces_per_word, separator_);
-         }
+      CharType *const data{&(*this)[0]};
+      size_type read{old_size};
+      size_type write{new_length};
 
-         if (spaces_truncated != 0) {
-            oss << separator_;
-            --spaces_truncated;
+      for (size_type gap{words_with_space}; gap-- != 0;) {
+         size_type separator{read};
+         while (data[--separator] != separator_) {
          }
+
+         size_type const word{read - separator - 1};
+         write -= word;
+         std::char_traits<CharType>::move(data + write, data + separator + 1,
+                                          word);
+
+         size_type const width{spaces_per_word + (gap < spaces_truncated)};
+         write -= width;
+         std::char_traits<CharType>::assign(data + write, width, separator_);
+
+         read = separator;
       }
+   }
 
-      *this = oss.str();
+   /**
+    * @brief Aligns the fstring within a specified size using one of the
+    * alignment modes.
+    *
+    * @param new_size_ The width, in columns, to which the fstring should be
+    * aligned (see display_width()).
+    * @param mode_ The alignment mode.
+    * @param separator_ The character used to pad the fstring (default is a
+    * space).
+    */
+   void align(size_type new_size_, align_mode mode_,
+              CharType const &separator_ = ' ') {
+      switch (mode_) {
+      case align_mode::left:
+         align_left(new_size_, separator_);
+         break;
+      case align_mode::center:
+         align_center(new_size_, separator_);
+         break;
+      case align_mode::right:
+         align_right(new_size_, separator_);
+         break;
+      case align_mode::justify:
+         align_justify(new_size_, separator_);
+         break;
+      }
    }
+
+   /**
+    * @brief Gets a lazy layout of the fstring wrapped into lines of a fixed
+    * width, in a single pass over the text.
+    *
+    * Each line of the fstring is a paragraph. The fstring must outlive the
+    * layout and stay unmodified while it is used.
+    *
+    * @param width_ The width of the lines.
+    * @param align_ How lines are aligned (default is align_mode::left).
+    * @param wrap_ How words are distributed (default is wrap_mode::greedy).
+    * @param separator_ The character between words, which also pads the
+    * lines (default is a space).
+    * @return A range of the wrapped lines.
+    */
+   basic_layout<CharType> wrap(size_type width_,
+                               align_mode align_ = align_mode::left,
+                               wrap_mode wrap_ = wrap_mode::greedy,
+                               CharType const &separator_ = ' ') const {
+      return basic_layout<CharType>(*this, width_, align_, wrap_, separator_);
+   }
+
    /**
     * @brief Sets the text color for the fstring using ANSI color codes.
     *
     * @param code_ The ANSI color code to apply (default is cfg::none).
     */
    void color(short code_ = cfg::none) {
-      bool search{
-          std::any_of(std::begin(cfg::list), std::end(cfg::list),
-                      [code_](short color_) { return code_ == color_; })};
-
-      if (!search || code_ == cfg::none) {
-         return;
+      if (auto escape{sgr::find(code_, sgr::foreground)}) {
+         enclose(*escape);
       }
-
-      std::ostringstream oss;
-
-      oss << "\33[" << code_ << "m" << *this << "\33[" << stl::regular << "m";
-      *this = oss.str();
    }
 
+   /**
+    * @brief Sets the text color for the fstring.
+    *
+    * @param color_ The color to apply.
+    */
+   void color(fg_color color_) { color(static_cast<short>(color_)); }
+
    /**
     * @brief Sets the background color for the fstring using ANSI color codes.
     *
@@ -493,18 +1478,18 @@ class fstring : public std::basic_string<CharType> {
     * cbg::none).
     */
    void background(short code_ = cbg::none) {
-      bool search{std::any_of(
-          std::begin(cbg::list), std::end(cbg::list),
-          [code_](short background_) { return code_ == background_; })};
-
-      if (!search || code_ == cbg::none) {
-         return;
+      if (auto escape{sgr::find(code_, sgr::background)}) {
+         enclose(*escape);
       }
+   }
 
-      std::ostringstream oss;
-
-      oss << "\33[" << code_ << "m" << *this << "\33[" << stl::regular << "m";
-      *this = oss.str();
+   /**
+    * @brief Sets the background color for the fstring.
+    *
+    * @param color_ The background color to apply.
+    */
+   void background(bg_color color_) {
+      background(static_cast<short>(color_));
    }
 
    /**
@@ -513,20 +1498,290 @@ class fstring : public std::basic_string<CharType> {
     * @param code_ The ANSI style code to apply (default is stl::none).
     */
    void style(short code_ = stl::none) {
-      bool search{
-          std::any_of(std::begin(stl::list), std::end(stl::list),
-                      [code_](short style_) { return code_ == style_; })};
+      if (auto escape{sgr::find(code_, sgr::style)}) {
+         enclose(*escape);
+      }
+   }
 
-      if (!search || code_ == stl::none) {
+   /**
+    * @brief Sets the text style for the fstring.
+    *
+    * @param style_ The style to apply.
+    */
+   void style(font_style style_) { style(static_cast<short>(style_)); }
+
+   /**
+    * @brief Sets typed attributes for the fstring with a single escape
+    * sequence built at compile time (e.g. style<fg_color::red,
+    * font_style::bold>()).
+    *
+    * @tparam Codes Values of fg_color, bg_color or font_style.
+    */
+   template <auto... Codes> void style() {
+      constexpr sgr::escape const &escape{sgr::sequence<Codes...>};
+
+      if constexpr (escape.size != 0) {
+         enclose(escape);
+      }
+   }
+
+   /**
+    * @brief Sets the text color, background color and style for the fstring at
+    * once, using a single combined ANSI sequence (e.g. "\33[31;44;1m").
+    *
+    * @param style_ The attributes to apply; invalid codes are ignored.
+    */
+   void style(text_style const &style_) {
+      text_style const valid{style_.validated()};
+
+      if (valid.plain()) {
+         return;
+      }
+
+      enclose(sgr::make(std::array<short, 3>{
+          valid.foreground, valid.background, valid.style}));
+   }
+
+   /**
+    * @brief Removes the escape sequences of the fstring in place, without
+    * allocating, so that it can be written to a plain file.
+    */
+   void strip_escapes() {
+      if (this->empty()) {
+         return;
+      }
+
+      CharType *const data{&(*this)[0]};
+      this->resize(ansi::strip(
+          std::basic_string_view<CharType>(data, this->size()), data));
+   }
+
+ private:
+   /**
+    * @brief Gets the allocator of a copy of an fstring, which is the
+    * allocator of a concatenation that starts with it.
+    */
+   static allocator_type copied_allocator(fstring const &source_) {
+      return std::allocator_traits<Allocator>::
+          select_on_container_copy_construction(source_.get_allocator());
+   }
+
+   /**
+    * @brief Concatenates texts and characters into a new fstring with a
+    * single allocation (see cat()).
+    */
+   template <class... Types>
+   static fstring concatenate(allocator_type const &alloc_,
+                              Types const &...pieces_) {
+      return concat<fstring, piece::type_t<CharType, Types>...>(
+                 alloc_, {piece::make<CharType>(pieces_)...})
+          .str();
+   }
+
+   /**
+    * @brief Converts the case of a text into a string of the same size, which
+    * may be the text itself.
+    *
+    * When a letter does not fit, the rest is converted into a copy with room
+    * for the worst case, half as long again, which replaces the string.
+    */
+   template <bool Upper>
+   static void change_case(std::basic_string_view<CharType> in_,
+                           base_type &out_) {
+      CharType *const out{&out_[0]};
+      casing::progress const done{
+          casing::convert<Upper>(in_.data(), in_.size(), out, in_.size())};
+      if (done.read == in_.size()) {
+         out_.resize(done.written);
          return;
       }
 
-      std::ostringstream oss;
+      size_type const left{in_.size() - done.read};
+      base_type grown(done.written + left + left / 2, CharType(),
+                      out_.get_allocator());
+      std::char_traits<CharType>::copy(&grown[0], out, done.written);
+      casing::progress const rest{
+          casing::convert<Upper>(in_.data() + done.read, left,
+                                 &grown[0] + done.written, left + left / 2)};
+      grown.resize(done.written + rest.written);
+      out_.swap(grown);
+   }
+
+   /**
+    * @brief Appends ASCII characters, widened for wider character types.
+    */
+   void append_ascii(std::string_view text_) {
+      if constexpr (sizeof(CharType) == 1) {
+         base_type::append(reinterpret_cast<CharType const *>(text_.data()),
+                           text_.size());
+      } else {
+         size_type const old_size{this->size()};
+         this->resize(old_size + text_.size());
+         std::copy(text_.begin(), text_.end(), this->begin() + old_size);
+      }
+   }
 
-      oss << "\33[" << code_ << "m" << *this << "\33[" << stl::regular << "m";
-      *this = oss.str();
+   /**
+    * @brief Calls a parser with a text as bytes; wider code units are copied
+    * first, and a text with non-ASCII code units is not a number.
+    */
+   template <class Parser>
+   static std::errc on_ascii(std::basic_string_view<CharType> text_,
+                             Parser parser_) {
+      if constexpr (sizeof(CharType) == 1) {
+         return parser_(std::string_view(
+             reinterpret_cast<char const *>(text_.data()), text_.size()));
+      } else {
+         std::string bytes;
+         if (!num::to_ascii(text_, bytes)) {
+            return std::errc::invalid_argument;
+         }
+         return parser_(std::string_view(bytes));
+      }
+   }
+
+   /**
+    * @brief Throws the exception matching a parse error, if any.
+    *
+    * @param error_ The error.
+    * @param what_ What was parsed, to start the message.
+    */
+   static void throw_if(std::errc error_, std::string const &what_) {
+      if (error_ == std::errc::result_out_of_range) {
+         throw std::out_of_range(what_ + " is out of range.");
+      }
+      if (error_ != std::errc()) {
+         throw std::invalid_argument(what_ + " is not a number.");
+      }
+   }
+
+   /**
+    * @brief Replaces all the occurrences found by a search function.
+    *
+    * The occurrences are located in a single left-to-right pass and never
+    * overlap. The result is sized up front, so at most one allocation is made
+    * (none when both sequences have the same length).
+    *
+    * @tparam Find A callable returning the next occurrence from a position.
+    * @param find_ The search function.
+    * @param target_size_ The size of the occurrences.
+    * @param replace_ The replacement character sequence.
+    * @return An iterator to the last occurrence of the replacement character
+    * sequence, or end() if nothing was replaced.
+    */
+   template <class Find>
+   typename base_type::iterator
+   replace_matches(Find const &find_, size_type target_size_,
+                   std::basic_string_view<CharType> replace_) {
+      size_type const replace_size{replace_.size()};
+
+      if (target_size_ == 0) {
+         return this->end();
+      }
+
+      size_type matches{0};
+      size_type last{base_type::npos};
+
+      for (size_type pos{find_(0)};
+           pos != base_type::npos;
+           pos = find_(pos + target_size_)) {
+         ++matches;
+         last = pos;
+      }
+
+      if (matches == 0) {
+         return this->end();
+      }
+
+      if (target_size_ == replace_size) {
+         for (size_type pos{find_(0)};
+              pos != base_type::npos;
+              pos = find_(pos + target_size_)) {
+            this->replace(pos, target_size_, replace_);
+         }
+
+         return this->begin() + last;
+      }
+
+      base_type result{this->get_allocator()};
+      result.reserve(this->size() - matches * target_size_ +
+                     matches * replace_size);
+
+      size_type first{0};
+      for (size_type pos{find_(0)};
+           pos != base_type::npos;
+           pos = find_(first)) {
+         result.append(*this, first, pos - first);
+         last = result.size();
+         result.append(replace_);
+         first = pos + target_size_;
+      }
+      result.append(*this, first, base_type::npos);
+
+      this->swap(result);
+      return this->begin() + last;
+   }
+
+   /**
+    * @brief Moves the contents right and pads both sides, growing the
+    * capacity at most once.
+    *
+    * @param before_ The number of separators to put on the left.
+    * @param padding_ The number of separators to add on both sides.
+    * @param separator_ The padding character.
+    */
+   void shift_right(size_type before_, size_type padding_,
+                    CharType const &separator_) {
+      size_type const old_size{this->size()};
+      this->resize(old_size + padding_, separator_);
+
+      CharType *const data{&(*this)[0]};
+      std::char_traits<CharType>::move(data + before_, data, old_size);
+      std::char_traits<CharType>::assign(data, before_, separator_);
+   }
+
+   /**
+    * @brief Encloses the fstring between an escape sequence and the reset
+    * sequence, growing it at most once.
+    *
+    * @param escape_ The escape sequence to prepend.
+    */
+   void enclose(sgr::escape const &escape_) {
+      base_type out{this->get_allocator()};
+      out.reserve(escape_.size + this->size() + sgr::reset.size);
+      out.append(escape_.data, escape_.data + escape_.size);
+      out.append(*this);
+      out.append(sgr::reset.data, sgr::reset.data + sgr::reset.size);
+
+      this->swap(out);
    }
 };
+
+/**
+ * @brief Namespace 'pmr' for fstrings using polymorphic allocators.
+ */
+namespace pmr {
+/**
+ * @brief An fstring whose characters come from a std::pmr::memory_resource.
+ * @tparam CharType The character type used in the string (e.g., char, wchar_t).
+ */
+template <typename CharType = char>
+using fstring = ext::fstring<CharType, std::pmr::polymorphic_allocator<CharType>>;
+} // namespace pmr
 } // namespace ext
 
+namespace std {
+/**
+ * @brief Hashes an fstring with fstring::hash(), so it can be the key of an
+ * unordered container.
+ */
+template <typename CharType, typename Allocator>
+struct hash<ext::fstring<CharType, Allocator>> {
+   std::size_t
+   operator()(ext::fstring<CharType, Allocator> const &text_) const noexcept {
+      return static_cast<std::size_t>(text_.hash());
+   }
+};
+} // namespace std
+
 #endif /// FSTRING_HPP_
\ No newline at end of file
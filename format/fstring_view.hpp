@@ -0,0 +1,459 @@
+/**
+ * @file fstring_view.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A read-only fstring over a memory-mapped file.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * An fstring_view maps a whole file into memory and runs the read-only
+ * fstring algorithms directly over the mapped pages, so a large file can be
+ * searched, split or trimmed without being copied into a string first. The
+ * pages are read by the kernel on demand, and an access hint tells it how to
+ * read ahead.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef FSTRING_VIEW_HPP_
+#define FSTRING_VIEW_HPP_
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /// _WIN32
+
+#include "charset.hpp"
+#include "split_view.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief How the pages of a mapping are going to be read.
+ */
+enum class access_hint {
+   normal,     ///< No particular order.
+   sequential, ///< From start to end, read ahead aggressively.
+   random,     ///< In no order, do not read ahead.
+   willneed,   ///< Soon, read everything ahead.
+};
+
+/**
+ * @brief A read-only view of a file mapped into memory.
+ *
+ * The view owns the mapping: it can be moved but not copied, and the views,
+ * tokens and iterators obtained from it are valid while it lives.
+ */
+class fstring_view {
+ public:
+   using value_type = char;
+   using view_type = std::string_view;
+   using size_type = view_type::size_type;
+   using const_iterator = view_type::const_iterator;
+
+   static constexpr size_type npos{view_type::npos}; ///< Not found.
+
+   /**
+    * @brief Default constructor, creates an empty view.
+    */
+   fstring_view() : m_data(nullptr), m_size(0) {}
+
+   /**
+    * @brief Maps a file (such as a FileHandler).
+    *
+    * @param path_ The path of the file.
+    * @param hint_ How the file is going to be read (default is
+    * access_hint::sequential).
+    * @throw std::system_error if the file cannot be opened or mapped.
+    */
+   explicit fstring_view(std::filesystem::path const &path_,
+                         access_hint hint_ = access_hint::sequential)
+       : fstring_view() {
+      map(path_, hint_);
+   }
+
+   fstring_view(fstring_view const &) = delete;
+   fstring_view &operator=(fstring_view const &) = delete;
+
+   /**
+    * @brief Move constructor, takes over the mapping of another view.
+    *
+    * @param rhs_ The view to be moved, left empty.
+    */
+   fstring_view(fstring_view &&rhs_) noexcept
+       : m_data(std::exchange(rhs_.m_data, nullptr)),
+         m_size(std::exchange(rhs_.m_size, 0)) {}
+
+   /**
+    * @brief Move assignment, releases the current mapping and takes over the
+    * mapping of another view.
+    *
+    * @param rhs_ The view to be moved, left empty.
+    * @return A reference to this view.
+    */
+   fstring_view &operator=(fstring_view &&rhs_) noexcept {
+      if (this != &rhs_) {
+         unmap();
+         m_data = std::exchange(rhs_.m_data, nullptr);
+         m_size = std::exchange(rhs_.m_size, 0);
+      }
+      return *this;
+   }
+
+   /**
+    * @brief Destructor, releases the mapping.
+    */
+   ~fstring_view() { unmap(); }
+
+   /**
+    * @brief Tells the system how the pages are going to be read from now on.
+    *
+    * @param hint_ The access hint.
+    */
+   void advise(access_hint hint_) const {
+#ifdef _WIN32
+      // Windows takes the hint when the file is opened, see map()
+      static_cast<void>(hint_);
+#else
+      if (m_size == 0) {
+         return;
+      }
+
+      int advice{MADV_NORMAL};
+      switch (hint_) {
+      case access_hint::sequential:
+         advice = MADV_SEQUENTIAL;
+         break;
+      case access_hint::random:
+         advice = MADV_RANDOM;
+         break;
+      case access_hint::willneed:
+         advice = MADV_WILLNEED;
+         break;
+      default:
+         break;
+      }
+
+      ::madvise(const_cast<char *>(m_data), m_size, advice);
+#endif /// _WIN32
+   }
+
+   /**
+    * @brief Gets the mapped characters.
+    */
+   char const *data() const { return m_data; }
+
+   /**
+    * @brief Gets the number of mapped characters.
+    */
+   size_type size() const { return m_size; }
+
+   /**
+    * @brief Checks if the view has no character.
+    */
+   bool empty() const { return m_size == 0; }
+
+   /**
+    * @brief Gets the character at a position (not checked).
+    */
+   char operator[](size_type pos_) const { return m_data[pos_]; }
+
+   /**
+    * @brief Gets an iterator to the first character.
+    */
+   const_iterator begin() const { return view().begin(); }
+
+   /**
+    * @brief Gets an iterator past the last character.
+    */
+   const_iterator end() const { return view().end(); }
+
+   /**
+    * @brief Gets the whole mapping as a string view.
+    */
+   view_type view() const { return view_type(m_data, m_size); }
+
+   /**
+    * @brief Converts the view to a string view of the whole mapping.
+    */
+   operator view_type() const { return view(); }
+
+   /**
+    * @brief Finds a character sequence.
+    *
+    * @param target_ The character sequence to search for.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The position of the first occurrence, or npos if there is none.
+    */
+   size_type find(view_type target_, size_type pos_ = 0) const {
+      return view().find(target_, pos_);
+   }
+
+   /**
+    * @brief Checks if the view contains a character sequence.
+    *
+    * @param target_ The character sequence to search for.
+    * @return True if the sequence occurs, false otherwise.
+    */
+   bool contains(view_type target_) const { return find(target_) != npos; }
+
+   /**
+    * @brief Finds the non-overlapping occurrences of a character sequence,
+    * left to right, as fstring::replace_all replaces them.
+    *
+    * @param target_ The character sequence to search for.
+    * @return The positions of the occurrences, none if the sequence is empty.
+    */
+   std::vector<size_type> find_all(view_type target_) const {
+      std::vector<size_type> positions;
+
+      if (target_.empty()) {
+         return positions;
+      }
+
+      for (size_type pos{find(target_)}; pos != npos;
+           pos = find(target_, pos + target_.size())) {
+         positions.push_back(pos);
+      }
+
+      return positions;
+   }
+
+   /**
+    * @brief Gets the view without leading whitespace characters.
+    */
+   view_type ltrim() const { return ltrim(charset::whitespace()); }
+
+   /**
+    * @brief Gets the view without leading characters of a set.
+    *
+    * @param target_ A precompiled set of the characters to skip.
+    * @return A view from the first character not in the set.
+    */
+   view_type ltrim(charset const &target_) const {
+      size_type const first{target_.find_first_not_of(m_data, m_size)};
+      return first == npos ? view_type() : view().substr(first);
+   }
+
+   /**
+    * @brief Gets the view without trailing whitespace characters.
+    */
+   view_type rtrim() const { return rtrim(charset::whitespace()); }
+
+   /**
+    * @brief Gets the view without trailing characters of a set.
+    *
+    * @param target_ A precompiled set of the characters to skip.
+    * @return A view up to the last character not in the set.
+    */
+   view_type rtrim(charset const &target_) const {
+      return view().substr(0, target_.find_last_not_of(m_data, m_size) + 1);
+   }
+
+   /**
+    * @brief Gets the view without leading and trailing whitespace characters.
+    */
+   view_type trim() const { return trim(charset::whitespace()); }
+
+   /**
+    * @brief Gets the view without leading and trailing characters of a set.
+    *
+    * @param target_ A precompiled set of the characters to skip.
+    * @return A view from the first to the last character not in the set.
+    */
+   view_type trim(charset const &target_) const {
+      size_type const first{target_.find_first_not_of(m_data, m_size)};
+      if (first == npos) {
+         return view_type();
+      }
+
+      return view().substr(first, target_.find_last_not_of(m_data, m_size) +
+                                      1 - first);
+   }
+
+   /**
+    * @brief Gets a lazy range over the tokens separated by a delimiter.
+    *
+    * @param delimiter_ The delimiter character (default is a space).
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty).
+    * @return A range of string view tokens into the mapping.
+    */
+   basic_split_view<char>
+   split_view(char delimiter_ = ' ',
+              split_mode mode_ = split_mode::skip_empty) const {
+      return basic_split_view<char>(view(), delimiter_, mode_);
+   }
+
+   /**
+    * @brief Gets a lazy range over the tokens separated by any character of a
+    * set.
+    *
+    * @param delimiters_ The delimiter characters (must outlive the range).
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty).
+    * @return A range of string view tokens into the mapping.
+    */
+   basic_split_view<char>
+   split_view(view_type delimiters_,
+              split_mode mode_ = split_mode::skip_empty) const {
+      return basic_split_view<char>(view(), delimiters_, mode_);
+   }
+
+   /**
+    * @brief Gets a lazy range over the tokens separated by any character of a
+    * precompiled set.
+    *
+    * @param delimiters_ The delimiter set.
+    * @param mode_ How empty tokens are handled (default is
+    * split_mode::skip_empty).
+    * @return A range of string view tokens into the mapping.
+    */
+   basic_split_view<char>
+   split_view(charset const &delimiters_,
+              split_mode mode_ = split_mode::skip_empty) const {
+      return basic_split_view<char>(view(), delimiters_, mode_);
+   }
+
+   /**
+    * @brief Gets a lazy range over the lines of the file.
+    *
+    * @return A range of string view lines into the mapping, without their
+    * "\n" or "\r\n".
+    */
+   basic_split_view<char> lines() const {
+      return basic_split_view<char>(view(), '\n', split_mode::lines);
+   }
+
+ private:
+   /**
+    * @brief Maps a whole file read-only; an empty file maps nothing.
+    */
+   void map(std::filesystem::path const &path_, access_hint hint_) {
+#ifdef _WIN32
+      DWORD const flags{hint_ == access_hint::sequential
+                            ? FILE_FLAG_SEQUENTIAL_SCAN
+                        : hint_ == access_hint::random
+                            ? FILE_FLAG_RANDOM_ACCESS
+                            : FILE_ATTRIBUTE_NORMAL};
+      HANDLE const file{CreateFileW(path_.c_str(), GENERIC_READ,
+                                    FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    flags, nullptr)};
+      if (file == INVALID_HANDLE_VALUE) {
+         throw std::system_error(static_cast<int>(GetLastError()),
+                                 std::system_category(),
+                                 "Cannot open the file to map.");
+      }
+
+      LARGE_INTEGER size{};
+      if (!GetFileSizeEx(file, &size)) {
+         DWORD const error{GetLastError()};
+         CloseHandle(file);
+         throw std::system_error(static_cast<int>(error),
+                                 std::system_category(),
+                                 "Cannot get the size of the file to map.");
+      }
+
+      if (size.QuadPart == 0) {
+         CloseHandle(file);
+         return;
+      }
+
+      HANDLE const mapping{
+          CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+      CloseHandle(file);
+      if (mapping == nullptr) {
+         throw std::system_error(static_cast<int>(GetLastError()),
+                                 std::system_category(),
+                                 "Cannot map the file.");
+      }
+
+      void *const data{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+      DWORD const error{GetLastError()};
+      CloseHandle(mapping);
+      if (data == nullptr) {
+         throw std::system_error(static_cast<int>(error),
+                                 std::system_category(),
+                                 "Cannot map the file.");
+      }
+
+      m_data = static_cast<char const *>(data);
+      m_size = static_cast<size_type>(size.QuadPart);
+#else
+      int const file{::open(path_.c_str(), O_RDONLY | O_CLOEXEC)};
+      if (file < 0) {
+         throw std::system_error(errno, std::generic_category(),
+                                 "Cannot open the file to map.");
+      }
+
+      struct stat status {};
+      if (::fstat(file, &status) != 0) {
+         int const error{errno};
+         ::close(file);
+         throw std::system_error(error, std::generic_category(),
+                                 "Cannot get the size of the file to map.");
+      }
+
+      if (status.st_size == 0) {
+         ::close(file);
+         return;
+      }
+
+      size_type const size{static_cast<size_type>(status.st_size)};
+      void *const data{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0)};
+      int const error{errno};
+      ::close(file);
+      if (data == MAP_FAILED) {
+         throw std::system_error(error, std::generic_category(),
+                                 "Cannot map the file.");
+      }
+
+      m_data = static_cast<char const *>(data);
+      m_size = size;
+#endif /// _WIN32
+
+      advise(hint_);
+   }
+
+   /**
+    * @brief Releases the mapping, if any.
+    */
+   void unmap() noexcept {
+      if (m_data == nullptr) {
+         return;
+      }
+
+#ifdef _WIN32
+      UnmapViewOfFile(m_data);
+#else
+      ::munmap(const_cast<char *>(m_data), m_size);
+#endif /// _WIN32
+
+      m_data = nullptr;
+      m_size = 0;
+   }
+
+   char const *m_data; ///< The first mapped character, nullptr if none.
+   size_type m_size;   ///< The number of mapped characters.
+};
+
+} // namespace ext
+
+#endif // FSTRING_VIEW_HPP_
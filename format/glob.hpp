@@ -0,0 +1,493 @@
+/**
+ * @file glob.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A shell wildcard pattern compiled once and matched against paths.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The braces of a pattern are expanded when it is compiled, and each of the
+ * resulting alternatives is classified: a plain name is compared as a whole,
+ * "*.ext" only compares the end of the path and "name*" only its beginning.
+ * The other alternatives are matched segment by segment, backtracking only to
+ * the last '*' of a segment and to the last "**" of the path, so no
+ * alternative costs more than a pass over the path per wildcard.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef GLOB_HPP_
+#define GLOB_HPP_
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A compiled shell wildcard pattern.
+ *
+ * The syntax is '*' (any run of characters but '/'), '?' (any character but
+ * '/'), "[abc]", "[a-z]" and "[!abc]" (or "[^abc]") classes, "{a,b}"
+ * alternatives (which can nest), "**" as a whole segment (any number of
+ * segments, none included) and '\' to escape the next character. A pattern
+ * without '/' is matched against the last segment of a path, the file name;
+ * any other is matched against the whole path, with '/' as the separator.
+ */
+class glob {
+ public:
+   using size_type = std::size_t;
+
+   static constexpr size_type max_alternatives{1024}; ///< After expansion.
+
+   /**
+    * @brief Compiles a pattern.
+    *
+    * @param pattern_ The pattern.
+    * @throw std::invalid_argument if a brace or a bracket is not closed, a
+    * backslash ends the pattern, or the braces expand to more than
+    * max_alternatives alternatives.
+    */
+   explicit glob(std::string_view pattern_)
+       : m_pattern(pattern_),
+         m_basename(pattern_.find('/') == std::string_view::npos) {
+      std::vector<std::string> alternatives;
+      expand(std::string(pattern_), alternatives);
+
+      std::sort(alternatives.begin(), alternatives.end());
+      alternatives.erase(
+          std::unique(alternatives.begin(), alternatives.end()),
+          alternatives.end());
+
+      for (std::string const &alternative : alternatives) {
+         compile(alternative);
+      }
+   }
+
+   /**
+    * @brief Gets the pattern.
+    */
+   std::string_view pattern() const { return m_pattern; }
+
+   /**
+    * @brief Checks if a path matches the pattern.
+    *
+    * @param path_ The path, with '/' as the separator (e.g., an fstring or
+    * std::filesystem::path::generic_string()).
+    * @return True if the path matches, false otherwise.
+    */
+   bool match(std::string_view path_) const {
+      bool located{!m_basename};
+
+      for (alternative const &current : m_alternatives) {
+         // The end of a path is the end of its file name, so an extension
+         // is checked before the name is even located
+         if (!ends_with(path_, current.text_tail)) {
+            continue;
+         }
+         if (current.type == kind::suffix && m_basename) {
+            return true;
+         }
+
+         if (!located) {
+            size_type const slash{path_.rfind('/')};
+            if (slash != std::string_view::npos) {
+               path_.remove_prefix(slash + 1);
+            }
+            located = true;
+         }
+         if (matches(current, path_)) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /**
+    * @brief Checks if a path matches the pattern, as match() does, so that a
+    * glob can be used as a predicate.
+    */
+   bool operator()(std::string_view path_) const { return match(path_); }
+
+ private:
+   /**
+    * @brief How an alternative is matched.
+    */
+   enum class kind : unsigned char {
+      literal, ///< The path equals the text.
+      prefix,  ///< The path starts with the text, then has no '/'.
+      suffix,  ///< The path ends with the text, before which it has no '/'.
+      general, ///< The path matches the segments.
+   };
+
+   /**
+    * @brief The kinds of tokens of a segment.
+    */
+   enum class token_kind : unsigned char {
+      byte, ///< One given character.
+      any,  ///< Any character.
+      set,  ///< A character of a class.
+      star, ///< Any run of characters.
+   };
+
+   /**
+    * @brief A token of a segment.
+    */
+   struct token {
+      token_kind type;    ///< The kind of the token.
+      unsigned char byte; ///< The character of a byte token.
+      std::uint32_t set;  ///< Index of the class of a set token.
+   };
+
+   /**
+    * @brief A segment of a general alternative.
+    */
+   struct segment {
+      bool globstar;   ///< Whether the segment is "**".
+      size_type first; ///< First token.
+      size_type last;  ///< One past the last token.
+   };
+
+   /**
+    * @brief A compiled alternative.
+    */
+   struct alternative {
+      kind type;                     ///< How the alternative is matched.
+      std::string text;              ///< Text of the fast kinds.
+      std::string text_tail;         ///< Text every matching path ends with.
+      std::vector<segment> segments; ///< Segments of the general kind.
+   };
+
+   [[noreturn]] static void fail(char const *reason_) {
+      throw std::invalid_argument(std::string("Invalid glob: ") + reason_ +
+                                  ".");
+   }
+
+   /**
+    * @brief Finds the end of a bracket class.
+    *
+    * @param pos_ The position of the '['.
+    * @return The position of the closing ']'.
+    */
+   static size_type bracket_end(std::string_view pattern_, size_type pos_) {
+      size_type pos{pos_ + 1};
+      if (pos < pattern_.size() &&
+          (pattern_[pos] == '!' || pattern_[pos] == '^')) {
+         ++pos;
+      }
+      if (pos < pattern_.size() && pattern_[pos] == ']') {
+         ++pos;
+      }
+
+      for (; pos < pattern_.size(); ++pos) {
+         if (pattern_[pos] == '\\') {
+            ++pos;
+         } else if (pattern_[pos] == ']') {
+            return pos;
+         }
+      }
+      fail("missing ']'");
+   }
+
+   /**
+    * @brief Expands the braces of a pattern.
+    */
+   static void expand(std::string const &pattern_,
+                      std::vector<std::string> &out_) {
+      size_type open{std::string::npos};
+      std::vector<size_type> commas;
+      size_type depth{0};
+
+      for (size_type pos{0}; pos < pattern_.size(); ++pos) {
+         char const char_{pattern_[pos]};
+
+         if (char_ == '\\') {
+            if (++pos == pattern_.size()) {
+               fail("trailing backslash");
+            }
+         } else if (char_ == '[') {
+            pos = bracket_end(pattern_, pos);
+         } else if (char_ == '{') {
+            if (depth++ == 0) {
+               open = pos;
+            }
+         } else if (char_ == ',' && depth == 1) {
+            commas.push_back(pos);
+         } else if (char_ == '}' && depth != 0 && --depth == 0) {
+            std::string const head{pattern_.substr(0, open)};
+            std::string const tail{pattern_.substr(pos + 1)};
+            commas.push_back(pos);
+
+            size_type first{open + 1};
+            for (size_type const comma : commas) {
+               expand(head + pattern_.substr(first, comma - first) + tail,
+                      out_);
+               first = comma + 1;
+            }
+            return;
+         }
+      }
+
+      if (depth != 0) {
+         fail("missing '}'");
+      }
+      if (out_.size() == max_alternatives) {
+         fail("too many alternatives");
+      }
+      out_.push_back(pattern_);
+   }
+
+   /**
+    * @brief Compiles an alternative without braces.
+    */
+   void compile(std::string_view pattern_) {
+      alternative compiled{kind::general, std::string(), std::string(), {}};
+      std::vector<token> tokens;
+      size_type start{0};
+      size_type stars{0};
+      bool other{false};
+
+      for (size_type pos{0}; pos <= pattern_.size(); ++pos) {
+         char const char_{pos == pattern_.size() ? '/' : pattern_[pos]};
+
+         if (char_ == '/') {
+            // "**" alone is a globstar segment, elsewhere it is a '*'
+            bool const globstar{pattern_.substr(start, pos - start) == "**"};
+            compiled.segments.push_back(segment{
+                globstar, m_tokens.size(), m_tokens.size() + tokens.size()});
+            m_tokens.insert(m_tokens.end(), tokens.begin(), tokens.end());
+            tokens.clear();
+            start = pos + 1;
+         } else if (char_ == '*') {
+            if (tokens.empty() || tokens.back().type != token_kind::star) {
+               tokens.push_back(token{token_kind::star, 0, 0});
+               ++stars;
+            }
+         } else if (char_ == '?') {
+            tokens.push_back(token{token_kind::any, 0, 0});
+            other = true;
+         } else if (char_ == '[') {
+            size_type const end{bracket_end(pattern_, pos)};
+            tokens.push_back(token{token_kind::set, 0,
+                                   bracket(pattern_.substr(pos, end - pos))});
+            pos = end;
+            other = true;
+         } else {
+            if (char_ == '\\') {
+               ++pos;
+            }
+            tokens.push_back(token{token_kind::byte,
+                                   static_cast<unsigned char>(pattern_[pos]),
+                                   0});
+            compiled.text += pattern_[pos];
+         }
+      }
+
+      if (compiled.segments.size() == 1 && !other && stars <= 1) {
+         segment const &only{compiled.segments.front()};
+
+         if (stars == 0) {
+            compiled.type = kind::literal;
+         } else if (m_tokens[only.first].type == token_kind::star) {
+            compiled.type = kind::suffix;
+         } else if (m_tokens[only.last - 1].type == token_kind::star) {
+            compiled.type = kind::prefix;
+         }
+      }
+
+      segment const &last{compiled.segments.back()};
+      for (size_type index{last.last}; index != last.first &&
+                                       !last.globstar &&
+                                       m_tokens[index - 1].type ==
+                                           token_kind::byte;
+           --index) {
+         compiled.text_tail.insert(compiled.text_tail.begin(),
+                                   char(m_tokens[index - 1].byte));
+      }
+
+      if (compiled.type != kind::general) {
+         compiled.segments.clear();
+      }
+      m_alternatives.push_back(std::move(compiled));
+   }
+
+   /**
+    * @brief Compiles a bracket class, from the '[' to before the ']'.
+    *
+    * @return The index of the class.
+    */
+   std::uint32_t bracket(std::string_view class_) {
+      std::bitset<256> set;
+      size_type pos{1};
+      bool const negated{class_.size() > 1 &&
+                         (class_[1] == '!' || class_[1] == '^')};
+      if (negated) {
+         ++pos;
+      }
+
+      while (pos < class_.size()) {
+         if (class_[pos] == '\\') {
+            ++pos;
+         }
+         unsigned char const low{static_cast<unsigned char>(class_[pos++])};
+         unsigned char high{low};
+
+         if (pos + 1 < class_.size() && class_[pos] == '-') {
+            pos += class_[pos + 1] == '\\' ? 2 : 1;
+            high = static_cast<unsigned char>(class_[pos++]);
+         }
+
+         for (unsigned byte{low}; byte <= high; ++byte) {
+            set.set(byte);
+         }
+      }
+
+      if (negated) {
+         set.flip();
+      }
+      set.reset('/');
+
+      auto const found{std::find(m_sets.begin(), m_sets.end(), set)};
+      if (found != m_sets.end()) {
+         return static_cast<std::uint32_t>(found - m_sets.begin());
+      }
+      m_sets.push_back(set);
+      return static_cast<std::uint32_t>(m_sets.size() - 1);
+   }
+
+   /**
+    * @brief Checks if a text ends with another, comparing the last
+    * characters first.
+    */
+   static bool ends_with(std::string_view text_, std::string_view end_) {
+      return end_.empty() ||
+             (text_.size() >= end_.size() && text_.back() == end_.back() &&
+              std::memcmp(text_.data() + text_.size() - end_.size(),
+                          end_.data(), end_.size()) == 0);
+   }
+
+   /**
+    * @brief Checks if a path matches an alternative.
+    */
+   bool matches(alternative const &alternative_, std::string_view path_) const {
+      std::string const &text{alternative_.text};
+
+      switch (alternative_.type) {
+      case kind::literal:
+         return path_ == text;
+      case kind::suffix: // The end was checked by match()
+         return std::memchr(path_.data(), '/', path_.size() - text.size()) ==
+                nullptr;
+      case kind::prefix:
+         return path_.size() >= text.size() &&
+                std::memcmp(path_.data(), text.data(), text.size()) == 0 &&
+                std::memchr(path_.data() + text.size(), '/',
+                            path_.size() - text.size()) == nullptr;
+      case kind::general:
+         break;
+      }
+
+      std::vector<segment> const &segments{alternative_.segments};
+      size_type index{0};
+      size_type offset{0};
+      size_type star{std::string_view::npos};
+      size_type star_offset{0};
+
+      // Each path segment is consumed by one pattern segment or by the last
+      // "**", which takes one more segment whenever a later one fails
+      while (offset <= path_.size()) {
+         size_type end{path_.find('/', offset)};
+         if (end == std::string_view::npos) {
+            end = path_.size();
+         }
+
+         if (index != segments.size() && segments[index].globstar) {
+            star = index++;
+            star_offset = offset;
+            continue;
+         }
+         if (index != segments.size() &&
+             matches(segments[index], path_.substr(offset, end - offset))) {
+            ++index;
+            offset = end + 1;
+            continue;
+         }
+         if (star == std::string_view::npos) {
+            return false;
+         }
+
+         index = star + 1;
+         size_type const next{path_.find('/', star_offset)};
+         star_offset = next == std::string_view::npos ? path_.size() + 1
+                                                      : next + 1;
+         offset = star_offset;
+      }
+
+      while (index != segments.size() && segments[index].globstar) {
+         ++index;
+      }
+      return index == segments.size();
+   }
+
+   /**
+    * @brief Checks if a path segment matches a pattern segment.
+    */
+   bool matches(segment const &segment_, std::string_view text_) const {
+      size_type current{segment_.first};
+      size_type index{0};
+      size_type star{std::string_view::npos};
+      size_type star_index{0};
+
+      while (index != text_.size()) {
+         if (current != segment_.last) {
+            token const &next{m_tokens[current]};
+            unsigned char const char_{
+                static_cast<unsigned char>(text_[index])};
+
+            if (next.type == token_kind::star) {
+               star = current++;
+               star_index = index;
+               continue;
+            }
+            if ((next.type == token_kind::byte && next.byte == char_) ||
+                next.type == token_kind::any ||
+                (next.type == token_kind::set && m_sets[next.set][char_])) {
+               ++current;
+               ++index;
+               continue;
+            }
+         }
+         if (star == std::string_view::npos) {
+            return false;
+         }
+
+         current = star + 1;
+         index = ++star_index;
+      }
+
+      while (current != segment_.last &&
+             m_tokens[current].type == token_kind::star) {
+         ++current;
+      }
+      return current == segment_.last;
+   }
+
+   std::string m_pattern;                   ///< The pattern.
+   bool m_basename;                         ///< Matches file names only.
+   std::vector<alternative> m_alternatives; ///< The expanded alternatives.
+   std::vector<token> m_tokens;             ///< Tokens of every segment.
+   std::vector<std::bitset<256>> m_sets;    ///< The bracket classes.
+};
+
+} // namespace ext
+
+#endif // GLOB_HPP_
@@ -0,0 +1,176 @@
+/**
+ * @file hash.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A fast non-cryptographic hash of bytes.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * hash_bytes() follows the design of wyhash: the input is read 8 bytes at a
+ * time and every pair of words is folded with a 64x64 to 128-bit multiply, so
+ * short keys take a handful of instructions and long ones run at several
+ * bytes per cycle. It is meant for hash tables, not for security or for
+ * storage: the values depend on the byte order of the machine and may change
+ * between versions.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef HASH_HPP_
+#define HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Wyhash namespace
+ *
+ * This namespace holds the steps of hash_bytes().
+ */
+namespace wy {
+/**
+ * @brief The constants mixed into the state, odd and with half of their bits
+ * set.
+ */
+constexpr std::uint64_t secret[4]{0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                  0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+/**
+ * @brief Multiplies two words into 128 bits.
+ *
+ * @param low_ The first word, receives the low half of the product.
+ * @param high_ The second word, receives the high half of the product.
+ */
+inline void multiply(std::uint64_t &low_, std::uint64_t &high_) {
+#if defined(__SIZEOF_INT128__)
+   __extension__ typedef unsigned __int128 uint128;
+   uint128 const product{static_cast<uint128>(low_) * high_};
+   low_ = static_cast<std::uint64_t>(product);
+   high_ = static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+   low_ = _umul128(low_, high_, &high_);
+#else
+   std::uint64_t const a_high{low_ >> 32};
+   std::uint64_t const a_low{low_ & 0xFFFFFFFFu};
+   std::uint64_t const b_high{high_ >> 32};
+   std::uint64_t const b_low{high_ & 0xFFFFFFFFu};
+   std::uint64_t const high_high{a_high * b_high};
+   std::uint64_t const high_low{a_high * b_low};
+   std::uint64_t const low_high{a_low * b_high};
+   std::uint64_t const low_low{a_low * b_low};
+   std::uint64_t const middle{(low_low >> 32) + (high_low & 0xFFFFFFFFu) +
+                              (low_high & 0xFFFFFFFFu)};
+
+   low_ = (middle << 32) | (low_low & 0xFFFFFFFFu);
+   high_ = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+#endif
+}
+
+/**
+ * @brief Folds two words into one through their 128-bit product.
+ */
+inline std::uint64_t mix(std::uint64_t a_, std::uint64_t b_) {
+   multiply(a_, b_);
+   return a_ ^ b_;
+}
+
+/**
+ * @brief Reads 8 bytes in the byte order of the machine.
+ */
+inline std::uint64_t read8(unsigned char const *data_) {
+   std::uint64_t word;
+   std::memcpy(&word, data_, sizeof(word));
+   return word;
+}
+
+/**
+ * @brief Reads 4 bytes in the byte order of the machine.
+ */
+inline std::uint64_t read4(unsigned char const *data_) {
+   std::uint32_t word;
+   std::memcpy(&word, data_, sizeof(word));
+   return word;
+}
+
+/**
+ * @brief Reads 1 to 3 bytes: the first, the middle and the last one.
+ */
+inline std::uint64_t read3(unsigned char const *data_, std::size_t size_) {
+   return (std::uint64_t{data_[0]} << 16) |
+          (std::uint64_t{data_[size_ >> 1]} << 8) | data_[size_ - 1];
+}
+} // namespace wy
+
+/**
+ * @brief Hashes bytes.
+ *
+ * @param data_ The bytes.
+ * @param size_ The number of bytes.
+ * @param seed_ A value that changes every hash (default is 0).
+ * @return The hash.
+ */
+inline std::uint64_t hash_bytes(void const *data_, std::size_t size_,
+                                std::uint64_t seed_ = 0) {
+   unsigned char const *it{static_cast<unsigned char const *>(data_)};
+   std::uint64_t seed{seed_ ^ wy::mix(seed_ ^ wy::secret[0], wy::secret[1])};
+   std::uint64_t a{0};
+   std::uint64_t b{0};
+
+   if (size_ <= 16) {
+      if (size_ >= 4) {
+         std::size_t const middle{(size_ >> 3) << 2};
+         a = (wy::read4(it) << 32) | wy::read4(it + middle);
+         b = (wy::read4(it + size_ - 4) << 32) |
+             wy::read4(it + size_ - 4 - middle);
+      } else if (size_ != 0) {
+         a = wy::read3(it, size_);
+      }
+   } else {
+      std::size_t left{size_};
+
+      if (left > 48) {
+         // Three independent lanes keep the multipliers busy
+         std::uint64_t second{seed};
+         std::uint64_t third{seed};
+         do {
+            seed = wy::mix(wy::read8(it) ^ wy::secret[1],
+                           wy::read8(it + 8) ^ seed);
+            second = wy::mix(wy::read8(it + 16) ^ wy::secret[2],
+                             wy::read8(it + 24) ^ second);
+            third = wy::mix(wy::read8(it + 32) ^ wy::secret[3],
+                            wy::read8(it + 40) ^ third);
+            it += 48;
+            left -= 48;
+         } while (left > 48);
+         seed ^= second ^ third;
+      }
+
+      while (left > 16) {
+         seed = wy::mix(wy::read8(it) ^ wy::secret[1],
+                        wy::read8(it + 8) ^ seed);
+         it += 16;
+         left -= 16;
+      }
+
+      // The last 16 bytes, which may overlap the ones already read
+      a = wy::read8(it + left - 16);
+      b = wy::read8(it + left - 8);
+   }
+
+   a ^= wy::secret[1];
+   b ^= seed;
+   wy::multiply(a, b);
+   return wy::mix(a ^ wy::secret[0] ^ size_, b ^ wy::secret[1]);
+}
+} // namespace ext
+
+#endif // HASH_HPP_
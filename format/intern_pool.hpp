@@ -0,0 +1,380 @@
+/**
+ * @file intern_pool.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A thread-safe pool of unique strings with cached hashes.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * Interning a string stores it once in the pool and returns a handle, a
+ * single pointer to the stored copy and its hash. Two handles of the same
+ * pool are equal if and only if their texts are, so keys that are hashed and
+ * compared over and over, such as file extensions or option names, compare
+ * with one pointer comparison and hash with one load. The texts live in large
+ * blocks that never move, so handles and their views stay valid as long as
+ * the pool. The pool is split into shards, each with its own lock, table and
+ * blocks, chosen by the hash, so threads interning different strings rarely
+ * wait for each other.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef INTERN_POOL_HPP_
+#define INTERN_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "hash.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A sharded, thread-safe pool of unique strings.
+ */
+class intern_pool {
+   /**
+    * @brief The header of a stored text, which follows it with a null
+    * character.
+    */
+   struct entry {
+      std::uint64_t hash; ///< The hash of the text (see hash_bytes()).
+      std::size_t size;   ///< The number of characters of the text.
+   };
+
+ public:
+   using size_type = std::size_t;
+
+   /**
+    * @brief A handle to an interned string.
+    *
+    * The default handle is the empty string, which is the same in every
+    * pool; handles of other strings from different pools are never equal.
+    */
+   class handle {
+    public:
+      /**
+       * @brief Default constructor, creates a handle to the empty string.
+       */
+      handle() : m_entry(empty_entry()) {}
+
+      /**
+       * @brief Gets the characters, followed by a null character.
+       */
+      char const *data() const {
+         return reinterpret_cast<char const *>(m_entry + 1);
+      }
+
+      /**
+       * @brief Gets the characters as a null-terminated string.
+       */
+      char const *c_str() const { return data(); }
+
+      /**
+       * @brief Gets the number of characters.
+       */
+      size_type size() const { return m_entry->size; }
+
+      /**
+       * @brief Checks if the string is empty.
+       */
+      bool empty() const { return m_entry->size == 0; }
+
+      /**
+       * @brief Gets the hash of the string, computed once when it was
+       * interned. It equals hash_bytes() of the characters, and so the
+       * hash() of an fstring with them.
+       */
+      std::uint64_t hash() const { return m_entry->hash; }
+
+      /**
+       * @brief Gets a view of the characters.
+       */
+      std::string_view view() const { return {data(), m_entry->size}; }
+
+      /**
+       * @brief Converts to a view of the characters.
+       */
+      operator std::string_view() const { return view(); }
+
+      /**
+       * @brief Checks if two handles are the same string, comparing
+       * pointers.
+       */
+      friend bool operator==(handle lhs_, handle rhs_) {
+         return lhs_.m_entry == rhs_.m_entry;
+      }
+
+      /**
+       * @brief Checks if two handles are different strings, comparing
+       * pointers.
+       */
+      friend bool operator!=(handle lhs_, handle rhs_) {
+         return lhs_.m_entry != rhs_.m_entry;
+      }
+
+    private:
+      friend class intern_pool;
+
+      /**
+       * @brief Constructs a handle to a stored text.
+       */
+      explicit handle(entry const *entry_) : m_entry(entry_) {}
+
+      entry const *m_entry; ///< The stored text.
+   };
+
+   /**
+    * @brief Constructs an empty pool.
+    *
+    * @param shards_ The number of shards, rounded up to a power of two (default
+    * is 16). More shards let more threads intern at the same time.
+    */
+   explicit intern_pool(size_type shards_ = 16) {
+      while (m_shard_count < shards_) {
+         m_shard_count *= 2;
+      }
+      while ((size_type{1} << m_shard_bits) < m_shard_count) {
+         ++m_shard_bits;
+      }
+      m_shards.reset(new shard[m_shard_count]);
+   }
+
+   intern_pool(intern_pool const &) = delete;
+   intern_pool &operator=(intern_pool const &) = delete;
+
+   /**
+    * @brief Interns a string, storing it if it is not in the pool yet.
+    *
+    * @param text_ The string.
+    * @return The handle of the stored string.
+    */
+   handle intern(std::string_view text_) {
+      if (text_.empty()) {
+         return handle();
+      }
+
+      std::uint64_t const hash{hash_bytes(text_.data(), text_.size())};
+      shard &owner{shard_of(hash)};
+      std::lock_guard<std::mutex> const lock{owner.mutex};
+
+      slot *const found{owner.find(text_, hash)};
+      if (found->stored != nullptr) {
+         return handle(found->stored);
+      }
+
+      entry const *const stored{owner.store(text_, hash)};
+      *found = slot{hash, stored};
+      owner.grow_if_full(); // Moves the slots
+      return handle(stored);
+   }
+
+   /**
+    * @brief Finds a string without storing it.
+    *
+    * @param text_ The string.
+    * @return The handle of the string, or std::nullopt if it was never
+    * interned.
+    */
+   std::optional<handle> find(std::string_view text_) const {
+      if (text_.empty()) {
+         return handle();
+      }
+
+      std::uint64_t const hash{hash_bytes(text_.data(), text_.size())};
+      shard &owner{shard_of(hash)};
+      std::lock_guard<std::mutex> const lock{owner.mutex};
+
+      slot const *const found{owner.find(text_, hash)};
+      if (found->stored == nullptr) {
+         return std::nullopt;
+      }
+      return handle(found->stored);
+   }
+
+   /**
+    * @brief Gets the number of strings in the pool, not counting the empty
+    * string.
+    */
+   size_type size() const {
+      size_type count{0};
+      for (size_type index{0}; index != m_shard_count; ++index) {
+         std::lock_guard<std::mutex> const lock{m_shards[index].mutex};
+         count += m_shards[index].count;
+      }
+      return count;
+   }
+
+   /**
+    * @brief Gets the number of bytes allocated for the strings and their
+    * tables.
+    */
+   size_type allocated() const {
+      size_type bytes{0};
+      for (size_type index{0}; index != m_shard_count; ++index) {
+         std::lock_guard<std::mutex> const lock{m_shards[index].mutex};
+         bytes += m_shards[index].allocated +
+                  m_shards[index].slots.capacity() * sizeof(slot);
+      }
+      return bytes;
+   }
+
+ private:
+   /**
+    * @brief Gets the stored empty string.
+    */
+   static entry const *empty_entry() {
+      struct empty_text {
+         entry header;
+         char text[alignof(entry)];
+      };
+      static empty_text const empty{{hash_bytes(nullptr, 0), 0}, {}};
+      return &empty.header;
+   }
+
+   /**
+    * @brief A slot of the table of a shard.
+    */
+   struct slot {
+      std::uint64_t hash{0};        ///< The hash of the stored text.
+      entry const *stored{nullptr}; ///< The stored text, or null if free.
+   };
+
+   /**
+    * @brief A part of the pool, with its own lock, table and blocks. Shards
+    * take whole cache lines so that their locks do not share one.
+    */
+   struct alignas(64) shard {
+      static constexpr size_type block_size{1 << 16};
+
+      mutable std::mutex mutex;                    ///< Guards the shard.
+      std::vector<slot> slots{16};                 ///< The table.
+      size_type count{0};                          ///< Stored texts.
+      std::vector<std::unique_ptr<char[]>> blocks; ///< Storage of the texts.
+      char *free{nullptr};                         ///< Free space in a block.
+      size_type left{0};                           ///< Bytes of that space.
+      size_type allocated{0};                      ///< Bytes of the blocks.
+
+      /**
+       * @brief Finds the slot of a text, or the free slot where it goes.
+       */
+      slot *find(std::string_view text_, std::uint64_t hash_) {
+         size_type const mask{slots.size() - 1};
+         for (size_type index{static_cast<size_type>(hash_) & mask};;
+              index = (index + 1) & mask) {
+            slot &current{slots[index]};
+            if (current.stored == nullptr ||
+                (current.hash == hash_ &&
+                 current.stored->size == text_.size() &&
+                 std::memcmp(current.stored + 1, text_.data(),
+                             text_.size()) == 0)) {
+               return &current;
+            }
+         }
+      }
+
+      /**
+       * @brief Copies a text into the blocks.
+       */
+      entry const *store(std::string_view text_, std::uint64_t hash_) {
+         // The header, the text and its null character, padded so that the
+         // next header is aligned
+         size_type const size{(sizeof(entry) + text_.size() + alignof(entry)) &
+                              ~(alignof(entry) - 1)};
+
+         if (size > left) {
+            // Long texts take a block of their own and keep the current one
+            size_type const new_size{size > block_size / 4 ? size
+                                                           : block_size};
+            blocks.emplace_back(new char[new_size]);
+            allocated += new_size;
+            if (new_size == block_size) {
+               free = blocks.back().get();
+               left = block_size;
+            } else {
+               return place(blocks.back().get(), text_, hash_);
+            }
+         }
+
+         entry const *const stored{place(free, text_, hash_)};
+         free += size;
+         left -= size;
+         return stored;
+      }
+
+      /**
+       * @brief Writes a header and a text.
+       */
+      static entry const *place(char *where_, std::string_view text_,
+                                std::uint64_t hash_) {
+         entry *const header{new (where_) entry{hash_, text_.size()}};
+         char *const text{reinterpret_cast<char *>(header + 1)};
+         std::memcpy(text, text_.data(), text_.size());
+         text[text_.size()] = '\0';
+         return header;
+      }
+
+      /**
+       * @brief Counts a stored text and doubles the table when it is half
+       * full, so that probes stay short.
+       */
+      void grow_if_full() {
+         if (++count * 2 <= slots.size()) {
+            return;
+         }
+
+         std::vector<slot> grown(slots.size() * 2);
+         size_type const mask{grown.size() - 1};
+         for (slot const &current : slots) {
+            if (current.stored != nullptr) {
+               size_type index{static_cast<size_type>(current.hash) & mask};
+               while (grown[index].stored != nullptr) {
+                  index = (index + 1) & mask;
+               }
+               grown[index] = current;
+            }
+         }
+         slots.swap(grown);
+      }
+   };
+
+   /**
+    * @brief Gets the shard of a hash, from its high bits; the low bits pick
+    * the slot.
+    */
+   shard &shard_of(std::uint64_t hash_) const {
+      if (m_shard_bits == 0) {
+         return m_shards[0];
+      }
+      return m_shards[static_cast<size_type>(hash_ >> (64 - m_shard_bits))];
+   }
+
+   size_type m_shard_count{1};        ///< The number of shards.
+   unsigned m_shard_bits{0};          ///< The bits that pick a shard.
+   std::unique_ptr<shard[]> m_shards; ///< The shards.
+};
+
+} // namespace ext
+
+namespace std {
+/**
+ * @brief Hashes an interned string by its cached hash.
+ */
+template <> struct hash<ext::intern_pool::handle> {
+   std::size_t operator()(ext::intern_pool::handle handle_) const noexcept {
+      return static_cast<std::size_t>(handle_.hash());
+   }
+};
+} // namespace std
+
+#endif // INTERN_POOL_HPP_
@@ -0,0 +1,503 @@
+/**
+ * @file layout.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A streaming word-wrap and alignment engine for whole documents.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The engine reads a text (or a stream) one paragraph at a time, where a
+ * paragraph is a line of the input, and yields the wrapped lines lazily. Each
+ * line is written into a buffer that is reused for the next one, so laying
+ * out a document costs time linear in its size and no allocation per line
+ * once the buffers have grown. Words are measured in display columns (escape
+ * sequences take none, wide characters take two) once, when they are read,
+ * and the planner reuses those widths on every pass.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef LAYOUT_HPP_
+#define LAYOUT_HPP_
+
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "width.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief How a line is placed inside its width, as in fstring::align_*.
+ */
+enum class align_mode {
+   left,    ///< Padding on the right.
+   center,  ///< Padding split between both sides (the extra one on the right).
+   right,   ///< Padding on the left.
+   justify, ///< Padding spread between the words.
+};
+
+/**
+ * @brief How words are distributed between lines.
+ */
+enum class wrap_mode {
+   greedy,         ///< Fill each line as much as possible.
+   min_raggedness, ///< Minimize the squared slack of all lines but the last.
+};
+
+/**
+ * @brief Lays out a text into lines of a fixed width.
+ *
+ * Words are runs of characters between separators. Words longer than the
+ * width are broken into pieces of the width. Every line is padded to the
+ * width according to the alignment; with align_mode::justify, the last line
+ * of each paragraph is aligned to the left.
+ *
+ * @tparam CharType The character type used in the text.
+ */
+template <typename CharType = char> class basic_layout {
+ public:
+   using string_type = std::basic_string<CharType>;
+   using view_type = std::basic_string_view<CharType>;
+   using size_type = typename string_type::size_type;
+
+   /**
+    * @brief Single-pass input iterator over the lines of a layout.
+    */
+   class iterator {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = string_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = string_type const *;
+      using reference = string_type const &;
+
+      /**
+       * @brief Default constructor, equal to the end iterator.
+       */
+      iterator() : m_layout(nullptr) {}
+
+      /**
+       * @brief Gets the current line.
+       *
+       * @return A reference to the line, valid until the next increment.
+       */
+      reference operator*() const { return m_layout->m_line; }
+
+      /**
+       * @brief Gets the current line.
+       *
+       * @return A pointer to the line, valid until the next increment.
+       */
+      pointer operator->() const { return &m_layout->m_line; }
+
+      /**
+       * @brief Moves to the next line.
+       *
+       * @return A reference to this iterator.
+       */
+      iterator &operator++() {
+         if (!m_layout->next(m_layout->m_line)) {
+            m_layout = nullptr;
+         }
+         return *this;
+      }
+
+      /**
+       * @brief Checks if two iterators are both at the end or both not.
+       *
+       * @param rhs_ The iterator to compare with.
+       * @return True if they are equal, false otherwise.
+       */
+      bool operator==(iterator const &rhs_) const {
+         return m_layout == rhs_.m_layout;
+      }
+
+      /**
+       * @brief Checks if two iterators are different.
+       *
+       * @param rhs_ The iterator to compare with.
+       * @return True if they are different, false otherwise.
+       */
+      bool operator!=(iterator const &rhs_) const { return !(*this == rhs_); }
+
+    private:
+      friend class basic_layout;
+
+      /**
+       * @brief Constructs an iterator at the next line of a layout.
+       *
+       * @param layout_ The layout being iterated.
+       */
+      explicit iterator(basic_layout *layout_) : m_layout(layout_) {
+         ++*this;
+      }
+
+      basic_layout *m_layout; ///< The layout, nullptr at the end.
+   };
+
+   /**
+    * @brief Constructs a layout over a text.
+    *
+    * @param text_ The text, which must outlive the layout.
+    * @param width_ The width of the lines.
+    * @param align_ How lines are aligned (default is align_mode::left).
+    * @param wrap_ How words are distributed (default is wrap_mode::greedy).
+    * @param separator_ The character between words, which also pads the
+    * lines (default is a space).
+    * @throw std::invalid_argument if the width is 0.
+    */
+   basic_layout(view_type text_, size_type width_,
+                align_mode align_ = align_mode::left,
+                wrap_mode wrap_ = wrap_mode::greedy,
+                CharType separator_ = CharType(' '))
+       : m_source(text_), m_stream(nullptr) {
+      setup(width_, align_, wrap_, separator_);
+   }
+
+   /**
+    * @brief Constructs a layout over a stream, read one line at a time.
+    *
+    * @param stream_ The input stream, which must outlive the layout.
+    * @param width_ The width of the lines.
+    * @param align_ How lines are aligned (default is align_mode::left).
+    * @param wrap_ How words are distributed (default is wrap_mode::greedy).
+    * @param separator_ The character between words, which also pads the
+    * lines (default is a space).
+    * @throw std::invalid_argument if the width is 0.
+    */
+   basic_layout(std::basic_istream<CharType> &stream_, size_type width_,
+                align_mode align_ = align_mode::left,
+                wrap_mode wrap_ = wrap_mode::greedy,
+                CharType separator_ = CharType(' '))
+       : m_source(), m_stream(&stream_) {
+      setup(width_, align_, wrap_, separator_);
+   }
+
+   /**
+    * @brief Gets an iterator to the next line. The layout is consumed as it is
+    * iterated, so begin() may only be called once.
+    *
+    * @return An iterator to the next line, or end() if there is none.
+    */
+   iterator begin() { return iterator(this); }
+
+   /**
+    * @brief Gets the past-the-end iterator.
+    *
+    * @return The past-the-end iterator.
+    */
+   iterator end() { return iterator(); }
+
+   /**
+    * @brief Writes the next line.
+    *
+    * @param line_ The string that receives the line (its contents are
+    * replaced, its capacity is reused).
+    * @return True if a line was written, false at the end of the text.
+    */
+   bool next(string_type &line_) {
+      if (!m_in_paragraph) {
+         if (!load_paragraph()) {
+            return false;
+         }
+
+         m_pos = 0;
+         m_word = 0;
+
+         if (find_word(0) == view_type::npos) {
+            m_words.clear();
+            render(line_, 0, 0, 0, true);
+            return true;
+         }
+
+         if (m_wrap == wrap_mode::min_raggedness) {
+            plan();
+         }
+
+         m_in_paragraph = true;
+      }
+
+      if (m_wrap == wrap_mode::min_raggedness) {
+         size_type const first{m_word};
+         size_type const last{m_next[first]};
+         m_word = last;
+         m_in_paragraph = last != m_words.size();
+         render(line_, first, last, line_size(first, last), !m_in_paragraph);
+         return true;
+      }
+
+      m_words.clear();
+      size_type size{0};
+
+      for (size_type first{find_word(m_pos)}; first != view_type::npos;
+           first = find_word(m_pos)) {
+         size_type last{m_paragraph.find(m_separator, first)};
+         if (last == view_type::npos) {
+            last = m_paragraph.size();
+         }
+
+         word const current{measure(first, last)};
+         size_type const needed{m_words.empty()
+                                    ? current.width
+                                    : size + 1 + current.width};
+
+         if (needed <= m_width) {
+            m_words.push_back(current);
+            size = needed;
+            m_pos = last;
+         } else if (m_words.empty()) {
+            m_words.push_back(piece(first, last));
+            size = m_words.back().width;
+            m_pos = first + m_words.back().size;
+            break;
+         } else {
+            break;
+         }
+      }
+
+      m_in_paragraph = find_word(m_pos) != view_type::npos;
+      render(line_, 0, m_words.size(), size, !m_in_paragraph);
+      return true;
+   }
+
+ private:
+   /**
+    * @brief Stores the settings shared by the constructors.
+    */
+   void setup(size_type width_, align_mode align_, wrap_mode wrap_,
+              CharType separator_) {
+      if (width_ == 0) {
+         throw std::invalid_argument("The layout width must be positive.");
+      }
+
+      m_source_pos = 0;
+      m_pos = 0;
+      m_word = 0;
+      m_in_paragraph = false;
+      m_width = width_;
+      m_align = align_;
+      m_wrap = wrap_;
+      m_separator = separator_;
+   }
+
+   /**
+    * @brief Moves to the next paragraph of the input.
+    *
+    * @return True if there is a paragraph, false at the end of the input.
+    */
+   bool load_paragraph() {
+      if (m_stream != nullptr) {
+         if (!std::getline(*m_stream, m_buffer)) {
+            return false;
+         }
+         m_paragraph = m_buffer;
+      } else {
+         if (m_source_pos >= m_source.size()) {
+            return false;
+         }
+
+         size_type end{m_source.find(CharType('\n'), m_source_pos)};
+         if (end == view_type::npos) {
+            end = m_source.size();
+         }
+
+         m_paragraph = m_source.substr(m_source_pos, end - m_source_pos);
+         m_source_pos = end + 1;
+      }
+
+      if (!m_paragraph.empty() && m_paragraph.back() == CharType('\r')) {
+         m_paragraph.remove_suffix(1);
+      }
+
+      return true;
+   }
+
+   /**
+    * @brief Finds the start of the next word of the paragraph.
+    */
+   size_type find_word(size_type pos_) const {
+      return m_paragraph.find_first_not_of(m_separator, pos_);
+   }
+
+   /**
+    * @brief The bounds of a word in the paragraph, and its width.
+    */
+   struct word {
+      size_type first; ///< Start of the word.
+      size_type size;  ///< Number of characters.
+      size_type width; ///< Display width.
+   };
+
+   /**
+    * @brief Measures the word between two positions of the paragraph.
+    */
+   word measure(size_type first_, size_type last_) const {
+      return word{first_, last_ - first_,
+                  display_width(m_paragraph.substr(first_, last_ - first_))};
+   }
+
+   /**
+    * @brief Gets the longest start of a word that fits in the width, at least
+    * one character long.
+    */
+   word piece(size_type first_, size_type last_) const {
+      view_type const text{m_paragraph.substr(first_, last_ - first_)};
+      size_type size{display_prefix(text, m_width)};
+
+      if (size == 0) {
+         CharType const *next{text.data()};
+         if (utf::decode(next, text.data() + text.size()) == utf::invalid) {
+            ++next;
+         }
+         size = static_cast<size_type>(next - text.data());
+      }
+
+      return word{first_, size, display_width(text.substr(0, size))};
+   }
+
+   /**
+    * @brief Gets the width of a line made of a range of words.
+    */
+   size_type line_size(size_type first_, size_type last_) const {
+      size_type size{last_ - first_ - 1};
+      for (size_type index{first_}; index != last_; ++index) {
+         size += m_words[index].width;
+      }
+      return size;
+   }
+
+   /**
+    * @brief Chooses the line breaks of the whole paragraph that minimize the
+    * sum of the squared slack of every line but the last.
+    */
+   void plan() {
+      m_words.clear();
+
+      for (size_type first{find_word(0)}; first != view_type::npos;
+           first = find_word(first)) {
+         size_type last{m_paragraph.find(m_separator, first)};
+         if (last == view_type::npos) {
+            last = m_paragraph.size();
+         }
+
+         for (word current{measure(first, last)};;
+              current = measure(first, last)) {
+            if (current.width <= m_width) {
+               m_words.push_back(current);
+               break;
+            }
+            m_words.push_back(piece(first, last));
+            first += m_words.back().size;
+         }
+         first = last;
+      }
+
+      size_type const count{m_words.size()};
+      m_cost.assign(count + 1, 0);
+      m_next.assign(count + 1, count);
+
+      for (size_type first{count}; first-- != 0;) {
+         unsigned long long best{std::numeric_limits<unsigned long long>::max()};
+         size_type size{0};
+
+         for (size_type last{first}; last != count; ++last) {
+            size += (last != first) + m_words[last].width;
+            // A character wider than the whole line gets a line of its own
+            if (size > m_width && last != first) {
+               break;
+            }
+
+            unsigned long long const slack{size < m_width ? m_width - size
+                                                          : 0};
+            unsigned long long const cost{
+                (last + 1 == count ? 0 : slack * slack) + m_cost[last + 1]};
+
+            if (cost < best) {
+               best = cost;
+               m_next[first] = last + 1;
+            }
+         }
+
+         m_cost[first] = best;
+      }
+   }
+
+   /**
+    * @brief Writes a range of words padded to the width.
+    *
+    * @param line_ The string that receives the line.
+    * @param first_ The first word of the line.
+    * @param last_ One past the last word of the line.
+    * @param size_ The width of the words joined by single separators.
+    * @param last_line_ Whether this is the last line of the paragraph.
+    */
+   void render(string_type &line_, size_type first_, size_type last_,
+               size_type size_, bool last_line_) const {
+      size_type const padding{size_ < m_width ? m_width - size_ : 0};
+      size_type const gaps{last_ - first_ > 1 ? last_ - first_ - 1 : 0};
+
+      line_.clear();
+
+      size_type before{0};
+      if (m_align == align_mode::right) {
+         before = padding;
+      } else if (m_align == align_mode::center) {
+         before = padding / 2;
+      }
+
+      bool const justify{m_align == align_mode::justify && !last_line_ &&
+                         gaps != 0};
+
+      line_.append(before, m_separator);
+
+      for (size_type index{first_}; index != last_; ++index) {
+         if (index != first_) {
+            size_type spaces{1};
+            if (justify) {
+               size_type const gap{index - first_ - 1};
+               spaces += padding / gaps + (gap < padding % gaps);
+            }
+            line_.append(spaces, m_separator);
+         }
+
+         line_.append(m_paragraph, m_words[index].first, m_words[index].size);
+      }
+
+      if (!justify) {
+         line_.append(padding - before, m_separator);
+      }
+   }
+
+   view_type m_source;                     ///< The text, if not a stream.
+   size_type m_source_pos;                 ///< Start of the next paragraph.
+   std::basic_istream<CharType> *m_stream; ///< The stream, if any.
+   string_type m_buffer;                   ///< The paragraph read from stream.
+   view_type m_paragraph;                  ///< The current paragraph.
+   size_type m_pos;                        ///< Next character (greedy).
+   size_type m_word;                       ///< Next word (min_raggedness).
+   bool m_in_paragraph;                    ///< Whether words remain.
+   size_type m_width;                      ///< The width of the lines.
+   align_mode m_align;                     ///< How lines are aligned.
+   wrap_mode m_wrap;                       ///< How words are distributed.
+   CharType m_separator;                   ///< The character between words.
+   std::vector<word> m_words;              ///< The measured words.
+   std::vector<unsigned long long> m_cost; ///< Best cost from each word.
+   std::vector<size_type> m_next;          ///< Best break after each word.
+   string_type m_line;                     ///< The line seen by iterators.
+};
+
+using layout = basic_layout<char>; ///< Layout of char text.
+
+} // namespace ext
+
+#endif // LAYOUT_HPP_
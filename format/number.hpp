@@ -0,0 +1,370 @@
+/**
+ * @file number.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Locale-free parsing of numbers, sizes and durations.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * Numbers are read with std::from_chars, so there is no locale, no stream and
+ * no allocation, and the whole text must be the number: surrounding spaces
+ * and a leading '+' are accepted, anything else is an error. Errors are
+ * reported as std::errc values, as std::from_chars does. Sizes ("10G",
+ * "512KiB", "1.5MB") and durations ("250ms", "1h30m") add a unit after the
+ * number.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef NUMBER_HPP_
+#define NUMBER_HPP_
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "utf.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Number parsing namespace
+ *
+ * This namespace holds the parsers behind fstring::parse(), try_parse(),
+ * parse_size(), parse_duration() and parse_all().
+ */
+namespace num {
+using size_type = std::size_t;
+
+/**
+ * @brief Removes the spaces and tabs around a text.
+ */
+inline std::string_view trimmed(std::string_view text_) {
+   size_type first{0};
+   size_type last{text_.size()};
+
+   while (first != last && (text_[first] == ' ' || text_[first] == '\t')) {
+      ++first;
+   }
+   while (last != first &&
+          (text_[last - 1] == ' ' || text_[last - 1] == '\t')) {
+      --last;
+   }
+
+   return text_.substr(first, last - first);
+}
+
+/**
+ * @brief Copies a text of wider code units to bytes.
+ *
+ * @param text_ The text.
+ * @param out_ Receives the bytes.
+ * @return False if a code unit is not ASCII, which no number contains.
+ */
+template <typename CharType>
+bool to_ascii(std::basic_string_view<CharType> text_, std::string &out_) {
+   out_.resize(text_.size());
+
+   for (size_type index{0}; index != text_.size(); ++index) {
+      char32_t const unit{utf::unit(text_[index])};
+      if (unit >= 0x80) {
+         return false;
+      }
+      out_[index] = static_cast<char>(unit);
+   }
+
+   return true;
+}
+
+/**
+ * @brief Reads a number that is the whole text.
+ *
+ * @param text_ The text.
+ * @param value_ Receives the number; it is left unchanged on error.
+ * @param read_ Reads the number, as std::from_chars does.
+ */
+template <class Type, class Read>
+std::errc read_whole(std::string_view text_, Type &value_, Read read_) {
+   text_ = trimmed(text_);
+   if (!text_.empty() && text_[0] == '+') {
+      text_.remove_prefix(1);
+      if (!text_.empty() && text_[0] == '-') {
+         return std::errc::invalid_argument;
+      }
+   }
+
+   char const *const last{text_.data() + text_.size()};
+   Type value{};
+   std::from_chars_result const result{read_(text_.data(), last, value)};
+
+   // A number out of range followed by more text is still not a number
+   if (result.ec == std::errc::invalid_argument || result.ptr != last) {
+      return std::errc::invalid_argument;
+   }
+   if (result.ec != std::errc()) {
+      return result.ec;
+   }
+
+   value_ = value;
+   return std::errc();
+}
+
+/**
+ * @brief Parses an integer.
+ *
+ * @param text_ The text, only the number and surrounding spaces.
+ * @param value_ Receives the number; it is left unchanged on error.
+ * @param base_ The base, from 2 to 36 (default is 10).
+ * @return std::errc() on success, std::errc::invalid_argument if the text is
+ * not a number and std::errc::result_out_of_range if it does not fit.
+ */
+template <class Type,
+          std::enable_if_t<std::is_integral_v<Type> &&
+                               !std::is_same_v<Type, bool>,
+                           bool> = true>
+std::errc parse(std::string_view text_, Type &value_, int base_ = 10) {
+   return read_whole(text_, value_,
+                     [base_](char const *first_, char const *last_,
+                             Type &out_) {
+                        return std::from_chars(first_, last_, out_, base_);
+                     });
+}
+
+/**
+ * @brief Parses a floating-point number.
+ *
+ * @param text_ The text, only the number and surrounding spaces.
+ * @param value_ Receives the number; it is left unchanged on error.
+ * @param format_ The accepted notations (default is fixed or scientific).
+ * @return std::errc() on success, std::errc::invalid_argument if the text is
+ * not a number and std::errc::result_out_of_range if it does not fit.
+ */
+template <class Type,
+          std::enable_if_t<std::is_floating_point_v<Type>, bool> = true>
+std::errc parse(std::string_view text_, Type &value_,
+                std::chars_format format_ = std::chars_format::general) {
+   return read_whole(text_, value_,
+                     [format_](char const *first_, char const *last_,
+                               Type &out_) {
+                        return std::from_chars(first_, last_, out_, format_);
+                     });
+}
+
+/**
+ * @brief A decimal number split at its point, as read before a unit.
+ */
+struct decimal {
+   std::uint64_t whole;   ///< The digits before the point.
+   double fraction;       ///< The digits after the point, below 1.
+   std::string_view rest; ///< The text after the number.
+};
+
+/**
+ * @brief Reads a decimal number at the start of a text.
+ *
+ * @return std::errc::invalid_argument if there is no digit and
+ * std::errc::result_out_of_range if the whole part does not fit.
+ */
+inline std::errc read_decimal(std::string_view text_, decimal &number_) {
+   char const *const first{text_.data()};
+   char const *const last{first + text_.size()};
+   char const *it{first};
+
+   number_.whole = 0;
+   number_.fraction = 0;
+   if (it != last && *it >= '0' && *it <= '9') {
+      std::from_chars_result const result{
+          std::from_chars(it, last, number_.whole)};
+      if (result.ec != std::errc()) {
+         return result.ec;
+      }
+      it = result.ptr;
+   }
+
+   if (it != last && *it == '.') {
+      char const *const point{it};
+      for (++it; it != last && *it >= '0' && *it <= '9'; ++it) {
+      }
+      if (it - point == 1 && point == first) {
+         return std::errc::invalid_argument; // A lone point
+      }
+      // Read at once, so that the fraction is rounded only once
+      if (it - point != 1) {
+         std::from_chars(point, it, number_.fraction);
+      }
+   } else if (it == first) {
+      return std::errc::invalid_argument;
+   }
+
+   number_.rest = text_.substr(static_cast<size_type>(it - first));
+   return std::errc();
+}
+
+/**
+ * @brief Multiplies a decimal number by a unit.
+ *
+ * @return False if the result does not fit.
+ */
+inline bool scale(decimal const &number_, std::uint64_t unit_,
+                  std::uint64_t &value_) {
+   constexpr std::uint64_t most{std::numeric_limits<std::uint64_t>::max()};
+   if (number_.whole > most / unit_) {
+      return false;
+   }
+
+   std::uint64_t const whole{number_.whole * unit_};
+   double const part{number_.fraction * static_cast<double>(unit_)};
+   if (part != 0 && part >= static_cast<double>(most - whole)) {
+      return false;
+   }
+
+   value_ = whole + static_cast<std::uint64_t>(part);
+   return true;
+}
+
+/**
+ * @brief Checks if a text is a unit, ignoring case.
+ */
+inline bool is_unit(std::string_view text_, std::string_view unit_) {
+   if (text_.size() != unit_.size()) {
+      return false;
+   }
+
+   for (size_type index{0}; index != text_.size(); ++index) {
+      char const char_{text_[index]};
+      if ((char_ >= 'A' && char_ <= 'Z' ? char_ - 'A' + 'a' : char_) !=
+          unit_[index]) {
+         return false;
+      }
+   }
+   return true;
+}
+
+/**
+ * @brief Parses a size in bytes, such as "10G", "512 KiB" or "1.5MB".
+ *
+ * The units, which ignore case, follow the dd convention: K, M, G, T, P and
+ * E, alone or followed by "iB", are powers of 1024, while kB, MB, GB, TB, PB
+ * and EB are powers of 1000. A number without a unit, or with "B", is in
+ * bytes. A fraction of a byte is dropped.
+ *
+ * @param text_ The text.
+ * @param bytes_ Receives the size; it is left unchanged on error.
+ * @return std::errc() on success, std::errc::invalid_argument if the text is
+ * not a size and std::errc::result_out_of_range if it does not fit.
+ */
+inline std::errc parse_size(std::string_view text_, std::uint64_t &bytes_) {
+   decimal number{};
+   if (std::errc const error{read_decimal(trimmed(text_), number)};
+       error != std::errc()) {
+      return error;
+   }
+
+   std::string_view const unit{trimmed(number.rest)};
+   std::uint64_t multiplier{1};
+
+   if (!unit.empty() && !is_unit(unit, "b")) {
+      constexpr std::string_view prefixes{"kmgtpe"};
+      char const prefix{unit[0] >= 'A' && unit[0] <= 'Z'
+                            ? static_cast<char>(unit[0] - 'A' + 'a')
+                            : unit[0]};
+      size_type const power{prefixes.find(prefix)};
+      std::string_view const kind{unit.substr(1)};
+
+      if (power == std::string_view::npos ||
+          !(kind.empty() || is_unit(kind, "b") || is_unit(kind, "ib"))) {
+         return std::errc::invalid_argument;
+      }
+
+      std::uint64_t const base{is_unit(kind, "b") ? 1000u : 1024u};
+      for (size_type times{0}; times <= power; ++times) {
+         multiplier *= base;
+      }
+   }
+
+   std::uint64_t bytes{0};
+   if (!scale(number, multiplier, bytes)) {
+      return std::errc::result_out_of_range;
+   }
+
+   bytes_ = bytes;
+   return std::errc();
+}
+
+/**
+ * @brief Parses a duration, such as "250ms", "1.5s" or "1h 30m".
+ *
+ * The duration is one or more numbers, each followed by a unit: ns, us (or
+ * µs), ms, s, m (or min), h or d. A fraction of a nanosecond is dropped.
+ *
+ * @param text_ The text.
+ * @param duration_ Receives the duration; it is left unchanged on error.
+ * @return std::errc() on success, std::errc::invalid_argument if the text is
+ * not a duration and std::errc::result_out_of_range if it does not fit.
+ */
+inline std::errc parse_duration(std::string_view text_,
+                                std::chrono::nanoseconds &duration_) {
+   struct unit {
+      std::string_view name; ///< The name of the unit.
+      std::uint64_t size;    ///< Nanoseconds in the unit.
+   };
+   // Longer names first, so that "ms" is not read as "m"
+   static constexpr unit units[]{
+       {"min", 60'000'000'000},  {"ns", 1},       {"us", 1'000},
+       {"\xC2\xB5s", 1'000},     {"ms", 1'000'000}, {"s", 1'000'000'000},
+       {"m", 60'000'000'000},    {"h", 3'600'000'000'000},
+       {"d", 86'400'000'000'000}};
+
+   constexpr std::uint64_t most{static_cast<std::uint64_t>(
+       std::numeric_limits<std::chrono::nanoseconds::rep>::max())};
+   std::string_view rest{trimmed(text_)};
+   std::uint64_t total{0};
+
+   if (rest.empty()) {
+      return std::errc::invalid_argument;
+   }
+
+   while (!rest.empty()) {
+      decimal number{};
+      if (std::errc const error{read_decimal(rest, number)};
+          error != std::errc()) {
+         return error;
+      }
+      rest = number.rest;
+
+      unit const *found{nullptr};
+      for (unit const &current : units) {
+         if (rest.substr(0, current.name.size()) == current.name) {
+            found = &current;
+            break;
+         }
+      }
+      if (found == nullptr) {
+         return std::errc::invalid_argument;
+      }
+      rest = trimmed(rest.substr(found->name.size()));
+
+      std::uint64_t nanoseconds{0};
+      if (!scale(number, found->size, nanoseconds) ||
+          nanoseconds > most - total) {
+         return std::errc::result_out_of_range;
+      }
+      total += nanoseconds;
+   }
+
+   duration_ = std::chrono::nanoseconds(
+       static_cast<std::chrono::nanoseconds::rep>(total));
+   return std::errc();
+}
+} // namespace num
+} // namespace ext
+
+#endif // NUMBER_HPP_
@@ -0,0 +1,410 @@
+/**
+ * @file out_buffer.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A growable output buffer that formats without streams.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * out_buffer is a contiguous, uninitialized block of bytes that grows
+ * geometrically. Texts are copied in, runs of a character are filled, and
+ * numbers are written with std::to_chars straight into the free space at the
+ * end, so there is no locale, no stream state and no temporary string. It has
+ * the append() members the formatting templates expect from a string, and the
+ * bytes are handed to a FILE*, a file descriptor or an ostream in one call.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef OUT_BUFFER_HPP_
+#define OUT_BUFFER_HPP_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif /// _WIN32
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A growable contiguous byte buffer with stream-free formatting.
+ */
+class out_buffer {
+ public:
+   using size_type = std::size_t;
+   using value_type = char;
+
+   /**
+    * @brief Default constructor, creates an empty buffer that allocates on
+    * the first write.
+    */
+   out_buffer() {}
+
+   /**
+    * @brief Constructs an empty buffer.
+    *
+    * @param capacity_ The initial capacity, in bytes.
+    */
+   explicit out_buffer(size_type capacity_) { reserve(capacity_); }
+
+   /**
+    * @brief Move constructor, leaves the other buffer empty.
+    */
+   out_buffer(out_buffer &&other_) noexcept
+       : m_data(std::move(other_.m_data)),
+         m_size(std::exchange(other_.m_size, 0)),
+         m_capacity(std::exchange(other_.m_capacity, 0)) {}
+
+   /**
+    * @brief Move assignment, leaves the other buffer empty.
+    */
+   out_buffer &operator=(out_buffer &&other_) noexcept {
+      m_data = std::move(other_.m_data);
+      m_size = std::exchange(other_.m_size, 0);
+      m_capacity = std::exchange(other_.m_capacity, 0);
+      return *this;
+   }
+
+   out_buffer(out_buffer const &) = delete;
+   out_buffer &operator=(out_buffer const &) = delete;
+
+   /**
+    * @brief Gets the bytes of the buffer.
+    */
+   char const *data() const { return m_data.get(); }
+
+   /**
+    * @brief Gets the number of bytes of the buffer.
+    */
+   size_type size() const { return m_size; }
+
+   /**
+    * @brief Gets the number of bytes the buffer holds without growing.
+    */
+   size_type capacity() const { return m_capacity; }
+
+   /**
+    * @brief Checks if the buffer is empty.
+    */
+   bool empty() const { return m_size == 0; }
+
+   /**
+    * @brief Gets a view of the bytes of the buffer, valid until it grows.
+    */
+   std::string_view view() const { return {m_data.get(), m_size}; }
+
+   /**
+    * @brief Empties the buffer, keeping its capacity.
+    */
+   void clear() { m_size = 0; }
+
+   /**
+    * @brief Grows the buffer to hold at least a number of bytes.
+    *
+    * @param capacity_ The number of bytes.
+    */
+   void reserve(size_type capacity_) {
+      if (capacity_ <= m_capacity) {
+         return;
+      }
+
+      std::unique_ptr<char[]> data{new char[capacity_]};
+      if (m_size != 0) {
+         std::memcpy(data.get(), m_data.get(), m_size);
+      }
+      m_data = std::move(data);
+      m_capacity = capacity_;
+   }
+
+   /**
+    * @brief Appends a character.
+    *
+    * @param char_ The character.
+    * @return A reference to this buffer.
+    */
+   out_buffer &put(char char_) {
+      *tail(1) = char_;
+      ++m_size;
+      return *this;
+   }
+
+   /**
+    * @brief Appends a text.
+    *
+    * @param text_ The text.
+    * @return A reference to this buffer.
+    */
+   out_buffer &put(std::string_view text_) {
+      if (!text_.empty()) {
+         std::memcpy(tail(text_.size()), text_.data(), text_.size());
+         m_size += text_.size();
+      }
+      return *this;
+   }
+
+   /**
+    * @brief Appends a character several times.
+    *
+    * @param count_ The number of characters.
+    * @param char_ The character.
+    * @return A reference to this buffer.
+    */
+   out_buffer &fill(size_type count_, char char_) {
+      if (count_ != 0) {
+         std::memset(tail(count_), char_, count_);
+         m_size += count_;
+      }
+      return *this;
+   }
+
+   /**
+    * @brief Appends an integer.
+    *
+    * @tparam Type An integer type.
+    * @param value_ The integer.
+    * @param base_ The base, from 2 to 36 (default is 10).
+    * @return A reference to this buffer.
+    */
+   template <class Type,
+             std::enable_if_t<std::is_integral_v<Type>, bool> = true>
+   out_buffer &put_number(Type value_, int base_ = 10) {
+      // Enough for the base 2 digits of the type, and a sign
+      constexpr size_type most{std::numeric_limits<Type>::digits + 2};
+      char *const first{tail(most)};
+      m_size += static_cast<size_type>(
+          std::to_chars(first, first + most, value_, base_).ptr - first);
+      return *this;
+   }
+
+   /**
+    * @brief Appends a floating-point number in its shortest form that reads
+    * back to the same value.
+    *
+    * @tparam Type A floating-point type.
+    * @param value_ The number.
+    * @return A reference to this buffer.
+    */
+   template <class Type,
+             std::enable_if_t<std::is_floating_point_v<Type>, bool> = true>
+   out_buffer &put_number(Type value_) {
+      return put_chars(
+          [value_](char *first_, char *last_) {
+             return std::to_chars(first_, last_, value_);
+          });
+   }
+
+   /**
+    * @brief Appends a floating-point number with a format and a precision,
+    * as printf does with "%f", "%e", "%g" or "%a".
+    *
+    * @tparam Type A floating-point type.
+    * @param value_ The number.
+    * @param format_ The notation.
+    * @param precision_ The number of digits.
+    * @return A reference to this buffer.
+    */
+   template <class Type,
+             std::enable_if_t<std::is_floating_point_v<Type>, bool> = true>
+   out_buffer &put_number(Type value_, std::chars_format format_,
+                          int precision_) {
+      return put_chars(
+          [value_, format_, precision_](char *first_, char *last_) {
+             return std::to_chars(first_, last_, value_, format_, precision_);
+          });
+   }
+
+   /**
+    * @brief Appends a value as an output stream with the default flags writes
+    * it: texts and characters as they are, booleans as 1 or 0, integers in
+    * base 10 and floating-point numbers as "%g" does. Other types go through
+    * their operator<<.
+    *
+    * @tparam Type The type of the value.
+    * @param value_ The value.
+    * @return A reference to this buffer.
+    */
+   template <class Type> out_buffer &print(Type const &value_) {
+      if constexpr (std::is_convertible_v<Type const &, std::string_view>) {
+         return put(std::string_view(value_));
+      } else if constexpr (std::is_same_v<Type, char> ||
+                           std::is_same_v<Type, signed char> ||
+                           std::is_same_v<Type, unsigned char>) {
+         return put(static_cast<char>(value_));
+      } else if constexpr (std::is_same_v<Type, bool>) {
+         return put(value_ ? '1' : '0');
+      } else if constexpr (std::is_integral_v<Type>) {
+         return put_number(+value_); // Wide characters print as numbers
+      } else if constexpr (std::is_floating_point_v<Type>) {
+         return put_number(value_, std::chars_format::general, 6);
+      } else {
+         std::ostringstream stream;
+         stream << value_;
+         return put(std::string_view(stream.str()));
+      }
+   }
+
+   /**
+    * @brief Appends characters, as std::string::append does.
+    *
+    * @param data_ The characters.
+    * @param size_ The number of characters.
+    */
+   void append(char const *data_, size_type size_) {
+      put(std::string_view(data_, size_));
+   }
+
+   /**
+    * @brief Appends a range of characters, as std::string::append does.
+    *
+    * @param first_ The first character.
+    * @param last_ The end of the characters.
+    */
+   void append(char const *first_, char const *last_) {
+      put(std::string_view(first_, static_cast<size_type>(last_ - first_)));
+   }
+
+   /**
+    * @brief Appends a character several times, as std::string::append does.
+    *
+    * @param count_ The number of characters.
+    * @param char_ The character.
+    */
+   void append(size_type count_, char char_) { fill(count_, char_); }
+
+   /**
+    * @brief Appends a character, as std::string::push_back does.
+    *
+    * @param char_ The character.
+    */
+   void push_back(char char_) { put(char_); }
+
+   /**
+    * @brief Appends a character, as std::string::operator+= does.
+    *
+    * @param char_ The character.
+    * @return A reference to this buffer.
+    */
+   out_buffer &operator+=(char char_) { return put(char_); }
+
+   /**
+    * @brief Appends a text, as std::string::operator+= does.
+    *
+    * @param text_ The text.
+    * @return A reference to this buffer.
+    */
+   out_buffer &operator+=(std::string_view text_) { return put(text_); }
+
+   /**
+    * @brief Writes the buffer to a C stream and empties it.
+    *
+    * @param file_ The stream.
+    * @throw std::system_error if the write fails.
+    */
+   void flush_to(std::FILE *file_) {
+      if (m_size != 0 &&
+          std::fwrite(m_data.get(), 1, m_size, file_) != m_size) {
+         throw std::system_error(errno, std::generic_category(),
+                                 "Cannot write the buffer to the file.");
+      }
+      m_size = 0;
+   }
+
+   /**
+    * @brief Writes the buffer to a file descriptor and empties it. Partial
+    * and interrupted writes are resumed.
+    *
+    * @param fd_ The file descriptor.
+    * @throw std::system_error if the write fails.
+    */
+   void flush_to(int fd_) {
+      char const *data{m_data.get()};
+      size_type left{m_size};
+
+      while (left != 0) {
+#ifdef _WIN32
+         int const written{::_write(fd_, data,
+                                    static_cast<unsigned>(
+                                        left < (1u << 30) ? left : 1u << 30))};
+#else
+         ::ssize_t const written{::write(fd_, data, left)};
+         if (written < 0 && errno == EINTR) {
+            continue;
+         }
+#endif
+         if (written < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Cannot write the buffer to the file.");
+         }
+
+         data += written;
+         left -= static_cast<size_type>(written);
+      }
+      m_size = 0;
+   }
+
+   /**
+    * @brief Writes the buffer to an output stream and empties it. Errors are
+    * reported by the state of the stream.
+    *
+    * @param os_ The output stream.
+    */
+   void flush_to(std::ostream &os_) {
+      os_.write(m_data.get(), static_cast<std::streamsize>(m_size));
+      m_size = 0;
+   }
+
+ private:
+   /**
+    * @brief Makes room for some bytes after the end of the buffer.
+    *
+    * @param count_ The number of bytes.
+    * @return The end of the buffer.
+    */
+   char *tail(size_type count_) {
+      if (m_capacity - m_size < count_) {
+         size_type const grown{m_capacity + m_capacity / 2};
+         reserve(grown < m_size + count_ ? m_size + count_ + 64 : grown);
+      }
+      return m_data.get() + m_size;
+   }
+
+   /**
+    * @brief Appends what a std::to_chars call writes, growing until it fits.
+    */
+   template <class Write> out_buffer &put_chars(Write write_) {
+      for (size_type room{64};; room *= 2) {
+         char *const first{tail(room)};
+         std::to_chars_result const result{write_(first, first + room)};
+
+         if (result.ec == std::errc()) {
+            m_size += static_cast<size_type>(result.ptr - first);
+            return *this;
+         }
+      }
+   }
+
+   std::unique_ptr<char[]> m_data; ///< The bytes, uninitialized past m_size.
+   size_type m_size{0};            ///< Bytes in use.
+   size_type m_capacity{0};        ///< Bytes allocated.
+};
+
+} // namespace ext
+
+#endif // OUT_BUFFER_HPP_
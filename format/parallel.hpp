@@ -0,0 +1,552 @@
+/**
+ * @file parallel.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Parallel versions of the fstring algorithms for very large buffers.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The input is cut into one chunk per thread, each chunk is processed on its
+ * own thread and the partial results are stitched in order, so the results
+ * are the same, byte for byte, as those of the serial fstring methods:
+ * - Searches cut anywhere; a match that starts in a chunk is found by that
+ *   chunk even if it ends in the next one, and the left-to-right,
+ *   non-overlapping order of fstring::replace_all is restored while
+ *   stitching.
+ * - Splits cut right after a delimiter, so no token spans two chunks.
+ *
+ * Inputs smaller than two chunks of min_chunk characters run on the calling
+ * thread only.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "fstring.hpp"
+#include "split_view.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Parallel algorithms namespace
+ *
+ * The functions of this namespace take the number of threads as their last
+ * argument; 0 (the default) uses one thread per hardware thread, with
+ * chunks of at least min_chunk characters.
+ */
+namespace par {
+inline constexpr std::size_t min_chunk{1 << 20}; ///< Smallest automatic chunk.
+
+/**
+ * @brief Gets the number of chunks to cut an input into.
+ *
+ * @param size_ The size of the input.
+ * @param threads_ The requested number of threads, 0 for automatic.
+ * @return The number of chunks, at least 1 and at most size_.
+ */
+inline std::size_t chunk_count(std::size_t size_, std::size_t threads_) {
+   if (threads_ == 0) {
+      threads_ = std::max(1u, std::thread::hardware_concurrency());
+      threads_ = std::min(threads_, size_ / min_chunk);
+   }
+
+   return std::max<std::size_t>(1, std::min(threads_, size_));
+}
+
+/**
+ * @brief Runs a task for every chunk, chunk 0 on the calling thread and each
+ * other one on a thread of its own, and waits for all of them.
+ *
+ * Chunks whose thread cannot be started run on the calling thread. The first
+ * exception thrown by a task is rethrown once every task has finished.
+ *
+ * @tparam Task A callable taking the index of a chunk.
+ * @param count_ The number of chunks.
+ * @param task_ The task.
+ */
+template <class Task> void run(std::size_t count_, Task const &task_) {
+   std::vector<std::exception_ptr> errors(count_);
+   auto const guarded{[&errors, &task_](std::size_t index_) {
+      try {
+         task_(index_);
+      } catch (...) {
+         errors[index_] = std::current_exception();
+      }
+   }};
+
+   std::vector<std::thread> threads;
+   std::size_t index{1};
+
+   try {
+      threads.reserve(count_ - 1);
+      for (; index < count_; ++index) {
+         threads.emplace_back(guarded, index);
+      }
+   } catch (std::exception const &) {
+      for (; index < count_; ++index) {
+         guarded(index);
+      }
+   }
+
+   guarded(0);
+
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+
+   for (std::exception_ptr const &error : errors) {
+      if (error) {
+         std::rethrow_exception(error);
+      }
+   }
+}
+
+/**
+ * @brief Cuts an input into chunks of about the same size.
+ *
+ * @param size_ The size of the input.
+ * @param count_ The number of chunks.
+ * @return The count_ + 1 bounds of the chunks.
+ */
+inline std::vector<std::size_t> even_bounds(std::size_t size_,
+                                            std::size_t count_) {
+   std::vector<std::size_t> bounds(count_ + 1);
+
+   for (std::size_t index{0}; index <= count_; ++index) {
+      bounds[index] = size_ / count_ * index + size_ % count_ * index / count_;
+   }
+
+   return bounds;
+}
+
+/**
+ * @brief The occurrences of a sequence in one chunk.
+ */
+struct chunk_matches {
+   std::vector<std::size_t> positions; ///< The first (or all) occurrences.
+   std::size_t count{0};               ///< The number of occurrences.
+   std::size_t last{0};                ///< The last occurrence, if any.
+};
+
+/**
+ * @brief Finds the non-overlapping occurrences of a sequence that start in a
+ * chunk, searching from the start of the chunk.
+ *
+ * @param text_ The whole input.
+ * @param target_ The sequence to search for (not empty).
+ * @param first_ The start of the chunk.
+ * @param last_ The end of the chunk.
+ * @param keep_ The maximum number of positions kept.
+ * @return The occurrences.
+ */
+template <typename CharType>
+chunk_matches find_in_chunk(std::basic_string_view<CharType> text_,
+                            std::basic_string_view<CharType> target_,
+                            std::size_t first_, std::size_t last_,
+                            std::size_t keep_) {
+   std::basic_string_view<CharType> const window{
+       text_.substr(0, last_ + target_.size() - 1)};
+   chunk_matches matches;
+
+   for (std::size_t pos{window.find(target_, first_)};
+        pos != window.npos; pos = window.find(target_, pos + target_.size())) {
+      if (matches.count++ < keep_) {
+         matches.positions.push_back(pos);
+      }
+      matches.last = pos;
+   }
+
+   return matches;
+}
+
+/**
+ * @brief Finds the non-overlapping occurrences of a sequence, chunk by chunk,
+ * in the same order as a serial left-to-right search.
+ *
+ * Each chunk searches from its own start. While stitching, the last match of
+ * a chunk may end past the start of the next one; the next chunk is then
+ * searched again from the end of that match until it meets one of its own
+ * positions, from where both searches agree.
+ *
+ * @param text_ The input.
+ * @param target_ The sequence to search for (not empty).
+ * @param bounds_ The bounds of the chunks.
+ * @param keep_ The maximum number of positions kept per chunk.
+ * @return The occurrences of each chunk; positions are only complete when
+ * keep_ is not smaller than any count.
+ */
+template <typename CharType>
+std::vector<chunk_matches>
+find_chunks(std::basic_string_view<CharType> text_,
+            std::basic_string_view<CharType> target_,
+            std::vector<std::size_t> const &bounds_, std::size_t keep_) {
+   std::size_t const chunks{bounds_.size() - 1};
+   std::vector<chunk_matches> found(chunks);
+
+   run(chunks, [&](std::size_t index_) {
+      found[index_] = find_in_chunk(text_, target_, bounds_[index_],
+                                    bounds_[index_ + 1], keep_);
+   });
+
+   std::size_t carry{0};
+   for (std::size_t index{0}; index != chunks; ++index) {
+      chunk_matches &chunk{found[index]};
+      std::basic_string_view<CharType> const window{
+          text_.substr(0, bounds_[index + 1] + target_.size() - 1)};
+      bool const complete{chunk.count <= keep_};
+
+      if (carry > bounds_[index] && chunk.count != 0) {
+         chunk_matches fixed;
+         std::size_t pos{window.find(target_, carry)};
+         auto mine{chunk.positions.begin()};
+
+         for (; pos != window.npos;
+              pos = window.find(target_, pos + target_.size())) {
+            mine = std::lower_bound(mine, chunk.positions.end(), pos);
+            if (mine != chunk.positions.end() && *mine == pos) {
+               break;
+            }
+
+            // Past the kept positions there is nothing to meet: keep counting
+            if (mine != chunk.positions.end() || complete) {
+               fixed.positions.push_back(pos);
+            }
+            ++fixed.count;
+            fixed.last = pos;
+         }
+
+         if (pos != window.npos) {
+            fixed.positions.insert(fixed.positions.end(), mine,
+                                   chunk.positions.end());
+            fixed.count += chunk.count - static_cast<std::size_t>(
+                                             mine - chunk.positions.begin());
+            fixed.last = chunk.last;
+         }
+
+         chunk = std::move(fixed);
+      }
+
+      if (chunk.count != 0) {
+         carry = chunk.last + target_.size();
+      }
+   }
+
+   return found;
+}
+
+/**
+ * @brief Counts the non-overlapping occurrences of a sequence, as
+ * fstring::replace_all replaces them.
+ *
+ * @tparam Text A string type convertible to a string view.
+ * @param text_ The input.
+ * @param target_ The sequence to search for.
+ * @param threads_ The number of threads, 0 for automatic.
+ * @return The number of occurrences, 0 if the sequence is empty.
+ */
+template <class Text>
+std::size_t count(Text const &text_,
+                  std::basic_string_view<typename Text::value_type> target_,
+                  std::size_t threads_ = 0) {
+   std::basic_string_view<typename Text::value_type> const text{text_};
+
+   if (target_.empty() || target_.size() > text.size()) {
+      return 0;
+   }
+
+   std::vector<std::size_t> const bounds{
+       even_bounds(text.size(), chunk_count(text.size(), threads_))};
+   std::size_t total{0};
+
+   for (chunk_matches const &chunk : find_chunks(text, target_, bounds, 64)) {
+      total += chunk.count;
+   }
+
+   return total;
+}
+
+/**
+ * @brief Finds the non-overlapping occurrences of a sequence, as
+ * fstring::replace_all replaces them.
+ *
+ * @tparam Text A string type convertible to a string view.
+ * @param text_ The input.
+ * @param target_ The sequence to search for.
+ * @param threads_ The number of threads, 0 for automatic.
+ * @return The positions of the occurrences in increasing order, none if the
+ * sequence is empty.
+ */
+template <class Text>
+std::vector<std::size_t>
+find_all(Text const &text_,
+         std::basic_string_view<typename Text::value_type> target_,
+         std::size_t threads_ = 0) {
+   std::basic_string_view<typename Text::value_type> const text{text_};
+   std::vector<std::size_t> positions;
+
+   if (target_.empty() || target_.size() > text.size()) {
+      return positions;
+   }
+
+   std::vector<std::size_t> const bounds{
+       even_bounds(text.size(), chunk_count(text.size(), threads_))};
+   std::vector<chunk_matches> const found{
+       find_chunks(text, target_, bounds, text.size())};
+
+   std::size_t total{0};
+   for (chunk_matches const &chunk : found) {
+      total += chunk.count;
+   }
+
+   positions.reserve(total);
+   for (chunk_matches const &chunk : found) {
+      positions.insert(positions.end(), chunk.positions.begin(),
+                       chunk.positions.end());
+   }
+
+   return positions;
+}
+
+/**
+ * @brief Checks if a sequence occurs in the input; every thread stops as
+ * soon as any of them finds it.
+ *
+ * @tparam Text A string type convertible to a string view.
+ * @param text_ The input.
+ * @param target_ The sequence to search for.
+ * @param threads_ The number of threads, 0 for automatic.
+ * @return True if the sequence occurs (or is empty), false otherwise.
+ */
+template <class Text>
+bool contains(Text const &text_,
+              std::basic_string_view<typename Text::value_type> target_,
+              std::size_t threads_ = 0) {
+   using view_type = std::basic_string_view<typename Text::value_type>;
+   view_type const text{text_};
+
+   if (target_.empty()) {
+      return true;
+   }
+   if (target_.size() > text.size()) {
+      return false;
+   }
+
+   std::vector<std::size_t> const bounds{
+       even_bounds(text.size(), chunk_count(text.size(), threads_))};
+   std::atomic<bool> found{false};
+
+   run(bounds.size() - 1, [&](std::size_t index_) {
+      constexpr std::size_t step{1 << 16};
+
+      for (std::size_t first{bounds[index_]}; first < bounds[index_ + 1];
+           first += step) {
+         if (found.load(std::memory_order_relaxed)) {
+            return;
+         }
+
+         std::size_t const last{std::min(first + step, bounds[index_ + 1])};
+         view_type const window{text.substr(0, last + target_.size() - 1)};
+         if (window.find(target_, first) != view_type::npos) {
+            found.store(true, std::memory_order_relaxed);
+            return;
+         }
+      }
+   });
+
+   return found.load();
+}
+
+/**
+ * @brief Replaces all occurrences of a character sequence with another, as
+ * fstring::replace_all does.
+ *
+ * Equal-size replacements are written in place by every thread. Otherwise
+ * the result is sized once and each thread copies its own chunk into it.
+ *
+ * @tparam CharType The character type of the fstring.
+ * @tparam Allocator The allocator of the fstring.
+ * @param text_ The fstring to modify.
+ * @param target_ The character sequence to be replaced.
+ * @param replace_ The replacement character sequence.
+ * @param threads_ The number of threads, 0 for automatic.
+ * @return An iterator to the last occurrence of the replacement character
+ * sequence, or end() if nothing was replaced.
+ */
+template <typename CharType, typename Allocator>
+typename fstring<CharType, Allocator>::iterator
+replace_all(fstring<CharType, Allocator> &text_,
+            typename basic_split_view<CharType>::view_type target_,
+            typename basic_split_view<CharType>::view_type replace_,
+            std::size_t threads_ = 0) {
+   using view_type = std::basic_string_view<CharType>;
+   using base_type = typename fstring<CharType, Allocator>::base_type;
+
+   if (target_.empty() || target_.size() > text_.size()) {
+      return text_.end();
+   }
+
+   view_type const text{text_};
+   std::vector<std::size_t> const bounds{
+       even_bounds(text.size(), chunk_count(text.size(), threads_))};
+   std::vector<chunk_matches> const found{
+       find_chunks(text, target_, bounds, text.size())};
+   std::size_t const chunks{found.size()};
+
+   // Each chunk copies from the end of the previous chunk's last match
+   std::vector<std::size_t> starts(chunks + 1, text.size());
+   std::vector<std::size_t> before(chunks + 1, 0);
+   std::size_t last{text.npos};
+
+   for (std::size_t index{0}; index != chunks; ++index) {
+      std::size_t const carry{last == text.npos ? 0 : last + target_.size()};
+      starts[index] = std::max(bounds[index], carry);
+      before[index + 1] = before[index] + found[index].count;
+
+      if (found[index].count != 0) {
+         last = found[index].last;
+      }
+   }
+
+   if (last == text.npos) {
+      return text_.end();
+   }
+
+   std::size_t const matches{before[chunks]};
+   std::size_t const last_output{last + (matches - 1) * replace_.size() -
+                                 (matches - 1) * target_.size()};
+
+   if (target_.size() == replace_.size()) {
+      CharType *const data{&text_[0]};
+
+      run(chunks, [&](std::size_t index_) {
+         for (std::size_t pos : found[index_].positions) {
+            std::char_traits<CharType>::copy(data + pos, replace_.data(),
+                                             replace_.size());
+         }
+      });
+
+      return text_.begin() + static_cast<std::ptrdiff_t>(last_output);
+   }
+
+   base_type result{text_.get_allocator()};
+   result.resize(text.size() - matches * target_.size() +
+                 matches * replace_.size());
+   CharType *const out{&result[0]};
+
+   run(chunks, [&](std::size_t index_) {
+      std::size_t first{starts[index_]};
+      CharType *write{out + (first + before[index_] * replace_.size() -
+                             before[index_] * target_.size())};
+
+      for (std::size_t pos : found[index_].positions) {
+         write = std::char_traits<CharType>::copy(write, text.data() + first,
+                                                  pos - first) +
+                 (pos - first);
+         write = std::char_traits<CharType>::copy(write, replace_.data(),
+                                                  replace_.size()) +
+                 replace_.size();
+         first = pos + target_.size();
+      }
+
+      std::size_t const end{std::max(first, starts[index_ + 1])};
+      std::char_traits<CharType>::copy(write, text.data() + first, end - first);
+   });
+
+   text_.swap(result);
+   return text_.begin() + static_cast<std::ptrdiff_t>(last_output);
+}
+
+/**
+ * @brief Splits an input into fstrings, as fstring::split_view does.
+ *
+ * The chunks are cut right after a delimiter ('\n' in split_mode::lines).
+ *
+ * @tparam Text A string type convertible to a string view.
+ * @param text_ The input.
+ * @param delimiter_ The delimiter character.
+ * @param mode_ How empty tokens are handled (default is
+ * split_mode::skip_empty).
+ * @param threads_ The number of threads, 0 for automatic.
+ * @return The tokens, in order.
+ */
+template <class Text>
+std::vector<fstring<typename Text::value_type>>
+split(Text const &text_, typename Text::value_type delimiter_,
+      split_mode mode_ = split_mode::skip_empty, std::size_t threads_ = 0) {
+   using CharType = typename Text::value_type;
+   using view_type = std::basic_string_view<CharType>;
+   view_type const text{text_};
+   CharType const cut{mode_ == split_mode::lines ? CharType('\n')
+                                                 : delimiter_};
+
+   std::vector<std::size_t> bounds{0};
+   for (std::size_t bound : even_bounds(text.size(),
+                                        chunk_count(text.size(), threads_))) {
+      if (bound <= bounds.back()) {
+         continue;
+      }
+
+      std::size_t const after{text.find(cut, bound - 1)};
+      if (after == view_type::npos) {
+         break;
+      }
+      if (after + 1 > bounds.back()) {
+         bounds.push_back(after + 1);
+      }
+   }
+   if (bounds.back() != text.size() || bounds.size() == 1) {
+      bounds.push_back(text.size());
+   }
+
+   std::size_t const chunks{bounds.size() - 1};
+   std::vector<std::vector<fstring<CharType>>> parts(chunks);
+
+   run(chunks, [&](std::size_t index_) {
+      view_type segment{
+          text.substr(bounds[index_], bounds[index_ + 1] - bounds[index_])};
+
+      // A delimiter ends the segment; the token after it is the next one's
+      if (mode_ == split_mode::keep_empty && index_ + 1 != chunks) {
+         segment.remove_suffix(1);
+      }
+
+      basic_split_view<CharType> const tokens{segment, delimiter_, mode_};
+      parts[index_].reserve(tokens.count());
+      for (view_type token : tokens) {
+         parts[index_].emplace_back(token.data(), token.size());
+      }
+   });
+
+   std::size_t total{0};
+   for (auto const &part : parts) {
+      total += part.size();
+   }
+
+   std::vector<fstring<CharType>> result;
+   result.reserve(total);
+   for (auto &part : parts) {
+      std::move(part.begin(), part.end(), std::back_inserter(result));
+   }
+
+   return result;
+}
+} // namespace par
+} // namespace ext
+
+#endif // PARALLEL_HPP_
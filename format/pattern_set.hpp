@@ -0,0 +1,415 @@
+/**
+ * @file pattern_set.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A set of patterns searched together in a single pass.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The patterns are compiled into an Aho-Corasick automaton. The bytes that do
+ * not occur in any pattern share one class, so the transition table only has
+ * a column per distinct pattern byte. While that table stays small it is
+ * filled in completely (one lookup per byte of text); otherwise each state
+ * keeps its own sorted edges and a failure link, which are followed at search
+ * time. Matches are reported leftmost-longest and never overlap, so a text is
+ * read once, plus at most the longest pattern after each match.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef PATTERN_SET_HPP_
+#define PATTERN_SET_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A set of patterns compiled for multi-pattern searches.
+ */
+class pattern_set {
+ public:
+   using size_type = std::size_t;
+
+   static constexpr size_type npos{std::string_view::npos}; ///< Not found.
+
+   /**
+    * @brief An occurrence of one of the patterns.
+    */
+   struct match {
+      size_type pattern;  ///< Index of the pattern, npos if there is none.
+      size_type position; ///< Position of the occurrence in the text.
+      size_type size;     ///< Size of the occurrence.
+
+      /**
+       * @brief Checks if a pattern was found.
+       */
+      explicit operator bool() const { return pattern != npos; }
+   };
+
+   /**
+    * @brief Constructs a set from a range of patterns.
+    *
+    * @tparam Range A range of values convertible to a string view.
+    * @param patterns_ The patterns, indexed in the order given. A repeated
+    * pattern is reported with its first index.
+    * @throw std::invalid_argument if a pattern is empty.
+    */
+   template <class Range> explicit pattern_set(Range const &patterns_) {
+      for (auto const &value : patterns_) {
+         m_patterns.emplace_back(std::string_view(value));
+      }
+
+      compile();
+   }
+
+   /**
+    * @brief Constructs a set from a list of patterns.
+    *
+    * @param patterns_ The patterns, indexed in the order given.
+    * @throw std::invalid_argument if a pattern is empty.
+    */
+   pattern_set(std::initializer_list<std::string_view> patterns_)
+       : pattern_set(std::vector<std::string_view>(patterns_)) {}
+
+   /**
+    * @brief Gets the number of patterns.
+    */
+   size_type size() const { return m_patterns.size(); }
+
+   /**
+    * @brief Gets a pattern.
+    *
+    * @param index_ The index of the pattern.
+    */
+   std::string_view pattern(size_type index_) const {
+      return m_patterns[index_];
+   }
+
+   /**
+    * @brief Checks if the automaton uses the complete transition table.
+    */
+   bool dense() const { return !m_dense.empty(); }
+
+   /**
+    * @brief Finds the leftmost occurrence of any pattern, the longest one if
+    * several start there.
+    *
+    * @param text_ The text to search in.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The occurrence, false when converted to bool if there is none.
+    */
+   match find_any(std::string_view text_, size_type pos_ = 0) const {
+      match found{npos, npos, 0};
+      if (pos_ >= text_.size() || m_patterns.empty()) {
+         return found;
+      }
+
+      unsigned char const *const text{
+          reinterpret_cast<unsigned char const *>(text_.data())};
+      std::uint32_t state{0};
+
+      for (size_type index{pos_}; index != text_.size(); ++index) {
+         state = next(state, text[index]);
+
+         // No later occurrence can start at or before the one found
+         size_type const reach{index + 1 - m_depth[state]};
+         if (found.pattern != npos && reach > found.position) {
+            return found;
+         }
+
+         std::uint32_t const output{m_output[state]};
+         if (output != none) {
+            size_type const size{m_patterns[output].size()};
+            size_type const position{index + 1 - size};
+
+            if (found.pattern == npos || position < found.position ||
+                (position == found.position && size > found.size)) {
+               found = match{output, position, size};
+            }
+         }
+      }
+
+      return found;
+   }
+
+   /**
+    * @brief Finds the non-overlapping occurrences of the patterns, left to
+    * right, as replace_many() replaces them.
+    *
+    * @param text_ The text to search in.
+    * @return The occurrences.
+    */
+   std::vector<match> find_all(std::string_view text_) const {
+      std::vector<match> matches;
+
+      for (match found{find_any(text_)}; found;
+           found = find_any(text_, found.position + found.size)) {
+         matches.push_back(found);
+      }
+
+      return matches;
+   }
+
+   /**
+    * @brief Counts the non-overlapping occurrences of the patterns.
+    *
+    * @param text_ The text to search in.
+    * @return The number of occurrences.
+    */
+   size_type count_all(std::string_view text_) const {
+      size_type count{0};
+
+      for (match found{find_any(text_)}; found;
+           found = find_any(text_, found.position + found.size)) {
+         ++count;
+      }
+
+      return count;
+   }
+
+   /**
+    * @brief Appends a text to a string, with every occurrence of a pattern
+    * replaced by the replacement of the same index.
+    *
+    * @tparam Range A random access range of values convertible to a string
+    * view.
+    * @tparam String The type of the output string.
+    * @param text_ The text to search in.
+    * @param replacements_ One replacement per pattern.
+    * @param out_ The string to append to.
+    * @return The number of replaced occurrences.
+    * @throw std::invalid_argument if there is not one replacement per
+    * pattern.
+    */
+   template <class Range, class String>
+   size_type replace_many(std::string_view text_, Range const &replacements_,
+                          String &out_) const {
+      if (static_cast<size_type>(std::distance(std::begin(replacements_),
+                                               std::end(replacements_))) !=
+          m_patterns.size()) {
+         throw std::invalid_argument(
+             "There must be one replacement per pattern.");
+      }
+
+      out_.reserve(out_.size() + text_.size());
+
+      size_type count{0};
+      size_type first{0};
+      for (match found{find_any(text_)}; found;
+           found = find_any(text_, first)) {
+         std::string_view const replace{std::begin(
+             replacements_)[static_cast<std::ptrdiff_t>(found.pattern)]};
+
+         out_.append(text_.data() + first, found.position - first);
+         out_.append(replace.data(), replace.size());
+         first = found.position + found.size;
+         ++count;
+      }
+      out_.append(text_.data() + first, text_.size() - first);
+
+      return count;
+   }
+
+   /**
+    * @brief Replaces every occurrence of a pattern by the replacement of the
+    * same index.
+    *
+    * @tparam Range A random access range of values convertible to a string
+    * view.
+    * @param text_ The text to search in.
+    * @param replacements_ One replacement per pattern.
+    * @return The text with the occurrences replaced.
+    * @throw std::invalid_argument if there is not one replacement per
+    * pattern.
+    */
+   template <class Range>
+   std::string replace_many(std::string_view text_,
+                            Range const &replacements_) const {
+      std::string out;
+      replace_many(text_, replacements_, out);
+      return out;
+   }
+
+ private:
+   static constexpr std::uint32_t none{~std::uint32_t{0}}; ///< No pattern.
+
+   /// Largest complete transition table, in entries.
+   static constexpr size_type dense_limit{size_type{1} << 20};
+
+   using edge = std::pair<std::uint16_t, std::uint32_t>; ///< Class and state.
+
+   /**
+    * @brief Gets the state after a byte.
+    */
+   std::uint32_t next(std::uint32_t state_, unsigned char byte_) const {
+      std::uint16_t const byte_class{m_class[byte_]};
+
+      if (!m_dense.empty()) {
+         return m_dense[state_ * m_stride + byte_class];
+      }
+      if (byte_class == 0) {
+         return 0;
+      }
+
+      for (;;) {
+         std::uint32_t const target{child(state_, byte_class)};
+         if (target != none) {
+            return target;
+         }
+         if (state_ == 0) {
+            return 0;
+         }
+         state_ = m_fail[state_];
+      }
+   }
+
+   /**
+    * @brief Gets the child of a state in the trie.
+    *
+    * @return The child, or none if there is no edge for the class.
+    */
+   std::uint32_t child(std::uint32_t state_, std::uint16_t class_) const {
+      std::vector<edge> const &edges{m_edges[state_]};
+      auto const found{std::lower_bound(
+          edges.begin(), edges.end(), class_,
+          [](edge const &edge_, std::uint16_t value_) {
+             return edge_.first < value_;
+          })};
+
+      return found != edges.end() && found->first == class_ ? found->second
+                                                            : none;
+   }
+
+   /**
+    * @brief Builds the byte classes, the trie, the failure links and, if it
+    * is small enough, the complete transition table.
+    */
+   void compile() {
+      m_class.fill(0);
+      size_type classes{1};
+      for (std::string const &pattern : m_patterns) {
+         if (pattern.empty()) {
+            throw std::invalid_argument(
+                "A pattern set cannot contain an empty pattern.");
+         }
+
+         for (char char_ : pattern) {
+            std::uint16_t &byte_class{
+                m_class[static_cast<unsigned char>(char_)]};
+            if (byte_class == 0) {
+               byte_class = static_cast<std::uint16_t>(classes++);
+            }
+         }
+      }
+      m_stride = classes;
+
+      m_edges.assign(1, {});
+      m_depth.assign(1, 0);
+      m_output.assign(1, none);
+
+      for (size_type index{0}; index != m_patterns.size(); ++index) {
+         std::uint32_t state{0};
+
+         for (char char_ : m_patterns[index]) {
+            std::uint16_t const byte_class{
+                m_class[static_cast<unsigned char>(char_)]};
+            std::uint32_t target{child(state, byte_class)};
+
+            if (target == none) {
+               target = static_cast<std::uint32_t>(m_edges.size());
+               std::vector<edge> &edges{m_edges[state]};
+               edges.insert(std::upper_bound(edges.begin(), edges.end(),
+                                             edge{byte_class, 0}),
+                            edge{byte_class, target});
+               m_edges.emplace_back();
+               m_depth.push_back(m_depth[state] + 1);
+               m_output.push_back(none);
+            }
+            state = target;
+         }
+
+         if (m_output[state] == none) {
+            m_output[state] = static_cast<std::uint32_t>(index);
+         }
+      }
+
+      // Breadth-first, so the failure link of a state is ready before its
+      // children are reached
+      m_fail.assign(m_edges.size(), 0);
+      std::vector<std::uint32_t> order{0};
+      order.reserve(m_edges.size());
+
+      for (size_type head{0}; head != order.size(); ++head) {
+         std::uint32_t const state{order[head]};
+
+         for (edge const &link : m_edges[state]) {
+            std::uint32_t fail{0};
+            if (state != 0) {
+               for (std::uint32_t back{m_fail[state]};; back = m_fail[back]) {
+                  std::uint32_t const target{child(back, link.first)};
+                  if (target != none) {
+                     fail = target;
+                     break;
+                  }
+                  if (back == 0) {
+                     break;
+                  }
+               }
+            }
+
+            m_fail[link.second] = fail;
+            if (m_output[link.second] == none) {
+               m_output[link.second] = m_output[fail];
+            }
+            order.push_back(link.second);
+         }
+      }
+
+      if (m_edges.size() * m_stride > dense_limit) {
+         return;
+      }
+
+      m_dense.assign(m_edges.size() * m_stride, 0);
+      for (std::uint32_t const state : order) {
+         std::uint32_t *const row{m_dense.data() + state * m_stride};
+
+         if (state != 0) {
+            std::copy_n(m_dense.data() + m_fail[state] * m_stride, m_stride,
+                        row);
+         }
+         row[0] = 0;
+         for (edge const &link : m_edges[state]) {
+            row[link.first] = link.second;
+         }
+      }
+
+      m_edges.clear();
+      m_edges.shrink_to_fit();
+   }
+
+   std::vector<std::string> m_patterns;    ///< The patterns.
+   std::array<std::uint16_t, 256> m_class; ///< Class of each byte.
+   size_type m_stride;                     ///< Number of classes.
+   std::vector<std::vector<edge>> m_edges; ///< Sorted trie edges.
+   std::vector<std::uint32_t> m_fail;      ///< Failure links.
+   std::vector<std::uint32_t> m_depth;     ///< Length of each state.
+   std::vector<std::uint32_t> m_output;    ///< Longest pattern ending here.
+   std::vector<std::uint32_t> m_dense;     ///< Complete table, or empty.
+};
+
+} // namespace ext
+
+#endif // PATTERN_SET_HPP_
@@ -0,0 +1,1263 @@
+/**
+ * @file regex.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A regular expression engine with linear-time matching.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * A pattern is parsed once into a Thompson NFA. Searches run a DFA whose
+ * states (ordered sets of NFA states) are built lazily, the first time a byte
+ * leads to them, and kept in a bounded cache that is cleared when it fills
+ * up. Every byte of text therefore costs one table lookup once the states it
+ * needs are known, and at most one NFA step otherwise, so the time is linear
+ * in the text whatever the pattern.
+ *
+ * Searches are leftmost-first, as in ECMAScript or Perl: a forward DFA finds
+ * where the match ends and a DFA of the reversed pattern, run backwards from
+ * there, finds where it starts. A pattern that begins with a literal skips to
+ * the occurrences of that literal with a searcher.
+ *
+ * The compiled pattern is immutable and the caches are borrowed from a pool,
+ * so a single regex can be used by several threads at once.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef REGEX_HPP_
+#define REGEX_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "searcher.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Regular expression namespace
+ *
+ * The parser, the NFA and the lazy DFA behind ext::regex.
+ */
+namespace rx {
+
+using size_type = std::size_t;
+using byte_set = std::bitset<256>;
+
+constexpr std::uint32_t none{~std::uint32_t{0}}; ///< No state.
+constexpr size_type unbounded{~size_type{0}};    ///< No repetition limit.
+constexpr size_type max_repeat{1000};            ///< Largest {m,n} bound.
+constexpr size_type max_program{size_type{1} << 20}; ///< Largest NFA.
+constexpr size_type cache_limit{size_type{1} << 21}; ///< DFA bytes.
+
+/**
+ * @brief A node of the syntax tree of a pattern.
+ */
+struct node {
+   /**
+    * @brief The kinds of nodes.
+    */
+   enum class kind {
+      empty,     ///< Matches the empty string.
+      bytes,     ///< Matches one byte of a set.
+      concat,    ///< Matches the children one after the other.
+      alternate, ///< Matches one of the children, the first preferred.
+      repeat,    ///< Matches the child from min to max times.
+      begin,     ///< Matches at the beginning of the text.
+      end,       ///< Matches at the end of the text.
+   };
+
+   kind type{kind::empty};     ///< Kind of the node.
+   byte_set set{};             ///< Bytes matched by a bytes node.
+   std::vector<node> children; ///< Children of the node.
+   size_type min{0};           ///< Least repetitions.
+   size_type max{0};           ///< Most repetitions, or unbounded.
+   bool greedy{true};          ///< Whether more repetitions are preferred.
+};
+
+/**
+ * @brief A recursive descent parser for the pattern syntax.
+ *
+ * The syntax is the ECMAScript one without captures, backreferences,
+ * lookarounds or word boundaries: literals, '.', classes such as [a-z] or
+ * [^0-9], the \d \w \s \D \W \S escapes, non-capturing groups, '|', the
+ * greedy and lazy quantifiers (*, +, ?, {m}, {m,}, {m,n}) and the '^' and '$'
+ * anchors, which only match at the ends of the text. Patterns are matched
+ * byte by byte.
+ */
+class parser {
+ public:
+   /**
+    * @brief Constructs a parser for a pattern.
+    */
+   explicit parser(std::string_view pattern_) : m_pattern(pattern_), m_pos(0) {}
+
+   /**
+    * @brief Parses the whole pattern.
+    *
+    * @throw std::invalid_argument if the pattern is not valid.
+    */
+   node parse() {
+      node root{alternation()};
+      if (m_pos != m_pattern.size()) {
+         fail("unmatched ')'");
+      }
+      return root;
+   }
+
+ private:
+   [[noreturn]] void fail(char const *reason_) const {
+      throw std::invalid_argument("Invalid regular expression at position " +
+                                  std::to_string(m_pos) + ": " + reason_ +
+                                  ".");
+   }
+
+   bool done() const { return m_pos == m_pattern.size(); }
+
+   bool peek(char char_) const {
+      return !done() && m_pattern[m_pos] == char_;
+   }
+
+   bool accept(char char_) {
+      if (!peek(char_)) {
+         return false;
+      }
+      ++m_pos;
+      return true;
+   }
+
+   static node make(node::kind type_) {
+      node made;
+      made.type = type_;
+      return made;
+   }
+
+   static node make(byte_set const &set_) {
+      node made{make(node::kind::bytes)};
+      made.set = set_;
+      return made;
+   }
+
+   node alternation() {
+      node first{concatenation()};
+      if (!peek('|')) {
+         return first;
+      }
+
+      node choice{make(node::kind::alternate)};
+      choice.children.push_back(std::move(first));
+      while (accept('|')) {
+         choice.children.push_back(concatenation());
+      }
+      return choice;
+   }
+
+   node concatenation() {
+      node sequence{make(node::kind::concat)};
+
+      while (!done() && !peek('|') && !peek(')')) {
+         node item{repetition()};
+         if (item.type == node::kind::concat) {
+            std::move(item.children.begin(), item.children.end(),
+                      std::back_inserter(sequence.children));
+         } else {
+            sequence.children.push_back(std::move(item));
+         }
+      }
+
+      if (sequence.children.empty()) {
+         return make(node::kind::empty);
+      }
+      if (sequence.children.size() == 1) {
+         return std::move(sequence.children.front());
+      }
+      return sequence;
+   }
+
+   node repetition() {
+      bool const anchor{peek('^') || peek('$')};
+      node item{atom()};
+      size_type min{0};
+      size_type max{0};
+
+      if (!quantifier(min, max)) {
+         return item;
+      }
+      if (anchor) {
+         fail("nothing to repeat");
+      }
+
+      node repeated{make(node::kind::repeat)};
+      repeated.min = min;
+      repeated.max = max;
+      repeated.greedy = !accept('?');
+      repeated.children.push_back(std::move(item));
+
+      size_type const after{m_pos};
+      if (quantifier(min, max)) {
+         m_pos = after;
+         fail("nothing to repeat");
+      }
+      return repeated;
+   }
+
+   bool quantifier(size_type &min_, size_type &max_) {
+      if (accept('*')) {
+         min_ = 0;
+         max_ = unbounded;
+      } else if (accept('+')) {
+         min_ = 1;
+         max_ = unbounded;
+      } else if (accept('?')) {
+         min_ = 0;
+         max_ = 1;
+      } else if (peek('{')) {
+         size_type const start{m_pos++};
+         if (!number(min_)) {
+            m_pos = start; // A '{' that starts no bound is a literal
+            return false;
+         }
+
+         max_ = min_;
+         if (accept(',')) {
+            max_ = peek('}') ? unbounded : 0;
+            if (max_ == 0 && !number(max_)) {
+               m_pos = start;
+               return false;
+            }
+         }
+         if (!accept('}')) {
+            m_pos = start;
+            return false;
+         }
+
+         if (max_ < min_) {
+            fail("numbers out of order in {} quantifier");
+         }
+         if (min_ > max_repeat || (max_ != unbounded && max_ > max_repeat)) {
+            fail("repetition count too large");
+         }
+      } else {
+         return false;
+      }
+      return true;
+   }
+
+   bool number(size_type &value_) {
+      size_type const start{m_pos};
+      value_ = 0;
+
+      while (!done() && m_pattern[m_pos] >= '0' && m_pattern[m_pos] <= '9') {
+         value_ = std::min(value_ * 10 + size_type(m_pattern[m_pos] - '0'),
+                           max_repeat + 1);
+         ++m_pos;
+      }
+      return m_pos != start;
+   }
+
+   node atom() {
+      char const char_{m_pattern[m_pos++]};
+
+      switch (char_) {
+      case '(': {
+         if (accept('?')) {
+            if (!accept(':')) {
+               fail("unsupported group");
+            }
+         }
+         node inner{alternation()};
+         if (!accept(')')) {
+            fail("missing ')'");
+         }
+         return inner;
+      }
+      case '[':
+         return make(bracket());
+      case '.': {
+         byte_set set;
+         set.set();
+         set.reset('\n');
+         return make(set);
+      }
+      case '^':
+         return make(node::kind::begin);
+      case '$':
+         return make(node::kind::end);
+      case '\\':
+         return make(escape(nullptr));
+      case '*':
+      case '+':
+      case '?':
+         --m_pos;
+         fail("nothing to repeat");
+      default: {
+         byte_set set;
+         set.set(static_cast<unsigned char>(char_));
+         return make(set);
+      }
+      }
+   }
+
+   /**
+    * @brief Parses the escape after a backslash.
+    *
+    * @param single_ Receives the byte if the escape is a single byte, -1
+    * otherwise (nullptr if not needed).
+    */
+   byte_set escape(int *single_) {
+      if (done()) {
+         fail("trailing backslash");
+      }
+
+      byte_set set;
+      unsigned char const char_{
+          static_cast<unsigned char>(m_pattern[m_pos++])};
+      unsigned char byte{char_};
+
+      switch (char_) {
+      case 'd':
+      case 'D':
+         for (unsigned char digit{'0'}; digit <= '9'; ++digit) {
+            set.set(digit);
+         }
+         break;
+      case 'w':
+      case 'W':
+         for (unsigned index{0}; index != 256; ++index) {
+            set[index] = (index >= 'a' && index <= 'z') ||
+                         (index >= 'A' && index <= 'Z') ||
+                         (index >= '0' && index <= '9') || index == '_';
+         }
+         break;
+      case 's':
+      case 'S':
+         for (unsigned char space : std::string_view(" \t\n\r\f\v")) {
+            set.set(space);
+         }
+         break;
+      case 'n':
+         byte = '\n';
+         break;
+      case 't':
+         byte = '\t';
+         break;
+      case 'r':
+         byte = '\r';
+         break;
+      case 'f':
+         byte = '\f';
+         break;
+      case 'v':
+         byte = '\v';
+         break;
+      case '0':
+         byte = '\0';
+         break;
+      case 'x': {
+         unsigned value{0};
+         for (int digit{0}; digit != 2; ++digit) {
+            char const hex{done() ? '\0' : m_pattern[m_pos++]};
+            if (hex >= '0' && hex <= '9') {
+               value = value * 16 + unsigned(hex - '0');
+            } else if ((hex | 0x20) >= 'a' && (hex | 0x20) <= 'f') {
+               value = value * 16 + unsigned((hex | 0x20) - 'a' + 10);
+            } else {
+               fail("invalid \\x escape");
+            }
+         }
+         byte = static_cast<unsigned char>(value);
+         break;
+      }
+      default:
+         if ((char_ >= 'a' && char_ <= 'z') || (char_ >= 'A' && char_ <= 'Z') ||
+             (char_ >= '0' && char_ <= '9')) {
+            --m_pos;
+            fail("unsupported escape");
+         }
+      }
+
+      if (set.any()) {
+         if (char_ >= 'A' && char_ <= 'Z') {
+            set.flip();
+         }
+         if (single_ != nullptr) {
+            *single_ = -1;
+         }
+         return set;
+      }
+
+      set.set(byte);
+      if (single_ != nullptr) {
+         *single_ = byte;
+      }
+      return set;
+   }
+
+   /**
+    * @brief Parses one member of a class.
+    *
+    * @return The byte if the member is a single byte, -1 otherwise.
+    */
+   int member(byte_set &set_) {
+      if (accept('\\')) {
+         int single{-1};
+         set_ |= escape(&single);
+         return single;
+      }
+
+      unsigned char const byte{static_cast<unsigned char>(m_pattern[m_pos++])};
+      set_.set(byte);
+      return byte;
+   }
+
+   byte_set bracket() {
+      bool const negated{accept('^')};
+      byte_set set;
+
+      for (bool first{true};; first = false) {
+         if (done()) {
+            fail("missing ']'");
+         }
+         if (!first && accept(']')) {
+            break;
+         }
+
+         int const low{member(set)};
+         if (peek('-') && m_pos + 1 < m_pattern.size() &&
+             m_pattern[m_pos + 1] != ']') {
+            ++m_pos;
+            byte_set upper;
+            int const high{member(upper)};
+            if (low < 0 || high < 0 || high < low) {
+               fail("invalid range in class");
+            }
+            for (int byte{low}; byte <= high; ++byte) {
+               set.set(static_cast<size_type>(byte));
+            }
+         }
+      }
+
+      return negated ? ~set : set;
+   }
+
+   std::string_view m_pattern; ///< The pattern.
+   size_type m_pos;            ///< Position of the next character.
+};
+
+/**
+ * @brief The operations of the NFA.
+ */
+enum class op : std::uint8_t {
+   bytes, ///< Consumes a byte of a set, then goes to next.
+   split, ///< Goes to next, then (less preferred) to alt.
+   begin, ///< Goes to next at the beginning of the scan.
+   end,   ///< Goes to next at the end of the scan.
+   match, ///< Accepts.
+};
+
+/**
+ * @brief An instruction of the NFA.
+ */
+struct inst {
+   op code;            ///< The operation.
+   std::uint32_t next; ///< The preferred successor.
+   std::uint32_t alt;  ///< The other successor of a split, or none.
+   std::uint32_t set;  ///< Index of the byte set of a bytes instruction.
+};
+
+/**
+ * @brief A Thompson NFA.
+ */
+struct program {
+   std::vector<inst> code;     ///< The instructions, code[0] accepts.
+   std::uint32_t start{none};  ///< The first instruction.
+};
+
+/**
+ * @brief Compiles a syntax tree into a program, forwards or reversed.
+ *
+ * Each node is compiled with its successor already known, so nothing has to
+ * be patched afterwards.
+ */
+class compiler {
+ public:
+   /**
+    * @brief Constructs a compiler.
+    *
+    * @param sets_ The byte sets, shared by the programs of a pattern.
+    * @param reversed_ Whether to compile the reversed pattern, whose '^' and
+    * '$' swap roles.
+    */
+   compiler(std::vector<byte_set> &sets_, bool reversed_)
+       : m_sets(sets_), m_reversed(reversed_) {}
+
+   /**
+    * @brief Compiles a syntax tree.
+    *
+    * @throw std::invalid_argument if the program is too large.
+    */
+   program compile(node const &root_) {
+      m_program.code.push_back(inst{op::match, none, none, 0});
+      m_program.start = emit(root_, 0);
+      return std::move(m_program);
+   }
+
+ private:
+   std::uint32_t add(inst const &inst_) {
+      if (m_program.code.size() == max_program) {
+         throw std::invalid_argument(
+             "Invalid regular expression: the pattern is too large.");
+      }
+      m_program.code.push_back(inst_);
+      return static_cast<std::uint32_t>(m_program.code.size() - 1);
+   }
+
+   std::uint32_t set_index(byte_set const &set_) {
+      auto const found{std::find(m_sets.begin(), m_sets.end(), set_)};
+      if (found != m_sets.end()) {
+         return static_cast<std::uint32_t>(found - m_sets.begin());
+      }
+      m_sets.push_back(set_);
+      return static_cast<std::uint32_t>(m_sets.size() - 1);
+   }
+
+   std::uint32_t split(std::uint32_t first_, std::uint32_t second_) {
+      return add(inst{op::split, first_, second_, 0});
+   }
+
+   std::uint32_t emit(node const &node_, std::uint32_t next_) {
+      switch (node_.type) {
+      case node::kind::empty:
+         return next_;
+      case node::kind::bytes:
+         return add(inst{op::bytes, next_, none, set_index(node_.set)});
+      case node::kind::begin:
+         return add(inst{m_reversed ? op::end : op::begin, next_, none, 0});
+      case node::kind::end:
+         return add(inst{m_reversed ? op::begin : op::end, next_, none, 0});
+      case node::kind::concat:
+         if (m_reversed) {
+            for (node const &child : node_.children) {
+               next_ = emit(child, next_);
+            }
+         } else {
+            for (auto child{node_.children.rbegin()};
+                 child != node_.children.rend(); ++child) {
+               next_ = emit(*child, next_);
+            }
+         }
+         return next_;
+      case node::kind::alternate: {
+         std::uint32_t entry{emit(node_.children.back(), next_)};
+         for (auto child{node_.children.rbegin() + 1};
+              child != node_.children.rend(); ++child) {
+            entry = split(emit(*child, next_), entry);
+         }
+         return entry;
+      }
+      case node::kind::repeat:
+         break;
+      }
+
+      node const &child{node_.children.front()};
+      std::uint32_t entry{next_};
+
+      if (node_.max == unbounded) {
+         std::uint32_t const loop{split(none, none)};
+         std::uint32_t const body{emit(child, loop)};
+         m_program.code[loop].next = node_.greedy ? body : next_;
+         m_program.code[loop].alt = node_.greedy ? next_ : body;
+         entry = loop;
+      } else {
+         // x{0,2} is compiled as (x(x)?)?, each choice leaving to next_
+         for (size_type count{node_.min}; count != node_.max; ++count) {
+            std::uint32_t const body{emit(child, entry)};
+            entry = node_.greedy ? split(body, next_) : split(next_, body);
+         }
+      }
+
+      for (size_type count{0}; count != node_.min; ++count) {
+         entry = emit(child, entry);
+      }
+      return entry;
+   }
+
+   std::vector<byte_set> &m_sets; ///< The byte sets.
+   bool m_reversed;               ///< Whether the pattern is reversed.
+   program m_program;             ///< The program being compiled.
+};
+
+/**
+ * @brief A lazily built DFA over a program.
+ *
+ * A state is the ordered list of the NFA instructions that are alive, plus
+ * whether new matches may still start (unanchored searches only). In
+ * leftmost-first mode the list is cut after the first match, since threads
+ * with a lower priority can no longer win; in longest mode nothing is cut.
+ * The transitions are computed the first time they are taken. When the
+ * states use more than cache_limit bytes, they are all dropped and built
+ * again as needed.
+ */
+class dfa {
+ public:
+   static constexpr std::uint32_t dead{0}; ///< The state without threads.
+
+   /**
+    * @brief Constructs an empty DFA.
+    *
+    * @param program_ The program to run.
+    * @param sets_ The byte sets of the program.
+    * @param classes_ The class of each byte.
+    * @param count_ The number of classes.
+    * @param first_ Whether the search is leftmost-first (or longest).
+    * @param unanchored_ Whether matches may start anywhere.
+    */
+   dfa(program const &program_, std::vector<byte_set> const &sets_,
+       std::array<std::uint8_t, 256> const &classes_, size_type count_,
+       bool first_, bool unanchored_)
+       : m_program(program_), m_sets(sets_), m_classes(classes_),
+         m_stride(count_), m_first(first_), m_unanchored(unanchored_),
+         m_marks(program_.code.size(), 0), m_stamp(0) {
+      m_representatives.resize(count_);
+      for (unsigned index{256}; index-- != 0;) {
+         m_representatives[classes_[index]] = static_cast<unsigned char>(index);
+      }
+      reset();
+   }
+
+   /**
+    * @brief Gets the state before the first byte.
+    *
+    * @param at_begin_ Whether the scan starts at its '^' end.
+    */
+   std::uint32_t start(bool at_begin_) {
+      std::uint32_t &start{m_start[at_begin_]};
+
+      if (start == none) {
+         m_key.clear();
+         bool matched{false};
+         stamp();
+         closure(m_key, m_program.start, at_begin_, false, matched);
+         if (m_unanchored && !(matched && m_first)) {
+            m_key.push_back(char32_t(none));
+         }
+         std::uint32_t const state{insert(m_key)};
+         m_start[at_begin_] = state;
+         m_flags[state] |= flag_start;
+      }
+
+      return m_start[at_begin_];
+   }
+
+   /**
+    * @brief Gets the state after a byte.
+    */
+   std::uint32_t next(std::uint32_t state_, unsigned char byte_) {
+      size_type const slot{state_ * m_stride + m_classes[byte_]};
+      std::uint32_t const target{m_table[slot]};
+      return target != none ? target : compute(state_, m_classes[byte_]);
+   }
+
+   /**
+    * @brief Checks if a match ends before the last byte taken.
+    */
+   bool accepts(std::uint32_t state_) const {
+      return (m_flags[state_] & flag_match) != 0;
+   }
+
+   /**
+    * @brief Checks if a match ends at the end of the scan.
+    *
+    * @param at_begin_ Whether the scan is also at its '^' end, which only
+    * happens when the text is empty.
+    */
+   bool accepts_at_end(std::uint32_t state_, bool at_begin_ = false) {
+      if ((m_flags[state_] & (flag_match | flag_end)) != 0) {
+         return true;
+      }
+      return at_begin_ && ends(*m_keys[state_], true);
+   }
+
+   /**
+    * @brief Checks if a state is one of the start states.
+    */
+   bool is_start(std::uint32_t state_) const {
+      return (m_flags[state_] & flag_start) != 0;
+   }
+
+ private:
+   static constexpr std::uint8_t flag_match{1}; ///< Has a match thread.
+   static constexpr std::uint8_t flag_end{2};   ///< Matches at the end.
+   static constexpr std::uint8_t flag_start{4}; ///< Is a start state.
+
+   using key = std::u32string; ///< Instructions, none if still unanchored.
+
+   void stamp() {
+      if (++m_stamp == 0) {
+         std::fill(m_marks.begin(), m_marks.end(), 0);
+         m_stamp = 1;
+      }
+   }
+
+   /**
+    * @brief Adds the instructions reachable without a byte, in priority
+    * order, skipping those already added since the last stamp().
+    */
+   void closure(key &list_, std::uint32_t pc_, bool at_begin_, bool at_end_,
+                bool &matched_) {
+      m_stack.push_back(pc_);
+
+      while (!m_stack.empty()) {
+         std::uint32_t const pc{m_stack.back()};
+         m_stack.pop_back();
+
+         if (pc == none || m_marks[pc] == m_stamp) {
+            continue;
+         }
+         m_marks[pc] = m_stamp;
+
+         inst const &current{m_program.code[pc]};
+         switch (current.code) {
+         case op::bytes:
+            list_.push_back(char32_t(pc));
+            break;
+         case op::match:
+            list_.push_back(char32_t(pc));
+            matched_ = true;
+            if (m_first) {
+               m_stack.clear();
+            }
+            break;
+         case op::split:
+            m_stack.push_back(current.alt);
+            m_stack.push_back(current.next);
+            break;
+         case op::begin:
+            if (at_begin_) {
+               m_stack.push_back(current.next);
+            }
+            break;
+         case op::end:
+            if (at_end_) {
+               m_stack.push_back(current.next);
+            } else {
+               list_.push_back(char32_t(pc));
+            }
+            break;
+         }
+      }
+   }
+
+   std::uint32_t compute(std::uint32_t state_, std::uint8_t class_) {
+      unsigned char const byte{m_representatives[class_]};
+      key const &source{*m_keys[state_]};
+      bool matched{false};
+
+      m_key.clear();
+      stamp();
+      for (char32_t const pc : source) {
+         if (pc == char32_t(none)) {
+            continue;
+         }
+
+         inst const &current{m_program.code[pc]};
+         if (current.code == op::bytes && m_sets[current.set][byte]) {
+            closure(m_key, current.next, false, false, matched);
+            if (matched && m_first) {
+               break;
+            }
+         }
+      }
+
+      if (!source.empty() && source.back() == char32_t(none) &&
+          !(matched && m_first)) {
+         closure(m_key, m_program.start, false, false, matched);
+         if (!(matched && m_first)) {
+            m_key.push_back(char32_t(none));
+         }
+      }
+
+      size_type const resets{m_resets};
+      std::uint32_t const target{insert(m_key)};
+      if (resets == m_resets) {
+         m_table[state_ * m_stride + class_] = target;
+      }
+      return target;
+   }
+
+   /**
+    * @brief Checks if the instructions of a state reach a match at the end of
+    * the scan.
+    */
+   bool ends(key const &key_, bool at_begin_) {
+      bool matched{false};
+      key scratch;
+
+      stamp();
+      for (char32_t const pc : key_) {
+         if (pc != char32_t(none) && m_program.code[pc].code == op::end) {
+            closure(scratch, m_program.code[pc].next, at_begin_, true, matched);
+            if (matched) {
+               return true;
+            }
+         }
+      }
+      return false;
+   }
+
+   std::uint32_t insert(key const &key_) {
+      auto const found{m_index.find(key_)};
+      if (found != m_index.end()) {
+         return found->second;
+      }
+
+      if (m_table.size() * sizeof(std::uint32_t) + m_bytes > cache_limit) {
+         reset();
+         ++m_resets;
+         if (key_.empty()) {
+            return dead;
+         }
+      }
+
+      std::uint8_t flags{ends(key_, false) ? flag_end : std::uint8_t{0}};
+      for (char32_t const pc : key_) {
+         if (pc != char32_t(none) && m_program.code[pc].code == op::match) {
+            flags |= flag_match;
+         }
+      }
+
+      std::uint32_t const state{static_cast<std::uint32_t>(m_flags.size())};
+      auto const inserted{m_index.emplace(key_, state).first};
+      m_keys.push_back(&inserted->first);
+      m_flags.push_back(flags);
+      m_table.resize(m_table.size() + m_stride, none);
+      m_bytes += 2 * key_.size() * sizeof(char32_t) + 64;
+      return state;
+   }
+
+   void reset() {
+      m_index.clear();
+      m_keys.clear();
+      m_flags.clear();
+      m_table.clear();
+      m_bytes = 0;
+      m_start[0] = m_start[1] = none;
+
+      auto const inserted{m_index.emplace(key(), dead).first};
+      m_keys.push_back(&inserted->first);
+      m_flags.push_back(0);
+      m_table.resize(m_stride, dead);
+   }
+
+   program const &m_program;                      ///< The program.
+   std::vector<byte_set> const &m_sets;           ///< Its byte sets.
+   std::array<std::uint8_t, 256> const &m_classes; ///< Class of each byte.
+   std::vector<unsigned char> m_representatives;  ///< A byte per class.
+   size_type m_stride;                            ///< Number of classes.
+   bool m_first;                                  ///< Leftmost-first mode.
+   bool m_unanchored;                             ///< Unanchored search.
+
+   std::unordered_map<key, std::uint32_t> m_index; ///< State of each key.
+   std::vector<key const *> m_keys;               ///< Key of each state.
+   std::vector<std::uint8_t> m_flags;             ///< Flags of each state.
+   std::vector<std::uint32_t> m_table;            ///< Known transitions.
+   std::uint32_t m_start[2]{none, none};          ///< Start states.
+   size_type m_bytes{0};                          ///< Size of the keys.
+   size_type m_resets{0};                         ///< Times dropped.
+
+   std::vector<std::uint32_t> m_marks; ///< Stamp of each visited inst.
+   std::uint32_t m_stamp;              ///< Current closure stamp.
+   std::vector<std::uint32_t> m_stack; ///< Closure work list.
+   key m_key;                          ///< Key being built.
+};
+
+struct cache;
+
+/**
+ * @brief A compiled pattern, shared by the copies of a regex.
+ */
+struct compiled {
+   std::string pattern;                   ///< The source pattern.
+   std::vector<byte_set> sets;            ///< The byte sets.
+   program forward;                       ///< The pattern.
+   program reverse;                       ///< The reversed pattern.
+   std::array<std::uint8_t, 256> classes; ///< Class of each byte.
+   size_type count;                       ///< Number of classes.
+   std::optional<searcher> prefix;        ///< Literal every match starts with.
+
+   std::mutex mutex; ///< Guards the pool.
+   std::vector<std::unique_ptr<cache>> pool; ///< Idle caches.
+};
+
+/**
+ * @brief The DFAs used by a search, one search at a time.
+ */
+struct cache {
+   /**
+    * @brief Constructs the DFAs of a compiled pattern.
+    */
+   explicit cache(compiled const &compiled_)
+       : search(compiled_.forward, compiled_.sets, compiled_.classes,
+                compiled_.count, true, true),
+         full(compiled_.forward, compiled_.sets, compiled_.classes,
+              compiled_.count, false, false),
+         reverse(compiled_.reverse, compiled_.sets, compiled_.classes,
+                 compiled_.count, false, false) {}
+
+   dfa search;  ///< Leftmost-first, unanchored, forwards.
+   dfa full;    ///< Longest, anchored, forwards.
+   dfa reverse; ///< Longest, anchored, backwards.
+};
+
+} // namespace rx
+
+/**
+ * @brief A compiled regular expression.
+ */
+class regex {
+ public:
+   using size_type = std::size_t;
+
+   static constexpr size_type npos{std::string_view::npos}; ///< Not found.
+
+   /**
+    * @brief An occurrence of the pattern.
+    */
+   struct match {
+      size_type position; ///< Position of the occurrence, npos if none.
+      size_type size;     ///< Size of the occurrence.
+
+      /**
+       * @brief Checks if the pattern was found.
+       */
+      explicit operator bool() const { return position != npos; }
+   };
+
+   /**
+    * @brief Compiles a pattern.
+    *
+    * @param pattern_ The pattern, in the syntax described in rx::parser.
+    * @throw std::invalid_argument if the pattern is not valid.
+    */
+   explicit regex(std::string_view pattern_)
+       : m_compiled(std::make_shared<rx::compiled>()) {
+      rx::compiled &compiled{*m_compiled};
+      rx::node const root{rx::parser(pattern_).parse()};
+
+      compiled.pattern = pattern_;
+      compiled.forward = rx::compiler(compiled.sets, false).compile(root);
+      compiled.reverse = rx::compiler(compiled.sets, true).compile(root);
+
+      // Bytes that every set treats alike share a class
+      compiled.classes.fill(0);
+      compiled.count = 1;
+      for (unsigned index{1}; index != 256; ++index) {
+         bool const boundary{std::any_of(
+             compiled.sets.begin(), compiled.sets.end(),
+             [index](rx::byte_set const &set_) {
+                return set_[index] != set_[index - 1];
+             })};
+         compiled.count += boundary;
+         compiled.classes[index] =
+             static_cast<std::uint8_t>(compiled.count - 1);
+      }
+
+      std::string const prefix{literal_prefix(root)};
+      if (!prefix.empty()) {
+         compiled.prefix.emplace(prefix);
+      }
+   }
+
+   /**
+    * @brief Gets the pattern.
+    */
+   std::string_view pattern() const { return m_compiled->pattern; }
+
+   /**
+    * @brief Checks if the pattern matches a whole text.
+    *
+    * @param text_ The text to match.
+    * @return True if the whole text matches, false otherwise.
+    */
+   bool matches(std::string_view text_) const {
+      lease borrowed{*m_compiled};
+      rx::dfa &full{borrowed->full};
+      std::uint32_t state{full.start(true)};
+
+      for (char const char_ : text_) {
+         state = full.next(state, static_cast<unsigned char>(char_));
+         if (state == rx::dfa::dead) {
+            return false;
+         }
+      }
+
+      return full.accepts_at_end(state, text_.empty());
+   }
+
+   /**
+    * @brief Checks if the pattern occurs in a text. The search stops at the
+    * first byte where a match ends.
+    *
+    * @param text_ The text to search in.
+    * @return True if the pattern occurs, false otherwise.
+    */
+   bool contains(std::string_view text_) const {
+      lease borrowed{*m_compiled};
+      return scan(*borrowed, text_, 0, true) != npos;
+   }
+
+   /**
+    * @brief Finds the leftmost occurrence of the pattern (the one a
+    * backtracking engine would report first among those that start there).
+    *
+    * @param text_ The text to search in.
+    * @param pos_ The position to start the search (default is 0). A '^' only
+    * matches at position 0.
+    * @return The occurrence, false when converted to bool if there is none.
+    */
+   match find(std::string_view text_, size_type pos_ = 0) const {
+      lease borrowed{*m_compiled};
+      return find(*borrowed, text_, pos_);
+   }
+
+   /**
+    * @brief Finds the non-overlapping occurrences of the pattern, left to
+    * right. After an empty occurrence the search goes on one byte later.
+    *
+    * @param text_ The text to search in.
+    * @return The occurrences.
+    */
+   std::vector<match> find_all(std::string_view text_) const {
+      lease borrowed{*m_compiled};
+      std::vector<match> occurrences;
+
+      for (match found{find(*borrowed, text_, 0)}; found;
+           found = find(*borrowed, text_, after(found))) {
+         occurrences.push_back(found);
+      }
+
+      return occurrences;
+   }
+
+   /**
+    * @brief Appends a text to a string, with every occurrence of the pattern
+    * replaced, as find_all() finds them.
+    *
+    * @tparam String The type of the output string.
+    * @param text_ The text to search in.
+    * @param replace_ The replacement, copied as is.
+    * @param out_ The string to append to.
+    * @return The number of replaced occurrences.
+    */
+   template <class String>
+   size_type replace(std::string_view text_, std::string_view replace_,
+                     String &out_) const {
+      lease borrowed{*m_compiled};
+      size_type count{0};
+      size_type first{0};
+
+      out_.reserve(out_.size() + text_.size());
+      for (match found{find(*borrowed, text_, 0)}; found;
+           found = find(*borrowed, text_, after(found))) {
+         out_.append(text_.data() + first, found.position - first);
+         out_.append(replace_.data(), replace_.size());
+         first = found.position + found.size;
+         ++count;
+      }
+      out_.append(text_.data() + first, text_.size() - first);
+
+      return count;
+   }
+
+   /**
+    * @brief Replaces every occurrence of the pattern, as find_all() finds
+    * them.
+    *
+    * @param text_ The text to search in.
+    * @param replace_ The replacement, copied as is.
+    * @return The text with the occurrences replaced.
+    */
+   std::string replace(std::string_view text_,
+                       std::string_view replace_) const {
+      std::string out;
+      replace(text_, replace_, out);
+      return out;
+   }
+
+ private:
+   /**
+    * @brief Borrows a cache from the pool for the lifetime of a search.
+    */
+   class lease {
+    public:
+      explicit lease(rx::compiled &compiled_) : m_compiled(compiled_) {
+         {
+            std::lock_guard<std::mutex> const lock{m_compiled.mutex};
+            if (!m_compiled.pool.empty()) {
+               m_cache = std::move(m_compiled.pool.back());
+               m_compiled.pool.pop_back();
+            }
+         }
+         if (!m_cache) {
+            m_cache = std::make_unique<rx::cache>(m_compiled);
+         }
+      }
+
+      lease(lease const &) = delete;
+      lease &operator=(lease const &) = delete;
+
+      ~lease() {
+         std::lock_guard<std::mutex> const lock{m_compiled.mutex};
+         m_compiled.pool.push_back(std::move(m_cache));
+      }
+
+      rx::cache &operator*() const { return *m_cache; }
+      rx::cache *operator->() const { return m_cache.get(); }
+
+    private:
+      rx::compiled &m_compiled;          ///< The pattern that owns the pool.
+      std::unique_ptr<rx::cache> m_cache; ///< The borrowed cache.
+   };
+
+   /**
+    * @brief Gets the literal that every match starts with, if any.
+    */
+   static std::string literal_prefix(rx::node const &root_) {
+      std::string prefix;
+      auto const literal{[&prefix](rx::node const &node_) {
+         if (node_.type != rx::node::kind::bytes || node_.set.count() != 1) {
+            return false;
+         }
+         for (unsigned index{0}; index != 256; ++index) {
+            if (node_.set[index]) {
+               prefix += static_cast<char>(index);
+            }
+         }
+         return true;
+      }};
+
+      if (root_.type == rx::node::kind::concat) {
+         for (rx::node const &child : root_.children) {
+            if (!literal(child)) {
+               break;
+            }
+         }
+      } else {
+         literal(root_);
+      }
+
+      return prefix;
+   }
+
+   /**
+    * @brief Gets where the next search starts after an occurrence.
+    */
+   static size_type after(match const &found_) {
+      return found_.position + std::max<size_type>(found_.size, 1);
+   }
+
+   /**
+    * @brief Runs the leftmost-first DFA from a position.
+    *
+    * @param earliest_ Whether to stop at the first match end.
+    * @return The end of the leftmost-first match, or npos if there is none.
+    */
+   size_type scan(rx::cache &cache_, std::string_view text_, size_type pos_,
+                  bool earliest_) const {
+      rx::dfa &search{cache_.search};
+      std::optional<searcher> const &prefix{m_compiled->prefix};
+      unsigned char const *const text{
+          reinterpret_cast<unsigned char const *>(text_.data())};
+      size_type last{npos};
+
+      std::uint32_t state{search.start(pos_ == 0)};
+      if (search.accepts(state)) {
+         if (earliest_) {
+            return pos_;
+         }
+         last = pos_;
+      }
+
+      for (size_type index{pos_}; index != text_.size(); ++index) {
+         if (prefix && search.is_start(state)) {
+            index = prefix->find(text_, index);
+            if (index == npos) {
+               return last;
+            }
+            state = search.start(index == 0);
+         }
+
+         state = search.next(state, text[index]);
+         if (state == rx::dfa::dead) {
+            return last;
+         }
+         if (search.accepts(state)) {
+            if (earliest_) {
+               return index + 1;
+            }
+            last = index + 1;
+         }
+      }
+
+      return search.accepts_at_end(state, text_.empty()) ? text_.size()
+                                                           : last;
+   }
+
+   /**
+    * @brief Finds the leftmost-first match with a borrowed cache.
+    */
+   match find(rx::cache &cache_, std::string_view text_,
+              size_type pos_) const {
+      if (pos_ > text_.size()) {
+         return match{npos, 0};
+      }
+
+      size_type const end{scan(cache_, text_, pos_, false)};
+      if (end == npos) {
+         return match{npos, 0};
+      }
+
+      // The leftmost start of the matches that end there
+      rx::dfa &reverse{cache_.reverse};
+      std::uint32_t state{reverse.start(end == text_.size())};
+      size_type start{end};
+
+      for (size_type index{end};; --index) {
+         if (reverse.accepts(state) ||
+             (index == 0 && reverse.accepts_at_end(state, text_.empty()))) {
+            start = index;
+         }
+         if (index == pos_) {
+            break;
+         }
+
+         state = reverse.next(state,
+                              static_cast<unsigned char>(text_[index - 1]));
+         if (state == rx::dfa::dead) {
+            break;
+         }
+      }
+
+      return match{start, end - start};
+   }
+
+   std::shared_ptr<rx::compiled> m_compiled; ///< Shared by the copies.
+};
+
+} // namespace ext
+
+#endif // REGEX_HPP_
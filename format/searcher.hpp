@@ -0,0 +1,362 @@
+/**
+ * @file searcher.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A substring searcher that preprocesses its pattern once.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * A searcher scans with a vector filter on the first and the last byte of the
+ * pattern (SSE2 or AVX2, chosen at compile time, with a memchr fallback) and
+ * only compares the candidates it lets through. If the filter lets too many
+ * false candidates through, as for "aaab" in "aaaa...", the search switches
+ * to the Two-Way algorithm with a Horspool shift table on the last byte, which
+ * never looks at a byte of the text more than a constant number of times. The
+ * factorization and the shift table are computed in the constructor, so a
+ * searcher built once can be used on any number of texts.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef SEARCHER_HPP_
+#define SEARCHER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A precompiled pattern for repeated substring searches.
+ */
+class searcher {
+ public:
+   using size_type = std::size_t;
+
+   static constexpr size_type npos{std::string_view::npos}; ///< Not found.
+
+   /**
+    * @brief Constructs a searcher, copying and preprocessing a pattern.
+    *
+    * @param pattern_ The pattern to search for.
+    */
+   explicit searcher(std::string_view pattern_)
+       : m_pattern(pattern_), m_suffix(0), m_period(1), m_periodic(false),
+         m_shift() {
+      size_type const size{m_pattern.size()};
+      if (size < 2) {
+         return;
+      }
+
+      m_shift.fill(size);
+      for (size_type index{0}; index != size; ++index) {
+         m_shift[byte(m_pattern[index])] = size - index - 1;
+      }
+
+      m_suffix = factorize(m_period);
+      m_periodic = std::memcmp(m_pattern.data(), m_pattern.data() + m_period,
+                               m_suffix) == 0;
+      if (!m_periodic) {
+         m_period = std::max(m_suffix, size - m_suffix) + 1;
+      }
+   }
+
+   /**
+    * @brief Gets the pattern.
+    */
+   std::string_view pattern() const { return m_pattern; }
+
+   /**
+    * @brief Gets the size of the pattern.
+    */
+   size_type size() const { return m_pattern.size(); }
+
+   /**
+    * @brief Finds the first occurrence of the pattern.
+    *
+    * @param text_ The text to search in.
+    * @param pos_ The position to start the search (default is 0).
+    * @return The position of the occurrence, or npos if there is none (an
+    * empty pattern is found at pos_ if pos_ is not past the end).
+    */
+   size_type find(std::string_view text_, size_type pos_ = 0) const {
+      size_type const size{m_pattern.size()};
+
+      if (pos_ > text_.size() || size > text_.size() - pos_) {
+         return npos;
+      }
+      if (size == 0) {
+         return pos_;
+      }
+      if (size == 1) {
+         return text_.find(m_pattern[0], pos_);
+      }
+
+      return filtered(text_, pos_);
+   }
+
+   /**
+    * @brief Checks if the pattern occurs in a text.
+    *
+    * @param text_ The text to search in.
+    * @return True if the pattern occurs, false otherwise.
+    */
+   bool contains(std::string_view text_) const {
+      return find(text_) != npos;
+   }
+
+   /**
+    * @brief Finds the non-overlapping occurrences of the pattern, left to
+    * right, as fstring::replace_all replaces them.
+    *
+    * @param text_ The text to search in.
+    * @return The positions of the occurrences, none if the pattern is empty.
+    */
+   std::vector<size_type> find_all(std::string_view text_) const {
+      std::vector<size_type> positions;
+
+      if (m_pattern.empty()) {
+         return positions;
+      }
+
+      for (size_type pos{find(text_)}; pos != npos;
+           pos = find(text_, pos + m_pattern.size())) {
+         positions.push_back(pos);
+      }
+
+      return positions;
+   }
+
+ private:
+   /**
+    * @brief Gets a character as an unsigned byte.
+    */
+   static unsigned char byte(char char_) {
+      return static_cast<unsigned char>(char_);
+   }
+
+   /**
+    * @brief Computes the critical factorization of the pattern (Crochemore
+    * and Perrin), from the maximal suffixes for both byte orders.
+    *
+    * @param period_ Receives the period of the right half.
+    * @return The start of the right half.
+    */
+   size_type factorize(size_type &period_) const {
+      size_type const size{m_pattern.size()};
+      unsigned char const *const pattern{
+          reinterpret_cast<unsigned char const *>(m_pattern.data())};
+
+      if (size < 3) {
+         period_ = 1;
+         return size - 1;
+      }
+
+      size_type suffixes[2]{};
+      size_type periods[2]{};
+
+      for (int order{0}; order != 2; ++order) {
+         size_type suffix{npos};
+         size_type pos{0};
+         size_type offset{1};
+         size_type period{1};
+
+         while (pos + offset < size) {
+            unsigned char const current{pattern[pos + offset]};
+            unsigned char const best{pattern[suffix + offset]};
+
+            if (current == best) {
+               if (offset != period) {
+                  ++offset;
+               } else {
+                  pos += period;
+                  offset = 1;
+               }
+            } else if ((current < best) == (order == 0)) {
+               pos += offset;
+               offset = 1;
+               period = pos - suffix;
+            } else {
+               suffix = pos++;
+               offset = period = 1;
+            }
+         }
+
+         suffixes[order] = suffix + 1;
+         periods[order] = period;
+      }
+
+      int const order{suffixes[1] < suffixes[0] ? 0 : 1};
+      period_ = periods[order];
+      return suffixes[order];
+   }
+
+   /**
+    * @brief Two-Way search, skipping by the Horspool shift of the byte under
+    * the end of the pattern.
+    *
+    * @param text_ The text to search in.
+    * @param pos_ The position to start the search.
+    * @return The position of the first occurrence, or npos if there is none.
+    */
+   size_type two_way(std::string_view text_, size_type pos_) const {
+      size_type const size{m_pattern.size()};
+      char const *const pattern{m_pattern.data()};
+      char const *const text{text_.data()};
+      size_type memory{0};
+
+      for (size_type start{pos_}; text_.size() - start >= size;) {
+         size_type const shift{m_shift[byte(text[start + size - 1])]};
+
+         if (shift != 0) {
+            // A periodic pattern cannot match before the mismatch is passed
+            start += m_periodic && memory != 0 && shift < m_period
+                         ? size - m_period
+                         : shift;
+            memory = 0;
+            continue;
+         }
+
+         size_type index{std::max(m_suffix, memory)};
+         while (index < size - 1 && pattern[index] == text[start + index]) {
+            ++index;
+         }
+
+         if (index < size - 1) {
+            start += index - m_suffix + 1;
+            memory = 0;
+            continue;
+         }
+
+         index = m_suffix;
+         while (index > memory &&
+                pattern[index - 1] == text[start + index - 1]) {
+            --index;
+         }
+
+         if (index <= memory) {
+            return start;
+         }
+
+         start += m_period;
+         memory = m_periodic ? size - m_period : 0;
+      }
+
+      return npos;
+   }
+
+   /**
+    * @brief Checks a candidate whose first and last bytes already match.
+    */
+   bool matches_at(char const *candidate_) const {
+      return std::memcmp(candidate_ + 1, m_pattern.data() + 1,
+                         m_pattern.size() - 2) == 0;
+   }
+
+   /**
+    * @brief Searches with the first and last byte filter, switching to
+    * two_way() once the rejected candidates cost more than a few passes over
+    * the text.
+    *
+    * @param text_ The text to search in.
+    * @param pos_ The position to start the search.
+    * @return The position of the first occurrence, or npos if there is none.
+    */
+   size_type filtered(std::string_view text_, size_type pos_) const {
+      size_type const size{m_pattern.size()};
+      char const *const text{text_.data()};
+      size_type const last{text_.size() - size}; // Last possible start
+      size_type budget{4096};
+      size_type start{pos_};
+
+#if defined(__AVX2__)
+      constexpr size_type block{32};
+      __m256i const first_byte{_mm256_set1_epi8(m_pattern.front())};
+      __m256i const last_byte{_mm256_set1_epi8(m_pattern.back())};
+
+      for (; last - start >= block; start += block) {
+         __m256i const head{_mm256_loadu_si256(
+             reinterpret_cast<__m256i const *>(text + start))};
+         __m256i const tail{_mm256_loadu_si256(
+             reinterpret_cast<__m256i const *>(text + start + size - 1))};
+         unsigned mask{static_cast<unsigned>(_mm256_movemask_epi8(
+             _mm256_and_si256(_mm256_cmpeq_epi8(head, first_byte),
+                              _mm256_cmpeq_epi8(tail, last_byte))))};
+#elif defined(__SSE2__)
+      constexpr size_type block{16};
+      __m128i const first_byte{_mm_set1_epi8(m_pattern.front())};
+      __m128i const last_byte{_mm_set1_epi8(m_pattern.back())};
+
+      for (; last - start >= block; start += block) {
+         __m128i const head{
+             _mm_loadu_si128(reinterpret_cast<__m128i const *>(text + start))};
+         __m128i const tail{_mm_loadu_si128(
+             reinterpret_cast<__m128i const *>(text + start + size - 1))};
+         unsigned mask{static_cast<unsigned>(_mm_movemask_epi8(
+             _mm_and_si128(_mm_cmpeq_epi8(head, first_byte),
+                           _mm_cmpeq_epi8(tail, last_byte))))};
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+         for (; mask != 0; mask &= mask - 1) {
+            size_type const candidate{start + static_cast<size_type>(
+                                                  __builtin_ctz(mask))};
+            if (matches_at(text + candidate)) {
+               return candidate;
+            }
+
+            if (budget < size) {
+               return two_way(text_, candidate + 1);
+            }
+            budget -= size;
+         }
+
+         budget += 4 * block;
+      }
+#endif
+
+      while (start <= last) {
+         void const *const found{
+             std::memchr(text + start, m_pattern.front(), last - start + 1)};
+         if (found == nullptr) {
+            return npos;
+         }
+
+         size_type const candidate{
+             static_cast<size_type>(static_cast<char const *>(found) - text)};
+         if (text[candidate + size - 1] == m_pattern.back() &&
+             matches_at(text + candidate)) {
+            return candidate;
+         }
+
+         if (budget < size) {
+            return two_way(text_, candidate + 1);
+         }
+         budget -= size;
+         budget += 4 * (candidate + 1 - start);
+         start = candidate + 1;
+      }
+
+      return npos;
+   }
+
+   std::string m_pattern; ///< The pattern.
+   size_type m_suffix;    ///< Start of the right half of the factorization.
+   size_type m_period;    ///< Shift after a match of the right half.
+   bool m_periodic;       ///< Whether the left half repeats with the period.
+   std::array<size_type, 256> m_shift; ///< Horspool shift per last byte.
+};
+
+} // namespace ext
+
+#endif // SEARCHER_HPP_
@@ -0,0 +1,360 @@
+/**
+ * @file split_view.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A lazy range of tokens over a character sequence.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The tokens are yielded as std::basic_string_view objects pointing into the
+ * source, so iterating the range never allocates. The source must outlive the
+ * range and its iterators.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef SPLIT_VIEW_HPP_
+#define SPLIT_VIEW_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+#include "charset.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief How a split handles consecutive delimiters and line endings.
+ */
+enum class split_mode {
+   skip_empty, ///< Consecutive delimiters are merged, no empty tokens.
+   keep_empty, ///< Every delimiter ends a token, even an empty one.
+   lines,      ///< Lines ending in '\n' (or "\r\n"), no trailing empty line.
+};
+
+/**
+ * @brief A lazy, non-owning range of the tokens of a character sequence.
+ * @tparam CharType The character type used in the sequence.
+ */
+template <typename CharType = char> class basic_split_view {
+ public:
+   using view_type = std::basic_string_view<CharType>;
+   using size_type = typename view_type::size_type;
+
+   /**
+    * @brief Forward iterator over the tokens of a basic_split_view.
+    */
+   class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = view_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = value_type const *;
+      using reference = value_type;
+
+      /**
+       * @brief Default constructor, equal to the end iterator.
+       */
+      iterator() : m_view(nullptr), m_first(view_type::npos), m_last(0) {}
+
+      /**
+       * @brief Gets the current token.
+       *
+       * @return A view of the current token.
+       */
+      value_type operator*() const {
+         value_type token{m_view->m_source.substr(m_first, m_last - m_first)};
+
+         if (m_view->m_mode == split_mode::lines && !token.empty() &&
+             token.back() == CharType('\r')) {
+            token.remove_suffix(1);
+         }
+
+         return token;
+      }
+
+      /**
+       * @brief Moves to the next token.
+       *
+       * @return A reference to this iterator.
+       */
+      iterator &operator++() {
+         m_view->next(m_first, m_last);
+         return *this;
+      }
+
+      /**
+       * @brief Moves to the next token.
+       *
+       * @return A copy of this iterator before the increment.
+       */
+      iterator operator++(int) {
+         iterator copy{*this};
+         ++*this;
+         return copy;
+      }
+
+      /**
+       * @brief Checks if two iterators point to the same token.
+       *
+       * @param rhs_ The iterator to compare with.
+       * @return True if both are at the same token, false otherwise.
+       */
+      bool operator==(iterator const &rhs_) const {
+         return m_first == rhs_.m_first;
+      }
+
+      /**
+       * @brief Checks if two iterators point to different tokens.
+       *
+       * @param rhs_ The iterator to compare with.
+       * @return True if they are at different tokens, false otherwise.
+       */
+      bool operator!=(iterator const &rhs_) const { return !(*this == rhs_); }
+
+    private:
+      friend class basic_split_view;
+
+      /**
+       * @brief Constructs an iterator at the first token of a view.
+       *
+       * @param view_ The view being iterated.
+       */
+      explicit iterator(basic_split_view const *view_)
+          : m_view(view_), m_first(0), m_last(0) {
+         m_view->locate(m_first, m_last);
+      }
+
+      basic_split_view const *m_view; ///< The view being iterated.
+      size_type m_first;              ///< Start of the token (npos at end).
+      size_type m_last;               ///< One past the end of the token.
+   };
+
+   /**
+    * @brief Constructs a view splitting at a single delimiter character.
+    *
+    * @param source_ The sequence to be split.
+    * @param delimiter_ The delimiter character.
+    * @param mode_ How empty tokens are handled.
+    */
+   basic_split_view(view_type source_, CharType delimiter_,
+                    split_mode mode_ = split_mode::skip_empty)
+       : m_source(source_), m_delimiters(), m_delimiter(delimiter_),
+         m_charset(), m_kind(kind::character), m_mode(mode_) {}
+
+   /**
+    * @brief Constructs a view splitting at any character of a set.
+    *
+    * @param source_ The sequence to be split.
+    * @param delimiters_ The delimiter characters (must outlive the view), an
+    * empty set yields the whole sequence as a single token.
+    * @param mode_ How empty tokens are handled.
+    */
+   basic_split_view(view_type source_, view_type delimiters_,
+                    split_mode mode_ = split_mode::skip_empty)
+       : m_source(source_), m_delimiters(delimiters_), m_delimiter(),
+         m_charset(), m_kind(kind::set), m_mode(mode_) {}
+
+   /**
+    * @brief Constructs a view splitting at any character of a precompiled
+    * set.
+    *
+    * @param source_ The sequence to be split.
+    * @param delimiters_ The delimiter set.
+    * @param mode_ How empty tokens are handled.
+    */
+   basic_split_view(view_type source_, charset const &delimiters_,
+                    split_mode mode_ = split_mode::skip_empty)
+       : m_source(source_), m_delimiters(), m_delimiter(),
+         m_charset(delimiters_), m_kind(kind::compiled), m_mode(mode_) {}
+
+   /**
+    * @brief Gets an iterator to the first token.
+    *
+    * @return An iterator to the first token, or end() if there is none.
+    */
+   iterator begin() const { return iterator(this); }
+
+   /**
+    * @brief Gets the past-the-end iterator.
+    *
+    * @return The past-the-end iterator.
+    */
+   iterator end() const { return iterator(); }
+
+   /**
+    * @brief Checks if the view yields no token.
+    *
+    * @return True if there is no token, false otherwise.
+    */
+   bool empty() const { return begin() == end(); }
+
+   /**
+    * @brief Counts the tokens without materializing them.
+    *
+    * @return The number of tokens in the view.
+    */
+   size_type count() const {
+      size_type total{0};
+
+      if (m_mode == split_mode::skip_empty) {
+         size_type first{0};
+         size_type last{0};
+
+         for (locate(first, last); first != view_type::npos;
+              locate(first, last)) {
+            ++total;
+         }
+
+         return total;
+      }
+
+      for (size_type pos{find_delimiter(0)}; pos != view_type::npos;
+           pos = find_delimiter(pos + 1)) {
+         ++total;
+      }
+
+      if (m_mode == split_mode::keep_empty) {
+         return total + 1;
+      }
+
+      return total + (!m_source.empty() && m_source.back() != CharType('\n'));
+   }
+
+ private:
+   /**
+    * @brief The kinds of delimiter a view splits at.
+    */
+   enum class kind {
+      character, ///< A single character, m_delimiter.
+      set,       ///< Any character of m_delimiters.
+      compiled,  ///< Any character of m_charset.
+   };
+
+   /**
+    * @brief Finds the next delimiter starting at a position.
+    *
+    * @param pos_ The position to start the search.
+    * @return The position of the delimiter, or npos if there is none.
+    */
+   size_type find_delimiter(size_type pos_) const {
+      if (m_mode == split_mode::lines) {
+         return m_source.find(CharType('\n'), pos_);
+      }
+
+      switch (m_kind) {
+      case kind::character:
+         return m_source.find(m_delimiter, pos_);
+      case kind::set:
+         return m_source.find_first_of(m_delimiters, pos_);
+      default:
+         return m_charset.find_first_of(m_source.data(), m_source.size(),
+                                        pos_);
+      }
+   }
+
+   /**
+    * @brief Finds the next non-delimiter starting at a position.
+    *
+    * @param pos_ The position to start the search.
+    * @return The position of the character, or npos if there is none.
+    */
+   size_type find_token(size_type pos_) const {
+      switch (m_kind) {
+      case kind::character:
+         return m_source.find_first_not_of(m_delimiter, pos_);
+      case kind::set:
+         return m_source.find_first_not_of(m_delimiters, pos_);
+      default:
+         return m_charset.find_first_not_of(m_source.data(), m_source.size(),
+                                            pos_);
+      }
+   }
+
+   /**
+    * @brief Locates the token following a bound (skip_empty mode) or sets up
+    * the first token (other modes).
+    *
+    * @param first_ Receives the start of the token, npos if there is none.
+    * @param last_ The search start on input, the end of the token on output.
+    */
+   void locate(size_type &first_, size_type &last_) const {
+      if (m_mode == split_mode::skip_empty) {
+         first_ = find_token(last_);
+      } else if (m_mode == split_mode::lines && m_source.empty()) {
+         first_ = view_type::npos;
+      } else {
+         first_ = 0;
+      }
+
+      if (first_ == view_type::npos) {
+         return;
+      }
+
+      last_ = find_delimiter(first_);
+      if (last_ == view_type::npos) {
+         last_ = m_source.size();
+      }
+   }
+
+   /**
+    * @brief Moves a token bound pair to the next token.
+    *
+    * @param first_ The start of the current token, npos after the last one.
+    * @param last_ The end of the current token.
+    */
+   void next(size_type &first_, size_type &last_) const {
+      if (m_mode == split_mode::skip_empty) {
+         locate(first_, last_);
+         return;
+      }
+
+      if (last_ >= m_source.size() ||
+          (m_mode == split_mode::lines && last_ + 1 == m_source.size())) {
+         first_ = view_type::npos;
+         return;
+      }
+
+      first_ = last_ + 1;
+      last_ = find_delimiter(first_);
+      if (last_ == view_type::npos) {
+         last_ = m_source.size();
+      }
+   }
+
+   view_type m_source;     ///< The sequence being split.
+   view_type m_delimiters; ///< The delimiter set, if any.
+   CharType m_delimiter;   ///< The single delimiter, if any.
+   charset m_charset;      ///< The precompiled delimiter set, if any.
+   kind m_kind;            ///< Which of the delimiters above is used.
+   split_mode m_mode;      ///< How empty tokens are handled.
+};
+
+/**
+ * @brief Reserves room for more elements in containers that support it.
+ *
+ * @tparam Container The type of container.
+ * @param container_ The container to reserve in.
+ * @param count_ The number of elements that will be added.
+ */
+template <class Container>
+auto reserve_more(Container &container_, std::size_t count_, int)
+    -> decltype(container_.reserve(container_.size() + count_), void()) {
+   container_.reserve(container_.size() + count_);
+}
+
+/**
+ * @brief Fallback for containers without reserve(), does nothing.
+ *
+ * Call as reserve_more(container, count, 0) so that the overload above is
+ * preferred whenever it is viable.
+ */
+template <class Container>
+void reserve_more(Container &, std::size_t, long) {}
+
+} // namespace ext
+
+#endif // SPLIT_VIEW_HPP_
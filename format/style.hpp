@@ -16,6 +16,11 @@
 #ifndef STYLE_HPP_
 #define STYLE_HPP_
 
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
 namespace ext {
 /**
  * @brief Foreground namespace
@@ -100,6 +105,253 @@ inline constexpr short const list[] = {
     none,   regular,          bold, faint, italic, underline, reverse, hide,
     strike, doubly_underlined}; ///< List of font styles
 } // namespace stl
+
+/**
+ * @brief Strongly typed foreground colors, with the values of cfg.
+ */
+enum class fg_color : short {
+   none = cfg::none,                     ///< No foreground color
+   black = cfg::black,                   ///< Black color
+   red = cfg::red,                       ///< Red color
+   green = cfg::green,                   ///< Green color
+   yellow = cfg::yellow,                 ///< Yellow color
+   blue = cfg::blue,                     ///< Blue color
+   magenta = cfg::magenta,               ///< Magenta color
+   cyan = cfg::cyan,                     ///< Cyan color
+   white = cfg::white,                   ///< White color
+   bright_black = cfg::bright_black,     ///< Bright black color
+   bright_red = cfg::bright_red,         ///< Bright red color
+   bright_green = cfg::bright_green,     ///< Bright green color
+   bright_yellow = cfg::bright_yellow,   ///< Bright yellow color
+   bright_blue = cfg::bright_blue,       ///< Bright blue color
+   bright_magenta = cfg::bright_magenta, ///< Bright magenta color
+   bright_cyan = cfg::bright_cyan,       ///< Bright cyan color
+   bright_white = cfg::bright_white,     ///< Bright white color
+};
+
+/**
+ * @brief Strongly typed background colors, with the values of cbg.
+ */
+enum class bg_color : short {
+   none = cbg::none,                     ///< No color
+   black = cbg::black,                   ///< Black
+   red = cbg::red,                       ///< Red
+   green = cbg::green,                   ///< Green
+   yellow = cbg::yellow,                 ///< Yellow
+   blue = cbg::blue,                     ///< Blue
+   magenta = cbg::magenta,               ///< Magenta
+   cyan = cbg::cyan,                     ///< Cyan
+   white = cbg::white,                   ///< White
+   bright_black = cbg::bright_black,     ///< Bright black
+   bright_red = cbg::bright_red,         ///< Bright red
+   bright_green = cbg::bright_green,     ///< Bright green
+   bright_yellow = cbg::bright_yellow,   ///< Bright yellow
+   bright_blue = cbg::bright_blue,       ///< Bright blue
+   bright_magenta = cbg::bright_magenta, ///< Bright magenta
+   bright_cyan = cbg::bright_cyan,       ///< Bright cyan
+   bright_white = cbg::bright_white,     ///< Bright white
+};
+
+/**
+ * @brief Strongly typed font styles, with the values of stl.
+ */
+enum class font_style : short {
+   none = stl::none,                           ///< No styling
+   regular = stl::regular,                     ///< Regular
+   bold = stl::bold,                           ///< Bold
+   faint = stl::faint,                         ///< Faint
+   italic = stl::italic,                       ///< Italic
+   underline = stl::underline,                 ///< Underlined
+   reverse = stl::reverse,                     ///< Reverse
+   hide = stl::hide,                           ///< Hidden
+   strike = stl::strike,                       ///< Strikethrough
+   doubly_underlined = stl::doubly_underlined, ///< Doubly underlined
+};
+
+/**
+ * @brief SGR (Select Graphic Rendition) namespace
+ *
+ * This namespace holds the escape sequences of the codes above, built at
+ * compile time so that applying a style is a copy of a constant string.
+ */
+namespace sgr {
+inline constexpr short const max_code{107}; ///< Highest code in the lists.
+
+/**
+ * @brief Kinds of codes, as bit flags.
+ */
+enum kind : unsigned char {
+   invalid = 0,         ///< Not in any list
+   foreground = 1 << 0, ///< Listed in cfg::list
+   background = 1 << 1, ///< Listed in cbg::list
+   style = 1 << 2,      ///< Listed in stl::list
+};
+
+/**
+ * @brief A complete escape sequence such as "\33[31;44;1m".
+ */
+struct escape {
+   char data[16]{};     ///< The characters of the sequence.
+   std::size_t size{0}; ///< The number of characters (0 if invalid).
+   unsigned char kind{invalid}; ///< The kind of a single-code sequence.
+
+   /**
+    * @brief Gets the sequence as a string view.
+    *
+    * @return A view of the sequence.
+    */
+   constexpr std::string_view view() const { return {data, size}; }
+};
+
+/**
+ * @brief The sequence that resets every attribute.
+ */
+inline constexpr escape const reset{{'\33', '[', '0', 'm'}, 4, style};
+
+/**
+ * @brief Checks if a code is in a list of codes.
+ *
+ * @param list_ The list of codes.
+ * @param code_ The code to look for.
+ * @return True if the code is listed, false otherwise.
+ */
+template <std::size_t Size>
+constexpr bool listed(short const (&list_)[Size], short code_) {
+   for (short listed_code : list_) {
+      if (listed_code == code_) {
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * @brief Gets the kinds of a code.
+ *
+ * @param code_ The code.
+ * @return The kind flags of the code, invalid if it is in no list.
+ */
+constexpr unsigned char kind_of(short code_) {
+   if (code_ < 0) {
+      return invalid;
+   }
+
+   return static_cast<unsigned char>(
+       (listed(cfg::list, code_) ? foreground : invalid) |
+       (listed(cbg::list, code_) ? background : invalid) |
+       (listed(stl::list, code_) ? style : invalid));
+}
+
+/**
+ * @brief Builds the escape sequence of a list of codes, skipping negative
+ * (none) codes.
+ *
+ * @param codes_ The codes of the sequence.
+ * @return The escape sequence, empty if every code is none.
+ */
+template <std::size_t Size>
+constexpr escape make(std::array<short, Size> const &codes_) {
+   escape result{};
+   std::size_t pos{0};
+   bool first{true};
+
+   for (short code : codes_) {
+      if (code < 0) {
+         continue;
+      }
+
+      if (first) {
+         result.data[pos++] = '\33';
+         result.data[pos++] = '[';
+      } else {
+         result.data[pos++] = ';';
+      }
+      first = false;
+
+      if (code >= 100) {
+         result.data[pos++] = static_cast<char>('0' + code / 100);
+      }
+      if (code >= 10) {
+         result.data[pos++] = static_cast<char>('0' + code / 10 % 10);
+      }
+      result.data[pos++] = static_cast<char>('0' + code % 10);
+   }
+
+   if (!first) {
+      result.data[pos++] = 'm';
+   }
+
+   result.size = pos;
+   result.kind = Size == 1 && pos != 0 ? kind_of(codes_[0])
+                                        : static_cast<unsigned char>(invalid);
+   return result;
+}
+
+/**
+ * @brief Builds the table of single-code sequences, indexed by code.
+ *
+ * @return The table, with empty entries for unlisted codes.
+ */
+constexpr std::array<escape, max_code + 1> make_table() {
+   std::array<escape, max_code + 1> table{};
+
+   for (short code{0}; code <= max_code; ++code) {
+      if (kind_of(code) != invalid) {
+         table[static_cast<std::size_t>(code)] =
+             make(std::array<short, 1>{code});
+      }
+   }
+
+   return table;
+}
+
+/**
+ * @brief Single-code sequences, indexed by code.
+ */
+inline constexpr std::array<escape, max_code + 1> const table{make_table()};
+
+/**
+ * @brief Gets the sequence of a single code if it is of a given kind.
+ *
+ * @param code_ The code.
+ * @param kind_ The expected kind.
+ * @return The sequence, or nullptr if the code is none or of another kind.
+ */
+constexpr escape const *find(short code_, kind kind_) {
+   if (code_ < 0 || code_ > max_code ||
+       !(table[static_cast<std::size_t>(code_)].kind & kind_)) {
+      return nullptr;
+   }
+
+   return &table[static_cast<std::size_t>(code_)];
+}
+
+/**
+ * @brief Gets the code of a typed attribute.
+ *
+ * @tparam Code A value of fg_color, bg_color or font_style.
+ * @return The code.
+ */
+template <auto Code> constexpr short code_of() {
+   using type = decltype(Code);
+   static_assert(std::is_same_v<type, fg_color> ||
+                     std::is_same_v<type, bg_color> ||
+                     std::is_same_v<type, font_style>,
+                 "SGR attributes must be fg_color, bg_color or font_style");
+   return static_cast<short>(Code);
+}
+
+/**
+ * @brief The combined escape sequence of typed attributes, built at compile
+ * time (e.g. sequence<fg_color::red, bg_color::blue, font_style::bold> is
+ * "\33[31;44;1m").
+ *
+ * @tparam Codes Values of fg_color, bg_color or font_style.
+ */
+template <auto... Codes>
+inline constexpr escape const sequence{
+    make(std::array<short, sizeof...(Codes)>{code_of<Codes>()...})};
+} // namespace sgr
 } // namespace ext
 
 #endif // STYLE_HPP_
@@ -0,0 +1,332 @@
+/**
+ * @file styled_text.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Text fragments that keep their ANSI attributes apart from the text.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * A styled_text holds plain text plus a list of spans, each one with its own
+ * foreground, background and style. Nothing is escaped until the text is
+ * rendered, which is done in a single pass into an output sized up front, and
+ * each styled span gets a single combined SGR sequence such as "\33[31;44;1m".
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef STYLED_TEXT_HPP_
+#define STYLED_TEXT_HPP_
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "style.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief The foreground, background and style of a piece of text.
+ *
+ * Codes that are not listed in cfg::list, cbg::list or stl::list are treated
+ * as none.
+ */
+struct text_style {
+   short foreground{cfg::none}; ///< Foreground color code (cfg namespace).
+   short background{cbg::none}; ///< Background color code (cbg namespace).
+   short style{stl::none};      ///< Style code (stl namespace).
+
+   /**
+    * @brief Checks if two styles are the same.
+    *
+    * @param rhs_ The style to compare with.
+    * @return True if all the attributes are equal, false otherwise.
+    */
+   bool operator==(text_style const &rhs_) const {
+      return foreground == rhs_.foreground && background == rhs_.background &&
+             style == rhs_.style;
+   }
+
+   /**
+    * @brief Checks if two styles are different.
+    *
+    * @param rhs_ The style to compare with.
+    * @return True if any attribute differs, false otherwise.
+    */
+   bool operator!=(text_style const &rhs_) const { return !(*this == rhs_); }
+
+   /**
+    * @brief Gets a copy of the style with invalid codes replaced by none.
+    *
+    * @return The validated style.
+    */
+   text_style validated() const {
+      text_style valid{*this};
+
+      if (!sgr::find(foreground, sgr::foreground)) {
+         valid.foreground = cfg::none;
+      }
+      if (!sgr::find(background, sgr::background)) {
+         valid.background = cbg::none;
+      }
+      if (!sgr::find(style, sgr::style)) {
+         valid.style = stl::none;
+      }
+
+      return valid;
+   }
+
+   /**
+    * @brief Checks if the style has no attribute.
+    *
+    * @return True if every attribute is none, false otherwise.
+    */
+   bool plain() const {
+      return foreground == cfg::none && background == cbg::none &&
+             style == stl::none;
+   }
+
+   /**
+    * @brief Gets the combined SGR sequence of the style, such as
+    * "\33[31;44;1m".
+    *
+    * @return The escape sequence, empty if the style is plain.
+    */
+   sgr::escape escape() const {
+      return sgr::make(std::array<short, 3>{foreground, background, style});
+   }
+
+   /**
+    * @brief Gets the size of the combined SGR sequence of the style.
+    *
+    * @return The number of characters written by open(), 0 if plain.
+    */
+   std::size_t open_size() const { return escape().size; }
+
+   /**
+    * @brief Appends the combined SGR sequence of the style. Nothing is
+    * appended if the style is plain.
+    *
+    * @tparam String The type of the output string.
+    * @param out_ The string to append to.
+    */
+   template <class String> void open(String &out_) const {
+      sgr::escape const sequence{escape()};
+      out_.append(sequence.data, sequence.data + sequence.size);
+   }
+
+   /**
+    * @brief Appends the reset sequence "\33[0m".
+    *
+    * @tparam String The type of the output string.
+    * @param out_ The string to append to.
+    */
+   template <class String> static void close(String &out_) {
+      out_.append(sgr::reset.data, sgr::reset.data + sgr::reset.size);
+   }
+
+   static constexpr std::size_t close_size{sgr::reset.size}; ///< Reset size.
+};
+
+/**
+ * @brief A sequence of text spans, each one with its own text_style.
+ * @tparam CharType The character type used in the text.
+ */
+template <typename CharType = char> class basic_styled_text {
+ public:
+   using string_type = std::basic_string<CharType>;
+   using view_type = std::basic_string_view<CharType>;
+   using size_type = typename string_type::size_type;
+
+   /**
+    * @brief A run of the text that shares one style.
+    */
+   struct span {
+      size_type first; ///< Start of the run in the text.
+      size_type size;  ///< Length of the run.
+      text_style style; ///< Attributes of the run.
+   };
+
+   /**
+    * @brief Default constructor, creates an empty text.
+    */
+   basic_styled_text() {}
+
+   /**
+    * @brief Constructs a text with a single span.
+    *
+    * @param text_ The text of the span.
+    * @param style_ The attributes of the span (default is plain).
+    */
+   explicit basic_styled_text(view_type text_, text_style style_ = {}) {
+      append(text_, style_);
+   }
+
+   /**
+    * @brief Appends a span. It is merged with the last span when both have the
+    * same attributes.
+    *
+    * @param text_ The text of the span.
+    * @param style_ The attributes of the span (default is plain).
+    * @return A reference to the modified text.
+    */
+   basic_styled_text &append(view_type text_, text_style style_ = {}) {
+      if (text_.empty()) {
+         return *this;
+      }
+
+      style_ = style_.validated();
+
+      if (!m_spans.empty() && m_spans.back().style == style_) {
+         m_spans.back().size += text_.size();
+      } else {
+         m_spans.push_back(span{m_text.size(), text_.size(), style_});
+      }
+
+      m_text.append(text_.data(), text_.size());
+      return *this;
+   }
+
+   /**
+    * @brief Sets the foreground color of the last span.
+    *
+    * @param code_ The ANSI color code (cfg namespace).
+    * @return A reference to the modified text.
+    */
+   basic_styled_text &color(short code_) {
+      return restyle([code_](text_style &style_) { style_.foreground = code_; });
+   }
+
+   /**
+    * @brief Sets the background color of the last span.
+    *
+    * @param code_ The ANSI background color code (cbg namespace).
+    * @return A reference to the modified text.
+    */
+   basic_styled_text &background(short code_) {
+      return restyle([code_](text_style &style_) { style_.background = code_; });
+   }
+
+   /**
+    * @brief Sets the style of the last span.
+    *
+    * @param code_ The ANSI style code (stl namespace).
+    * @return A reference to the modified text.
+    */
+   basic_styled_text &style(short code_) {
+      return restyle([code_](text_style &style_) { style_.style = code_; });
+   }
+
+   /**
+    * @brief Gets the text without any escape sequence.
+    *
+    * @return The plain text.
+    */
+   string_type const &plain() const { return m_text; }
+
+   /**
+    * @brief Gets the spans of the text.
+    *
+    * @return The spans, in order.
+    */
+   std::vector<span> const &spans() const { return m_spans; }
+
+   /**
+    * @brief Gets the number of characters of the rendered text.
+    *
+    * @return The size of the text plus the size of its escape sequences.
+    */
+   size_type rendered_size() const {
+      size_type size{m_text.size()};
+
+      for (span const &run : m_spans) {
+         if (!run.style.plain()) {
+            size += run.style.open_size() + text_style::close_size;
+         }
+      }
+
+      return size;
+   }
+
+   /**
+    * @brief Appends the rendered text to a string, growing it at most once.
+    *
+    * @tparam Allocator The allocator of the output string.
+    * @param out_ The string to append to.
+    */
+   template <class Allocator>
+   void render(
+       std::basic_string<CharType, std::char_traits<CharType>, Allocator> &out_)
+       const {
+      out_.reserve(out_.size() + rendered_size());
+
+      for (span const &run : m_spans) {
+         run.style.open(out_);
+         out_.append(m_text.data() + run.first, run.size);
+
+         if (!run.style.plain()) {
+            text_style::close(out_);
+         }
+      }
+   }
+
+   /**
+    * @brief Renders the text with its escape sequences.
+    *
+    * @return The rendered text.
+    */
+   string_type render() const {
+      string_type out;
+      render(out);
+      return out;
+   }
+
+   /**
+    * @brief Writes the rendered text to an output stream.
+    *
+    * @param os_ The output stream.
+    * @param text_ The text to write.
+    * @return A reference to the output stream.
+    */
+   friend std::basic_ostream<CharType> &
+   operator<<(std::basic_ostream<CharType> &os_,
+              basic_styled_text const &text_) {
+      string_type const out{text_.render()};
+      return os_.write(out.data(), static_cast<std::streamsize>(out.size()));
+   }
+
+ private:
+   /**
+    * @brief Changes the style of the last span and merges it with the previous
+    * one if they end up equal.
+    */
+   template <class Change> basic_styled_text &restyle(Change change_) {
+      if (m_spans.empty()) {
+         return *this;
+      }
+
+      change_(m_spans.back().style);
+      m_spans.back().style = m_spans.back().style.validated();
+
+      if (m_spans.size() > 1 &&
+          m_spans[m_spans.size() - 2].style == m_spans.back().style) {
+         m_spans[m_spans.size() - 2].size += m_spans.back().size;
+         m_spans.pop_back();
+      }
+
+      return *this;
+   }
+
+   string_type m_text;       ///< The plain text of all the spans.
+   std::vector<span> m_spans; ///< The runs of the text, in order.
+};
+
+using styled_text = basic_styled_text<char>; ///< Styled text of char.
+
+} // namespace ext
+
+#endif // STYLED_TEXT_HPP_
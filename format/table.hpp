@@ -0,0 +1,376 @@
+/**
+ * @file table.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A batch renderer for tables of aligned and styled columns.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The cells of every row are stored back to back in a single buffer, and the
+ * width of each column is updated as rows are added, so no separate measuring
+ * pass is needed. Widths are display widths (escape sequences take no column
+ * and wide characters take two), measured once per cell and kept with it.
+ * Rendering reserves the whole output once and writes the padding and escape
+ * sequences directly, without a temporary per cell.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef TABLE_HPP_
+#define TABLE_HPP_
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "layout.hpp"
+#include "styled_text.hpp"
+#include "width.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A table of rows with a fixed set of columns.
+ * @tparam CharType The character type used in the cells.
+ */
+template <typename CharType = char> class basic_table {
+ public:
+   using string_type = std::basic_string<CharType>;
+   using view_type = std::basic_string_view<CharType>;
+   using size_type = typename string_type::size_type;
+
+   /**
+    * @brief The layout and attributes of a column.
+    */
+   struct column {
+      align_mode align;  ///< How the cells are aligned.
+      text_style style;  ///< Attributes of the cells (header excluded).
+      size_type width;   ///< Display width of the widest cell so far.
+   };
+
+   /**
+    * @brief Default constructor, creates a table with no column.
+    *
+    * @param separator_ The text between columns (default is a space).
+    */
+   explicit basic_table(view_type separator_ = view_type())
+       : m_separator(separator_.empty() ? string_type(1, CharType(' '))
+                                        : string_type(separator_)),
+         m_has_header(false) {}
+
+   /**
+    * @brief Adds a column.
+    *
+    * @param header_ The header of the column, empty for none.
+    * @param align_ How the cells are aligned (default is align_mode::left).
+    * @param style_ Attributes of the cells (default is plain).
+    * @return A reference to the modified table.
+    * @throw std::logic_error if rows were already added.
+    */
+   basic_table &add_column(view_type header_ = view_type(),
+                           align_mode align_ = align_mode::left,
+                           text_style style_ = {}) {
+      if (!m_cells.empty()) {
+         throw std::logic_error("Cannot add a column to a table with rows.");
+      }
+
+      m_header.push_back(store(header_));
+      m_columns.push_back(
+          column{align_, style_.validated(), m_header.back().width});
+      m_has_header = m_has_header || !header_.empty();
+      return *this;
+   }
+
+   /**
+    * @brief Sets the attributes of the header row.
+    *
+    * @param style_ Attributes of the header cells.
+    * @return A reference to the modified table.
+    */
+   basic_table &header_style(text_style style_) {
+      m_header_style = style_.validated();
+      return *this;
+   }
+
+   /**
+    * @brief Adds a row of cells, one per column.
+    *
+    * @tparam Range A range of values convertible to a string view.
+    * @param cells_ The cells of the row.
+    * @return A reference to the modified table.
+    * @throw std::invalid_argument if the number of cells is not the number of
+    * columns.
+    */
+   template <class Range> basic_table &add_row(Range const &cells_) {
+      size_type const count{
+          static_cast<size_type>(std::distance(std::begin(cells_),
+                                               std::end(cells_)))};
+
+      if (count != m_columns.size()) {
+         throw std::invalid_argument(
+             "The row must have one cell per column.");
+      }
+
+      size_type index{0};
+      for (auto const &value : cells_) {
+         m_cells.push_back(store(view_type(value)));
+         m_columns[index].width =
+             std::max(m_columns[index].width, m_cells.back().width);
+         ++index;
+      }
+
+      return *this;
+   }
+
+   /**
+    * @brief Adds a row of cells, one per column.
+    *
+    * @param cells_ The cells of the row.
+    * @return A reference to the modified table.
+    * @throw std::invalid_argument if the number of cells is not the number of
+    * columns.
+    */
+   basic_table &add_row(std::initializer_list<view_type> cells_) {
+      return add_row<std::initializer_list<view_type>>(cells_);
+   }
+
+   /**
+    * @brief Reserves room for a number of rows.
+    *
+    * @param rows_ The number of rows.
+    * @param text_ The total size of the text of those rows.
+    */
+   void reserve(size_type rows_, size_type text_ = 0) {
+      m_cells.reserve(rows_ * m_columns.size());
+      m_text.reserve(text_);
+   }
+
+   /**
+    * @brief Gets the columns of the table.
+    *
+    * @return The columns, with their current widths.
+    */
+   std::vector<column> const &columns() const { return m_columns; }
+
+   /**
+    * @brief Gets the number of rows, the header excluded.
+    *
+    * @return The number of rows.
+    */
+   size_type rows() const {
+      return m_columns.empty() ? 0 : m_cells.size() / m_columns.size();
+   }
+
+   /**
+    * @brief Gets the number of characters of the rendered table.
+    *
+    * @return The size of every row, escape sequences and line breaks
+    * included.
+    */
+   size_type rendered_size() const {
+      size_type row{0};
+      size_type styled{0};
+
+      for (column const &col : m_columns) {
+         row += col.width;
+         if (!col.style.plain()) {
+            styled += col.style.open_size() + text_style::close_size;
+         }
+      }
+
+      if (!m_columns.empty()) {
+         row += (m_columns.size() - 1) * m_separator.size();
+      }
+      row += 1;
+
+      // Each cell takes its size minus its width more than the columns (a
+      // wrap-around for a cell wider than its size cancels out in the sum)
+      size_type size{rows() * (row + styled) + extra_size(m_cells)};
+
+      if (m_has_header) {
+         size += row + extra_size(m_header);
+         if (!m_header_style.plain()) {
+            size += m_columns.size() * (m_header_style.open_size() +
+                                        text_style::close_size);
+         }
+      }
+
+      return size;
+   }
+
+   /**
+    * @brief Appends the rendered table to a string, growing it at most once.
+    *
+    * @tparam Allocator The allocator of the output string.
+    * @param out_ The string to append to.
+    */
+   template <class Allocator>
+   void render(
+       std::basic_string<CharType, std::char_traits<CharType>, Allocator> &out_)
+       const {
+      out_.reserve(out_.size() + rendered_size());
+
+      if (m_has_header) {
+         render_row(out_, m_header.data(), &m_header_style);
+      }
+
+      for (size_type first{0}; first < m_cells.size();
+           first += m_columns.size()) {
+         render_row(out_, m_cells.data() + first, nullptr);
+      }
+   }
+
+   /**
+    * @brief Renders the table.
+    *
+    * @return The rendered table.
+    */
+   string_type render() const {
+      string_type out;
+      render(out);
+      return out;
+   }
+
+   /**
+    * @brief Writes the rendered table to an output stream with a single
+    * write.
+    *
+    * @param os_ The output stream.
+    * @param table_ The table to write.
+    * @return A reference to the output stream.
+    */
+   friend std::basic_ostream<CharType> &
+   operator<<(std::basic_ostream<CharType> &os_, basic_table const &table_) {
+      string_type const out{table_.render()};
+      return os_.write(out.data(), static_cast<std::streamsize>(out.size()));
+   }
+
+ private:
+   /**
+    * @brief The bounds of a cell in the shared buffer, and its width.
+    */
+   struct cell {
+      size_type first; ///< Offset of the text.
+      size_type size;  ///< Size of the text.
+      size_type width; ///< Display width of the text.
+   };
+
+   /**
+    * @brief Copies a text into the shared buffer and measures it.
+    *
+    * @return The bounds of the text in the buffer.
+    */
+   cell store(view_type text_) {
+      cell const bounds{m_text.size(), text_.size(), display_width(text_)};
+      m_text.append(text_.data(), text_.size());
+      return bounds;
+   }
+
+   /**
+    * @brief Gets the number of characters of some cells beyond their width.
+    */
+   static size_type extra_size(std::vector<cell> const &cells_) {
+      size_type extra{0};
+      for (cell const &current : cells_) {
+         extra += current.size - current.width;
+      }
+      return extra;
+   }
+
+   /**
+    * @brief Appends one row, each cell padded to its column width.
+    *
+    * @tparam String The type of the output string.
+    * @param out_ The string to append to.
+    * @param cells_ The cells of the row, one per column.
+    * @param style_ Attributes for every cell, or nullptr to use the column
+    * attributes.
+    */
+   template <class String>
+   void render_row(String &out_, cell const *cells_,
+                   text_style const *style_) const {
+      for (size_type index{0}; index != m_columns.size(); ++index) {
+         column const &col{m_columns[index]};
+         text_style const &style{style_ != nullptr ? *style_ : col.style};
+
+         if (index != 0) {
+            out_.append(m_separator.data(), m_separator.size());
+         }
+
+         style.open(out_);
+         pad(out_, view_type(m_text).substr(cells_[index].first,
+                                            cells_[index].size),
+             col.width - cells_[index].width, col.align);
+         if (!style.plain()) {
+            text_style::close(out_);
+         }
+      }
+
+      out_ += CharType('\n');
+   }
+
+   /**
+    * @brief Appends a cell and its padding.
+    *
+    * @tparam String The type of the output string.
+    * @param out_ The string to append to.
+    * @param text_ The text of the cell.
+    * @param padding_ The number of columns to fill.
+    * @param align_ How the text is aligned.
+    */
+   template <class String>
+   static void pad(String &out_, view_type text_, size_type padding_,
+                   align_mode align_) {
+      if (align_ == align_mode::justify && padding_ != 0) {
+         size_type const gaps{static_cast<size_type>(
+             std::count(text_.begin(), text_.end(), CharType(' ')))};
+
+         if (gaps != 0) {
+            size_type gap{0};
+            for (CharType char_ : text_) {
+               if (char_ == CharType(' ')) {
+                  out_.append(1 + padding_ / gaps + (gap < padding_ % gaps),
+                              CharType(' '));
+                  ++gap;
+               } else {
+                  out_ += char_;
+               }
+            }
+            return;
+         }
+      }
+
+      size_type before{0};
+      if (align_ == align_mode::right) {
+         before = padding_;
+      } else if (align_ == align_mode::center) {
+         before = padding_ / 2;
+      }
+
+      out_.append(before, CharType(' '));
+      out_.append(text_.data(), text_.size());
+      out_.append(padding_ - before, CharType(' '));
+   }
+
+   string_type m_separator;        ///< The text between columns.
+   std::vector<column> m_columns;  ///< The columns of the table.
+   std::vector<cell> m_header;     ///< The header cells.
+   std::vector<cell> m_cells;      ///< The row cells, row after row.
+   string_type m_text;             ///< The text of every cell.
+   text_style m_header_style;      ///< Attributes of the header row.
+   bool m_has_header;              ///< Whether any column has a header.
+};
+
+using table = basic_table<char>; ///< Table of char cells.
+
+} // namespace ext
+
+#endif // TABLE_HPP_
@@ -0,0 +1,322 @@
+/**
+ * @file term_writer.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief A terminal writer that only emits the attributes that change.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * Styled fragments usually open with a full SGR sequence and close with a
+ * reset, even when the next fragment uses the same attributes. term_writer
+ * keeps the attributes the terminal is in and, before each run of visible
+ * text, emits the shortest sequence that turns them into the ones wanted:
+ * only the codes that change, or a reset followed by the new codes, whichever
+ * is shorter. Nothing is emitted for fragments that keep the attributes.
+ * Everything goes into one buffer that is written with a single write(2) per
+ * frame.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef TERM_WRITER_HPP_
+#define TERM_WRITER_HPP_
+
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+#include "ansi.hpp"
+#include "out_buffer.hpp"
+#include "style.hpp"
+#include "styled_text.hpp"
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief A buffered terminal writer that tracks the SGR attributes of the
+ * terminal and emits only their changes.
+ *
+ * The terminal keeps the last attributes between frames, so call reset()
+ * before another writer uses it; the destructor does it too.
+ */
+class term_writer {
+ public:
+   using size_type = std::size_t;
+
+   /**
+    * @brief Constructs a writer.
+    *
+    * @param fd_ The file descriptor to write to (default is the standard
+    * output).
+    * @param capacity_ The initial capacity of the frame buffer.
+    */
+   explicit term_writer(int fd_ = 1, size_type capacity_ = 1 << 16)
+       : m_fd(fd_), m_buffer(capacity_) {}
+
+   term_writer(term_writer const &) = delete;
+   term_writer &operator=(term_writer const &) = delete;
+
+   /**
+    * @brief Resets the attributes of the terminal and writes what is left in
+    * the buffer, ignoring errors.
+    */
+   ~term_writer() {
+      try {
+         reset();
+         flush();
+      } catch (std::system_error const &) {
+      }
+   }
+
+   /**
+    * @brief Writes a plain text with some attributes.
+    *
+    * @param text_ The text, without escape sequences.
+    * @param style_ The attributes of the text; invalid codes are ignored.
+    * @return A reference to this writer.
+    */
+   term_writer &write(std::string_view text_, text_style const &style_) {
+      text_style const wanted{normalized(style_)};
+
+      m_naive += text_.size();
+      if (!wanted.plain() && !text_.empty()) {
+         m_naive += wanted.open_size() + text_style::close_size;
+      }
+
+      m_wanted = wanted;
+      put(text_);
+      m_wanted = text_style{}; // As after the reset of a styled fragment
+      return *this;
+   }
+
+   /**
+    * @brief Writes a text rendered with SGR sequences, such as a colored
+    * fstring or a rendered styled_text. Its SGR sequences are folded into the
+    * attributes of the terminal, and other escape sequences are written as
+    * they are.
+    *
+    * @param rendered_ The rendered text.
+    * @return A reference to this writer.
+    */
+   term_writer &write(std::string_view rendered_) {
+      m_naive += rendered_.size();
+
+      for (ansi::segment const &segment : ansi::segments(rendered_)) {
+         if (!segment.escape) {
+            put(segment.text);
+         } else if (segment.sgr()) {
+            ansi::parse_sgr(segment.text, m_wanted);
+            m_wanted = normalized(m_wanted);
+         } else {
+            append(segment.text);
+         }
+      }
+
+      return *this;
+   }
+
+   /**
+    * @brief Writes a styled text span by span.
+    *
+    * @param text_ The text.
+    * @return A reference to this writer.
+    */
+   term_writer &write(styled_text const &text_) {
+      m_naive += text_.rendered_size();
+
+      for (styled_text::span const &run : text_.spans()) {
+         m_wanted = normalized(run.style);
+         put(std::string_view(text_.plain()).substr(run.first, run.size));
+      }
+      m_wanted = text_style{};
+
+      return *this;
+   }
+
+   /**
+    * @brief Returns the terminal to plain attributes.
+    *
+    * @return A reference to this writer.
+    */
+   term_writer &reset() {
+      m_wanted = text_style{};
+      sync();
+      return *this;
+   }
+
+   /**
+    * @brief Writes the buffer with a single write(2), ending a frame.
+    *
+    * @throw std::system_error if the write fails.
+    */
+   void flush() {
+      size_type const size{m_buffer.size()};
+      m_buffer.flush_to(m_fd);
+      m_written += size;
+   }
+
+   /**
+    * @brief Gets the attributes the terminal is left in.
+    */
+   text_style const &current() const { return m_current; }
+
+   /**
+    * @brief Gets the number of bytes waiting in the buffer.
+    */
+   size_type pending() const { return m_buffer.size(); }
+
+   /**
+    * @brief Gets the number of bytes written by flush() so far.
+    */
+   size_type bytes_written() const { return m_written; }
+
+   /**
+    * @brief Gets the number of bytes saved so far, compared with writing
+    * every fragment with its full sequence and a reset.
+    *
+    * @return The bytes saved, or 0 if the writer emitted more, which happens
+    * when the fragments leave the terminal styled and the writer resets it.
+    */
+   size_type bytes_saved() const {
+      return m_naive > m_emitted ? m_naive - m_emitted : 0;
+   }
+
+ private:
+   /**
+    * @brief Gets a style without invalid codes. Regular is the same as no
+    * style, as its code would reset the colors too.
+    */
+   static text_style normalized(text_style const &style_) {
+      text_style valid{style_.validated()};
+      if (valid.style == stl::regular) {
+         valid.style = stl::none;
+      }
+      return valid;
+   }
+
+   /**
+    * @brief Gets the code that turns a style off.
+    */
+   static short style_off(short style_) {
+      switch (style_) {
+      case stl::bold:
+      case stl::faint:
+         return 22;
+      case stl::underline:
+      case stl::doubly_underlined:
+         return 24;
+      default:
+         return static_cast<short>(style_ + 20);
+      }
+   }
+
+   /**
+    * @brief A list of SGR codes, rendered as a sequence.
+    */
+   struct codes {
+      char data[32]{'\33', '['}; ///< The sequence.
+      size_type size{2};           ///< The size of the sequence.
+
+      /**
+       * @brief Adds a code.
+       */
+      void add(short code_) {
+         if (size != 2) {
+            data[size++] = ';';
+         }
+         if (code_ >= 100) {
+            data[size++] = static_cast<char>('0' + code_ / 100);
+         }
+         if (code_ >= 10) {
+            data[size++] = static_cast<char>('0' + code_ / 10 % 10);
+         }
+         data[size++] = static_cast<char>('0' + code_ % 10);
+      }
+
+      /**
+       * @brief Gets the finished sequence, empty if no code was added.
+       */
+      std::string_view view() {
+         if (size == 2) {
+            return {};
+         }
+         data[size] = 'm';
+         return {data, size + 1};
+      }
+   };
+
+   /**
+    * @brief Emits the shortest sequence that turns the current attributes
+    * into the wanted ones.
+    */
+   void sync() {
+      if (m_wanted == m_current) {
+         return;
+      }
+
+      codes changes;
+      if (m_wanted.style != m_current.style) {
+         if (m_current.style != stl::none) {
+            changes.add(style_off(m_current.style));
+         }
+         if (m_wanted.style != stl::none) {
+            changes.add(m_wanted.style);
+         }
+      }
+      if (m_wanted.foreground != m_current.foreground) {
+         changes.add(m_wanted.foreground == cfg::none ? 39
+                                                      : m_wanted.foreground);
+      }
+      if (m_wanted.background != m_current.background) {
+         changes.add(m_wanted.background == cbg::none ? 49
+                                                      : m_wanted.background);
+      }
+
+      codes reset;
+      reset.add(0);
+      for (short code :
+           {m_wanted.foreground, m_wanted.background, m_wanted.style}) {
+         if (code >= 0) {
+            reset.add(code);
+         }
+      }
+
+      std::string_view const shorter{reset.size < changes.size
+                                         ? reset.view()
+                                         : changes.view()};
+      append(shorter);
+      m_current = m_wanted;
+   }
+
+   /**
+    * @brief Writes visible text with the wanted attributes.
+    */
+   void put(std::string_view text_) {
+      if (!text_.empty()) {
+         sync();
+         append(text_);
+      }
+   }
+
+   /**
+    * @brief Appends bytes to the frame.
+    */
+   void append(std::string_view bytes_) {
+      m_buffer.put(bytes_);
+      m_emitted += bytes_.size();
+   }
+
+   int m_fd;               ///< The file descriptor written to.
+   out_buffer m_buffer;    ///< The bytes of the current frame.
+   text_style m_current;   ///< The attributes the terminal is in.
+   text_style m_wanted;    ///< The attributes of the next visible text.
+   size_type m_naive{0};   ///< Bytes of the fragments as given.
+   size_type m_emitted{0}; ///< Bytes put in the buffer.
+   size_type m_written{0}; ///< Bytes written by flush().
+};
+
+} // namespace ext
+
+#endif // TERM_WRITER_HPP_
@@ -0,0 +1,832 @@
+/**
+ * @file utf.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief Validation and conversion of UTF-8, UTF-16 and UTF-32 text.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * The encoding of a text follows from the size of its character type: one
+ * byte is UTF-8, two bytes are UTF-16 and four bytes are UTF-32 (wchar_t is
+ * UTF-16 or UTF-32, depending on the platform). Runs of ASCII characters are
+ * converted 16 or 32 at a time with SSE2 or AVX2, chosen at compile time, and
+ * only the other characters go through the scalar decoder. With SSSE3 or
+ * AVX2, UTF-8 is validated a whole vector at a time with the lookup tables of
+ * Keiser and Lemire, which classify each pair of adjacent bytes by their
+ * nibbles. Conversions size the result once for the worst case, so each one
+ * allocates at most once.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef UTF_HPP_
+#define UTF_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief UTF namespace
+ *
+ * This namespace validates UTF text and converts it between encodings. The
+ * conversions throw std::invalid_argument if their input is not valid in its
+ * encoding (overlong forms, surrogates and code points above U+10FFFF are
+ * all invalid).
+ */
+namespace utf {
+using size_type = std::size_t;
+
+inline constexpr char32_t invalid{0xFFFFFFFF}; ///< An invalid sequence.
+
+/**
+ * @brief Gets the unsigned code of a code unit.
+ */
+template <typename CharType> constexpr char32_t unit(CharType char_) {
+   if constexpr (sizeof(CharType) == 1) {
+      return static_cast<unsigned char>(char_);
+   } else if constexpr (sizeof(CharType) == 2) {
+      return static_cast<char16_t>(char_);
+   } else {
+      return static_cast<char32_t>(char_);
+   }
+}
+
+/**
+ * @brief Decodes the code point at the start of a sequence of code units.
+ *
+ * @tparam CharType The character type, which sets the encoding.
+ * @param first_ The first code unit, moved past the code point.
+ * @param last_ The end of the sequence (must not be first_).
+ * @return The code point, or invalid (first_ is then unchanged).
+ */
+template <typename CharType>
+char32_t decode(CharType const *&first_, CharType const *last_) {
+   char32_t const lead{unit(*first_)};
+
+   if constexpr (sizeof(CharType) == 1) {
+      if (lead < 0x80) {
+         ++first_;
+         return lead;
+      }
+
+      size_type size{0};
+      char32_t low{0x80};  // Bounds of the second byte
+      char32_t high{0xBF};
+
+      if (lead < 0xC2) {
+         return invalid;
+      } else if (lead < 0xE0) {
+         size = 2;
+      } else if (lead < 0xF0) {
+         size = 3;
+         low = lead == 0xE0 ? 0xA0 : low;
+         high = lead == 0xED ? 0x9F : high;
+      } else if (lead < 0xF5) {
+         size = 4;
+         low = lead == 0xF0 ? 0x90 : low;
+         high = lead == 0xF4 ? 0x8F : high;
+      } else {
+         return invalid;
+      }
+
+      if (static_cast<size_type>(last_ - first_) < size ||
+          unit(first_[1]) < low || unit(first_[1]) > high) {
+         return invalid;
+      }
+
+      char32_t code{lead & (0x7F >> size)};
+      for (size_type index{1}; index != size; ++index) {
+         char32_t const next{unit(first_[index])};
+         if ((next & 0xC0) != 0x80) {
+            return invalid;
+         }
+         code = (code << 6) | (next & 0x3F);
+      }
+
+      first_ += size;
+      return code;
+   } else if constexpr (sizeof(CharType) == 2) {
+      if (lead < 0xD800 || lead > 0xDFFF) {
+         ++first_;
+         return lead;
+      }
+      if (lead > 0xDBFF || last_ - first_ < 2 || unit(first_[1]) < 0xDC00 ||
+          unit(first_[1]) > 0xDFFF) {
+         return invalid;
+      }
+
+      char32_t const code{0x10000 + ((lead - 0xD800) << 10) +
+                          (unit(first_[1]) - 0xDC00)};
+      first_ += 2;
+      return code;
+   } else {
+      if (lead > 0x10FFFF || (lead >= 0xD800 && lead <= 0xDFFF)) {
+         return invalid;
+      }
+
+      ++first_;
+      return lead;
+   }
+}
+
+/**
+ * @brief Encodes a valid code point.
+ *
+ * @tparam CharType The character type, which sets the encoding.
+ * @param code_ The code point.
+ * @param out_ Where to write the code units (up to 4 bytes, 2 UTF-16 units
+ * or 1 UTF-32 unit).
+ * @return The end of the written code units.
+ */
+template <typename CharType> CharType *encode(char32_t code_, CharType *out_) {
+   if constexpr (sizeof(CharType) == 1) {
+      if (code_ < 0x80) {
+         *out_++ = static_cast<CharType>(code_);
+      } else if (code_ < 0x800) {
+         *out_++ = static_cast<CharType>(0xC0 | (code_ >> 6));
+         *out_++ = static_cast<CharType>(0x80 | (code_ & 0x3F));
+      } else if (code_ < 0x10000) {
+         *out_++ = static_cast<CharType>(0xE0 | (code_ >> 12));
+         *out_++ = static_cast<CharType>(0x80 | ((code_ >> 6) & 0x3F));
+         *out_++ = static_cast<CharType>(0x80 | (code_ & 0x3F));
+      } else {
+         *out_++ = static_cast<CharType>(0xF0 | (code_ >> 18));
+         *out_++ = static_cast<CharType>(0x80 | ((code_ >> 12) & 0x3F));
+         *out_++ = static_cast<CharType>(0x80 | ((code_ >> 6) & 0x3F));
+         *out_++ = static_cast<CharType>(0x80 | (code_ & 0x3F));
+      }
+   } else if constexpr (sizeof(CharType) == 2) {
+      if (code_ < 0x10000) {
+         *out_++ = static_cast<CharType>(code_);
+      } else {
+         *out_++ = static_cast<CharType>(0xD800 + ((code_ - 0x10000) >> 10));
+         *out_++ = static_cast<CharType>(0xDC00 + (code_ & 0x3FF));
+      }
+   } else {
+      *out_++ = static_cast<CharType>(code_);
+   }
+
+   return out_;
+}
+
+/**
+ * @brief Gets the length of the run of ASCII bytes at the start of a text.
+ *
+ * @param data_ The bytes.
+ * @param size_ The number of bytes.
+ * @return The number of leading bytes below 0x80.
+ */
+inline size_type ascii_prefix(unsigned char const *data_, size_type size_) {
+   size_type pos{0};
+
+#if defined(__AVX2__)
+   for (; size_ - pos >= 32; pos += 32) {
+      unsigned const mask{static_cast<unsigned>(_mm256_movemask_epi8(
+          _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data_ + pos))))};
+      if (mask != 0) {
+         return pos + static_cast<size_type>(__builtin_ctz(mask));
+      }
+   }
+#elif defined(__SSE2__)
+   for (; size_ - pos >= 16; pos += 16) {
+      unsigned const mask{static_cast<unsigned>(_mm_movemask_epi8(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(data_ + pos))))};
+      if (mask != 0) {
+         return pos + static_cast<size_type>(__builtin_ctz(mask));
+      }
+   }
+#endif
+
+   while (pos != size_ && data_[pos] < 0x80) {
+      ++pos;
+   }
+   return pos;
+}
+
+/**
+ * @brief Copies the run of ASCII bytes at the start of a text into wider
+ * code units.
+ *
+ * @tparam CharType The output character type (2 or 4 bytes).
+ * @return The number of bytes copied.
+ */
+template <typename CharType>
+size_type widen_ascii(unsigned char const *in_, size_type size_,
+                      CharType *out_) {
+   size_type pos{0};
+
+#if defined(__SSE2__)
+   __m128i const zero{_mm_setzero_si128()};
+
+   for (; size_ - pos >= 16; pos += 16) {
+      __m128i const bytes{
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(in_ + pos))};
+      if (_mm_movemask_epi8(bytes) != 0) {
+         break;
+      }
+
+      __m128i const low{_mm_unpacklo_epi8(bytes, zero)};
+      __m128i const high{_mm_unpackhi_epi8(bytes, zero)};
+      __m128i *const out{reinterpret_cast<__m128i *>(out_ + pos)};
+
+      if constexpr (sizeof(CharType) == 2) {
+         _mm_storeu_si128(out, low);
+         _mm_storeu_si128(out + 1, high);
+      } else {
+         _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+         _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+         _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+         _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+      }
+   }
+#endif
+
+   for (; pos != size_ && in_[pos] < 0x80; ++pos) {
+      out_[pos] = static_cast<CharType>(in_[pos]);
+   }
+   return pos;
+}
+
+/**
+ * @brief Copies the run of ASCII code units at the start of a text into
+ * bytes.
+ *
+ * @tparam CharType The input character type (2 or 4 bytes).
+ * @return The number of code units copied.
+ */
+template <typename CharType>
+size_type narrow_ascii(CharType const *in_, size_type size_,
+                       unsigned char *out_) {
+   size_type pos{0};
+
+#if defined(__SSE2__)
+   __m128i const zero{_mm_setzero_si128()};
+
+   for (; size_ - pos >= 16; pos += 16) {
+      __m128i const *const in{reinterpret_cast<__m128i const *>(in_ + pos)};
+      __m128i bytes;
+
+      if constexpr (sizeof(CharType) == 2) {
+         __m128i const low{_mm_loadu_si128(in)};
+         __m128i const high{_mm_loadu_si128(in + 1)};
+         __m128i const above{_mm_and_si128(_mm_or_si128(low, high),
+                                           _mm_set1_epi16(-0x80))};
+         if (_mm_movemask_epi8(_mm_cmpeq_epi16(above, zero)) != 0xFFFF) {
+            break;
+         }
+         bytes = _mm_packus_epi16(low, high);
+      } else {
+         __m128i const first{_mm_loadu_si128(in)};
+         __m128i const second{_mm_loadu_si128(in + 1)};
+         __m128i const third{_mm_loadu_si128(in + 2)};
+         __m128i const fourth{_mm_loadu_si128(in + 3)};
+         __m128i const above{_mm_and_si128(
+             _mm_or_si128(_mm_or_si128(first, second),
+                          _mm_or_si128(third, fourth)),
+             _mm_set1_epi32(-0x80))};
+         if (_mm_movemask_epi8(_mm_cmpeq_epi32(above, zero)) != 0xFFFF) {
+            break;
+         }
+         bytes = _mm_packus_epi16(_mm_packs_epi32(first, second),
+                                  _mm_packs_epi32(third, fourth));
+      }
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out_ + pos), bytes);
+   }
+#endif
+
+   for (; pos != size_ && unit(in_[pos]) < 0x80; ++pos) {
+      out_[pos] = static_cast<unsigned char>(in_[pos]);
+   }
+   return pos;
+}
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+/**
+ * @brief Error bits of the UTF-8 lookup tables, one per kind of invalid
+ * pair of adjacent bytes.
+ */
+enum lookup_error : unsigned char {
+   too_short = 1 << 0,  ///< A lead byte followed by a non-continuation.
+   too_long = 1 << 1,   ///< An ASCII byte followed by a continuation.
+   overlong_3 = 1 << 2, ///< E0 followed by 80..9F.
+   too_large = 1 << 3,  ///< F4 followed by 90..BF, or F5..FF.
+   surrogate = 1 << 4,  ///< ED followed by A0..BF.
+   overlong_2 = 1 << 5, ///< C0 or C1.
+   overlong_4 = 1 << 6, ///< F0 followed by 80..8F.
+   two_conts = 1 << 7,  ///< Two continuations, right only after a lead.
+   too_large_1000 = 1 << 6, ///< F5..FF followed by 80..8F.
+   carry = too_short | too_long | two_conts ///< Set by any lead nibble.
+};
+
+/**
+ * @brief Lookup tables of the errors, by the high and the low nibble of a
+ * byte and by the high nibble of the byte after it.
+ */
+alignas(16) inline constexpr unsigned char first_high[16]{
+    too_long, too_long, too_long, too_long,
+    too_long, too_long, too_long, too_long,
+    two_conts, two_conts, two_conts, two_conts,
+    too_short | overlong_2,
+    too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4};
+alignas(16) inline constexpr unsigned char first_low[16]{
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000};
+alignas(16) inline constexpr unsigned char second_high[16]{
+    too_short, too_short, too_short, too_short,
+    too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 |
+        overlong_4,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_short, too_short, too_short, too_short};
+
+/**
+ * @brief Largest bytes that do not start a sequence running past the end of
+ * a vector, for its last three positions.
+ */
+alignas(32) inline constexpr unsigned char last_bytes[32]{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+#endif
+
+#if defined(__AVX2__)
+using byte_vector = __m256i;                 ///< Vector of the validator.
+inline constexpr size_type vector_block{32}; ///< Bytes per vector step.
+
+/// Loads a vector of bytes.
+inline byte_vector load(unsigned char const *data_) {
+   return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data_));
+}
+
+/// Sets every byte to a value.
+inline byte_vector splat(unsigned char byte_) {
+   return _mm256_set1_epi8(static_cast<char>(byte_));
+}
+
+/// Loads a 16-byte table into each lane.
+inline byte_vector table(unsigned char const *table_) {
+   return _mm256_broadcastsi128_si256(
+       _mm_load_si128(reinterpret_cast<__m128i const *>(table_)));
+}
+
+/// Looks up each byte (0 to 15) in a table.
+inline byte_vector lookup(byte_vector table_, byte_vector index_) {
+   return _mm256_shuffle_epi8(table_, index_);
+}
+
+/// Gets the high nibble of each byte.
+inline byte_vector high_nibbles(byte_vector bytes_) {
+   return _mm256_and_si256(_mm256_srli_epi16(bytes_, 4),
+                           _mm256_set1_epi8(0x0F));
+}
+
+/// Gets the low nibble of each byte.
+inline byte_vector low_nibbles(byte_vector bytes_) {
+   return _mm256_and_si256(bytes_, _mm256_set1_epi8(0x0F));
+}
+
+/// Gets the bytes Shift positions before each byte.
+template <int Shift>
+inline byte_vector previous(byte_vector bytes_, byte_vector before_) {
+   return _mm256_alignr_epi8(
+       bytes_, _mm256_permute2x128_si256(before_, bytes_, 0x21), 16 - Shift);
+}
+
+/// Subtracts with unsigned saturation.
+inline byte_vector saturated_sub(byte_vector left_, byte_vector right_) {
+   return _mm256_subs_epu8(left_, right_);
+}
+
+/// Bitwise operations.
+inline byte_vector bit_and(byte_vector left_, byte_vector right_) {
+   return _mm256_and_si256(left_, right_);
+}
+inline byte_vector bit_or(byte_vector left_, byte_vector right_) {
+   return _mm256_or_si256(left_, right_);
+}
+inline byte_vector bit_xor(byte_vector left_, byte_vector right_) {
+   return _mm256_xor_si256(left_, right_);
+}
+
+/// Checks if every byte is below 0x80.
+inline bool is_ascii(byte_vector bytes_) {
+   return _mm256_movemask_epi8(bytes_) == 0;
+}
+
+/// Checks if any byte is not zero.
+inline bool any(byte_vector bytes_) {
+   return !_mm256_testz_si256(bytes_, bytes_);
+}
+#elif defined(__SSSE3__)
+using byte_vector = __m128i;                 ///< Vector of the validator.
+inline constexpr size_type vector_block{16}; ///< Bytes per vector step.
+
+/// Loads a vector of bytes.
+inline byte_vector load(unsigned char const *data_) {
+   return _mm_loadu_si128(reinterpret_cast<__m128i const *>(data_));
+}
+
+/// Sets every byte to a value.
+inline byte_vector splat(unsigned char byte_) {
+   return _mm_set1_epi8(static_cast<char>(byte_));
+}
+
+/// Loads a 16-byte table.
+inline byte_vector table(unsigned char const *table_) {
+   return _mm_load_si128(reinterpret_cast<__m128i const *>(table_));
+}
+
+/// Looks up each byte (0 to 15) in a table.
+inline byte_vector lookup(byte_vector table_, byte_vector index_) {
+   return _mm_shuffle_epi8(table_, index_);
+}
+
+/// Gets the high nibble of each byte.
+inline byte_vector high_nibbles(byte_vector bytes_) {
+   return _mm_and_si128(_mm_srli_epi16(bytes_, 4), _mm_set1_epi8(0x0F));
+}
+
+/// Gets the low nibble of each byte.
+inline byte_vector low_nibbles(byte_vector bytes_) {
+   return _mm_and_si128(bytes_, _mm_set1_epi8(0x0F));
+}
+
+/// Gets the bytes Shift positions before each byte.
+template <int Shift>
+inline byte_vector previous(byte_vector bytes_, byte_vector before_) {
+   return _mm_alignr_epi8(bytes_, before_, 16 - Shift);
+}
+
+/// Subtracts with unsigned saturation.
+inline byte_vector saturated_sub(byte_vector left_, byte_vector right_) {
+   return _mm_subs_epu8(left_, right_);
+}
+
+/// Bitwise operations.
+inline byte_vector bit_and(byte_vector left_, byte_vector right_) {
+   return _mm_and_si128(left_, right_);
+}
+inline byte_vector bit_or(byte_vector left_, byte_vector right_) {
+   return _mm_or_si128(left_, right_);
+}
+inline byte_vector bit_xor(byte_vector left_, byte_vector right_) {
+   return _mm_xor_si128(left_, right_);
+}
+
+/// Checks if every byte is below 0x80.
+inline bool is_ascii(byte_vector bytes_) {
+   return _mm_movemask_epi8(bytes_) == 0;
+}
+
+/// Checks if any byte is not zero.
+inline bool any(byte_vector bytes_) {
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes_, _mm_setzero_si128())) !=
+          0xFFFF;
+}
+#endif
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+/**
+ * @brief Validates UTF-8 a vector at a time.
+ *
+ * The last, partial vector is padded with zeros, which also exposes a
+ * sequence cut by the end of the text.
+ */
+inline bool vector_valid(unsigned char const *data_, size_type size_) {
+   byte_vector const high_table{table(first_high)};
+   byte_vector const low_table{table(first_low)};
+   byte_vector const next_table{table(second_high)};
+   byte_vector const limits{load(last_bytes + 32 - vector_block)};
+   byte_vector const third_lead{splat(0xE0 - 0x80)};
+   byte_vector const fourth_lead{splat(0xF0 - 0x80)};
+   byte_vector const high_bit{splat(0x80)};
+
+   byte_vector const zero{splat(0)};
+   byte_vector errors{zero};
+   byte_vector before{zero};
+   byte_vector incomplete{zero};
+   unsigned char padded[vector_block];
+
+   for (size_type pos{0};; pos += vector_block) {
+      bool const last{size_ - pos < vector_block};
+      byte_vector bytes;
+      if (last) {
+         std::memset(padded, 0, vector_block);
+         std::memcpy(padded, data_ + pos, size_ - pos);
+         bytes = load(padded);
+      } else {
+         bytes = load(data_ + pos);
+      }
+
+      if (is_ascii(bytes)) {
+         errors = bit_or(errors, incomplete);
+         incomplete = zero;
+      } else {
+         byte_vector const one_back{previous<1>(bytes, before)};
+         byte_vector const special{
+             bit_and(bit_and(lookup(high_table, high_nibbles(one_back)),
+                             lookup(low_table, low_nibbles(one_back))),
+                     lookup(next_table, high_nibbles(bytes)))};
+
+         // A byte 2 after a lead of 3 or 4 bytes, or 3 after a lead of 4
+         // bytes, must be a continuation, which two_conts then allows
+         byte_vector const must_continue{bit_and(
+             bit_or(saturated_sub(previous<2>(bytes, before), third_lead),
+                    saturated_sub(previous<3>(bytes, before), fourth_lead)),
+             high_bit)};
+
+         errors = bit_or(errors, bit_xor(must_continue, special));
+         incomplete = saturated_sub(bytes, limits);
+      }
+
+      before = bytes;
+      if (last) {
+         return !any(errors);
+      }
+   }
+}
+#endif
+
+/**
+ * @brief Checks if a text is valid UTF-8.
+ *
+ * @param text_ The text.
+ * @return True if the text is valid, false otherwise.
+ */
+inline bool valid(std::string_view text_) {
+   unsigned char const *const data{
+       reinterpret_cast<unsigned char const *>(text_.data())};
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+   return vector_valid(data, text_.size());
+#else
+   unsigned char const *const end{data + text_.size()};
+
+   for (unsigned char const *it{data};;) {
+      it += ascii_prefix(it, static_cast<size_type>(end - it));
+      if (it == end) {
+         return true;
+      }
+      if (decode(it, end) == invalid) {
+         return false;
+      }
+   }
+#endif
+}
+
+/**
+ * @brief Checks if a text of 2 or 4-byte code units is valid UTF-16 or
+ * UTF-32.
+ *
+ * @tparam CharType The character type.
+ * @param text_ The text.
+ * @return True if the text is valid, false otherwise.
+ */
+template <typename CharType>
+bool valid_units(std::basic_string_view<CharType> text_) {
+   static_assert(sizeof(CharType) == 2 || sizeof(CharType) == 4,
+                 "UTF-16 or UTF-32 code units expected.");
+
+   CharType const *it{text_.data()};
+   CharType const *const end{it + text_.size()};
+
+   if constexpr (sizeof(CharType) == 4) {
+      char32_t bad{0};
+      for (; it != end; ++it) {
+         // Surrogates and values above U+10FFFF, without a branch
+         bad |= static_cast<char32_t>(unit(*it) - 0xD800 < 0x800) |
+                static_cast<char32_t>(unit(*it) > 0x10FFFF);
+      }
+      return bad == 0;
+   } else {
+      while (it != end) {
+#if defined(__SSE2__)
+         // Skip blocks without surrogates
+         while (end - it >= 8) {
+            __m128i const units{
+                _mm_loadu_si128(reinterpret_cast<__m128i const *>(it))};
+            __m128i const surrogates{_mm_cmpeq_epi16(
+                _mm_and_si128(units, _mm_set1_epi16(-0x800)),
+                _mm_set1_epi16(-0x2800))};
+            if (_mm_movemask_epi8(surrogates) != 0) {
+               break;
+            }
+            it += 8;
+         }
+         if (it == end) {
+            break;
+         }
+#endif
+         if (decode(it, end) == invalid) {
+            return false;
+         }
+      }
+      return true;
+   }
+}
+
+/**
+ * @brief Checks if a text is valid UTF-16.
+ */
+inline bool valid(std::u16string_view text_) { return valid_units(text_); }
+
+/**
+ * @brief Checks if a text is valid UTF-32.
+ */
+inline bool valid(std::u32string_view text_) { return valid_units(text_); }
+
+/**
+ * @brief Checks if a wide text is valid UTF-16 or UTF-32, depending on the
+ * size of wchar_t.
+ */
+inline bool valid(std::wstring_view text_) { return valid_units(text_); }
+
+/**
+ * @brief Appends a text to a string, converted to the encoding of the
+ * string's character type.
+ *
+ * @tparam CharType The character type of the text, which sets its encoding.
+ * @tparam String A std::basic_string-like type.
+ * @param text_ The text.
+ * @param out_ The string to append to; unchanged if an exception is thrown.
+ * @throw std::invalid_argument if the text is not valid in its encoding.
+ */
+template <typename CharType, class String>
+void convert(std::basic_string_view<CharType> text_, String &out_) {
+   using out_type = typename String::value_type;
+   static constexpr char const *const errors[]{
+       "Invalid UTF-8 sequence.", "Invalid UTF-16 sequence.", nullptr,
+       "Invalid UTF-32 sequence."};
+   char const *const error{errors[sizeof(CharType) - 1]};
+
+   if constexpr (sizeof(CharType) == sizeof(out_type)) {
+      bool valid_text;
+      if constexpr (sizeof(CharType) == 1) {
+         valid_text = valid(std::string_view(
+             reinterpret_cast<char const *>(text_.data()), text_.size()));
+      } else {
+         valid_text = valid_units(text_);
+      }
+      if (!valid_text) {
+         throw std::invalid_argument(error);
+      }
+
+      out_.append(reinterpret_cast<out_type const *>(text_.data()),
+                  text_.size());
+   } else {
+      // Most code units needed per input code unit
+      constexpr size_type growth{
+          sizeof(out_type) == 1
+              ? (sizeof(CharType) == 2 ? 3 : 4)
+              : (sizeof(CharType) == 4 && sizeof(out_type) == 2 ? 2 : 1)};
+
+      size_type const old_size{out_.size()};
+      out_.resize(old_size + text_.size() * growth);
+
+      out_type *out{&out_[0] + old_size};
+      CharType const *in{text_.data()};
+      CharType const *const end{in + text_.size()};
+
+      while (in != end) {
+         size_type copied{0};
+         if constexpr (sizeof(CharType) == 1) {
+            copied = widen_ascii(
+                reinterpret_cast<unsigned char const *>(in),
+                static_cast<size_type>(end - in), out);
+         } else if constexpr (sizeof(out_type) == 1) {
+            copied = narrow_ascii(in, static_cast<size_type>(end - in),
+                                  reinterpret_cast<unsigned char *>(out));
+         }
+         in += copied;
+         out += copied;
+         if (in == end) {
+            break;
+         }
+
+         char32_t const code{decode(in, end)};
+         if (code == invalid) {
+            out_.resize(old_size);
+            throw std::invalid_argument(error);
+         }
+         out = encode(code, out);
+      }
+
+      out_.resize(static_cast<size_type>(out - out_.data()));
+   }
+}
+
+/**
+ * @brief Converts UTF-16 to UTF-8.
+ * @throw std::invalid_argument if the text is not valid UTF-16.
+ */
+inline std::string to_utf8(std::u16string_view text_) {
+   std::string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts UTF-32 to UTF-8.
+ * @throw std::invalid_argument if the text is not valid UTF-32.
+ */
+inline std::string to_utf8(std::u32string_view text_) {
+   std::string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts a wide text to UTF-8.
+ * @throw std::invalid_argument if the text is not valid UTF-16 or UTF-32.
+ */
+inline std::string to_utf8(std::wstring_view text_) {
+   std::string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts UTF-8 to UTF-16.
+ * @throw std::invalid_argument if the text is not valid UTF-8.
+ */
+inline std::u16string to_utf16(std::string_view text_) {
+   std::u16string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts UTF-32 to UTF-16.
+ * @throw std::invalid_argument if the text is not valid UTF-32.
+ */
+inline std::u16string to_utf16(std::u32string_view text_) {
+   std::u16string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts UTF-8 to UTF-32.
+ * @throw std::invalid_argument if the text is not valid UTF-8.
+ */
+inline std::u32string to_utf32(std::string_view text_) {
+   std::u32string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts UTF-16 to UTF-32.
+ * @throw std::invalid_argument if the text is not valid UTF-16.
+ */
+inline std::u32string to_utf32(std::u16string_view text_) {
+   std::u32string out;
+   convert(text_, out);
+   return out;
+}
+
+/**
+ * @brief Converts UTF-8 to a wide text, in UTF-16 or UTF-32 depending on the
+ * size of wchar_t.
+ * @throw std::invalid_argument if the text is not valid UTF-8.
+ */
+inline std::wstring to_wide(std::string_view text_) {
+   std::wstring out;
+   convert(text_, out);
+   return out;
+}
+
+} // namespace utf
+} // namespace ext
+
+#endif // UTF_HPP_
@@ -0,0 +1,415 @@
+/**
+ * @file width.hpp
+ * @author Pedro Lucas (pedrolucas.jsrn@gmail.com)
+ * @brief The width of a text on a terminal, in columns.
+ * @version 1.0
+ * @date 2023-10-20
+ *
+ * Escape sequences take no column, nor do combining marks, format characters
+ * and controls, while wide East Asian characters and emoji take two. Two
+ * sorted tables of ranges (zero-width and wide) are expanded at compile time
+ * into a 16 KB table of two bits per code point of the Basic Multilingual
+ * Plane, and only the other planes search the ranges. Runs of printable
+ * ASCII, one column per byte, are measured 16 bytes at a time with SSE2, so
+ * plain text costs little more than a pass over its bytes.
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef WIDTH_HPP_
+#define WIDTH_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+#include "ansi.hpp"
+#include "utf.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Namespace 'ext' for external utilities and extensions.
+ */
+namespace ext {
+
+/**
+ * @brief Column width namespace
+ *
+ * This namespace holds the tables and kernels behind display_width() and
+ * display_prefix().
+ */
+namespace cols {
+using size_type = std::size_t;
+
+/**
+ * @brief An inclusive range of code points.
+ */
+struct range {
+   char32_t first; ///< First code point.
+   char32_t last;  ///< Last code point.
+};
+
+/**
+ * @brief Combining marks, format characters and other code points that take
+ * no column.
+ */
+inline constexpr range zero_width[]{
+    {0x0300, 0x036F},   {0x0483, 0x0489},   {0x0591, 0x05BD},
+    {0x05BF, 0x05BF},   {0x05C1, 0x05C2},   {0x05C4, 0x05C5},
+    {0x05C7, 0x05C7},   {0x0600, 0x0605},   {0x0610, 0x061A},
+    {0x061C, 0x061C},   {0x064B, 0x065F},   {0x0670, 0x0670},
+    {0x06D6, 0x06DD},   {0x06DF, 0x06E4},   {0x06E7, 0x06E8},
+    {0x06EA, 0x06ED},   {0x070F, 0x070F},   {0x0711, 0x0711},
+    {0x0730, 0x074A},   {0x07A6, 0x07B0},   {0x07EB, 0x07F3},
+    {0x07FD, 0x07FD},   {0x0816, 0x0819},   {0x081B, 0x0823},
+    {0x0825, 0x0827},   {0x0829, 0x082D},   {0x0859, 0x085B},
+    {0x0890, 0x0891},   {0x0898, 0x089F},   {0x08CA, 0x0902},
+    {0x093A, 0x093A},   {0x093C, 0x093C},   {0x0941, 0x0948},
+    {0x094D, 0x094D},   {0x0951, 0x0957},   {0x0962, 0x0963},
+    {0x0981, 0x0981},   {0x09BC, 0x09BC},   {0x09C1, 0x09C4},
+    {0x09CD, 0x09CD},   {0x09E2, 0x09E3},   {0x09FE, 0x09FE},
+    {0x0A01, 0x0A02},   {0x0A3C, 0x0A3C},   {0x0A41, 0x0A42},
+    {0x0A47, 0x0A48},   {0x0A4B, 0x0A4D},   {0x0A51, 0x0A51},
+    {0x0A70, 0x0A71},   {0x0A75, 0x0A75},   {0x0A81, 0x0A82},
+    {0x0ABC, 0x0ABC},   {0x0AC1, 0x0AC5},   {0x0AC7, 0x0AC8},
+    {0x0ACD, 0x0ACD},   {0x0AE2, 0x0AE3},   {0x0AFA, 0x0AFF},
+    {0x0B01, 0x0B01},   {0x0B3C, 0x0B3C},   {0x0B3F, 0x0B3F},
+    {0x0B41, 0x0B44},   {0x0B4D, 0x0B4D},   {0x0B55, 0x0B56},
+    {0x0B62, 0x0B63},   {0x0B82, 0x0B82},   {0x0BC0, 0x0BC0},
+    {0x0BCD, 0x0BCD},   {0x0C00, 0x0C00},   {0x0C04, 0x0C04},
+    {0x0C3C, 0x0C3C},   {0x0C3E, 0x0C40},   {0x0C46, 0x0C48},
+    {0x0C4A, 0x0C4D},   {0x0C55, 0x0C56},   {0x0C62, 0x0C63},
+    {0x0C81, 0x0C81},   {0x0CBC, 0x0CBC},   {0x0CBF, 0x0CBF},
+    {0x0CC6, 0x0CC6},   {0x0CCC, 0x0CCD},   {0x0CE2, 0x0CE3},
+    {0x0D00, 0x0D01},   {0x0D3B, 0x0D3C},   {0x0D41, 0x0D44},
+    {0x0D4D, 0x0D4D},   {0x0D62, 0x0D63},   {0x0D81, 0x0D81},
+    {0x0DCA, 0x0DCA},   {0x0DD2, 0x0DD4},   {0x0DD6, 0x0DD6},
+    {0x0E31, 0x0E31},   {0x0E34, 0x0E3A},   {0x0E47, 0x0E4E},
+    {0x0EB1, 0x0EB1},   {0x0EB4, 0x0EBC},   {0x0EC8, 0x0ECE},
+    {0x0F18, 0x0F19},   {0x0F35, 0x0F35},   {0x0F37, 0x0F37},
+    {0x0F39, 0x0F39},   {0x0F71, 0x0F7E},   {0x0F80, 0x0F84},
+    {0x0F86, 0x0F87},   {0x0F8D, 0x0F97},   {0x0F99, 0x0FBC},
+    {0x0FC6, 0x0FC6},   {0x102D, 0x1030},   {0x1032, 0x1037},
+    {0x1039, 0x103A},   {0x103D, 0x103E},   {0x1058, 0x1059},
+    {0x105E, 0x1060},   {0x1071, 0x1074},   {0x1082, 0x1082},
+    {0x1085, 0x1086},   {0x108D, 0x108D},   {0x109D, 0x109D},
+    {0x1160, 0x11FF},   {0x135D, 0x135F},   {0x1712, 0x1714},
+    {0x1732, 0x1733},   {0x1752, 0x1753},   {0x1772, 0x1773},
+    {0x17B4, 0x17B5},   {0x17B7, 0x17BD},   {0x17C6, 0x17C6},
+    {0x17C9, 0x17D3},   {0x17DD, 0x17DD},   {0x180B, 0x180F},
+    {0x1885, 0x1886},   {0x18A9, 0x18A9},   {0x1920, 0x1922},
+    {0x1927, 0x1928},   {0x1932, 0x1932},   {0x1939, 0x193B},
+    {0x1A17, 0x1A18},   {0x1A1B, 0x1A1B},   {0x1A56, 0x1A56},
+    {0x1A58, 0x1A5E},   {0x1A60, 0x1A60},   {0x1A62, 0x1A62},
+    {0x1A65, 0x1A6C},   {0x1A73, 0x1A7C},   {0x1A7F, 0x1A7F},
+    {0x1AB0, 0x1ACE},   {0x1B00, 0x1B03},   {0x1B34, 0x1B34},
+    {0x1B36, 0x1B3A},   {0x1B3C, 0x1B3C},   {0x1B42, 0x1B42},
+    {0x1B6B, 0x1B73},   {0x1B80, 0x1B81},   {0x1BA2, 0x1BA5},
+    {0x1BA8, 0x1BA9},   {0x1BAB, 0x1BAD},   {0x1BE6, 0x1BE6},
+    {0x1BE8, 0x1BE9},   {0x1BED, 0x1BED},   {0x1BEF, 0x1BF1},
+    {0x1C2C, 0x1C33},   {0x1C36, 0x1C37},   {0x1CD0, 0x1CD2},
+    {0x1CD4, 0x1CE0},   {0x1CE2, 0x1CE8},   {0x1CED, 0x1CED},
+    {0x1CF4, 0x1CF4},   {0x1CF8, 0x1CF9},   {0x1DC0, 0x1DFF},
+    {0x200B, 0x200F},   {0x202A, 0x202E},   {0x2060, 0x2064},
+    {0x2066, 0x206F},   {0x20D0, 0x20F0},   {0x2CEF, 0x2CF1},
+    {0x2D7F, 0x2D7F},   {0x2DE0, 0x2DFF},   {0x302A, 0x302D},
+    {0x3099, 0x309A},   {0xA66F, 0xA672},   {0xA674, 0xA67D},
+    {0xA69E, 0xA69F},   {0xA6F0, 0xA6F1},   {0xA802, 0xA802},
+    {0xA806, 0xA806},   {0xA80B, 0xA80B},   {0xA825, 0xA826},
+    {0xA82C, 0xA82C},   {0xA8C4, 0xA8C5},   {0xA8E0, 0xA8F1},
+    {0xA8FF, 0xA8FF},   {0xA926, 0xA92D},   {0xA947, 0xA951},
+    {0xA980, 0xA982},   {0xA9B3, 0xA9B3},   {0xA9B6, 0xA9B9},
+    {0xA9BC, 0xA9BD},   {0xA9E5, 0xA9E5},   {0xAA29, 0xAA2E},
+    {0xAA31, 0xAA32},   {0xAA35, 0xAA36},   {0xAA43, 0xAA43},
+    {0xAA4C, 0xAA4C},   {0xAA7C, 0xAA7C},   {0xAAB0, 0xAAB0},
+    {0xAAB2, 0xAAB4},   {0xAAB7, 0xAAB8},   {0xAABE, 0xAABF},
+    {0xAAC1, 0xAAC1},   {0xAAEC, 0xAAED},   {0xAAF6, 0xAAF6},
+    {0xABE5, 0xABE5},   {0xABE8, 0xABE8},   {0xABED, 0xABED},
+    {0xD7B0, 0xD7FF},   {0xFB1E, 0xFB1E},   {0xFE00, 0xFE0F},
+    {0xFE20, 0xFE2F},   {0xFEFF, 0xFEFF},   {0xFFF9, 0xFFFB},
+    {0x101FD, 0x101FD}, {0x102E0, 0x102E0}, {0x10376, 0x1037A},
+    {0x10A01, 0x10A03}, {0x10A05, 0x10A06}, {0x10A0C, 0x10A0F},
+    {0x10A38, 0x10A3A}, {0x10A3F, 0x10A3F}, {0x10AE5, 0x10AE6},
+    {0x10D24, 0x10D27}, {0x10EAB, 0x10EAC}, {0x10F46, 0x10F50},
+    {0x11001, 0x11001}, {0x11038, 0x11046}, {0x1107F, 0x11081},
+    {0x110B3, 0x110B6}, {0x110B9, 0x110BA}, {0x110BD, 0x110BD},
+    {0x11100, 0x11102}, {0x11127, 0x1112B}, {0x1112D, 0x11134},
+    {0x11173, 0x11173}, {0x11180, 0x11181}, {0x111B6, 0x111BE},
+    {0x1D167, 0x1D169}, {0x1D173, 0x1D182}, {0x1D185, 0x1D18B},
+    {0x1D1AA, 0x1D1AD}, {0x1D242, 0x1D244}, {0x1E000, 0x1E02A},
+    {0x1E8D0, 0x1E8D6}, {0x1E944, 0x1E94A}, {0x1F3FB, 0x1F3FF},
+    {0xE0001, 0xE0001}, {0xE0020, 0xE007F}, {0xE0100, 0xE01EF},
+};
+
+/**
+ * @brief East Asian wide and fullwidth code points, and emoji presented as
+ * wide, which take two columns.
+ */
+inline constexpr range wide[]{
+    {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},
+    {0x23E9, 0x23EC},   {0x23F0, 0x23F0},   {0x23F3, 0x23F3},
+    {0x25FD, 0x25FE},   {0x2614, 0x2615},   {0x2648, 0x2653},
+    {0x267F, 0x267F},   {0x2693, 0x2693},   {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB},   {0x26BD, 0x26BE},   {0x26C4, 0x26C5},
+    {0x26CE, 0x26CE},   {0x26D4, 0x26D4},   {0x26EA, 0x26EA},
+    {0x26F2, 0x26F3},   {0x26F5, 0x26F5},   {0x26FA, 0x26FA},
+    {0x26FD, 0x26FD},   {0x2705, 0x2705},   {0x270A, 0x270B},
+    {0x2728, 0x2728},   {0x274C, 0x274C},   {0x274E, 0x274E},
+    {0x2753, 0x2755},   {0x2757, 0x2757},   {0x2795, 0x2797},
+    {0x27B0, 0x27B0},   {0x27BF, 0x27BF},   {0x2B1B, 0x2B1C},
+    {0x2B50, 0x2B50},   {0x2B55, 0x2B55},   {0x2E80, 0x2E99},
+    {0x2E9B, 0x2EF3},   {0x2F00, 0x2FD5},   {0x2FF0, 0x2FFB},
+    {0x3000, 0x3029},   {0x302E, 0x303E},   {0x3041, 0x3096},
+    {0x309B, 0x30FF},   {0x3105, 0x312F},   {0x3131, 0x318E},
+    {0x3190, 0x31E3},   {0x31F0, 0x321E},   {0x3220, 0x3247},
+    {0x3250, 0x4DBF},   {0x4E00, 0xA48C},   {0xA490, 0xA4C6},
+    {0xA960, 0xA97C},   {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},
+    {0xFE10, 0xFE19},   {0xFE30, 0xFE52},   {0xFE54, 0xFE66},
+    {0xFE68, 0xFE6B},   {0xFF01, 0xFF60},   {0xFFE0, 0xFFE6},
+    {0x16FE0, 0x16FE4}, {0x16FF0, 0x16FF1}, {0x17000, 0x187F7},
+    {0x18800, 0x18CD5}, {0x18D00, 0x18D08}, {0x1AFF0, 0x1AFFE},
+    {0x1B000, 0x1B122}, {0x1B132, 0x1B132}, {0x1B150, 0x1B152},
+    {0x1B155, 0x1B155}, {0x1B164, 0x1B167}, {0x1B170, 0x1B2FB},
+    {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E},
+    {0x1F191, 0x1F19A}, {0x1F200, 0x1F202}, {0x1F210, 0x1F23B},
+    {0x1F240, 0x1F248}, {0x1F250, 0x1F251}, {0x1F260, 0x1F265},
+    {0x1F300, 0x1F320}, {0x1F32D, 0x1F335}, {0x1F337, 0x1F37C},
+    {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA}, {0x1F3CF, 0x1F3D3},
+    {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4}, {0x1F3F8, 0x1F43E},
+    {0x1F440, 0x1F440}, {0x1F442, 0x1F4FC}, {0x1F4FF, 0x1F53D},
+    {0x1F54B, 0x1F54E}, {0x1F550, 0x1F567}, {0x1F57A, 0x1F57A},
+    {0x1F595, 0x1F596}, {0x1F5A4, 0x1F5A4}, {0x1F5FB, 0x1F64F},
+    {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC}, {0x1F6D0, 0x1F6D2},
+    {0x1F6D5, 0x1F6D7}, {0x1F6DC, 0x1F6DF}, {0x1F6EB, 0x1F6EC},
+    {0x1F6F4, 0x1F6FC}, {0x1F7E0, 0x1F7EB}, {0x1F7F0, 0x1F7F0},
+    {0x1F90C, 0x1F93A}, {0x1F93C, 0x1F945}, {0x1F947, 0x1F9FF},
+    {0x1FA70, 0x1FA7C}, {0x1FA80, 0x1FA88}, {0x1FA90, 0x1FABD},
+    {0x1FABF, 0x1FAC5}, {0x1FACE, 0x1FADB}, {0x1FAE0, 0x1FAE8},
+    {0x1FAF0, 0x1FAF8}, {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+};
+
+/**
+ * @brief Checks if a code point is in a sorted table of ranges.
+ */
+template <size_type Size>
+bool in_table(char32_t code_, range const (&table_)[Size]) {
+   if (code_ < table_[0].first || code_ > table_[Size - 1].last) {
+      return false;
+   }
+
+   range const *const found{std::upper_bound(
+       table_, table_ + Size, code_,
+       [](char32_t value_, range const &range_) {
+          return value_ < range_.first;
+       })};
+   return found != table_ && code_ <= found[-1].last;
+}
+
+/**
+ * @brief The width of every code point of the Basic Multilingual Plane, two
+ * bits each, built at compile time from the tables.
+ */
+struct plane_widths {
+   unsigned char bits[0x10000 / 4]; ///< Four widths per byte.
+
+   /**
+    * @brief Fills the widths of the plane.
+    */
+   constexpr plane_widths() : bits{} {
+      for (unsigned char &byte : bits) {
+         byte = 0x55; // Four widths of 1
+      }
+      for (char32_t code{0}; code != 0xA0; ++code) {
+         if (code < 0x20 || code >= 0x7F) {
+            set(code, 0);
+         }
+      }
+      for (range const &zero : zero_width) {
+         for (char32_t code{zero.first}; code <= zero.last && code < 0x10000;
+              ++code) {
+            set(code, 0);
+         }
+      }
+      for (range const &two : wide) {
+         for (char32_t code{two.first}; code <= two.last && code < 0x10000;
+              ++code) {
+            set(code, 2);
+         }
+      }
+   }
+
+   /**
+    * @brief Sets the width of a code point.
+    */
+   constexpr void set(char32_t code_, unsigned width_) {
+      unsigned const shift{(code_ & 3) * 2};
+      bits[code_ >> 2] = static_cast<unsigned char>(
+          (bits[code_ >> 2] & ~(3u << shift)) | (width_ << shift));
+   }
+
+   /**
+    * @brief Gets the width of a code point.
+    */
+   constexpr size_type get(char32_t code_) const {
+      return (bits[code_ >> 2] >> ((code_ & 3) * 2)) & 3;
+   }
+};
+
+inline constexpr plane_widths plane{}; ///< Widths of the BMP.
+
+/**
+ * @brief Gets the number of columns of a code point.
+ *
+ * @param code_ The code point.
+ * @return 0 for controls and zero-width code points, 2 for wide ones and 1
+ * for the others.
+ */
+inline size_type width(char32_t code_) {
+   if (code_ < 0x10000) {
+      return plane.get(code_);
+   }
+   if (in_table(code_, zero_width)) {
+      return 0;
+   }
+   return in_table(code_, wide) ? 2 : 1;
+}
+
+/**
+ * @brief Counts the leading bytes that are printable ASCII characters.
+ */
+inline size_type printable_prefix(unsigned char const *data_,
+                                  size_type size_) {
+   size_type pos{0};
+
+#if defined(__SSE2__)
+   // Printable bytes, 0x20 to 0x7E, are -0x60 to -0x02 once the sign flips
+   __m128i const sign{_mm_set1_epi8(-0x80)};
+   __m128i const low{_mm_set1_epi8(-0x61)};
+   __m128i const high{_mm_set1_epi8(-0x01)};
+
+   for (; size_ - pos >= 16; pos += 16) {
+      __m128i const bytes{_mm_xor_si128(
+          _mm_loadu_si128(reinterpret_cast<__m128i const *>(data_ + pos)),
+          sign)};
+      unsigned const mask{static_cast<unsigned>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpgt_epi8(bytes, low),
+                        _mm_cmpgt_epi8(high, bytes))))};
+
+      if (mask != 0xFFFF) {
+         return pos + static_cast<size_type>(__builtin_ctz(~mask));
+      }
+   }
+#endif
+
+   while (pos != size_ && data_[pos] >= 0x20 && data_[pos] < 0x7F) {
+      ++pos;
+   }
+   return pos;
+}
+
+/**
+ * @brief Measures the longest prefix of a text that fits in a number of
+ * columns.
+ *
+ * @param text_ The text.
+ * @param columns_ The number of columns available.
+ * @param width_ Receives the width of the prefix.
+ * @return The size of the prefix, in code units.
+ */
+template <typename CharType>
+size_type measure(std::basic_string_view<CharType> text_, size_type columns_,
+                  size_type &width_) {
+   CharType const *const first{text_.data()};
+   CharType const *const last{first + text_.size()};
+   CharType const *it{first};
+   size_type used{0};
+
+   while (it != last) {
+      if constexpr (sizeof(CharType) == 1) {
+         size_type const run{
+             std::min(printable_prefix(
+                          reinterpret_cast<unsigned char const *>(it),
+                          static_cast<size_type>(last - it)),
+                      columns_ - used)};
+         it += run;
+         used += run;
+         if (it == last) {
+            break;
+         }
+      }
+
+      char32_t const lead{utf::unit(*it)};
+      CharType const *next{it + 1};
+      size_type columns{1};
+
+      if (lead == 0x1B) {
+         next = ansi::skip(it, last);
+         columns = 0;
+      } else if (lead < 0x20 || lead >= 0x7F) {
+         next = it;
+         char32_t const code{utf::decode(next, last)};
+         if (code == utf::invalid) {
+            next = it + 1; // An invalid unit takes a column, as U+FFFD would
+         } else {
+            columns = width(code);
+         }
+      }
+
+      if (columns > columns_ - used) {
+         break;
+      }
+      used += columns;
+      it = next;
+   }
+
+   width_ = used;
+   return static_cast<size_type>(it - first);
+}
+} // namespace cols
+
+/**
+ * @brief Gets the number of terminal columns a text takes.
+ *
+ * @tparam CharType The character type, which sets the encoding.
+ * @param text_ The text; escape sequences take no column.
+ * @return The width of the text.
+ */
+template <typename CharType>
+std::size_t display_width(std::basic_string_view<CharType> text_) {
+   std::size_t width{0};
+   cols::measure(text_, static_cast<std::size_t>(-1), width);
+   return width;
+}
+
+/**
+ * @brief Gets the number of terminal columns a text takes.
+ *
+ * @param text_ The text; escape sequences take no column.
+ * @return The width of the text.
+ */
+inline std::size_t display_width(std::string_view text_) {
+   return display_width<char>(text_);
+}
+
+/**
+ * @brief Gets the longest prefix of a text that fits in a number of columns,
+ * never cutting a character or an escape sequence.
+ *
+ * @tparam CharType The character type, which sets the encoding.
+ * @param text_ The text.
+ * @param columns_ The number of columns available.
+ * @return The size of the prefix, in code units.
+ */
+template <typename CharType>
+std::size_t display_prefix(std::basic_string_view<CharType> text_,
+                           std::size_t columns_) {
+   std::size_t width{0};
+   return cols::measure(text_, columns_, width);
+}
+
+} // namespace ext
+
+#endif // WIDTH_HPP_
@@ -0,0 +1,283 @@
+#include "../format/ansi.hpp"
+#include "../format/fstring.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Gets the size of the escape sequence at the start of a text: CSI
+ * up to a final byte, OSC up to BEL or ESC '\', or two characters.
+ */
+template <typename CharType>
+std::size_t Escape(std::basic_string_view<CharType> text_) {
+   if (text_.size() < 2) {
+      return text_.size();
+   }
+
+   std::size_t pos{2};
+   if (text_[1] == CharType('[')) {
+      while (pos != text_.size() && (text_[pos] < 0x40 || text_[pos] > 0x7E)) {
+         ++pos;
+      }
+      return std::min(pos + 1, text_.size());
+   }
+   if (text_[1] == CharType(']')) {
+      for (bool escaped{false}; pos != text_.size(); ++pos) {
+         if (text_[pos] == 0x07 || (escaped && text_[pos] == CharType('\\'))) {
+            return pos + 1;
+         }
+         escaped = text_[pos] == 0x1B;
+      }
+   }
+   return pos;
+}
+
+/**
+ * @brief Cuts a text into plain runs and escape sequences, one character at
+ * a time, as a reference for the scanner.
+ */
+template <typename CharType>
+std::vector<std::basic_string<CharType>>
+Pieces(std::basic_string_view<CharType> text_) {
+   std::vector<std::basic_string<CharType>> pieces;
+   std::size_t pos{0};
+   while (pos != text_.size()) {
+      std::size_t size{0};
+      if (text_[pos] == 0x1B) {
+         size = Escape(text_.substr(pos));
+      } else {
+         while (pos + size != text_.size() && text_[pos + size] != 0x1B) {
+            ++size;
+         }
+      }
+      pieces.emplace_back(text_.substr(pos, size));
+      pos += size;
+   }
+   return pieces;
+}
+
+/**
+ * @brief Removes the escape sequences found by Pieces().
+ */
+template <typename CharType>
+std::basic_string<CharType> Strip(std::basic_string_view<CharType> text_) {
+   std::basic_string<CharType> plain;
+   for (auto const &piece : Pieces(text_)) {
+      if (piece[0] != 0x1B) {
+         plain += piece;
+      }
+   }
+   return plain;
+}
+
+/**
+ * @brief Checks if a text ends inside an escape sequence.
+ */
+bool Open(std::string_view text_) {
+   std::vector<std::string> const pieces{Pieces(text_)};
+   if (pieces.empty() || pieces.back()[0] != '\33') {
+      return false;
+   }
+
+   std::string const &last{pieces.back()};
+   std::size_t const size{last.size()};
+   if (size == 1) {
+      return true;
+   }
+   if (last[1] == '[') {
+      return size == 2 || last.back() < 0x40 || last.back() > 0x7E;
+   }
+   if (last[1] == ']') {
+      return size == 2 ||
+             !(last.back() == '\7' ||
+               (size >= 4 && last.back() == '\\' && last[size - 2] == '\33'));
+   }
+   return false;
+}
+
+/**
+ * @brief Draws a text of plain runs, some longer than a vector block, and
+ * escape sequences, some cut short or holding an escape character.
+ */
+std::string RandomText(std::mt19937 &random_) {
+   char const *const escapes[]{
+       "\33[31m",    "\33[1;38;5;208m", "\33[0m", "\33[",
+       "\33[2J",     "\33]0;title\7",   "\33]8;;x\33\\", "\33]2;a\33b\7",
+       "\33(B",      "\33",             "\33]",    "\33[?25l"};
+   std::string text;
+
+   for (auto count{random_() % 10}; count != 0; --count) {
+      if (random_() % 2 == 0) {
+         text += escapes[random_() % 12];
+      } else {
+         for (auto run{random_() % 50}; run != 0; --run) {
+            text += "ab m;[]\\\7ção"[random_() % 14];
+         }
+      }
+   }
+   return text;
+}
+
+void TestStrip() {
+   // Test random texts against the reference, whole and in chunks that cut
+   // the sequences in two
+   std::mt19937 random{2023};
+
+   for (int round{0}; round != 30000; ++round) {
+      std::string const text{RandomText(random)};
+      std::string const expected{Strip(std::string_view{text})};
+      assert(ext::ansi::strip(text) == expected);
+
+      ext::fstring<char> in_place{text};
+      in_place.strip_escapes();
+      assert(in_place == expected);
+
+      std::u16string const wide(text.begin(), text.end());
+      ext::fstring<char16_t> wide_in_place{wide};
+      wide_in_place.strip_escapes();
+      assert(wide_in_place == Strip(std::u16string_view{wide}));
+
+      ext::ansi::scanner scanner;
+      std::string chunked(text.size(), '\0');
+      std::size_t written{0};
+      for (std::size_t pos{0}; pos < text.size();) {
+         std::size_t const size{std::min<std::size_t>(1 + random() % 40,
+                                                      text.size() - pos)};
+         written += scanner.strip(std::string_view{text}.substr(pos, size),
+                                  &chunked[written]);
+         pos += size;
+      }
+      chunked.resize(written);
+      assert(chunked == expected);
+      assert(scanner.pending() == Open(text));
+   }
+}
+
+void TestSegments() {
+   // Test that the segments are the reference pieces, in order
+   std::mt19937 random{7};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::string const text{RandomText(random)};
+      std::vector<std::string> segments;
+      for (ext::ansi::segment const &segment : ext::ansi::segments(text)) {
+         assert(segment.escape == (segment.text[0] == '\33'));
+         assert(segment.sgr() ==
+                (segment.escape && segment.text.size() >= 3 &&
+                 segment.text.substr(0, 2) == "\33[" &&
+                 segment.text.back() == 'm'));
+         segments.emplace_back(segment.text);
+      }
+      assert(segments == Pieces(std::string_view{text}));
+   }
+}
+
+/**
+ * @brief Applies SGR codes one at a time, as a reference for parse_sgr.
+ */
+ext::text_style Apply(ext::text_style style_,
+                      std::vector<short> const &codes_) {
+   auto const listed{[](auto const &list_, short code_) {
+      return std::find(std::begin(list_), std::end(list_), code_) !=
+             std::end(list_);
+   }};
+
+   for (std::size_t index{0}; index < codes_.size(); ++index) {
+      short const code{codes_[index]};
+      if (code == 0) {
+         style_ = ext::text_style{};
+      } else if (code == 38 || code == 48) {
+         // 5;n or 2;r;g;b, any other mode skips only itself
+         if (index + 1 < codes_.size()) {
+            short const mode{codes_[++index]};
+            index += mode == 5 ? 1 : mode == 2 ? 3 : 0;
+         }
+      } else if (code == 39) {
+         style_.foreground = ext::cfg::none;
+      } else if (code == 49) {
+         style_.background = ext::cbg::none;
+      } else if (listed(ext::cfg::list, code)) {
+         style_.foreground = code;
+      } else if (listed(ext::cbg::list, code)) {
+         style_.background = code;
+      } else if (listed(ext::stl::list, code)) {
+         style_.style = code;
+      } else if (code == 22) {
+         if (style_.style == ext::stl::bold ||
+             style_.style == ext::stl::faint) {
+            style_.style = ext::stl::none;
+         }
+      } else if (code == 24) {
+         if (style_.style == ext::stl::underline ||
+             style_.style == ext::stl::doubly_underlined) {
+            style_.style = ext::stl::none;
+         }
+      } else if (code > 22 && code <= 29 && style_.style == code - 20) {
+         style_.style = ext::stl::none;
+      }
+   }
+   return style_;
+}
+
+void TestParseSgr() {
+   // Test random sequences, with extended colors and resets, against the
+   // codes applied one at a time
+   std::mt19937 random{2023};
+   short const codes[]{0,  1,  2,  3,  4,  7,  9,  21, 22, 23, 24, 27, 29, 31,
+                       37, 38, 39, 44, 48, 49, 92, 107, 5, 2, 255, 12, 99};
+
+   for (int round{0}; round != 30000; ++round) {
+      std::vector<short> values;
+      std::string sequence{"\33["};
+      for (auto count{random() % 8}; count != 0; --count) {
+         values.push_back(codes[random() % 27]);
+         if (sequence.size() != 2) {
+            sequence += random() % 4 == 0 ? ':' : ';';
+         }
+         sequence += std::to_string(values.back());
+      }
+      sequence += 'm';
+      if (values.empty()) {
+         values.push_back(0);
+      }
+
+      ext::text_style const start{ext::cfg::red, ext::cbg::blue,
+                                  ext::stl::bold};
+      ext::text_style style{start};
+      assert(ext::ansi::parse_sgr(sequence, style));
+      assert(style == Apply(start, values));
+   }
+
+   // Test that empty parameters read as 0 and values saturate
+   std::vector<short> read;
+   assert(ext::ansi::for_each_code("\33[;31;;123456m",
+                                   [&read](short code_) {
+                                      read.push_back(code_);
+                                   }));
+   assert((read == std::vector<short>{0, 31, 0, 9999}));
+
+   // Test that other sequences leave the style alone
+   ext::text_style style{ext::cfg::green};
+   for (char const *invalid :
+        {"\33[31", "\33[3x1m", "\33]31m", "31m", "\33m"}) {
+      assert(!ext::ansi::parse_sgr(invalid, style));
+      assert(style == ext::text_style{ext::cfg::green});
+   }
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestStrip();
+   TestSegments();
+   TestParseSgr();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
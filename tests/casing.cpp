@@ -0,0 +1,292 @@
+#include "../format/casing.hpp"
+#include "../format/fstring.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Maps a code point by scanning a whole table, as a reference for the
+ * search in casing::apply() and the ASCII shortcuts.
+ */
+template <std::size_t Size>
+char32_t Linear(ext::casing::mapping const (&table_)[Size], char32_t code_) {
+   for (ext::casing::mapping const &entry : table_) {
+      if (code_ >= entry.first && code_ <= entry.last &&
+          (code_ - entry.first) % entry.stride == 0) {
+         return static_cast<char32_t>(static_cast<std::int32_t>(code_) +
+                                      entry.delta);
+      }
+   }
+   return code_;
+}
+
+/**
+ * @brief A code point or, when the code unit at the start of a text is
+ * invalid, that code unit alone.
+ */
+struct unit {
+   char32_t code;     ///< The code point, or utf::invalid.
+   std::size_t size;  ///< The number of code units.
+   std::size_t first; ///< The position of the first code unit.
+};
+
+/**
+ * @brief Cuts a text into code points and invalid code units, one at a time.
+ */
+template <typename CharType>
+std::vector<unit> Units(std::basic_string_view<CharType> text_) {
+   std::vector<unit> units;
+   CharType const *const last{text_.data() + text_.size()};
+   for (CharType const *it{text_.data()}; it != last;) {
+      CharType const *next{it};
+      char32_t const code{ext::utf::decode(next, last)};
+      std::size_t const size{code == ext::utf::invalid
+                                 ? 1u
+                                 : static_cast<std::size_t>(next - it)};
+      units.push_back({code, size, static_cast<std::size_t>(
+                                       it - text_.data())});
+      it += size;
+   }
+   return units;
+}
+
+/**
+ * @brief Converts the case of a text one code point at a time, copying the
+ * invalid code units.
+ */
+template <bool Upper, typename CharType>
+std::basic_string<CharType> Convert(std::basic_string_view<CharType> text_) {
+   std::basic_string<CharType> out;
+   for (unit const &piece : Units(text_)) {
+      if (piece.code == ext::utf::invalid) {
+         out += text_[piece.first];
+         continue;
+      }
+      CharType encoded[4];
+      char32_t const other{Upper ? Linear(ext::casing::upper_map, piece.code)
+                                 : Linear(ext::casing::lower_map, piece.code)};
+      out.append(encoded, ext::utf::encode(other, encoded));
+   }
+   return out;
+}
+
+/**
+ * @brief Folds a text into the values casing::compare() orders, invalid
+ * bytes after every code point.
+ */
+template <typename CharType>
+std::u32string Fold(std::basic_string_view<CharType> text_) {
+   std::u32string folded;
+   for (unit const &piece : Units(text_)) {
+      char32_t const raw{ext::utf::unit(text_[piece.first])};
+      folded += piece.code != ext::utf::invalid
+                    ? Linear(ext::casing::fold_map, piece.code)
+                : sizeof(CharType) == 1 ? 0x110000 + raw
+                                        : raw;
+   }
+   return folded;
+}
+
+/**
+ * @brief Finds a pattern by comparing the foldings at the start of every
+ * code point, as a reference for casing::find().
+ */
+template <typename CharType>
+std::size_t Find(std::basic_string_view<CharType> text_,
+                 std::basic_string_view<CharType> pattern_, std::size_t pos_) {
+   if (pos_ > text_.size()) {
+      return std::string_view::npos;
+   }
+   if (pattern_.empty()) {
+      return pos_;
+   }
+
+   std::u32string const pattern{Fold(pattern_)};
+   std::basic_string_view<CharType> const rest{text_.substr(pos_)};
+   std::vector<unit> const units{Units(rest)};
+   for (std::size_t index{0}; index != units.size(); ++index) {
+      std::u32string folded;
+      for (std::size_t next{index};
+           next != units.size() && folded.size() < pattern.size(); ++next) {
+         folded += Fold(rest.substr(units[next].first, units[next].size));
+      }
+      if (folded == pattern) {
+         return pos_ + units[index].first;
+      }
+   }
+   return std::string_view::npos;
+}
+
+/**
+ * @brief Draws code points: ASCII runs longer than a vector block, letters
+ * of every script, and the letters that change length or fold into ASCII.
+ */
+std::u32string RandomCodes(std::mt19937 &random_) {
+   char32_t const samples[]{0xDF,   0xC0,    0xFF,    0x130,   0x131,
+                            0x17F,  0x23A,   0x23E,   0x250,   0x26B,
+                            0x2C65, 0x3A3,   0x3C2,   0x3C3,   0x41F,
+                            0x1E9E, 0x212A,  0x2126,  0x10400, 0x1E900,
+                            0xFF21, 0x1F600, 0x3042,  0xE9,    0x1C5};
+   std::u32string codes;
+
+   for (auto count{random_() % 10}; count != 0; --count) {
+      switch (random_() % 5) {
+      case 0:
+      case 1:
+         for (auto run{random_() % 70}; run != 0; --run) {
+            codes += static_cast<char32_t>(
+                random_() % 3 == 0 ? ' ' + random_() % 95
+                                   : "aAkKsSzZ@[`{"[random_() % 12]);
+         }
+         break;
+      case 2: {
+         char32_t const code{static_cast<char32_t>(random_() % 0x20000)};
+         codes += code >= 0xD800 && code <= 0xDFFF ? 0x41 : code;
+         break;
+      }
+      default:
+         codes += samples[random_() % 25];
+         break;
+      }
+   }
+   return codes;
+}
+
+/**
+ * @brief Flips the case of some code points and spoils a few, so that a
+ * text is compared with one that is often equal ignoring case.
+ */
+std::u32string Vary(std::u32string codes_, std::mt19937 &random_) {
+   for (char32_t &code : codes_) {
+      if (random_() % 2 == 0) {
+         code = Linear(ext::casing::upper_map, code);
+      } else if (random_() % 200 == 0) {
+         code = code + 1;
+      }
+   }
+   if (!codes_.empty() && random_() % 8 == 0) {
+      codes_.erase(random_() % codes_.size(), 1);
+   }
+   return codes_;
+}
+
+/**
+ * @brief Checks the conversions, comparisons and searches of an fstring
+ * against the references.
+ */
+template <typename CharType>
+void Check(std::basic_string<CharType> const &text_,
+           std::basic_string<CharType> const &other_, std::mt19937 &random_) {
+   using view_type = std::basic_string_view<CharType>;
+   view_type const view{text_};
+   ext::fstring<CharType> const text{text_};
+
+   std::basic_string<CharType> const lower{Convert<false>(view)};
+   std::basic_string<CharType> const upper{Convert<true>(view)};
+   assert(text.lowercased() == lower);
+   assert(text.uppercased() == upper);
+
+   ext::fstring<CharType> in_place{text_};
+   in_place.to_lower();
+   assert(in_place == lower);
+   in_place.to_upper();
+   assert(in_place == Convert<true>(view_type{lower}));
+
+   std::u32string const left{Fold(view)};
+   std::u32string const right{Fold(view_type{other_})};
+   int const expected{left < right ? -1 : left == right ? 0 : 1};
+   int const order{text.icompare(other_)};
+   assert((order > 0) - (order < 0) == expected);
+   assert(text.iequals(other_) == (expected == 0));
+
+   // Test patterns cut from the other text, and from the text itself
+   std::size_t const size{random_() % 8};
+   view_type const sources[]{view_type{other_}, view};
+   view_type const source{sources[random_() % 2]};
+   std::size_t const first{random_() % (source.size() + 1)};
+   view_type const pattern{source.substr(first, size)};
+   std::size_t const pos{random_() % 4 == 0 ? random_() % (view.size() + 2)
+                                            : 0};
+   std::size_t const found{Find(view, pattern, pos)};
+   assert(text.ifind(pattern, pos) == found);
+   assert(text.icontains(pattern) ==
+          (Find(view, pattern, 0) != std::string_view::npos));
+}
+
+void TestMappings() {
+   // Test every code point against a scan of the whole tables
+   for (char32_t code{0}; code != 0x110000; ++code) {
+      assert(ext::casing::to_lower(code) ==
+             Linear(ext::casing::lower_map, code));
+      assert(ext::casing::to_upper(code) ==
+             Linear(ext::casing::upper_map, code));
+      assert(ext::casing::fold(code) == Linear(ext::casing::fold_map, code));
+   }
+}
+
+void TestAgainstScalar() {
+   // Test random texts in every encoding, with invalid code units, against
+   // the conversions and foldings done one code point at a time
+   std::mt19937 random{2023};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::u32string const codes{RandomCodes(random)};
+      std::u32string const other{Vary(codes, random)};
+
+      std::string utf8{ext::utf::to_utf8(codes)};
+      std::string other8{ext::utf::to_utf8(other)};
+      if (!utf8.empty() && random() % 4 == 0) {
+         utf8[random() % utf8.size()] = "\xFF\x80\xC3\xE2"[random() % 4];
+      }
+      if (!other8.empty() && random() % 8 == 0) {
+         other8.insert(random() % other8.size(), 1, '\xFE');
+      }
+      Check(utf8, other8, random);
+
+      std::u16string utf16{ext::utf::to_utf16(codes)};
+      if (!utf16.empty() && random() % 4 == 0) {
+         utf16[random() % utf16.size()] = u"\xD800\xDC00"[random() % 2];
+      }
+      Check(utf16, ext::utf::to_utf16(other), random);
+      Check(codes, other, random);
+   }
+}
+
+void TestInPlace() {
+   // Test that converting in place keeps the storage unless a letter grows
+   ext::fstring<char> text(300, 'a');
+   text += "ÀÉÎ ĳ Σσς Ⱥ";
+   char const *const data{text.data()};
+   text.to_upper();
+   assert(text.data() == data);
+   assert(text == std::string(300, 'A') + "ÀÉÎ Ĳ ΣΣΣ Ⱥ");
+
+   // U+023A lowercases to U+2C65, a byte longer in UTF-8, and the simple
+   // mapping has no final sigma
+   text.to_lower();
+   assert(text == std::string(300, 'a') + "àéî ĳ σσσ ⱥ");
+   assert(text.iequals(std::string(300, 'A') + "ÀÉÎ Ĳ ΣΣΣ Ⱥ"));
+   assert(text.icontains("Î Ĳ"));
+
+   // Test the letters that fold into ASCII
+   ext::fstring<char> const units{"5 K, 2 ſecs"};
+   assert(units.ifind("5 k") == 0);
+   assert(units.ifind("s") == 9);
+   assert(!units.icontains("ss"));
+   assert(ext::fstring<char>{"Straße"}.icompare("STRASSE") != 0);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestMappings();
+   TestAgainstScalar();
+   TestInPlace();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
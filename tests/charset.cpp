@@ -0,0 +1,112 @@
+#include "../format/fstring.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Draws random bytes, most from a small alphabet so that members and
+ * non-members alternate in runs longer than a vector block.
+ */
+class byte_generator {
+ public:
+   explicit byte_generator(std::uint32_t seed_) : m_random(seed_) {}
+
+   std::string bytes(std::size_t size_, std::string const &alphabet_) {
+      std::string result(size_, '\0');
+      for (char &byte : result) {
+         byte = m_random() % 8 == 0 ? static_cast<char>(m_random() % 256)
+                                    : alphabet_[m_random() % alphabet_.size()];
+      }
+      return result;
+   }
+
+   std::size_t below(std::size_t limit_) { return m_random() % limit_; }
+
+ private:
+   std::mt19937 m_random;
+};
+
+void TestAgainstStringView() {
+   // Test the kernels on random sets and texts against std::string_view,
+   // with lengths around the 16 and 32 byte blocks and bytes above 127
+   byte_generator random{2023};
+
+   for (int round{0}; round != 100000; ++round) {
+      std::string const members{
+          random.bytes(1 + random.below(12), "\x01\x7f\x80\xfe")};
+      std::string const alphabet{members + random.bytes(4, "az\x80\xff")};
+      std::string const text{random.bytes(random.below(100), alphabet)};
+      std::string_view const view{text};
+
+      ext::charset const set{std::string_view{members}};
+      std::size_t const pos{random.below(text.size() + 2)};
+
+      assert(set.find_first_of(text.data(), text.size(), pos) ==
+             view.find_first_of(members, pos));
+      assert(set.find_first_not_of(text.data(), text.size(), pos) ==
+             view.find_first_not_of(members, pos));
+      assert(set.find_last_not_of(text.data(), text.size()) ==
+             view.find_last_not_of(members));
+   }
+}
+
+void TestWideCharacters() {
+   // Test that wide code units above 255 are never members
+   ext::charset const set{std::u16string_view{u"aš "}};
+   std::u16string const text{u"  aššbĀa "};
+
+   assert(set.contains(u'a') && !set.contains(u'š'));
+   assert(!set.contains(u'Ā') && !set.contains(char16_t{0}));
+   assert(set.find_first_not_of(text.data(), text.size()) == 3);
+   assert(set.find_first_of(text.data(), text.size(), 4) == 7);
+   assert(set.find_last_not_of(text.data(), text.size()) == 6);
+}
+
+void TestTrim() {
+   // Test that the trims agree with erasing the same characters by hand
+   byte_generator random{7};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::string const text{random.bytes(random.below(80), " \t\n.x")};
+      std::string_view const view{text};
+      std::size_t const first{view.find_first_not_of(" \t\n\r\f\v")};
+      std::size_t const last{view.find_last_not_of(" \t\n\r\f\v")};
+
+      ext::fstring<char> trimmed{text};
+      trimmed.trim();
+      assert(trimmed == (first == std::string_view::npos
+                             ? std::string_view{}
+                             : view.substr(first, last - first + 1)));
+
+      ext::fstring<char> left{text};
+      left.ltrim(ext::charset{" \t\n."});
+      assert(left == view.substr(std::min(view.find_first_not_of(" \t\n."),
+                                          view.size())));
+
+      ext::fstring<char> right{text};
+      right.rtrim(std::string_view{".x"});
+      assert(right == view.substr(0, view.find_last_not_of(".x") + 1));
+   }
+
+   ext::fstring<char> punctuated{"...Olá, mundo!!!"};
+   punctuated.trim(ext::charset{".,;:!?"});
+   assert(punctuated == "Olá, mundo");
+
+   ext::fstring<wchar_t> wide{L" \t wide \n"};
+   wide.trim();
+   assert(wide == L"wide");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstStringView();
+   TestWideCharacters();
+   TestTrim();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
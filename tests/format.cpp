@@ -0,0 +1,339 @@
+#include "../format/format.hpp"
+#include "../format/fstring.hpp"
+#include "../format/out_buffer.hpp"
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief A replacement field written out by hand, as a reference for the
+ * parsed one.
+ */
+struct spec {
+   char fill;
+   char align;
+   std::size_t width;
+   int precision;
+   char type;
+};
+
+/**
+ * @brief Counts the columns of a text without wide characters, one per code
+ * point.
+ */
+std::size_t Columns(std::string const &text_) {
+   std::size_t columns{0};
+   for (char byte : text_) {
+      columns += (static_cast<unsigned char>(byte) & 0xC0) != 0x80;
+   }
+   return columns;
+}
+
+/**
+ * @brief Pads a text to the width of its field.
+ */
+std::string Pad(std::string const &text_, spec const &spec_, char align_) {
+   std::size_t const columns{Columns(text_)};
+   if (columns >= spec_.width) {
+      return text_;
+   }
+
+   char const align{spec_.align != '\0' ? spec_.align : align_};
+   std::size_t const padding{spec_.width - columns};
+   std::size_t const before{align == '>'   ? padding
+                            : align == '^' ? padding / 2
+                                           : 0};
+   return std::string(before, spec_.fill) + text_ +
+          std::string(padding - before, spec_.fill);
+}
+
+/**
+ * @brief Writes an integer with snprintf, its sign apart so that negative
+ * numbers keep their magnitude in every base.
+ */
+template <class Type>
+std::enable_if_t<std::is_integral_v<Type>, std::string>
+Reference(Type value_, spec const &spec_) {
+   bool const negative{value_ < 0};
+   unsigned long long const magnitude{
+       negative ? 0ull - static_cast<unsigned long long>(value_)
+                : static_cast<unsigned long long>(value_)};
+
+   std::string digits;
+   if (spec_.type == 'b') {
+      for (unsigned long long rest{magnitude}; rest != 0 || digits.empty();
+           rest /= 2) {
+         digits.insert(digits.begin(), static_cast<char>('0' + rest % 2));
+      }
+   } else {
+      char const *const formats{spec_.type == 'x'   ? "%llx"
+                                : spec_.type == 'X' ? "%llX"
+                                : spec_.type == 'o' ? "%llo"
+                                                    : "%llu"};
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), formats, magnitude);
+      digits = buffer;
+   }
+
+   return Pad((negative ? "-" : "") + digits, spec_, '>');
+}
+
+/**
+ * @brief Writes a floating-point number with snprintf when it has a
+ * precision, or with the shortest std::to_chars of its notation otherwise.
+ */
+std::string Reference(double value_, spec const &spec_) {
+   char const type{static_cast<char>(
+       spec_.type >= 'A' && spec_.type <= 'Z' ? spec_.type - 'A' + 'a'
+                                              : spec_.type)};
+   std::string text;
+
+   if (spec_.precision < 0) {
+      char buffer[1024];
+      std::to_chars_result const result{
+          type == '\0'  ? std::to_chars(buffer, buffer + sizeof(buffer),
+                                        value_)
+          : type == 'f' ? std::to_chars(buffer, buffer + sizeof(buffer),
+                                        value_, std::chars_format::fixed)
+          : type == 'e' ? std::to_chars(buffer, buffer + sizeof(buffer),
+                                        value_, std::chars_format::scientific)
+          : type == 'a' ? std::to_chars(buffer, buffer + sizeof(buffer),
+                                        value_, std::chars_format::hex)
+                        : std::to_chars(buffer, buffer + sizeof(buffer),
+                                        value_, std::chars_format::general)};
+      text.assign(buffer, result.ptr);
+   } else {
+      char const format[]{'%', '.', '*', type == '\0' ? 'g' : type, '\0'};
+      char buffer[1024];
+      std::snprintf(buffer, sizeof(buffer), format, spec_.precision, value_);
+      text = buffer;
+
+      // printf marks hexadecimal numbers with "0x", std::to_chars does not
+      std::size_t const prefix{text.find("0x")};
+      if (type == 'a' && prefix != std::string::npos) {
+         text.erase(prefix, 2);
+      }
+   }
+
+   if (spec_.type >= 'A' && spec_.type <= 'Z') {
+      for (char &c : text) {
+         c = c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+      }
+   }
+   return Pad(text, spec_, '>');
+}
+
+/**
+ * @brief Writes a text cut to its precision in code points.
+ */
+std::string Reference(std::string const &value_, spec const &spec_) {
+   std::string text;
+   std::size_t columns{0};
+   for (char byte : value_) {
+      bool const lead{(static_cast<unsigned char>(byte) & 0xC0) != 0x80};
+      if (lead && spec_.precision >= 0 &&
+          columns == static_cast<std::size_t>(spec_.precision)) {
+         break;
+      }
+      columns += lead;
+      text += byte;
+   }
+   return Pad(text, spec_, '<');
+}
+
+/**
+ * @brief Checks one formatted argument against the reference.
+ */
+template <auto const &Format, class Type>
+void Check(Type const &value_, spec const &spec_) {
+   std::string const expected{Reference(value_, spec_)};
+   assert(ext::format<Format>(value_) == expected);
+}
+
+static constexpr char plain[]{"{}"};
+static constexpr char decimal[]{"{:d}"};
+static constexpr char hex[]{"{:x}"};
+static constexpr char upper_hex[]{"{:X}"};
+static constexpr char octal[]{"{:o}"};
+static constexpr char binary[]{"{:b}"};
+static constexpr char right[]{"{:>12}"};
+static constexpr char star_hex[]{"{:*<12x}"};
+static constexpr char centered_binary[]{"{:^13b}"};
+static constexpr char zeros[]{"{:0>8}"};
+
+void TestIntegers() {
+   // Test random integers of several types in every base and alignment
+   std::mt19937 random{2023};
+
+   for (int round{0}; round != 20000; ++round) {
+      long long const wide{static_cast<long long>(
+          (static_cast<unsigned long long>(random()) << 32 | random()) >>
+          random() % 64)};
+      long long const signed_value{random() % 2 == 0 ? wide : -wide};
+      int const small{static_cast<int>(random()) >> random() % 32};
+      unsigned const unsigned_value{
+          static_cast<unsigned>(random() >> random() % 32)};
+      short const tiny{static_cast<short>(random())};
+
+      Check<plain>(signed_value, {' ', '\0', 0, -1, '\0'});
+      Check<decimal>(small, {' ', '\0', 0, -1, 'd'});
+      Check<hex>(signed_value, {' ', '\0', 0, -1, 'x'});
+      Check<upper_hex>(unsigned_value, {' ', '\0', 0, -1, 'X'});
+      Check<octal>(tiny, {' ', '\0', 0, -1, 'o'});
+      Check<binary>(small, {' ', '\0', 0, -1, 'b'});
+      Check<right>(tiny, {' ', '>', 12, -1, '\0'});
+      Check<star_hex>(small, {'*', '<', 12, -1, 'x'});
+      Check<centered_binary>(tiny, {' ', '^', 13, -1, 'b'});
+      Check<zeros>(unsigned_value, {'0', '>', 8, -1, '\0'});
+   }
+
+   Check<plain>(std::numeric_limits<long long>::min(), {' ', '\0', 0, -1, 0});
+   Check<binary>(std::numeric_limits<unsigned long long>::max(),
+                 {' ', '\0', 0, -1, 'b'});
+   Check<hex>(std::numeric_limits<signed char>::min(), {' ', '\0', 0, -1, 'x'});
+}
+
+static constexpr char precise[]{"{:.3}"};
+static constexpr char fixed[]{"{:f}"};
+static constexpr char fixed_two[]{"{:.2f}"};
+static constexpr char scientific[]{"{:12.4e}"};
+static constexpr char upper_scientific[]{"{:E}"};
+static constexpr char general[]{"{:.5g}"};
+static constexpr char hexadecimal[]{"{:a}"};
+static constexpr char precise_hexadecimal[]{"{:.3A}"};
+static constexpr char centered_fixed[]{"{:_^20.3F}"};
+
+void TestFloats() {
+   // Test random numbers, tiny to huge, in every notation
+   std::mt19937 random{7};
+   std::uniform_real_distribution<double> mantissa{-10.0, 10.0};
+
+   for (int round{0}; round != 20000; ++round) {
+      double const value{std::ldexp(mantissa(random),
+                                    static_cast<int>(random() % 200) - 100)};
+
+      Check<plain>(value, {' ', '\0', 0, -1, '\0'});
+      Check<precise>(value, {' ', '\0', 0, 3, '\0'});
+      Check<fixed>(value, {' ', '\0', 0, -1, 'f'});
+      Check<fixed_two>(value, {' ', '\0', 0, 2, 'f'});
+      Check<scientific>(value, {' ', '\0', 12, 4, 'e'});
+      Check<upper_scientific>(value, {' ', '\0', 0, -1, 'E'});
+      Check<general>(value, {' ', '\0', 0, 5, 'g'});
+      Check<hexadecimal>(value, {' ', '\0', 0, -1, 'a'});
+      Check<precise_hexadecimal>(value, {' ', '\0', 0, 3, 'A'});
+      Check<centered_fixed>(value, {'_', '^', 20, 3, 'F'});
+   }
+
+   // Test that a fixed notation longer than the stack buffer still fits
+   Check<fixed>(1e300, {' ', '\0', 0, -1, 'f'});
+   Check<fixed_two>(-1e300, {' ', '\0', 0, 2, 'f'});
+
+   double const infinity{std::numeric_limits<double>::infinity()};
+   assert(ext::format<plain>(-infinity) == "-inf");
+   assert(ext::format<upper_scientific>(infinity) == "INF");
+}
+
+static constexpr char left[]{"{:10}"};
+static constexpr char text_right[]{"{:>10}"};
+static constexpr char cut[]{"{:-^11.3}"};
+static constexpr char typed[]{"{:s}"};
+static constexpr char dots[]{"{:.<7.0}"};
+static constexpr char flags[]{"{:4}|{:>3c}|{:6}|{:^7s}"};
+
+void TestText() {
+   // Test random texts, accented letters included, with widths and cuts
+   std::mt19937 random{2023};
+   char const *const letters[]{"a", "Z", " ", "ã", "é", "ç", "{", "}"};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::string value;
+      for (auto count{random() % 14}; count != 0; --count) {
+         value += letters[random() % 8];
+      }
+
+      Check<plain>(value, {' ', '\0', 0, -1, '\0'});
+      Check<left>(value, {' ', '\0', 10, -1, '\0'});
+      Check<text_right>(value, {' ', '>', 10, -1, '\0'});
+      Check<cut>(value, {'-', '^', 11, 3, '\0'});
+      Check<typed>(value, {' ', '\0', 0, -1, 's'});
+      Check<dots>(value, {'.', '<', 7, 0, '\0'});
+
+      // Test that string views and fstrings format as the same text
+      assert(ext::format<cut>(std::string_view{value}) ==
+             ext::format<cut>(ext::fstring<char>{value}));
+   }
+
+   // Test that characters and booleans are left aligned by default
+   assert(ext::format<flags>('x', 'y', true, false) ==
+          "x   |  y|true  | false ");
+}
+
+void TestEscapesAndColumns() {
+   // Test that doubled braces are literal, around fields or alone
+   static constexpr char braces[]{"{{{}}}{{}}"};
+   assert(ext::format<braces>(42) == "{42}{}");
+   static constexpr char only[]{"}}{{ {{x}}"};
+   assert(ext::format<only>() == "}{ {x}");
+
+   // Test that padding counts columns, not bytes
+   static constexpr char row[]{"|{:<10}|{:>5}|{:^9.2f}|{:#>6x}|"};
+   assert(ext::format<row>("Pavão", 2, 0.5, 10) ==
+          "|Pavão     |    2|  0.50   |#####a|");
+   assert(ext::format<row>("漢字", 2, 0.5, 10) ==
+          "|漢字      |    2|  0.50   |#####a|");
+   assert(ext::format<row>("\33[31mred\33[0m", 2, 0.5, 10) ==
+          "|\33[31mred\33[0m       |    2|  0.50   |#####a|");
+
+   // Test that a precision never splits a wide character
+   static constexpr char narrow[]{"[{:.3}]"};
+   assert(ext::format<narrow>("漢字") == "[漢]");
+   assert(ext::format<narrow>("ab漢字") == "[ab]");
+}
+
+static constexpr char entry[]{"{}: {:>6.1f} ({:x})"};
+
+void TestOutputs() {
+   // Test that format_to appends what format() returns
+   std::mt19937 random{7};
+
+   for (int round{0}; round != 2000; ++round) {
+      std::string const name(random() % 20, 'n');
+      double const value{static_cast<double>(random()) / 1000.0};
+      unsigned const code{static_cast<unsigned>(random())};
+      std::string const expected{ext::format<entry>(name, value, code)};
+
+      std::string out{"> "};
+      ext::format_to<entry>(out, name, value, code);
+      assert(out == "> " + expected);
+
+      ext::fstring<char> fout{"> "};
+      ext::format_to<entry>(fout, name, value, code);
+      assert(fout == out);
+
+      ext::out_buffer buffer;
+      buffer.put("> ");
+      ext::format_to<entry>(buffer, name, value, code);
+      ext::format_to<entry>(buffer, name, value, code);
+      assert(buffer.view() == out + expected);
+   }
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestIntegers();
+   TestFloats();
+   TestText();
+   TestEscapesAndColumns();
+   TestOutputs();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
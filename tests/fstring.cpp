@@ -1,4 +1,9 @@
-#include "../advance/fstring.hpp"
+#include "../format/fstring.hpp"
+#include "../format/format.hpp"
+#include "../format/intern_pool.hpp"
+#include "../format/parallel.hpp"
+#include "../format/table.hpp"
+#include "../format/term_writer.hpp"
 #include <iostream>
 #include <vector>
 
@@ -37,6 +42,11 @@ int main() {
    std::cout << "Right trim: \"" << rtrim << "\"\n";
    std::cout << "Trim: \"" << trim << "\"\n";
 
+   ext::charset const punctuation{".,;:!?"};
+   ext::fstring punctuated{"...Olá, mundo!!!"};
+   punctuated.trim(punctuation);
+   std::cout << "Trim punctuation: \"" << punctuated << "\"\n";
+
    std::cout << "\n[========[REPLACE]========]\n";
    ext::fstring not_replace{"Macacos Macaquiando"};
    not_replace.replace_all("Banana", "Banana");
@@ -50,6 +60,12 @@ int main() {
    std::cout << "All replace: \"" << replace << "\"\n";
    std::cout << "Not replace: \"" << not_replace << "\"\n";
 
+   ext::fstring redact{"senha=1234 senhas=abcd token=xyz"};
+   std::size_t const redacted{redact.replace_many(
+       {{"senha", "***"}, {"senhas", "****"}, {"token", "###"}})};
+   std::cout << "Many replace: \"" << redact << "\" (" << redacted
+             << " trocas)\n";
+
    std::cout << "\n[========[SPLIT]========]\n";
    ext::fstring split{"Titulo;Texto;Autor1;;;Editora;Versão;;Casa;"};
    std::vector<ext::fstring<char>> tokens;
@@ -70,6 +86,28 @@ int main() {
    }
    std::cout << "\n";
 
+   std::cout << "\n[========[SPLIT VIEW]========]\n";
+   std::cout << "Split view: ";
+   for (auto token : split.split_view(';')) {
+      std::cout << "\"" << token << "\" ";
+   }
+
+   ext::fstring paragraph{"Primeira linha\r\nSegunda linha\n\nQuarta linha\n"};
+   std::cout << "\nLines (" << paragraph.lines().count() << "): ";
+   for (auto line : paragraph.lines()) {
+      std::cout << "\"" << line << "\" ";
+   }
+   std::cout << "\n";
+
+   std::cout << "\n[========[PARALLEL]========]\n";
+   std::cout << "Parallel split (4 threads): ";
+   for (auto const &token :
+        ext::par::split(split, ';', ext::split_mode::keep_empty, 4)) {
+      std::cout << token.quoted() << " ";
+   }
+   std::cout << "\nParallel count of \";\" (4 threads): "
+             << ext::par::count(split, ";", 4) << "\n";
+
    std::cout << "\n[========[CONTAINS]========]\n";
    ext::fstring text{"Minha querida casa é muito bonita, venha me visitar!"};
    std::cout << "Normal: \"" << text << "\"\n";
@@ -81,6 +119,41 @@ int main() {
              << (text.contains("visita") ? "Sim" : "Não") << "\n";
    std::cout << "Contains \"querido\": "
              << (text.contains("querido") ? "Sim" : "Não") << "\n";
+   ext::searcher const word{"ta"};
+   std::cout << "Find \"ta\" (searcher): " << text.find(word) << "\n";
+   std::cout << "Count \"ta\" (searcher): " << text.find_all(word).size()
+             << "\n";
+
+   std::cout << "\n[========[REGEX]========]\n";
+   ext::fstring log{"12:00 erro=42 ok 12:05 erro=7 12:10 erro=1337"};
+   ext::regex const error{"erro=\\d+"};
+   ext::regex::match const first_error{log.find(error)};
+   std::cout << "Normal: \"" << log << "\"\n";
+   std::cout << "Matches time: "
+             << (ext::fstring{"12:00"}.matches(ext::regex{"\\d\\d:\\d\\d"})
+                     ? "Sim"
+                     : "Não")
+             << "\n";
+   std::cout << "First error: \"" << log.substr(first_error.position,
+                                                 first_error.size)
+             << "\"\n";
+   std::vector<ext::fstring<char>> entries;
+   log.split_regex(entries, ext::regex{" ?\\d\\d:\\d\\d ?"});
+   for (auto const &entry : entries) {
+      std::cout << "Entry: \"" << entry << "\"\n";
+   }
+   log.replace_regex(error, "erro=?");
+   std::cout << "Regex replace: \"" << log << "\"\n";
+
+   std::cout << "\n[========[UTF]========]\n";
+   auto wide{ext::fstring<char32_t>::from_utf8("  Ação: 日本 😀  ")};
+   wide.trim();
+   std::cout << "Code points: " << wide.size() << "\n";
+   std::cout << "Back to UTF-8: \"" << wide.to_utf8() << "\"\n";
+   std::cout << "UTF-16 units: " << ext::utf::to_utf16(wide.to_utf8()).size()
+             << "\n";
+   std::cout << "Valid \"\\xC0\\x80\": "
+             << (ext::utf::valid("\xC0\x80") ? "Sim" : "Não") << "\n";
 
    std::cout << "\n[========[APPEND]========]\n";
    ext::fstring title;
@@ -92,6 +165,63 @@ int main() {
    title.append(5, "=-=");
    std::cout << "Second append: \"" << title << "\"\n";
 
+   std::cout << "\n[========[NUMBERS]========]\n";
+   ext::fstring numbers{"Total: "};
+   numbers.append_number(1234);
+   numbers += " / 0x";
+   numbers.append_number(255, 16);
+   numbers += " / ";
+   numbers.append_number(3.14159, std::chars_format::fixed, 2);
+   std::cout << "Append numbers: \"" << numbers << "\"\n";
+   std::cout << "Parse \" 42 \": " << ext::fstring{" 42 "}.parse<int>() << "\n";
+   std::cout << "Try parse \"4x\": "
+             << ext::fstring{"4x"}.try_parse<int>().value_or(-1) << "\n";
+   std::cout << "Size \"1.5G\": " << *ext::fstring{"1.5G"}.parse_size()
+             << " bytes\n";
+   std::cout << "Duration \"1m 30s\": "
+             << ext::fstring{"1m 30s"}.parse_duration()->count() << " ns\n";
+   double sum{0};
+   for (double value : ext::fstring{"0.5, 1.25, 2"}.parse_all<double>()) {
+      sum += value;
+   }
+   std::cout << "Sum of \"0.5, 1.25, 2\": " << sum << "\n";
+
+   std::cout << "\n[========[CONCATENATION]========]\n";
+   ext::fstring const directory{"/var/log"};
+   ext::fstring const file{"app.log"};
+   ext::fstring const path{directory + '/' + file};
+   std::cout << "Path: " << path << "\n";
+   std::cout << "Cat: " << ext::cat("level=", 2, " took=", 1.5, "ms ", path)
+             << "\n";
+   std::vector<std::string> const parts{"alpha", "beta", "gamma"};
+   std::cout << "Join: " << ext::join(parts, ", ") << "\n";
+
+   std::cout << "\n[========[HASH AND INTERN]========]\n";
+   ext::intern_pool pool;
+   ext::intern_pool::handle const extension{pool.intern("txt")};
+   std::cout << "Hash of \"txt\" cached by its handle: "
+             << (ext::fstring{"txt"}.hash() == extension.hash() ? "yes" : "no")
+             << "\n";
+   std::cout << "Interned \"txt\" twice is the same handle: "
+             << (pool.intern(ext::fstring{"txt"}) == extension ? "yes" : "no")
+             << "\n";
+   std::cout << "Pool size: " << pool.size() << "\n";
+
+   std::cout << "\n[========[CASE]========]\n";
+   ext::fstring shout{"Ærø Straße, ΚΑΛΗΜΈΡΑ"};
+   std::cout << "Lowercased: " << shout.lowercased() << "\n";
+   shout.to_upper();
+   std::cout << "Uppercased in place: " << shout << "\n";
+   std::cout << "\"README.md\" equals \"readme.MD\" ignoring case: "
+             << (ext::fstring{"README.md"}.iequals("readme.MD") ? "yes" : "no")
+             << "\n";
+   std::cout << "\"Content-Type\" contains \"TYPE\" ignoring case: "
+             << (ext::fstring{"Content-Type"}.icontains("TYPE") ? "yes" : "no")
+             << "\n";
+   std::cout << "\"apple\" sorts before \"Banana\" ignoring case: "
+             << (ext::fstring{"apple"}.icompare("Banana") < 0 ? "yes" : "no")
+             << "\n";
+
    std::cout << "\n[========[SPLIT AT]========]\n";
    ext::fstring new_text{
        "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Quisque et "
@@ -106,6 +236,18 @@ int main() {
       copy = returned;
    }
 
+   std::cout << "\n[========[WRAP]========]\n";
+   std::cout << "Greedy justified at 30: \n";
+   for (auto const &line : new_text.wrap(30, ext::align_mode::justify)) {
+      std::cout << "|" << line << "|\n";
+   }
+
+   std::cout << "\nMinimum raggedness at 30: \n";
+   for (auto const &line : new_text.wrap(30, ext::align_mode::left,
+                                         ext::wrap_mode::min_raggedness)) {
+      std::cout << "|" << line << "|\n";
+   }
+
    std::cout << "\n[========[ALIGN]========]\n";
    ext::fstring new_text2{"Meu cachorro!"};
    ext::fstring left {new_text2};
@@ -124,6 +266,37 @@ int main() {
    std::cout << "Align right with 35 size:    \"" << right << "\" \n";
    std::cout << "Align justify with 35 size:  \"" << justify << "\" \n";
 
+   ext::fstring colored{"Ação: 日本"};
+   colored.color(ext::fg_color::green);
+   std::cout << "Display width: " << colored.display_width() << " of "
+             << colored.size() << " chars\n";
+   colored.align_right(35);
+   std::cout << "Align right colored with 35: \"" << colored << "\" \n";
+   colored.strip_escapes();
+   std::cout << "Stripped for a log file:     \"" << colored << "\" \n";
+
+   std::cout << "\n[========[FORMAT]========]\n";
+   static constexpr char row[]{"|{:<10}|{:>5}|{:^9.2f}|{:#>6x}|"};
+   std::cout << ext::format<row>("Cachorro", 4, 12.5, 255) << "\n";
+   std::cout << ext::format<row>("Galinha", 2, 3.14159, 4096) << "\n";
+   std::cout << ext::format<row>("Pavão", 2, 0.5, 10) << "\n";
+
+   ext::out_buffer buffer;
+   ext::format_to<row>(buffer, "Gato", 4, 7.25, 16);
+   buffer.put(' ').fill(3, '*').put(' ').put_number(1234567).put('\n');
+   buffer.flush_to(std::cout);
+
+   std::cout << "\n[========[TABLE]========]\n";
+   ext::table table{" | "};
+   table.add_column("Animal")
+       .add_column("Patas", ext::align_mode::right)
+       .add_column("Cor", ext::align_mode::center, {ext::cfg::bright_green});
+   table.header_style({ext::cfg::none, ext::cbg::none, ext::stl::bold});
+   table.add_row({"Cachorro", "4", "Caramelo"});
+   table.add_row({"Galinha", "2", "Branca"});
+   table.add_row({"Cobra", "0", "Verde"});
+   std::cout << table;
+
    std::cout << "\n[========[STYLE]========]\n";
    ext::fstring new_text3{"Meu cachorro!"};
    ext::fstring color {new_text2};
@@ -146,4 +319,31 @@ int main() {
    std::cout << "Style:    \"" << style << "\" \n";
    std::cout << "All:  \"" << all << "\" \n";
    std::cout << "None:  \"" << err << "\" \n";
+
+   ext::fstring combined{new_text3};
+   combined.style(ext::text_style{ext::cfg::bright_green, ext::cbg::bright_red,
+                                  ext::stl::reverse});
+   std::cout << "Combined:  \"" << combined << "\" \n";
+
+   ext::fstring typed{new_text3};
+   typed.style<ext::fg_color::bright_green, ext::font_style::bold>();
+   std::cout << "Typed:  \"" << typed << "\" \n";
+
+   ext::styled_text spans;
+   spans.append("Meu ", {ext::cfg::red})
+       .append("cachorro", {ext::cfg::red, ext::cbg::blue, ext::stl::bold})
+       .append("!");
+   std::cout << "Spans:  \"" << spans << "\" \n";
+
+   std::cout << "\n[========[TERM WRITER]========]\n" << std::flush;
+   ext::term_writer terminal;
+   for (int cell{0}; cell != 8; ++cell) {
+      ext::fstring value{" 42 "};
+      value.color(cell < 6 ? ext::cfg::green : ext::cfg::red);
+      terminal.write(value);
+   }
+   terminal.write(spans).reset().write("\n", {});
+   terminal.flush();
+   std::cout << "Bytes written: " << terminal.bytes_written()
+             << ", saved: " << terminal.bytes_saved() << "\n";
 }
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "../format/fstring.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+static std::size_t allocations{0};
+
+void *operator new(std::size_t size_) {
+   ++allocations;
+   if (void *memory = std::malloc(size_ == 0 ? 1 : size_)) {
+      return memory;
+   }
+   throw std::bad_alloc();
+}
+
+void operator delete(void *memory_) noexcept { std::free(memory_); }
+
+void operator delete(void *memory_, std::size_t) noexcept {
+   std::free(memory_);
+}
+
+ext::fstring<char> MakeLong() {
+   ext::fstring<char> text(100, 'x');
+   text.align_right(120);
+   return text;
+}
+
+void TestMove() {
+   ext::fstring<char> source(100, 'a');
+
+   // Test that moving an fstring does not allocate
+   std::size_t before{allocations};
+   ext::fstring<char> moved{std::move(source)};
+   assert(allocations == before);
+   assert(moved.size() == 100);
+
+   // Test that move assignment does not allocate
+   ext::fstring<char> target;
+   before = allocations;
+   target = std::move(moved);
+   assert(allocations == before);
+   assert(target.size() == 100);
+
+   // Test that a returned temporary is not copied
+   before = allocations;
+   ext::fstring<char> returned{MakeLong()};
+   assert(allocations - before <= 2);
+   assert(returned.size() == 120);
+}
+
+void TestReplaceAll() {
+   ext::fstring<char> text{"{{name}} and {{name}}, always {{name}}!"};
+
+   // Test that a longer replacement allocates at most once
+   std::size_t before{allocations};
+   auto last{text.replace_all("{{name}}", "Fulano de Tal")};
+   assert(allocations - before <= 1);
+   assert(text == "Fulano de Tal and Fulano de Tal, always Fulano de Tal!");
+   assert(last == text.begin() + 40);
+
+   // Test that an equal-length replacement is done in place
+   before = allocations;
+   text.replace_all("Tal", "Sá");
+   assert(allocations == before);
+   assert(text == "Fulano de Sá and Fulano de Sá, always Fulano de Sá!");
+
+   // Test that replaced text is not searched again
+   ext::fstring<char> grow{"aaa"};
+   grow.replace_all("a", "aa");
+   assert(grow == "aaaaaa");
+
+   // Test that an empty target and a missing target change nothing
+   assert(grow.replace_all("", "b") == grow.end());
+   assert(grow.replace_all("b", "c") == grow.end());
+   assert(grow == "aaaaaa");
+}
+
+void TestAlignAllocations() {
+   ext::fstring<char> base{"Meu cachorro come muita ração todos os dias!"};
+
+   // Test that each alignment grows the capacity at most once
+   ext::fstring<char> left{base};
+   ext::fstring<char> center{base};
+   ext::fstring<char> right{base};
+   ext::fstring<char> justify{base};
+
+   std::size_t before{allocations};
+   left.align_left(80);
+   assert(allocations - before <= 1);
+   assert(left.display_width() == 80);
+
+   before = allocations;
+   center.align_center(80);
+   assert(allocations - before <= 1);
+
+   before = allocations;
+   right.align_right(80);
+   assert(allocations - before <= 1);
+
+   before = allocations;
+   justify.align_justify(80);
+   assert(allocations - before <= 1);
+
+   // Test that alignments do not allocate when the capacity is enough. They
+   // pad to columns, and "ç" and "ã" take two bytes for one column each, so
+   // 200 columns are 202 bytes
+   ext::fstring<char> reserved{base};
+   reserved.reserve(202);
+
+   before = allocations;
+   reserved.align_center(100);
+   reserved.align_right(150);
+   reserved.align_justify(200);
+   assert(allocations == before);
+   assert(reserved.size() == 202);
+   assert(reserved.display_width() == 200);
+}
+
+void TestConcatenation() {
+   ext::fstring<char> const directory{"/var/log/applications"};
+   ext::fstring<char> const file{"server-with-a-long-name.log"};
+
+   // Test that "+" returns an fstring, so keeping it keeps no views
+   static_assert(std::is_same_v<decltype(directory + std::string()),
+                                ext::fstring<char>>);
+   static_assert(std::is_same_v<decltype(std::string() + directory),
+                                ext::fstring<char>>);
+   auto const kept{directory + std::string("/a-temporary-long-file-name")};
+   auto const front{std::string("/home/someone/a-long-home") + directory};
+   assert(kept == "/var/log/applications/a-temporary-long-file-name");
+   assert(front == "/home/someone/a-long-home/var/log/applications");
+
+   // Test that "+" of two fstrings allocates the result once
+   std::size_t before{allocations};
+   ext::fstring<char> const joined{directory + file};
+   assert(allocations - before == 1);
+   assert(joined.size() == directory.size() + file.size());
+
+   // Test that a chain appends to the temporary on the left
+   ext::fstring<char> const path{directory + '/' + file};
+   assert(path == "/var/log/applications/server-with-a-long-name.log");
+   assert(ext::fstring<char>{directory + std::string("/") + file} == path);
+
+   // Test that quoted() allocates once
+   before = allocations;
+   ext::fstring<char> const quoted{path.quoted()};
+   assert(allocations - before == 1);
+   assert(quoted == '"' + path + '"');
+}
+
+void TestArena() {
+   char buffer[1024];
+   std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                             std::pmr::null_memory_resource()};
+   ext::fstring<char> line{"Titulo;Texto de um autor muito prolixo;;Editora"};
+
+   // Test that splitting into an arena does not touch the heap
+   std::size_t before{allocations};
+   auto tokens{line.split(';', &arena, ext::split_mode::keep_empty)};
+   assert(allocations == before);
+   assert(tokens.size() == 4);
+   assert(tokens[1] == "Texto de um autor muito prolixo");
+   assert(tokens[2].empty());
+   assert(tokens[1].get_allocator().resource() == &arena);
+
+   // Test that a pmr fstring keeps its resource through its operations
+   before = allocations;
+   ext::pmr::fstring<char> text{"Macacos Macaquiando", &arena};
+   text.replace_all("Maca", "Banana");
+   text.align_center(40);
+   text.color(ext::cfg::red);
+   assert(allocations == before);
+   assert(text.get_allocator().resource() == &arena);
+
+   // Test that splitting at a width keeps both parts in the arena
+   before = allocations;
+   ext::pmr::fstring<char> words{"Um texto de palavras para quebrar", &arena};
+   ext::pmr::fstring<char> const rest{words.split_at(12)};
+   ext::pmr::fstring<char> const none{words.split_at(0)};
+   assert(allocations == before);
+   assert(words == "Um texto de " && rest == "palavras para quebrar");
+   assert(none.empty());
+   assert(words.get_allocator().resource() == &arena);
+   assert(rest.get_allocator().resource() == &arena);
+   assert(none.get_allocator().resource() == &arena);
+
+   // Test that substrings and ranges can be built in the arena
+   before = allocations;
+   ext::pmr::fstring<char> const tail{words, 3, &arena};
+   ext::pmr::fstring<char> const middle{words, 3, 5, &arena};
+   ext::pmr::fstring<char> const copy{rest.begin(), rest.end(), &arena};
+   assert(allocations == before);
+   assert(tail == "texto de " && middle == "texto" && copy == rest);
+   assert(tail.get_allocator().resource() == &arena);
+   assert(middle.get_allocator().resource() == &arena);
+   assert(copy.get_allocator().resource() == &arena);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestMove();
+   TestReplaceAll();
+   TestAlignAllocations();
+   TestConcatenation();
+   TestArena();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
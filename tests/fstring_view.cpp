@@ -0,0 +1,76 @@
+#include "../explorer/FileHandler.hpp"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+void TestMapFile(fs::path const &directory_) {
+   // Test mapping a file and reading it without copying it
+   ext::FileHandler mapped_file{directory_ / "mapped_file.txt"};
+   {
+      std::ofstream out{mapped_file};
+      out << "  primeira;linha\r\nsegunda linha\n\n";
+   }
+
+   {
+      ext::fstring_view view{mapped_file.view()};
+      assert(view.size() == mapped_file.size());
+      assert(view.contains("segunda"));
+      assert(view.find_all("linha").size() == 2);
+      assert(view.trim() == "primeira;linha\r\nsegunda linha");
+      assert(view.lines().count() == 3);
+      assert(*view.lines().begin() == "  primeira;linha");
+
+      // Test that moving a view moves the mapping
+      ext::fstring_view moved{std::move(view)};
+      assert(view.empty());
+      assert(moved.contains("primeira"));
+   }
+
+   // Clean up: remove the mapped file
+   mapped_file.remove();
+   assert(!mapped_file.exists());
+}
+
+void TestMapEmptyAndMissing(fs::path const &directory_) {
+   // Test that an empty file maps to an empty view
+   fs::path const empty_file{directory_ / "empty.txt"};
+   std::ofstream{empty_file};
+   {
+      ext::fstring_view const view{empty_file};
+      assert(view.empty());
+      assert(view.lines().count() == 0);
+   }
+
+   // Test that a missing file cannot be mapped
+   bool thrown{false};
+   try {
+      ext::fstring_view const view{directory_ / "missing.txt"};
+   } catch (std::system_error const &) {
+      thrown = true;
+   }
+   assert(thrown);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   fs::path const directory{fs::temp_directory_path() /
+                            "cpp-extras-fstring-view"};
+   fs::remove_all(directory);
+   fs::create_directories(directory);
+
+   TestMapFile(directory);
+   TestMapEmptyAndMissing(directory);
+
+   fs::remove_all(directory);
+   assert(!fs::exists(directory));
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,185 @@
+#include "../explorer/Explorer.hpp"
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+void TestWildcards() {
+   // Test that '*' and '?' never cross a '/'
+   ext::glob const sources{"src/*.cpp"};
+   assert(sources.match("src/main.cpp"));
+   assert(sources.match("src/.cpp"));
+   assert(!sources.match("src/format/main.cpp"));
+   assert(!sources.match("src/main.cpp.orig"));
+
+   ext::glob const two{"a?c/?"};
+   assert(two.match("abc/d"));
+   assert(!two.match("a/c/d"));
+   assert(!two.match("abc/de"));
+
+   // Test that a pattern without '/' matches the file name
+   ext::glob const logs{"*.log"};
+   assert(logs("build/out/run.log"));
+   assert(logs("run.log"));
+   assert(!logs("run.log/notes"));
+
+   ext::glob const prefix{"test_*"};
+   assert(prefix.match("tests/test_glob.cpp"));
+   assert(!prefix.match("test_dir/glob.cpp"));
+}
+
+void TestGlobstar() {
+   // Test that "**" matches any number of segments, none included
+   ext::glob const sources{"**/*.{cpp,hpp}"};
+   assert(sources.match("main.cpp"));
+   assert(sources.match("src/format/glob.hpp"));
+   assert(!sources.match("src/format/glob.hpp.orig"));
+
+   ext::glob const objects{"build/**/[a-f]?.o"};
+   assert(objects.match("build/c1.o"));
+   assert(objects.match("build/x/y/ab.o"));
+   assert(!objects.match("build/x/g1.o"));
+   assert(!objects.match("other/build/c1.o"));
+
+   ext::glob const nested{"a/**/b/**/c"};
+   assert(nested.match("a/b/c"));
+   assert(nested.match("a/x/b/y/z/c"));
+   assert(!nested.match("a/x/c"));
+
+   // Test that "**" inside a segment is an ordinary '*'
+   ext::glob const inner{"a**b"};
+   assert(inner.match("axyb"));
+   assert(!inner.match("ax/yb"));
+}
+
+void TestBraces() {
+   // Test alternatives, nested and empty ones
+   ext::glob const nested{"{a,b{c,d}}.txt"};
+   assert(nested.match("a.txt"));
+   assert(nested.match("bc.txt"));
+   assert(nested.match("bd.txt"));
+   assert(!nested.match("b.txt"));
+   assert(!nested.match("abc.txt"));
+
+   ext::glob const backup{"file{,.bak}"};
+   assert(backup.match("file"));
+   assert(backup.match("file.bak"));
+   assert(!backup.match("file.ba"));
+
+   ext::glob const folders{"{src,include}/**/*.h"};
+   assert(folders.match("src/a.h"));
+   assert(folders.match("include/ext/b.h"));
+   assert(!folders.match("lib/a.h"));
+}
+
+void TestBrackets() {
+   // Test ranges, negations and a leading ']'
+   ext::glob const range{"[a-c][0-9]"};
+   assert(range.match("b7"));
+   assert(!range.match("d7"));
+   assert(!range.match("bx"));
+
+   ext::glob const negated{"[!a-c]*"};
+   assert(negated.match("data"));
+   assert(!negated.match("build"));
+
+   ext::glob const caret{"[^0-9]"};
+   assert(caret.match("x"));
+   assert(!caret.match("5"));
+
+   ext::glob const bracket{"[]a]"};
+   assert(bracket.match("]"));
+   assert(bracket.match("a"));
+   assert(!bracket.match("b"));
+
+   ext::glob const dash{"[a-]"};
+   assert(dash.match("-"));
+
+   // Test that a class never matches the separator
+   ext::glob const separator{"a[!b]c/d"};
+   assert(!separator.match("a/c/d"));
+}
+
+void TestEscapes() {
+   // Test that escaped characters are literal
+   ext::glob const star{"\\*.txt"};
+   assert(star.match("*.txt"));
+   assert(!star.match("a.txt"));
+
+   ext::glob const question{"a\\?b"};
+   assert(question.match("a?b"));
+   assert(!question.match("axb"));
+
+   ext::glob const braces{"\\{a,b\\}"};
+   assert(braces.match("{a,b}"));
+   assert(!braces.match("a"));
+
+   ext::glob const bracket{"\\[x]"};
+   assert(bracket.match("[x]"));
+   assert(!bracket.match("x"));
+}
+
+void TestInvalid() {
+   // Test that unclosed braces and brackets and a trailing '\' are rejected
+   for (char const *pattern : {"{a,b", "[abc", "abc\\"}) {
+      bool thrown{false};
+      try {
+         ext::glob const invalid{pattern};
+      } catch (std::invalid_argument const &) {
+         thrown = true;
+      }
+      assert(thrown);
+   }
+}
+
+void TestExplorer(fs::path const &directory_) {
+   // Test filtering the items of a directory tree with a glob
+   fs::create_directories(directory_ / "sub" / "deep");
+   std::ofstream{directory_ / "first.txt"};
+   std::ofstream{directory_ / "second.log"};
+   std::ofstream{directory_ / "sub" / "third.txt"};
+   std::ofstream{directory_ / "sub" / "deep" / "fourth.txt"};
+
+   ext::Explorer const explorer{directory_};
+
+   ext::List const texts{explorer.getChildrens(ext::glob{"*.txt"})};
+   assert(texts.getFilesSize() == 3);
+   assert(texts.getFoldersSize() == 0);
+
+   ext::List const nested{explorer.getChildrens(ext::glob{"sub/**/*.txt"})};
+   assert(nested.getFilesSize() == 2);
+
+   ext::List const direct{explorer.getChildrens(ext::glob{"sub/*"})};
+   assert(direct.getFilesSize() == 1);
+   assert(direct.getFoldersSize() == 1);
+
+   ext::List const all{explorer.getImediateChildrens(ext::glob{"*"})};
+   assert(all.getFilesSize() == 2);
+   assert(all.getFoldersSize() == 1);
+   assert(explorer.getImediateChildrens(ext::glob{"*.log"}).getFilesSize() ==
+          1);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestWildcards();
+   TestGlobstar();
+   TestBraces();
+   TestBrackets();
+   TestEscapes();
+   TestInvalid();
+
+   fs::path const directory{fs::temp_directory_path() / "cpp-extras-glob"};
+   fs::remove_all(directory);
+   TestExplorer(directory);
+   fs::remove_all(directory);
+   assert(!fs::exists(directory));
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,210 @@
+#include "../format/fstring.hpp"
+#include "../format/hash.hpp"
+#include "../format/intern_pool.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Draws a string from a small alphabet, so that many repeat, with a
+ * few longer than a block.
+ */
+std::string RandomText(std::mt19937_64 &random_) {
+   std::size_t const size{random_() % 50 == 0 ? 16000 + random_() % 70000
+                          : random_() % 4 == 0 ? random_() % 3
+                                               : random_() % 40};
+   std::string text(size, '\0');
+   for (char &byte : text) {
+      byte = "ab\0\xff."[random_() % 5];
+   }
+   return text;
+}
+
+/**
+ * @brief Checks that a handle holds a text, with its null character and its
+ * hash.
+ */
+void CheckHandle(ext::intern_pool::handle handle_, std::string const &text_) {
+   assert(handle_.view() == text_);
+   assert(std::string_view(handle_) == text_);
+   assert(handle_.size() == text_.size());
+   assert(handle_.empty() == text_.empty());
+   assert(handle_.c_str()[text_.size()] == '\0');
+   assert(handle_.hash() == ext::hash_bytes(text_.data(), text_.size()));
+   assert(handle_.hash() == ext::fstring<char>{text_}.hash());
+}
+
+void TestAgainstMap() {
+   // Test random strings against a map from each string to its first handle
+   std::mt19937_64 random{2023};
+
+   for (std::size_t shards : {0, 1, 3, 16}) {
+      ext::intern_pool pool{shards};
+      std::unordered_map<std::string, ext::intern_pool::handle> known;
+      std::map<char const *, std::string> owners;
+
+      for (int round{0}; round != 20000; ++round) {
+         std::string const text{RandomText(random)};
+         auto const seen{known.find(text)};
+         std::optional<ext::intern_pool::handle> const found{
+             pool.find(text)};
+         assert(found.has_value() ==
+                (text.empty() || seen != known.end()));
+
+         ext::intern_pool::handle const handle{pool.intern(text)};
+         CheckHandle(handle, text);
+         if (seen != known.end()) {
+            assert(handle == seen->second && *found == handle);
+         } else {
+            // Test that a new string gets a place no other string has
+            assert(text.empty() || owners.count(handle.data()) == 0);
+            known.emplace(text, handle);
+            owners[handle.data()] = text;
+         }
+         assert(pool.size() == known.size() - known.count(""));
+      }
+
+      // Test that the tables and blocks grew without moving a string
+      for (auto const &[text, handle] : known) {
+         CheckHandle(handle, text);
+         assert(pool.intern(text) == handle);
+      }
+      assert(pool.allocated() > 0);
+   }
+}
+
+void TestHandles() {
+   // Test that only the empty string is shared between pools
+   ext::intern_pool first;
+   ext::intern_pool second{2};
+   assert(first.intern("") == ext::intern_pool::handle());
+   assert(second.intern("") == ext::intern_pool::handle());
+   assert(first.intern("gato") != second.intern("gato"));
+   assert(first.intern("gato") == first.intern(std::string{"gato"}));
+   assert(first.intern("gato") != first.intern("gata"));
+   CheckHandle(ext::intern_pool::handle(), "");
+
+   // Test handles and fstrings as keys of unordered containers
+   std::unordered_set<ext::intern_pool::handle> handles;
+   std::unordered_set<ext::fstring<char>> texts;
+   for (char const *name : {"cpp", "hpp", "txt", "cpp", "", "hpp"}) {
+      handles.insert(first.intern(name));
+      texts.insert(name);
+   }
+   assert(handles.size() == 4 && texts.size() == 4);
+   assert(handles.count(first.intern("txt")) == 1);
+   assert(texts.count(ext::fstring<char>{"txt"}) == 1);
+}
+
+void TestThreads() {
+   // Test threads interning the same strings in different orders: every
+   // thread must get the same handle for a string
+   std::mt19937_64 random{7};
+   std::vector<std::string> texts;
+   for (int count{0}; count != 3001; ++count) {
+      texts.push_back(RandomText(random));
+   }
+   std::unordered_set<std::string> const distinct(texts.begin(),
+                                                  texts.end());
+
+   ext::intern_pool pool{4};
+   std::vector<std::vector<ext::intern_pool::handle>> handles(8);
+   std::vector<std::thread> threads;
+   for (std::size_t thread{0}; thread != handles.size(); ++thread) {
+      threads.emplace_back([&pool, &texts, &handles, thread] {
+         std::vector<ext::intern_pool::handle> &mine{handles[thread]};
+         mine.resize(texts.size());
+         for (std::size_t step{0}; step != texts.size(); ++step) {
+            // Each thread walks the strings with its own stride, prime to
+            // their number
+            std::size_t const index{(step * (2 * thread + 1)) %
+                                    texts.size()};
+            mine[index] = pool.intern(texts[index]);
+         }
+      });
+   }
+   for (std::thread &thread : threads) {
+      thread.join();
+   }
+
+   for (std::size_t index{0}; index != texts.size(); ++index) {
+      CheckHandle(handles[0][index], texts[index]);
+      for (auto const &mine : handles) {
+         assert(mine[index] == handles[0][index]);
+      }
+   }
+   assert(pool.size() == distinct.size() - distinct.count(""));
+}
+
+void TestHash() {
+   // Test that the hash reads every bit of every length, wherever the bytes
+   // are: flipping one bit must change it
+   std::mt19937_64 random{2023};
+   unsigned char buffer[300 + 8];
+
+   for (std::size_t size{0}; size != 300; ++size) {
+      for (unsigned char &byte : buffer) {
+         byte = static_cast<unsigned char>(random());
+      }
+      std::size_t const offset{random() % 8};
+      unsigned char *const data{buffer + offset};
+      std::uint64_t const hash{ext::hash_bytes(data, size)};
+
+      std::vector<unsigned char> const copy(data, data + size);
+      assert(ext::hash_bytes(copy.data(), size) == hash);
+      assert(ext::hash_bytes(data, size, 1) != hash);
+
+      for (std::size_t bit{0}; bit != size * 8; ++bit) {
+         data[bit / 8] ^= static_cast<unsigned char>(1u << bit % 8);
+         assert(ext::hash_bytes(data, size) != hash);
+         data[bit / 8] ^= static_cast<unsigned char>(1u << bit % 8);
+      }
+   }
+
+   // Test that distinct strings and lengths of zeros do not collide, and
+   // that fstrings hash their code units
+   std::unordered_set<std::uint64_t> hashes;
+   std::unordered_set<std::string> texts;
+   for (int count{0}; count != 100000; ++count) {
+      std::string text(random() % 24, '\0');
+      for (char &byte : text) {
+         byte = static_cast<char>('a' + random() % 26);
+      }
+      if (texts.insert(text).second) {
+         assert(hashes.insert(ext::hash_bytes(text.data(), text.size()))
+                    .second);
+      }
+   }
+   std::string const zeros(100, '\0');
+   for (std::size_t size{1}; size != 100; ++size) {
+      assert(hashes.insert(ext::hash_bytes(zeros.data(), size)).second);
+   }
+
+   ext::fstring<char16_t> const wide{u"gato"};
+   assert(wide.hash() == ext::hash_bytes(u"gato", 8));
+   assert(std::hash<ext::fstring<char16_t>>()(wide) ==
+          static_cast<std::size_t>(wide.hash()));
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstMap();
+   TestHandles();
+   TestThreads();
+   TestHash();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
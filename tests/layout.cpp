@@ -0,0 +1,278 @@
+#include "../format/fstring.hpp"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using words = std::vector<std::string>;
+
+/**
+ * @brief Splits a paragraph into its words, breaking those wider than the
+ * width into pieces of the width.
+ */
+words Pieces(std::string const &paragraph_, std::size_t width_) {
+   words result;
+   std::istringstream in{paragraph_};
+   for (std::string word; in >> word;) {
+      for (; word.size() > width_; word.erase(0, width_)) {
+         result.push_back(word.substr(0, width_));
+      }
+      result.push_back(word);
+   }
+   return result;
+}
+
+/**
+ * @brief Gets the width of a line made of some words joined by one space.
+ */
+std::size_t Size(words const &line_) {
+   std::size_t size{line_.size() - 1};
+   for (std::string const &word : line_) {
+      size += word.size();
+   }
+   return size;
+}
+
+/**
+ * @brief Fills each line with as many words as fit.
+ */
+std::vector<words> Greedy(words const &pieces_, std::size_t width_) {
+   std::vector<words> lines;
+   for (std::string const &word : pieces_) {
+      if (lines.empty() || Size(lines.back()) + 1 + word.size() > width_) {
+         lines.emplace_back();
+      }
+      lines.back().push_back(word);
+   }
+   return lines;
+}
+
+/**
+ * @brief Gets the squared slack of every line but the last.
+ */
+unsigned long long Cost(std::vector<words> const &lines_,
+                        std::size_t width_) {
+   unsigned long long cost{0};
+   for (std::size_t i{0}; i + 1 < lines_.size(); ++i) {
+      unsigned long long const slack{width_ - Size(lines_[i])};
+      cost += slack * slack;
+   }
+   return cost;
+}
+
+/**
+ * @brief Finds the lowest cost of all the ways to break the words, by
+ * trying every one of them.
+ */
+unsigned long long BestCost(words const &pieces_, std::size_t width_) {
+   unsigned long long best{std::numeric_limits<unsigned long long>::max()};
+   std::size_t const breaks{pieces_.empty() ? 0 : pieces_.size() - 1};
+
+   for (unsigned long mask{0}; mask != (1ul << breaks); ++mask) {
+      std::vector<words> lines{{pieces_[0]}};
+      for (std::size_t i{1}; i < pieces_.size(); ++i) {
+         if (mask >> (i - 1) & 1) {
+            lines.emplace_back();
+         }
+         lines.back().push_back(pieces_[i]);
+      }
+
+      bool fits{true};
+      for (words const &line : lines) {
+         fits = fits && Size(line) <= width_;
+      }
+      if (fits && Cost(lines, width_) < best) {
+         best = Cost(lines, width_);
+      }
+   }
+   return best;
+}
+
+/**
+ * @brief Pads a line of words to the width as fstring::align_* does, or
+ * spreads the padding between the words to justify it.
+ */
+std::string Render(words const &line_, std::size_t width_,
+                   ext::align_mode align_, bool last_) {
+   std::size_t const padding{line_.empty() ? width_
+                                           : width_ - Size(line_)};
+   std::size_t const gaps{line_.empty() ? 0 : line_.size() - 1};
+
+   if (align_ == ext::align_mode::justify && !last_ && gaps != 0) {
+      std::string result{line_[0]};
+      for (std::size_t i{1}; i != line_.size(); ++i) {
+         result.append(1 + padding / gaps + (i - 1 < padding % gaps), ' ');
+         result += line_[i];
+      }
+      return result;
+   }
+
+   std::string text;
+   for (std::string const &word : line_) {
+      text += (text.empty() ? "" : " ") + word;
+   }
+
+   std::size_t before{0};
+   if (align_ == ext::align_mode::right) {
+      before = padding;
+   } else if (align_ == ext::align_mode::center) {
+      before = padding / 2;
+   }
+   return std::string(before, ' ') + text +
+          std::string(padding - before, ' ');
+}
+
+/**
+ * @brief Lays out a text with the reference functions above.
+ */
+words Reference(std::string const &text_, std::size_t width_,
+                ext::align_mode align_) {
+   words result;
+   std::size_t start{0};
+   while (start < text_.size()) {
+      std::size_t end{text_.find('\n', start)};
+      if (end == std::string::npos) {
+         end = text_.size();
+      }
+
+      std::vector<words> const lines{
+          Greedy(Pieces(text_.substr(start, end - start), width_), width_)};
+      if (lines.empty()) {
+         result.push_back(std::string(width_, ' '));
+      }
+      for (std::size_t i{0}; i != lines.size(); ++i) {
+         result.push_back(
+             Render(lines[i], width_, align_, i + 1 == lines.size()));
+      }
+      start = end + 1;
+   }
+   return result;
+}
+
+words Collect(ext::layout &&layout_) {
+   words result;
+   for (std::string const &line : layout_) {
+      result.push_back(line);
+   }
+   return result;
+}
+
+std::string RandomText(std::mt19937 &random_) {
+   std::string text;
+   for (auto count{random_() % 14}; count != 0; --count) {
+      auto const kind{random_() % 10};
+      if (kind == 0) {
+         text += '\n';
+      } else if (kind < 3) {
+         text += ' ';
+      } else {
+         text.append(1 + random_() % (kind == 9 ? 25 : 7),
+                     static_cast<char>('a' + random_() % 26));
+      }
+   }
+   return text;
+}
+
+void TestGreedy() {
+   // Test every alignment against the reference on random texts
+   std::mt19937 random{2023};
+   ext::align_mode const aligns[]{ext::align_mode::left,
+                                  ext::align_mode::center,
+                                  ext::align_mode::right,
+                                  ext::align_mode::justify};
+
+   for (int round{0}; round != 5000; ++round) {
+      std::string const text{RandomText(random)};
+      std::size_t const width{1 + random() % 20};
+
+      for (ext::align_mode align : aligns) {
+         assert(Collect(ext::layout{text, width, align}) ==
+                Reference(text, width, align));
+      }
+
+      // Test that a stream gives the same lines as the text
+      std::istringstream stream{text};
+      assert(Collect(ext::layout{stream, width}) ==
+             Reference(text, width, ext::align_mode::left));
+   }
+}
+
+void TestMinRaggedness() {
+   // Test that the planned breaks cost as little as the best of all breaks
+   std::mt19937 random{7};
+
+   for (int round{0}; round != 3000; ++round) {
+      std::string text{RandomText(random)};
+      for (char &c : text) {
+         c = c == '\n' ? ' ' : c;
+      }
+      std::size_t const width{1 + random() % 20};
+      words const pieces{Pieces(text, width)};
+      if (pieces.empty() || pieces.size() > 14) {
+         continue;
+      }
+
+      std::vector<words> lines;
+      for (std::string const &line : Collect(ext::layout{
+               text, width, ext::align_mode::left,
+               ext::wrap_mode::min_raggedness})) {
+         assert(line.size() == width);
+         lines.push_back(Pieces(line, width));
+      }
+
+      words joined;
+      for (words const &line : lines) {
+         assert(!line.empty() && Size(line) <= width);
+         joined.insert(joined.end(), line.begin(), line.end());
+      }
+      assert(joined == pieces);
+      assert(Cost(lines, width) == BestCost(pieces, width));
+      assert(Cost(lines, width) <= Cost(Greedy(pieces, width), width));
+   }
+}
+
+void TestSeparatorAndWidth() {
+   // Test that the separator splits the words and pads the lines
+   assert((Collect(ext::layout{"ab.cd..ef", 6, ext::align_mode::right,
+                               ext::wrap_mode::greedy, '.'}) ==
+           words{".ab.cd", "....ef"}));
+
+   // Test that words are measured in columns, not bytes
+   assert((Collect(ext::layout{"Pavão 漢字 x\r\n\n", 6}) ==
+           words{"Pavão ", "漢字 x", "      "}));
+   assert((Collect(ext::layout{"\33[31mred\33[0m blue", 4,
+                               ext::align_mode::center}) ==
+           words{"\33[31mred\33[0m ", "blue"}));
+
+   bool thrown{false};
+   try {
+      ext::layout const invalid{"text", 0};
+   } catch (std::invalid_argument const &) {
+      thrown = true;
+   }
+   assert(thrown);
+
+   // Test the layout of an fstring
+   ext::fstring<char> const text{"one two three four"};
+   words lines;
+   for (auto const &line : text.wrap(9, ext::align_mode::justify)) {
+      lines.push_back(line);
+   }
+   assert((lines == words{"one   two", "three    ", "four     "}));
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestGreedy();
+   TestMinRaggedness();
+   TestSeparatorAndWidth();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
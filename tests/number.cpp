@@ -0,0 +1,563 @@
+#include "../format/fstring.hpp"
+#include "../format/number.hpp"
+#include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Writes an integer digit by digit, as a reference for append_number.
+ */
+template <class Type> std::string Digits(Type value_, int base_) {
+   bool negative{false};
+   if constexpr (std::is_signed_v<Type>) {
+      negative = value_ < 0;
+   }
+
+   std::string digits;
+   do {
+      int const digit{static_cast<int>(value_ % base_)};
+      digits.insert(digits.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"
+                                        [digit < 0 ? -digit : digit]);
+      value_ /= static_cast<Type>(base_);
+   } while (value_ != 0);
+   return negative ? '-' + digits : digits;
+}
+
+/**
+ * @brief Counts the significant digits of a number written in fixed or
+ * scientific notation, without the zeros around them.
+ */
+std::size_t Significant(std::string_view text_) {
+   text_ = text_.substr(0, text_.find('e'));
+   std::string digits;
+   for (char byte : text_) {
+      if (byte >= '0' && byte <= '9' && !(digits.empty() && byte == '0')) {
+         digits += byte;
+      }
+   }
+   while (!digits.empty() && digits.back() == '0') {
+      digits.pop_back();
+   }
+   return digits.size();
+}
+
+/**
+ * @brief Writes a number in scientific notation with the fewest digits that
+ * read back to it, trying every precision of "%e".
+ */
+std::string Shortest(double value_) {
+   for (int precision{0};; ++precision) {
+      char text[64];
+      std::snprintf(text, sizeof(text), "%.*e", precision, value_);
+      if (std::strtod(text, nullptr) == value_) {
+         return text;
+      }
+   }
+}
+
+/**
+ * @brief Writes a floating-point number with snprintf, dropping the "0x"
+ * that "%a" adds and std::to_chars does not.
+ */
+std::string Printf(double value_, std::chars_format format_, int precision_) {
+   char const *const pattern{format_ == std::chars_format::fixed ? "%.*f"
+                             : format_ == std::chars_format::scientific
+                                 ? "%.*e"
+                             : format_ == std::chars_format::general ? "%.*g"
+                                                                     : "%.*a"};
+   std::string text(std::snprintf(nullptr, 0, pattern, precision_, value_),
+                    '\0');
+   std::snprintf(&text[0], text.size() + 1, pattern, precision_, value_);
+
+   std::size_t const prefix{text.find("0x")};
+   return prefix == std::string::npos ? text : text.erase(prefix, 2);
+}
+
+/**
+ * @brief Checks if a call throws an exception of a type.
+ */
+template <class Exception, class Call> bool Throws(Call const &call_) {
+   try {
+      call_();
+   } catch (Exception const &) {
+      return true;
+   }
+   return false;
+}
+
+/**
+ * @brief Draws an integer of a type from its whole range or around 0.
+ */
+template <class Type> Type RandomInteger(std::mt19937_64 &random_) {
+   if (random_() % 4 == 0) {
+      return static_cast<Type>(static_cast<int>(random_() % 21) - 10);
+   }
+   return static_cast<Type>(random_());
+}
+
+/**
+ * @brief Draws a finite floating-point number of any magnitude.
+ */
+double RandomFloat(std::mt19937_64 &random_) {
+   if (random_() % 3 == 0) {
+      return static_cast<double>(static_cast<int>(random_() % 2001) - 1000) /
+             8;
+   }
+
+   std::uint64_t bits{random_()};
+   double value;
+   std::memcpy(&value, &bits, sizeof(value));
+   return value == value && value - value == 0 ? value : 0.1;
+}
+
+/**
+ * @brief Appends random integers of a type in every base to a byte and a
+ * wide fstring, and checks both against the reference.
+ */
+template <class Type> void CheckIntegers(std::mt19937_64 &random_) {
+   ext::fstring<char> bytes;
+   ext::fstring<char16_t> wide;
+   std::string expected;
+
+   for (int count{0}; count != 200; ++count) {
+      Type const value{RandomInteger<Type>(random_)};
+      int const base{random_() % 2 == 0 ? 10
+                                        : 2 + static_cast<int>(random_() % 35)};
+      bytes.append_number(value, base);
+      wide.append_number(value, base);
+      expected += Digits(value, base) + ' ';
+      bytes += ' ';
+      wide += u' ';
+   }
+
+   assert(bytes == expected);
+   assert(wide == std::u16string(expected.begin(), expected.end()));
+}
+
+void TestAppend() {
+   // Test integers of every width, floats in their shortest form and with a
+   // precision, against the digit writer and snprintf
+   std::mt19937_64 random{2023};
+
+   for (int round{0}; round != 50; ++round) {
+      CheckIntegers<signed char>(random);
+      CheckIntegers<unsigned char>(random);
+      CheckIntegers<short>(random);
+      CheckIntegers<int>(random);
+      CheckIntegers<unsigned>(random);
+      CheckIntegers<long long>(random);
+      CheckIntegers<std::uint64_t>(random);
+   }
+
+   std::chars_format const formats[]{
+       std::chars_format::fixed, std::chars_format::scientific,
+       std::chars_format::general, std::chars_format::hex};
+   for (int round{0}; round != 20000; ++round) {
+      double const value{RandomFloat(random)};
+
+      ext::fstring<char> shortest;
+      shortest.append_number(value);
+      std::string const scientific{Shortest(value)};
+      assert(std::strtod(shortest.c_str(), nullptr) == value);
+      assert(shortest.size() <= scientific.size());
+      // Only a whole number written out in full may have more digits
+      assert(Significant(shortest) == Significant(scientific) ||
+             shortest.find_first_of(".e") == ext::fstring<char>::npos);
+
+      // Large fixed numbers do not fit the digits on the stack
+      std::chars_format const format{formats[random() % 4]};
+      int const precision{static_cast<int>(random() % 30)};
+      ext::fstring<char32_t> precise{U"="};
+      precise.append_number(value, format, precision);
+      std::string const printed{Printf(value, format, precision)};
+      assert(precise ==
+             U"=" + std::u32string(printed.begin(), printed.end()));
+   }
+
+   // Test that a base out of range throws and appends nothing
+   ext::fstring<char> text{"n="};
+   for (int base : {-10, 0, 1, 37, 100}) {
+      assert(Throws<std::invalid_argument>(
+          [&text, base] { text.append_number(42, base); }));
+      assert(text == "n=");
+   }
+   text.append_number(35, 36);
+   text.append_number(-2, 2);
+   assert(text == "n=z-10");
+}
+
+/**
+ * @brief Draws the text of an integer, with the spaces, signs and stray
+ * characters that make it invalid now and then.
+ */
+std::string RandomIntegerText(std::mt19937_64 &random_) {
+   std::string text;
+   for (auto count{random_() % 3}; count != 0; --count) {
+      text += " \t"[random_() % 2];
+   }
+   if (random_() % 3 == 0) {
+      text += "+-"[random_() % 2];
+   }
+   for (auto count{random_() % 24}; count != 0; --count) {
+      text += random_() % 30 == 0 ? " +-x."[random_() % 5]
+                                  : static_cast<char>('0' + random_() % 10);
+   }
+   for (auto count{random_() % 3}; count != 0; --count) {
+      text += " \t"[random_() % 2];
+   }
+   return text;
+}
+
+/**
+ * @brief Parses an integer with strtoll or strtoull, as a reference for
+ * num::parse: the text is trimmed, a '+' is skipped unless a sign follows,
+ * and what is left must be the number and nothing else.
+ */
+template <class Type> std::errc Strto(std::string_view text_, Type &value_) {
+   text_ = ext::num::trimmed(text_);
+   bool const plus{!text_.empty() && text_[0] == '+'};
+   text_.remove_prefix(plus ? 1 : 0);
+   if (text_.empty() || !((text_[0] == '-' && !plus) ||
+                          (text_[0] >= '0' && text_[0] <= '9'))) {
+      return std::errc::invalid_argument;
+   }
+
+   std::string const digits{text_};
+   char *end{nullptr};
+   errno = 0;
+   if constexpr (std::is_signed_v<Type>) {
+      long long const value{std::strtoll(digits.c_str(), &end, 10)};
+      if (end != digits.c_str() + digits.size()) {
+         return std::errc::invalid_argument;
+      }
+      if (errno == ERANGE || value < std::numeric_limits<Type>::min() ||
+          value > std::numeric_limits<Type>::max()) {
+         return std::errc::result_out_of_range;
+      }
+      value_ = static_cast<Type>(value);
+   } else {
+      if (text_[0] == '-') {
+         return std::errc::invalid_argument;
+      }
+      unsigned long long const value{std::strtoull(digits.c_str(), &end, 10)};
+      if (end != digits.c_str() + digits.size()) {
+         return std::errc::invalid_argument;
+      }
+      if (errno == ERANGE || value > std::numeric_limits<Type>::max()) {
+         return std::errc::result_out_of_range;
+      }
+      value_ = static_cast<Type>(value);
+   }
+   return std::errc();
+}
+
+/**
+ * @brief Parses random integer texts of a type with every member and checks
+ * them against strtoll.
+ */
+template <class Type> void CheckParse(std::mt19937_64 &random_) {
+   for (int round{0}; round != 5000; ++round) {
+      std::string const text{RandomIntegerText(random_)};
+      Type expected{7};
+      std::errc const error{Strto(text, expected)};
+
+      Type value{7};
+      assert(ext::num::parse(text, value) == error);
+      assert(value == expected);
+
+      ext::fstring<char> const bytes{text};
+      ext::fstring<char16_t> const wide(text.begin(), text.end());
+      assert(wide.parse(value) == error && value == expected);
+      assert(bytes.try_parse<Type>().has_value() == (error == std::errc()));
+
+      if (error == std::errc()) {
+         assert(bytes.parse<Type>() == expected);
+      } else if (error == std::errc::result_out_of_range) {
+         assert(Throws<std::out_of_range>([&bytes] { bytes.parse<Type>(); }));
+      } else {
+         assert(Throws<std::invalid_argument>(
+             [&bytes] { bytes.parse<Type>(); }));
+      }
+   }
+}
+
+/**
+ * @brief Parses a floating-point number with strtod, as a reference for
+ * num::parse.
+ */
+std::errc Strtod(std::string_view text_, double &value_) {
+   text_ = ext::num::trimmed(text_);
+   bool const plus{!text_.empty() && text_[0] == '+'};
+   text_.remove_prefix(plus ? 1 : 0);
+   if (text_.empty() || text_[0] == '+' || (text_[0] == '-' && plus) ||
+       text_[0] == ' ' || text_[0] == '\t') {
+      return std::errc::invalid_argument;
+   }
+
+   std::string const digits{text_};
+   char *end{nullptr};
+   errno = 0;
+   double const value{std::strtod(digits.c_str(), &end)};
+   if (end != digits.c_str() + digits.size()) {
+      return std::errc::invalid_argument;
+   }
+   // Subnormal numbers are only inexact, not out of range
+   if (errno == ERANGE && (value == 0 || std::isinf(value))) {
+      return std::errc::result_out_of_range;
+   }
+   value_ = value;
+   return std::errc();
+}
+
+void TestParse() {
+   // Test integers of every width against strtoll and strtoull
+   std::mt19937_64 random{7};
+   CheckParse<signed char>(random);
+   CheckParse<unsigned char>(random);
+   CheckParse<short>(random);
+   CheckParse<int>(random);
+   CheckParse<unsigned>(random);
+   CheckParse<long long>(random);
+   CheckParse<unsigned long long>(random);
+
+   // Test floating-point texts, written back from random numbers or cut and
+   // spoiled, against strtod
+   for (int round{0}; round != 20000; ++round) {
+      std::string text;
+      char digits[64];
+      double const source{RandomFloat(random)};
+      text.append(digits,
+                  random() % 2 == 0
+                      ? std::to_chars(digits, digits + 64, source).ptr
+                      : digits + std::snprintf(digits, 64, "%.*f",
+                                               static_cast<int>(random() % 5),
+                                               source / 1e290));
+      if (random() % 3 == 0) {
+         text.erase(random() % text.size(), 1);
+      }
+      if (random() % 4 == 0) {
+         text.insert(random() % (text.size() + 1), 1, " +-.e0"[random() % 6]);
+      }
+      if (random() % 3 == 0) {
+         text = " +" + text + '\t';
+      }
+
+      double expected{-1};
+      std::errc const error{Strtod(text, expected)};
+      double value{-1};
+      assert(ext::num::parse(text, value) == error);
+      assert(value == expected);
+      assert(ext::fstring<char>{text}.try_parse<double>().has_value() ==
+             (error == std::errc()));
+   }
+
+   double value{0};
+   assert(ext::num::parse("1e400", value) == std::errc::result_out_of_range);
+   assert(ext::num::parse("0x10", value) == std::errc::invalid_argument);
+   assert(ext::num::parse("ff", value, std::chars_format::hex) ==
+              std::errc() &&
+          value == 255);
+   int hex{0};
+   assert(ext::num::parse("-7f", hex, 16) == std::errc() && hex == -127);
+}
+
+/**
+ * @brief A unit and the size it multiplies by.
+ */
+struct unit {
+   char const *name;
+   std::uint64_t size;
+};
+
+/**
+ * @brief Draws a number with a fraction in quarters, and the text of it, so
+ * that every multiple of 4 scales it exactly.
+ */
+std::string RandomQuarters(std::mt19937_64 &random_, std::uint64_t &whole_,
+                           unsigned &quarters_) {
+   whole_ = random_() % 4 == 0 ? random_() : random_() % 5000;
+   quarters_ = static_cast<unsigned>(random_() % 4);
+   char const *const fractions[]{"", ".25", ".5", ".75"};
+   std::string const text{std::to_string(whole_) + fractions[quarters_]};
+   if (quarters_ == 0 && random_() % 2 == 0) {
+      return text + ".0";
+   }
+   return text;
+}
+
+/**
+ * @brief Scales a number by a unit, as a reference that checks the overflow
+ * with divisions.
+ *
+ * @return False if the result does not fit.
+ */
+bool Scale(std::uint64_t whole_, unsigned quarters_, std::uint64_t size_,
+           std::uint64_t most_, std::uint64_t &value_) {
+   std::uint64_t const part{size_ / 4 * quarters_};
+   if (whole_ > most_ / size_ || whole_ * size_ > most_ - part) {
+      return false;
+   }
+   value_ = whole_ * size_ + part;
+   return true;
+}
+
+void TestSizes() {
+   // Test numbers with every unit, and spaces and case changes, against the
+   // units multiplied by hand
+   std::mt19937_64 random{2023};
+   constexpr std::uint64_t kibi{1024};
+   unit const units[]{{"", 1},
+                      {"B", 1},
+                      {"k", kibi},
+                      {"KiB", kibi},
+                      {"kB", 1000},
+                      {"M", kibi * kibi},
+                      {"MB", 1'000'000},
+                      {"gib", kibi * kibi * kibi},
+                      {"G", kibi * kibi * kibi},
+                      {"TB", 1'000'000'000'000},
+                      {"P", kibi * kibi * kibi * kibi * kibi},
+                      {"EiB", kibi * kibi * kibi * kibi * kibi * kibi},
+                      {"eb", 1'000'000'000'000'000'000}};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::uint64_t whole{0};
+      unsigned quarters{0};
+      unit const &suffix{units[random() % 13]};
+      std::string const text{RandomQuarters(random, whole, quarters) +
+                             (random() % 2 == 0 ? " " : "") + suffix.name};
+
+      std::uint64_t expected{0};
+      bool const fits{Scale(whole, suffix.size < 4 ? 0 : quarters,
+                            suffix.size, std::uint64_t(-1), expected)};
+      std::optional<std::uint64_t> const bytes{
+          ext::fstring<char>{text}.parse_size()};
+      std::uint64_t read{0};
+      assert(ext::num::parse_size(text, read) ==
+             (fits ? std::errc() : std::errc::result_out_of_range));
+      assert(bytes.has_value() == fits);
+      assert(!fits || *bytes == expected);
+   }
+
+   for (char const *invalid : {"", "k", "10 kk", "10q", "1.2.3G", "-1G",
+                               ". G", "10 GiBs", "20000000000000000000"}) {
+      assert(!ext::fstring<char>{invalid}.parse_size());
+   }
+}
+
+void TestDurations() {
+   // Test sums of numbers with every unit against the nanoseconds added by
+   // hand
+   std::mt19937_64 random{7};
+   unit const units[]{{"ns", 1},
+                      {"us", 1'000},
+                      {"\xC2\xB5s", 1'000},
+                      {"ms", 1'000'000},
+                      {"s", 1'000'000'000},
+                      {"m", 60'000'000'000},
+                      {"min", 60'000'000'000},
+                      {"h", 3'600'000'000'000},
+                      {"d", 86'400'000'000'000}};
+   constexpr std::uint64_t most{
+       static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::string text;
+      std::uint64_t total{0};
+      bool fits{true};
+
+      for (auto count{1 + random() % 3}; count != 0; --count) {
+         std::uint64_t whole{0};
+         unsigned quarters{0};
+         unit const &suffix{units[random() % 9]};
+         text += RandomQuarters(random, whole, quarters) + suffix.name +
+                 (random() % 2 == 0 ? " " : "");
+
+         std::uint64_t nanoseconds{0};
+         fits = fits &&
+                Scale(whole, suffix.size < 4 ? 0 : quarters, suffix.size,
+                      most, nanoseconds) &&
+                nanoseconds <= most - total;
+         total += fits ? nanoseconds : 0;
+      }
+
+      auto const duration{ext::fstring<char>{text}.parse_duration()};
+      assert(duration.has_value() == fits);
+      assert(!fits || static_cast<std::uint64_t>(duration->count()) == total);
+   }
+
+   for (char const *invalid : {"", "10", "ms", "10 x", "1h 30", "1.5.2s",
+                               "-1s", "5 mins"}) {
+      assert(!ext::fstring<char>{invalid}.parse_duration());
+   }
+}
+
+void TestParseAll() {
+   // Test delimited lists against every token parsed alone
+   std::mt19937_64 random{2023};
+
+   for (int round{0}; round != 5000; ++round) {
+      std::vector<int> expected;
+      std::string text;
+      std::errc error{};
+      char const delimiter{",;|"[random() % 3]};
+
+      for (auto count{1 + random() % 8}; count != 0; --count) {
+         std::string const token{RandomIntegerText(random)};
+         int value{0};
+         std::errc const token_error{Strto(token, value)};
+         if (error == std::errc()) {
+            error = token_error;
+         }
+         expected.push_back(value);
+         text += (expected.size() == 1 ? "" : std::string(1, delimiter)) +
+                 token;
+      }
+
+      ext::fstring<char> const list{text};
+      bool const blank{text.find_first_not_of(" \t") == std::string::npos};
+      if (blank) {
+         assert(list.parse_all<int>(delimiter).empty());
+      } else if (error == std::errc()) {
+         assert(list.parse_all<int>(delimiter) == expected);
+         ext::fstring<char32_t> const wide(text.begin(), text.end());
+         assert(wide.parse_all<int>(char32_t(delimiter)) == expected);
+      } else if (error == std::errc::result_out_of_range) {
+         assert(Throws<std::out_of_range>(
+             [&list, delimiter] { list.parse_all<int>(delimiter); }));
+      } else {
+         assert(Throws<std::invalid_argument>(
+             [&list, delimiter] { list.parse_all<int>(delimiter); }));
+      }
+   }
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAppend();
+   TestParse();
+   TestSizes();
+   TestDurations();
+   TestParseAll();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,319 @@
+#include "../format/out_buffer.hpp"
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+/**
+ * @brief Writes an integer digit by digit, as a reference for the integer
+ * put_number.
+ */
+template <class Type> std::string Digits(Type value_, int base_) {
+   bool negative{false};
+   if constexpr (std::is_signed_v<Type>) {
+      negative = value_ < 0;
+   }
+
+   std::string digits;
+   do {
+      int const digit{static_cast<int>(value_ % base_)};
+      digits.insert(digits.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"
+                                        [digit < 0 ? -digit : digit]);
+      value_ /= static_cast<Type>(base_);
+   } while (value_ != 0);
+   return negative ? '-' + digits : digits;
+}
+
+/**
+ * @brief Writes a floating-point number with snprintf, dropping the "0x"
+ * that "%a" adds and std::to_chars does not.
+ */
+std::string Printf(double value_, std::chars_format format_, int precision_) {
+   char const *const pattern{format_ == std::chars_format::fixed ? "%.*f"
+                             : format_ == std::chars_format::scientific
+                                 ? "%.*e"
+                             : format_ == std::chars_format::general ? "%.*g"
+                                                                     : "%.*a"};
+   std::string text(std::snprintf(nullptr, 0, pattern, precision_, value_),
+                    '\0');
+   std::snprintf(&text[0], text.size() + 1, pattern, precision_, value_);
+
+   std::size_t const prefix{text.find("0x")};
+   return prefix == std::string::npos ? text : text.erase(prefix, 2);
+}
+
+/**
+ * @brief Writes a value with a default output stream.
+ */
+template <class Type> std::string Stream(Type const &value_) {
+   std::ostringstream stream;
+   stream << value_;
+   return stream.str();
+}
+
+/**
+ * @brief A type only an output stream knows how to write.
+ */
+struct point {
+   int x;
+   int y;
+};
+
+std::ostream &operator<<(std::ostream &os_, point const &point_) {
+   return os_ << '(' << point_.x << ", " << point_.y << ')';
+}
+
+/**
+ * @brief Draws an integer of a type from its whole range or around 0.
+ */
+template <class Type> Type RandomInteger(std::mt19937_64 &random_) {
+   if (random_() % 4 == 0) {
+      return static_cast<Type>(static_cast<int>(random_() % 21) - 10);
+   }
+   return static_cast<Type>(random_());
+}
+
+/**
+ * @brief Draws a floating-point number of any magnitude, with zeros and
+ * subnormals among them.
+ */
+double RandomFloat(std::mt19937_64 &random_) {
+   switch (random_() % 6) {
+   case 0:
+      return static_cast<double>(static_cast<int>(random_() % 2001) - 1000);
+   case 1:
+      return std::numeric_limits<double>::denorm_min() *
+             static_cast<double>(random_() % 1000);
+   case 2:
+      return -0.0;
+   default:
+      std::uint64_t bits{random_()};
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value == value && value - value == 0 ? value : 1.5;
+   }
+}
+
+/**
+ * @brief Appends one random piece to a buffer and what it should write to a
+ * string.
+ */
+void PutRandom(std::mt19937_64 &random_, ext::out_buffer &buffer_,
+               std::string &expected_) {
+   switch (random_() % 12) {
+   case 0: {
+      char const byte{static_cast<char>(random_())};
+      buffer_.put(byte);
+      expected_ += byte;
+      break;
+   }
+   case 1: {
+      std::string const text(random_() % 300, "abc\0 ção"[random_() % 9]);
+      buffer_.put(text);
+      expected_ += text;
+      break;
+   }
+   case 2: {
+      std::size_t const count{random_() % 200};
+      buffer_.fill(count, '*');
+      expected_.append(count, '*');
+      break;
+   }
+   case 3: {
+      int const base{2 + static_cast<int>(random_() % 35)};
+      auto const value{RandomInteger<long long>(random_)};
+      buffer_.put_number(value, base);
+      expected_ += Digits(value, base);
+      break;
+   }
+   case 4: {
+      auto const value{RandomInteger<std::uint64_t>(random_)};
+      buffer_.put_number(value, 2);
+      expected_ += Digits(value, 2);
+      break;
+   }
+   case 5: {
+      auto const value{RandomInteger<signed char>(random_)};
+      buffer_.put_number(value);
+      expected_ += Digits(value, 10);
+      break;
+   }
+   case 6: {
+      double const value{RandomFloat(random_)};
+      buffer_.put_number(value);
+      char digits[64];
+      char *const last{std::to_chars(digits, digits + 64, value).ptr};
+      expected_.append(digits, last);
+      assert(std::strtod(std::string(digits, last).c_str(), nullptr) ==
+             value);
+      break;
+   }
+   case 7: {
+      std::chars_format const formats[]{
+          std::chars_format::fixed, std::chars_format::scientific,
+          std::chars_format::general, std::chars_format::hex};
+      std::chars_format const format{formats[random_() % 4]};
+      double const value{RandomFloat(random_)};
+      int const precision{static_cast<int>(random_() % 40)};
+      buffer_.put_number(value, format, precision);
+      expected_ += Printf(value, format, precision);
+      break;
+   }
+   case 8: {
+      double const value{RandomFloat(random_)};
+      buffer_.print(value);
+      expected_ += Stream(value);
+      break;
+   }
+   case 9: {
+      auto const value{RandomInteger<short>(random_)};
+      bool const flag{random_() % 2 == 0};
+      point const where{RandomInteger<int>(random_), -1};
+      buffer_.print(value).print(flag).print(where).print("txt").print('c');
+      expected_ += Stream(value) + Stream(flag) + Stream(where) + "txtc";
+      break;
+   }
+   case 10: {
+      std::string const text{"append"};
+      buffer_.append(text.data(), 3);
+      buffer_.append(text.data() + 3, text.data() + text.size());
+      buffer_.append(2, '-');
+      buffer_.push_back('!');
+      buffer_ += '?';
+      buffer_ += std::string_view{"+="};
+      expected_ += "append--!?+=";
+      break;
+   }
+   default:
+      std::string const text(1 + random_() % 5000, 'x');
+      buffer_.put(text);
+      expected_ += text;
+      break;
+   }
+}
+
+void TestAgainstString() {
+   // Test random pieces, some larger than the whole buffer, against the
+   // same pieces written to a string
+   std::mt19937_64 random{2023};
+
+   for (int round{0}; round != 3000; ++round) {
+      ext::out_buffer buffer{random() % 2 == 0 ? 0 : random() % 100};
+      std::string expected;
+
+      for (auto count{random() % 30}; count != 0; --count) {
+         PutRandom(random, buffer, expected);
+         assert(buffer.view() == expected);
+         assert(buffer.size() == expected.size());
+         assert(buffer.capacity() >= buffer.size());
+         assert(buffer.empty() == expected.empty());
+      }
+   }
+
+   // Test numbers longer than the first room put_chars makes
+   ext::out_buffer buffer;
+   buffer.put_number(1e300, std::chars_format::fixed, 20);
+   buffer.put_number(-std::numeric_limits<double>::max());
+   buffer.put_number(std::numeric_limits<long long>::min(), 2);
+   assert(buffer.view() == Printf(1e300, std::chars_format::fixed, 20) +
+                               "-1.7976931348623157e+308" +
+                               Digits(std::numeric_limits<long long>::min(),
+                                      2));
+}
+
+void TestStorage() {
+   // Test that reserve and clear keep the bytes and the room
+   ext::out_buffer buffer{10};
+   assert(buffer.empty() && buffer.capacity() == 10);
+   buffer.put("0123456789");
+   char const *const data{buffer.data()};
+   buffer.reserve(5);
+   assert(buffer.data() == data && buffer.capacity() == 10);
+   buffer.reserve(1000);
+   assert(buffer.capacity() == 1000 && buffer.view() == "0123456789");
+
+   buffer.clear();
+   assert(buffer.empty() && buffer.capacity() == 1000);
+   buffer.put('a');
+   assert(buffer.view() == "a");
+
+   // Test that moving takes the bytes and leaves the other buffer empty
+   ext::out_buffer moved{std::move(buffer)};
+   assert(moved.view() == "a" && moved.capacity() == 1000);
+   assert(buffer.empty() && buffer.capacity() == 0);
+
+   buffer = std::move(moved);
+   assert(buffer.view() == "a");
+   assert(moved.empty() && moved.capacity() == 0 && moved.data() == nullptr);
+   moved.put("reused");
+   assert(moved.view() == "reused");
+}
+
+/**
+ * @brief Reads back what was written to a temporary file.
+ */
+std::string ReadBack(std::FILE *file_) {
+   std::fflush(file_);
+   std::string out;
+   char chunk[4096];
+   lseek(fileno(file_), 0, SEEK_SET);
+   for (ssize_t size; (size = ::read(fileno(file_), chunk, 4096)) > 0;) {
+      out.append(chunk, static_cast<std::size_t>(size));
+   }
+   return out;
+}
+
+void TestFlush() {
+   // Test that every sink gets the bytes once and the buffer is emptied
+   std::mt19937_64 random{7};
+   ext::out_buffer buffer;
+   std::FILE *const to_file{std::tmpfile()};
+   std::FILE *const to_fd{std::tmpfile()};
+   std::ostringstream to_stream;
+   std::string expected[3];
+
+   for (int round{0}; round != 300; ++round) {
+      std::size_t const sink{random() % 3};
+      PutRandom(random, buffer, expected[sink]);
+      std::size_t const capacity{buffer.capacity()};
+
+      if (sink == 0) {
+         buffer.flush_to(to_file);
+      } else if (sink == 1) {
+         buffer.flush_to(fileno(to_fd));
+      } else {
+         buffer.flush_to(to_stream);
+      }
+      assert(buffer.empty() && buffer.capacity() == capacity);
+   }
+
+   assert(ReadBack(to_file) == expected[0]);
+   assert(ReadBack(to_fd) == expected[1]);
+   assert(to_stream.str() == expected[2]);
+
+   std::fclose(to_file);
+   std::fclose(to_fd);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstString();
+   TestStorage();
+   TestFlush();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,148 @@
+#include "../format/fstring.hpp"
+#include "../format/parallel.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Finds the non-overlapping occurrences of a sequence one after the
+ * other, as a reference for par::find_all.
+ */
+template <typename CharType>
+std::vector<std::size_t> Serial(std::basic_string_view<CharType> text_,
+                                std::basic_string_view<CharType> target_) {
+   std::vector<std::size_t> positions;
+   if (target_.empty()) {
+      return positions;
+   }
+
+   for (std::size_t pos{text_.find(target_)}; pos != text_.npos;
+        pos = text_.find(target_, pos + target_.size())) {
+      positions.push_back(pos);
+   }
+   return positions;
+}
+
+/**
+ * @brief Draws a random text from a small alphabet, so that sequences
+ * repeat and overlap across the chunk bounds.
+ */
+template <typename CharType>
+std::basic_string<CharType> RandomText(std::mt19937 &random_,
+                                       std::size_t size_) {
+   std::basic_string<CharType> text(size_, CharType('a'));
+   for (CharType &c : text) {
+      c = CharType("aab;\n"[random_() % 5]);
+   }
+   return text;
+}
+
+/**
+ * @brief Compares the parallel algorithms with the serial ones on one input.
+ */
+template <typename CharType>
+void Compare(std::basic_string<CharType> const &text_,
+             std::basic_string<CharType> const &target_,
+             std::basic_string<CharType> const &replace_,
+             std::size_t threads_) {
+   using view_type = std::basic_string_view<CharType>;
+   view_type const text{text_};
+   view_type const target{target_};
+   ext::fstring<CharType> const input{text_};
+
+   std::vector<std::size_t> const expected{Serial(text, target)};
+   assert(ext::par::find_all(input, target, threads_) == expected);
+   assert(ext::par::count(input, target, threads_) == expected.size());
+   assert(ext::par::contains(input, target, threads_) ==
+          (text.find(target) != view_type::npos));
+
+   ext::fstring<CharType> serial{text_};
+   ext::fstring<CharType> parallel{text_};
+   auto const serial_last{serial.replace_all(target, replace_)};
+   auto const parallel_last{
+       ext::par::replace_all(parallel, target, replace_, threads_)};
+   assert(parallel == serial);
+   assert(parallel_last - parallel.begin() == serial_last - serial.begin());
+
+   for (ext::split_mode mode :
+        {ext::split_mode::skip_empty, ext::split_mode::keep_empty,
+         ext::split_mode::lines}) {
+      std::vector<ext::fstring<CharType>> tokens;
+      for (view_type token : input.split_view(CharType(';'), mode)) {
+         tokens.emplace_back(token.data(), token.size());
+      }
+      assert(ext::par::split(input, CharType(';'), mode, threads_) == tokens);
+   }
+}
+
+void TestAgainstSerial() {
+   // Test random inputs, cut into up to nine chunks, against the serial
+   // algorithms
+   std::mt19937 random{2023};
+   std::string const targets[]{"a", "b;", "aa", "aab", ";\n", "a;a;", "x"};
+   std::string const replaces[]{"", "Z", "YY", "XXX", "WWWWW"};
+
+   for (int round{0}; round != 3000; ++round) {
+      std::string const text{RandomText<char>(random, random() % 120)};
+      std::string const &target{targets[random() % 7]};
+      std::string const &replace{replaces[random() % 5]};
+      std::size_t const threads{random() % 10};
+
+      Compare(text, target, replace, threads);
+      Compare(text, target, std::string(target.size(), 'R'), threads);
+   }
+
+   // Test that wide characters take the same paths
+   for (int round{0}; round != 500; ++round) {
+      std::u16string const text{RandomText<char16_t>(random, random() % 80)};
+      Compare<char16_t>(text, u"ab", u"ç", 1 + random() % 8);
+      Compare<char16_t>(text, u";", u"ḃ;", 1 + random() % 8);
+   }
+}
+
+void TestLargeInput() {
+   // Test an input above the automatic chunk size with every core
+   std::mt19937 random{7};
+   std::string const text{RandomText<char>(random, 1 << 20)};
+   Compare<char>(text, "ab;", "--", 0);
+   Compare<char>(text, "\n", "\r\n", 0);
+}
+
+void TestEmptyAndErrors() {
+   // Test that an empty target matches nothing but is always contained
+   ext::fstring<char> text{"a;b"};
+   assert(ext::par::count(text, "", 4) == 0);
+   assert(ext::par::find_all(text, "", 4).empty());
+   assert(ext::par::contains(text, "", 4));
+   assert(ext::par::replace_all(text, "", "x", 4) == text.end());
+   assert(text == "a;b");
+
+   // Test that an exception in a worker reaches the caller
+   bool thrown{false};
+   try {
+      ext::par::run(4, [](std::size_t index_) {
+         if (index_ == 3) {
+            throw std::runtime_error("chunk 3");
+         }
+      });
+   } catch (std::runtime_error const &error) {
+      thrown = std::string_view{error.what()} == "chunk 3";
+   }
+   assert(thrown);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstSerial();
+   TestLargeInput();
+   TestEmptyAndErrors();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
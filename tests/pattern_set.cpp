@@ -0,0 +1,187 @@
+#include "../format/fstring.hpp"
+#include "../format/pattern_set.hpp"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using patterns = std::vector<std::string>;
+
+/**
+ * @brief Finds the leftmost-longest occurrence by trying every pattern at
+ * every position, as a reference for pattern_set::find_any.
+ */
+ext::pattern_set::match Naive(patterns const &patterns_,
+                              std::string_view text_, std::size_t pos_) {
+   for (std::size_t position{pos_}; position < text_.size(); ++position) {
+      ext::pattern_set::match found{ext::pattern_set::npos, position, 0};
+      for (std::size_t index{0}; index != patterns_.size(); ++index) {
+         std::string_view const pattern{patterns_[index]};
+         if (text_.substr(position, pattern.size()) == pattern &&
+             pattern.size() > found.size) {
+            found = {index, position, pattern.size()};
+         }
+      }
+      if (found) {
+         return found;
+      }
+   }
+   return {ext::pattern_set::npos, ext::pattern_set::npos, 0};
+}
+
+/**
+ * @brief Replaces the occurrences one after the other with the naive search.
+ */
+std::string NaiveReplace(patterns const &patterns_,
+                         patterns const &replacements_,
+                         std::string_view text_, std::size_t &count_) {
+   std::string out;
+   std::size_t first{0};
+   count_ = 0;
+   for (auto found{Naive(patterns_, text_, 0)}; found;
+        found = Naive(patterns_, text_, first)) {
+      out.append(text_.substr(first, found.position - first));
+      out += replacements_[found.pattern];
+      first = found.position + found.size;
+      ++count_;
+   }
+   return out.append(text_.substr(first));
+}
+
+/**
+ * @brief Draws a random string from an alphabet.
+ */
+std::string RandomText(std::mt19937 &random_, std::size_t size_,
+                       std::string const &alphabet_) {
+   std::string text(size_, '\0');
+   for (char &byte : text) {
+      byte = alphabet_[random_() % alphabet_.size()];
+   }
+   return text;
+}
+
+/**
+ * @brief Checks every search of a set against the naive one.
+ */
+void Check(ext::pattern_set const &set_, patterns const &patterns_,
+           std::string const &text_, std::mt19937 &random_) {
+   std::size_t const pos{random_() % (text_.size() + 2)};
+   auto const found{set_.find_any(text_, pos)};
+   auto const expected{Naive(patterns_, text_, pos)};
+   assert(found.pattern == expected.pattern);
+   assert(!found || (found.position == expected.position &&
+                     found.size == expected.size));
+
+   std::vector<std::size_t> positions;
+   for (auto const &match : set_.find_all(text_)) {
+      positions.push_back(match.position);
+   }
+
+   patterns replacements;
+   for (std::size_t index{0}; index != patterns_.size(); ++index) {
+      replacements.push_back("<" + std::to_string(index) + ">");
+   }
+
+   std::size_t count{0};
+   std::string const replaced{
+       NaiveReplace(patterns_, replacements, text_, count)};
+   assert(positions.size() == count);
+   assert(set_.count_all(text_) == count);
+   assert(set_.replace_many(text_, replacements) == replaced);
+
+   ext::fstring<char> fstr{text_};
+   assert(fstr.replace_many(set_, replacements) == count);
+   assert(fstr == replaced);
+}
+
+void TestAgainstNaive() {
+   // Test random sets, with prefixes of each other and repeated patterns,
+   // against the naive search
+   std::mt19937 random{2023};
+   std::string const alphabets[]{"ab", "abc", "a\x80\xff\n", "abcdefgh"};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::string const &alphabet{alphabets[random() % 4]};
+      patterns set;
+      for (auto count{1 + random() % 6}; count != 0; --count) {
+         set.push_back(RandomText(random, 1 + random() % 5, alphabet));
+      }
+
+      std::string const text{RandomText(random, random() % 60, alphabet)};
+      ext::pattern_set const compiled{set};
+      assert(compiled.size() == set.size() && compiled.dense());
+      Check(compiled, set, text, random);
+   }
+}
+
+void TestSparse() {
+   // Test sets too large for the complete table, which follow the failure
+   // links instead
+   std::mt19937 random{7};
+   std::string alphabet;
+   for (int byte{1}; byte != 256; ++byte) {
+      alphabet += static_cast<char>(byte);
+   }
+
+   for (int round{0}; round != 3; ++round) {
+      patterns set;
+      for (int count{0}; count != 3000; ++count) {
+         set.push_back(RandomText(random, 1 + random() % 8,
+                                  alphabet.substr(0, 8 + random() % 247)));
+      }
+
+      ext::pattern_set const compiled{set};
+      assert(!compiled.dense());
+
+      for (int text{0}; text != 50; ++text) {
+         std::string const source{
+             RandomText(random, random() % 200, alphabet.substr(0, 12))};
+         Check(compiled, set, source, random);
+      }
+   }
+}
+
+void TestMapsAndErrors() {
+   // Test that maps and lists replace like the set they make
+   ext::fstring<char> text{"o gato e o rato"};
+   std::map<std::string, std::string> const animals{{"gato", "cão"},
+                                                    {"rato", "gato"}};
+   assert(text.replace_many(animals) == 2);
+   assert(text == "o cão e o gato");
+   assert(text.replace_many({{"o", "0"}, {"o c", "O C"}}) == 4);
+   assert(text == "O Cã0 e 0 gat0");
+
+   // Test that empty patterns and missing replacements throw
+   bool thrown{false};
+   try {
+      ext::pattern_set const invalid{"a", ""};
+   } catch (std::invalid_argument const &) {
+      thrown = true;
+   }
+   assert(thrown);
+
+   thrown = false;
+   try {
+      ext::pattern_set const set{"a", "b"};
+      set.replace_many("ab", std::vector<std::string>{"x"});
+   } catch (std::invalid_argument const &) {
+      thrown = true;
+   }
+   assert(thrown);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstNaive();
+   TestSparse();
+   TestMapsAndErrors();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,240 @@
+#include "../format/fstring.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A random pattern and whether it matches the empty string.
+ */
+struct pattern {
+   std::string text;
+   bool nullable;
+};
+
+/**
+ * @brief Generates random patterns from a fixed seed, so every run checks the
+ * same ones.
+ *
+ * Repetitions of nullable subpatterns are never generated: ECMAScript stops
+ * such loops on an empty iteration, which changes the length of some
+ * matches, while the DFA follows the usual regular-language semantics.
+ */
+class pattern_generator {
+ public:
+   explicit pattern_generator(std::uint32_t seed_) : m_random(seed_) {}
+
+   pattern alternation(int depth_) {
+      pattern result{concatenation(depth_)};
+      if (m_random() % 4 == 0 && depth_ < 3) {
+         pattern const other{alternation(depth_ + 1)};
+         result.text += "|" + other.text;
+         result.nullable = result.nullable || other.nullable;
+      }
+      return result;
+   }
+
+   std::string text() {
+      std::string result;
+      for (auto count{m_random() % 12}; count != 0; --count) {
+         result += "abc1 "[m_random() % 5];
+      }
+      return result;
+   }
+
+ private:
+   pattern concatenation(int depth_) {
+      pattern result{"", true};
+      for (auto count{1 + m_random() % 3}; count != 0; --count) {
+         pattern const next{quantified(depth_)};
+         result.text += next.text;
+         result.nullable = result.nullable && next.nullable;
+      }
+      return result;
+   }
+
+   pattern quantified(int depth_) {
+      static char const *const loops[]{"*", "+", "{1,2}", "*?", "+?", "{2}"};
+      pattern result{atom(depth_)};
+      bool const anchor{result.text == "^" || result.text == "$"};
+
+      auto const choice{m_random() % 10};
+      if (anchor || choice >= 8) {
+         return result;
+      }
+      if (choice >= 6 || result.nullable) {
+         result.text += choice % 2 == 0 ? "?" : "??";
+         result.nullable = true;
+         return result;
+      }
+
+      char const *const loop{loops[choice]};
+      result.text += loop;
+      result.nullable = loop[0] == '*';
+      return result;
+   }
+
+   pattern atom(int depth_) {
+      switch (m_random() % 12) {
+      case 0:
+      case 1: {
+         if (depth_ >= 3) {
+            return {"a", false};
+         }
+         pattern const inner{alternation(depth_ + 1)};
+         return {(m_random() % 2 == 0 ? "(" : "(?:") + inner.text + ")",
+                 inner.nullable};
+      }
+      case 2:
+         return {".", false};
+      case 3:
+         return {"[ab]", false};
+      case 4:
+         return {"[^a]", false};
+      case 5:
+         return {"^", true};
+      case 6:
+         return {"$", true};
+      case 7:
+         return {"\\d", false};
+      default:
+         return {std::string(1, "abc1"[m_random() % 4]), false};
+      }
+   }
+
+   std::mt19937 m_random;
+};
+
+void TestAgainstStdRegex() {
+   // Test that random patterns find, match and contain what std::regex does
+   pattern_generator generator{2023};
+
+   for (int round{0}; round != 2000; ++round) {
+      std::string const source{generator.alternation(0).text};
+      std::regex const expected{source};
+      ext::regex const compiled{source};
+
+      for (int sample{0}; sample != 8; ++sample) {
+         std::string const text{generator.text()};
+
+         assert(compiled.matches(text) == std::regex_match(text, expected));
+         assert(compiled.contains(text) == std::regex_search(text, expected));
+
+         for (std::size_t pos{0}; pos <= text.size(); ++pos) {
+            std::cmatch found;
+            bool const any{std::regex_search(
+                text.data() + pos, text.data() + text.size(), found, expected,
+                pos == 0 ? std::regex_constants::match_default
+                         : std::regex_constants::match_prev_avail)};
+
+            ext::regex::match const occurrence{compiled.find(text, pos)};
+            assert(bool(occurrence) == any);
+            if (any) {
+               assert(occurrence.position ==
+                      pos + static_cast<std::size_t>(found.position(0)));
+               assert(occurrence.size ==
+                      static_cast<std::size_t>(found.length(0)));
+            }
+         }
+      }
+   }
+}
+
+void TestAnchorsAndEmptyMatches() {
+   using positions = std::vector<std::pair<std::size_t, std::size_t>>;
+   auto const find_all{[](char const *pattern_, char const *text_) {
+      positions result;
+      for (ext::regex::match const &found :
+           ext::regex{pattern_}.find_all(text_)) {
+         result.emplace_back(found.position, found.size);
+      }
+      return result;
+   }};
+
+   // Test that anchors only match at the ends of the text
+   assert((find_all("^", "ab") == positions{{0, 0}}));
+   assert((find_all("$", "ab") == positions{{2, 0}}));
+   assert((find_all("^a|b$", "aab") == positions{{0, 1}, {2, 1}}));
+   assert((find_all("^$", "") == positions{{0, 0}}));
+   assert(find_all("^$", "a").empty());
+   assert(!ext::regex{"^b"}.find("ab", 1));
+
+   // Test that an empty match moves the next search one byte on
+   assert((find_all("a*", "baaac") ==
+           positions{{0, 0}, {1, 3}, {4, 0}, {5, 0}}));
+   assert((find_all("x*", "ab") == positions{{0, 0}, {1, 0}, {2, 0}}));
+   assert((find_all("a*?", "aa") == positions{{0, 0}, {1, 0}, {2, 0}}));
+
+   ext::fstring<char> text{"ab"};
+   assert(text.replace_regex(ext::regex{"x*"}, "-") == 3);
+   assert(text == "-a-b-");
+}
+
+void TestCacheReset() {
+   // Each of the 2^14 combinations of the last bytes is a state of the
+   // search DFA, which takes more than the cache limit, so the states are
+   // dropped and built again along the text
+   std::mt19937 random{7};
+   std::string text(1 << 18, 'a');
+   for (char &byte : text) {
+      byte = "ab"[random() % 2];
+   }
+
+   ext::regex const compiled{"a[ab]{13}b"};
+   std::vector<ext::regex::match> const found{compiled.find_all(text)};
+
+   std::size_t count{0};
+   for (std::size_t pos{0}; pos + 15 <= text.size();) {
+      if (text[pos] == 'a' && text[pos + 14] == 'b') {
+         assert(count < found.size());
+         assert(found[count].position == pos && found[count].size == 15);
+         ++count;
+         pos += 15;
+      } else {
+         ++pos;
+      }
+   }
+   assert(count == found.size());
+
+   // Test that a copy shares the pattern and still matches after that
+   ext::regex const copy{compiled};
+   assert(copy.matches("abababababababb"));
+   assert(!copy.matches("abababababababa"));
+}
+
+void TestFstring() {
+   // Test the fstring methods that take a regex
+   ext::fstring<char> log{"12:00 erro=42 ok 12:05 erro=7"};
+   ext::regex const error{"erro=\\d+"};
+
+   assert(log.contains(error));
+   assert(!log.matches(error));
+   assert(ext::fstring<char>{"erro=7"}.matches(error));
+   assert(log.find(error).position == 6);
+   assert(log.find_all(error).size() == 2);
+
+   std::vector<ext::fstring<char>> entries;
+   log.split_regex(entries, ext::regex{" ?\\d\\d:\\d\\d ?"});
+   assert(entries.size() == 2);
+   assert(entries[0] == "erro=42 ok");
+   assert(entries[1] == "erro=7");
+
+   assert(log.replace_regex(error, "erro=?") == 2);
+   assert(log == "12:00 erro=? ok 12:05 erro=?");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstStdRegex();
+   TestAnchorsAndEmptyMatches();
+   TestCacheReset();
+   TestFstring();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,143 @@
+#include "../format/fstring.hpp"
+#include "../format/searcher.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Finds the non-overlapping occurrences of a pattern with
+ * std::string_view, as a reference for searcher::find_all.
+ */
+std::vector<std::size_t> Serial(std::string_view text_,
+                                std::string_view pattern_) {
+   std::vector<std::size_t> positions;
+   if (pattern_.empty()) {
+      return positions;
+   }
+
+   for (std::size_t pos{text_.find(pattern_)}; pos != text_.npos;
+        pos = text_.find(pattern_, pos + pattern_.size())) {
+      positions.push_back(pos);
+   }
+   return positions;
+}
+
+/**
+ * @brief Draws a random text from an alphabet, with a byte above 127 now
+ * and then.
+ */
+std::string RandomText(std::mt19937 &random_, std::size_t size_,
+                       std::string const &alphabet_) {
+   std::string text(size_, '\0');
+   for (char &byte : text) {
+      byte = random_() % 16 == 0 ? static_cast<char>(0x80 + random_() % 128)
+                                 : alphabet_[random_() % alphabet_.size()];
+   }
+   return text;
+}
+
+/**
+ * @brief Checks every search of a searcher against std::string_view.
+ */
+void Check(ext::searcher const &searcher_, std::string_view text_,
+           std::size_t pos_) {
+   std::string_view const pattern{searcher_.pattern()};
+   assert(searcher_.find(text_, pos_) == text_.find(pattern, pos_));
+   assert(searcher_.contains(text_) ==
+          (text_.find(pattern) != std::string_view::npos));
+   assert(searcher_.find_all(text_) == Serial(text_, pattern));
+}
+
+void TestAgainstStringView() {
+   // Test random patterns and texts, with lengths around the 16 and 32 byte
+   // blocks, against std::string_view
+   std::mt19937 random{2023};
+   std::string const alphabets[]{"ab", "abc", "a\x80\xff", "xyzw.,"};
+
+   for (int round{0}; round != 30000; ++round) {
+      std::string const &alphabet{alphabets[random() % 4]};
+      std::string const pattern{RandomText(random, random() % 12, alphabet)};
+      std::string text{RandomText(random, random() % 300, alphabet)};
+
+      // Plant the pattern so that most texts have at least one occurrence
+      if (!text.empty() && random() % 2 == 0) {
+         text.insert(random() % text.size(), pattern);
+      }
+
+      ext::searcher const searcher{pattern};
+      assert(searcher.size() == pattern.size());
+      Check(searcher, text, random() % (text.size() + 3));
+   }
+}
+
+void TestTwoWay() {
+   // Test texts full of candidates whose first and last bytes match, which
+   // spend the filter's budget and fall back to the two-way search
+   std::mt19937 random{7};
+
+   for (int round{0}; round != 400; ++round) {
+      std::string const unit{RandomText(random, 1 + random() % 3, "ab")};
+      std::string pattern;
+      for (auto count{1 + random() % 8}; count != 0; --count) {
+         pattern += unit;
+      }
+      pattern += RandomText(random, random() % 3, "abc");
+
+      std::string text;
+      while (text.size() < 5000 + random() % 5000) {
+         text += random() % 200 == 0 ? pattern : unit;
+      }
+
+      ext::searcher const searcher{pattern};
+      Check(searcher, text, random() % 100);
+      Check(searcher, text, text.size() - random() % 100);
+   }
+
+   // Test the periodic and aperiodic worst cases on their own
+   std::string const many_a(20000, 'a');
+   for (std::string const pattern :
+        {"aaab", "baaa", "aaaaaaaaaaaaaaaaaaab", "abaaaaaaaaaaaaaaaaaa",
+         "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"}) {
+      ext::searcher const searcher{pattern};
+      Check(searcher, many_a, 0);
+      Check(searcher, many_a + pattern, 1);
+      Check(searcher, pattern + many_a + pattern, 3);
+   }
+}
+
+void TestFstring() {
+   // Test that the fstring methods give the same results with a searcher
+   std::mt19937 random{2023};
+
+   for (int round{0}; round != 5000; ++round) {
+      std::string const pattern{RandomText(random, 1 + random() % 5, "ab")};
+      std::string const text{RandomText(random, random() % 200, "ab")};
+      ext::searcher const searcher{pattern};
+
+      ext::fstring<char> expected{text};
+      ext::fstring<char> actual{text};
+      auto const expected_last{expected.replace_all(pattern, "<>")};
+      auto const actual_last{actual.replace_all(searcher, "<>")};
+      assert(actual == expected);
+      assert(actual_last - actual.begin() == expected_last - expected.begin());
+
+      ext::fstring<char> const input{text};
+      assert(input.find(searcher) == input.find(pattern));
+      assert(input.contains(searcher) == input.contains(pattern));
+   }
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstStringView();
+   TestTwoWay();
+   TestFstring();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
@@ -0,0 +1,126 @@
+#include "../format/fstring.hpp"
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using tokens = std::vector<std::string>;
+
+/**
+ * @brief Splits a text the simple way, as a reference for the views.
+ */
+tokens Reference(std::string_view text_, std::string_view delimiters_,
+                 ext::split_mode mode_) {
+   tokens pieces{""};
+   for (char c : text_) {
+      if (delimiters_.find(c) != std::string_view::npos) {
+         pieces.emplace_back();
+      } else {
+         pieces.back() += c;
+      }
+   }
+
+   tokens result;
+   for (std::string &piece : pieces) {
+      if (mode_ == ext::split_mode::lines && !piece.empty() &&
+          piece.back() == '\r') {
+         piece.pop_back();
+      }
+      if (mode_ != ext::split_mode::skip_empty || !piece.empty()) {
+         result.push_back(piece);
+      }
+   }
+
+   if (mode_ == ext::split_mode::lines &&
+       (text_.empty() || text_.back() == '\n')) {
+      result.pop_back();
+   }
+   return result;
+}
+
+tokens Collect(ext::basic_split_view<char> const &view_) {
+   tokens result;
+   for (std::string_view token : view_) {
+      result.emplace_back(token);
+   }
+   assert(view_.count() == result.size());
+   assert(view_.empty() == result.empty());
+   return result;
+}
+
+void TestAgainstReference() {
+   // Test every mode and kind of delimiter on random texts
+   std::mt19937 random{2023};
+   ext::split_mode const modes[]{ext::split_mode::skip_empty,
+                                 ext::split_mode::keep_empty,
+                                 ext::split_mode::lines};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::string text;
+      for (auto size{random() % 24}; size != 0; --size) {
+         text += "ab,;\n\r"[random() % 6];
+      }
+
+      for (ext::split_mode mode : modes) {
+         std::string_view const set{
+             mode == ext::split_mode::lines ? "\n" : ",;"};
+         tokens const expected{Reference(text, set, mode)};
+
+         assert(Collect({text, set, mode}) == expected);
+         assert(Collect({text, ext::charset{set}, mode}) == expected);
+         if (mode == ext::split_mode::lines) {
+            assert(Collect({text, '\n', mode}) == expected);
+         } else {
+            assert(Collect({text, ',', mode}) ==
+                   Reference(text, ",", mode));
+         }
+      }
+   }
+}
+
+void TestEmptyDelimiters() {
+   // Test that an empty set yields the whole text, even with a NUL in it
+   std::string const text{"a\0b,c", 5};
+
+   tokens const whole{Collect({text, std::string_view{}})};
+   assert(whole.size() == 1 && whole[0] == text);
+   assert(Collect({text, std::string_view{}, ext::split_mode::keep_empty}) ==
+          whole);
+   assert(Collect({"", std::string_view{}}).empty());
+
+   // Test that a NUL given as the delimiter still splits
+   assert((Collect({text, '\0'}) == tokens{"a", "b,c"}));
+}
+
+void TestFstring() {
+   // Test the fstring methods built on the views
+   ext::fstring<char> const text{"  alpha beta\r\ngamma;;delta\n"};
+
+   std::vector<ext::fstring<char>> words;
+   text.split(words);
+   assert(words.size() == 2);
+   assert(words[1] == "beta\r\ngamma;;delta\n");
+
+   std::list<std::string> fields;
+   text.split(fields, ext::charset{";"}, ext::split_mode::keep_empty);
+   assert(fields.size() == 3 && fields.back() == "delta\n");
+
+   tokens const lines{Collect(text.lines())};
+   assert((lines == tokens{"  alpha beta", "gamma;;delta"}));
+   assert(text.split_view(" \n").count() == 3);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstReference();
+   TestEmptyDelimiters();
+   TestFstring();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
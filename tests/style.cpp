@@ -0,0 +1,94 @@
+#include "../format/fstring.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief Applies a code the way fstring did before the table, as a
+ * reference: a listed code other than none gets its own sequence.
+ */
+template <std::size_t Size>
+std::string Reference(short const (&list_)[Size], short code_,
+                      std::string const &text_) {
+   short const *const end{std::end(list_)};
+   if (code_ < 0 || std::find(std::begin(list_), end, code_) == end) {
+      return text_;
+   }
+
+   std::ostringstream oss;
+   oss << "\33[" << code_ << "m" << text_ << "\33[" << ext::stl::regular
+       << "m";
+   return oss.str();
+}
+
+void TestCodesAgainstStream() {
+   // Test every code, listed or not, against the stream formatting
+   std::string const text{"Macaco"};
+
+   for (short code{-3}; code <= 130; ++code) {
+      ext::fstring<char> color{text};
+      color.color(code);
+      assert(color == Reference(ext::cfg::list, code, text));
+
+      ext::fstring<char> background{text};
+      background.background(code);
+      assert(background == Reference(ext::cbg::list, code, text));
+
+      ext::fstring<char> style{text};
+      style.style(code);
+      assert(style == Reference(ext::stl::list, code, text));
+
+      // Test that the kind of a code matches the lists it is in
+      unsigned char const kind{ext::sgr::kind_of(code)};
+      assert(bool(kind & ext::sgr::foreground) ==
+             (code >= 0 && ext::sgr::listed(ext::cfg::list, code)));
+      assert(bool(kind & ext::sgr::background) ==
+             (code >= 0 && ext::sgr::listed(ext::cbg::list, code)));
+      assert(bool(kind & ext::sgr::style) ==
+             (code >= 0 && ext::sgr::listed(ext::stl::list, code)));
+   }
+}
+
+void TestTypedAttributes() {
+   // Test that the sequences are built at compile time
+   static_assert(ext::sgr::sequence<ext::fg_color::red, ext::bg_color::blue,
+                                    ext::font_style::bold>
+                     .view() == "\33[31;44;1m");
+   static_assert(ext::sgr::sequence<ext::bg_color::bright_white>.view() ==
+                 "\33[107m");
+   static_assert(ext::sgr::sequence<ext::fg_color::none>.size == 0);
+   static_assert(ext::sgr::reset.view() == "\33[0m");
+
+   // Test that the typed overloads match the raw codes
+   ext::fstring<char> typed{"Pai"};
+   typed.color(ext::fg_color::bright_green);
+   ext::fstring<char> raw{"Pai"};
+   raw.color(ext::cfg::bright_green);
+   assert(typed == raw);
+
+   typed.background(ext::bg_color::magenta);
+   typed.style(ext::font_style::doubly_underlined);
+   assert(typed == "\33[21m\33[45m\33[92mPai\33[0m\33[0m\33[0m");
+
+   ext::fstring<char> combined{"Pai"};
+   combined.style<ext::fg_color::bright_green, ext::font_style::bold>();
+   assert(combined == "\33[92;1mPai\33[0m");
+
+   ext::fstring<char> none{"Pai"};
+   none.style<ext::font_style::none>();
+   assert(none == "Pai");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestCodesAgainstStream();
+   TestTypedAttributes();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
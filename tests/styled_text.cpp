@@ -0,0 +1,166 @@
+#include "../format/fstring.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Checks if a code is listed, the way fstring used to.
+ */
+template <std::size_t Size>
+bool Listed(short const (&list_)[Size], short code_) {
+   return code_ >= 0 && std::find(std::begin(list_), std::end(list_),
+                                  code_) != std::end(list_);
+}
+
+/**
+ * @brief A span as given to append(), with the raw codes.
+ */
+struct piece {
+   std::string text;
+   ext::text_style style;
+};
+
+/**
+ * @brief Renders spans with a stream, merging equal neighbours, as a
+ * reference for basic_styled_text::render().
+ */
+std::string Reference(std::vector<piece> const &pieces_) {
+   std::vector<piece> merged;
+   for (piece run : pieces_) {
+      if (run.text.empty()) {
+         continue;
+      }
+      if (!Listed(ext::cfg::list, run.style.foreground)) {
+         run.style.foreground = ext::cfg::none;
+      }
+      if (!Listed(ext::cbg::list, run.style.background)) {
+         run.style.background = ext::cbg::none;
+      }
+      if (!Listed(ext::stl::list, run.style.style)) {
+         run.style.style = ext::stl::none;
+      }
+
+      if (!merged.empty() && merged.back().style == run.style) {
+         merged.back().text += run.text;
+      } else {
+         merged.push_back(run);
+      }
+   }
+
+   std::ostringstream oss;
+   for (piece const &run : merged) {
+      std::vector<short> codes;
+      for (short code : {run.style.foreground, run.style.background,
+                         run.style.style}) {
+         if (code >= 0) {
+            codes.push_back(code);
+         }
+      }
+
+      if (codes.empty()) {
+         oss << run.text;
+         continue;
+      }
+
+      oss << "\33[";
+      for (std::size_t i{0}; i != codes.size(); ++i) {
+         oss << (i == 0 ? "" : ";") << codes[i];
+      }
+      oss << "m" << run.text << "\33[0m";
+   }
+   return oss.str();
+}
+
+void TestAgainstStream() {
+   // Test random spans, with invalid codes, against a stream rendering
+   std::mt19937 random{2023};
+   short const codes[]{-1, 0, 1, 7, 21, 31, 37, 44, 92, 107, 5, 38, 200};
+
+   for (int round{0}; round != 5000; ++round) {
+      std::vector<piece> pieces;
+      ext::styled_text text;
+
+      for (auto count{random() % 6}; count != 0; --count) {
+         piece run{std::string(random() % 4, "xyz"[random() % 3]),
+                   {codes[random() % 13], codes[random() % 13],
+                    codes[random() % 13]}};
+         text.append(run.text, run.style);
+         pieces.push_back(run);
+      }
+
+      std::string const expected{Reference(pieces)};
+      assert(text.render() == expected);
+      assert(text.rendered_size() == expected.size());
+
+      std::string plain;
+      for (piece const &run : pieces) {
+         plain += run.text;
+      }
+      assert(text.plain() == plain);
+
+      for (std::size_t i{1}; i < text.spans().size(); ++i) {
+         assert(text.spans()[i - 1].style != text.spans()[i].style);
+      }
+
+      std::ostringstream oss;
+      oss << text;
+      assert(oss.str() == expected);
+   }
+}
+
+void TestRestyle() {
+   // Test that restyling the last span merges it with an equal neighbour
+   ext::styled_text text;
+   text.append("Meu ", {ext::cfg::red})
+       .append("cachorro", {ext::cfg::red, ext::cbg::blue, ext::stl::bold})
+       .append("!");
+   assert(text.spans().size() == 3);
+   assert(text.render() ==
+          "\33[31mMeu \33[0m\33[31;44;1mcachorro\33[0m!");
+
+   text.color(ext::cfg::red).background(ext::cbg::blue).style(ext::stl::bold);
+   assert(text.spans().size() == 2);
+   assert(text.render() == "\33[31mMeu \33[0m\33[31;44;1mcachorro!\33[0m");
+
+   // Test that an invalid code leaves the attribute unset
+   text.color(12);
+   assert(text.spans().back().style.foreground == ext::cfg::none);
+
+   // Test that rendering appends to a string
+   std::string out{"> "};
+   text.render(out);
+   assert(out == "> " + text.render());
+}
+
+void TestFstringStyle() {
+   // Test that fstring::style() gives one sequence for the three attributes
+   ext::fstring<char> combined{"Pai"};
+   combined.style(ext::text_style{ext::cfg::bright_green,
+                                  ext::cbg::bright_red, ext::stl::reverse});
+   assert(combined == "\33[92;101;7mPai\33[0m");
+
+   ext::fstring<char> partial{"Pai"};
+   partial.style(ext::text_style{ext::cfg::none, ext::cbg::black, 99});
+   assert(partial == "\33[40mPai\33[0m");
+
+   ext::fstring<char> plain{"Pai"};
+   plain.style(ext::text_style{});
+   assert(plain == "Pai");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstStream();
+   TestRestyle();
+   TestFstringStyle();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
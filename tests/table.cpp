@@ -0,0 +1,176 @@
+#include "../format/fstring.hpp"
+#include "../format/table.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using row = std::vector<std::string>;
+
+/**
+ * @brief The settings of a column, as given to add_column().
+ */
+struct column {
+   std::string header;
+   ext::align_mode align;
+   ext::text_style style;
+};
+
+/**
+ * @brief Aligns and styles one cell with the fstring methods, as a table
+ * used to be printed.
+ */
+std::string Cell(std::string const &text_, std::size_t width_,
+                 ext::align_mode align_, ext::text_style const &style_) {
+   ext::fstring<char> cell{text_};
+   switch (align_) {
+   case ext::align_mode::left:
+      cell.align_left(width_);
+      break;
+   case ext::align_mode::center:
+      cell.align_center(width_);
+      break;
+   case ext::align_mode::right:
+      cell.align_right(width_);
+      break;
+   case ext::align_mode::justify:
+      cell.align_justify(width_);
+      break;
+   }
+   cell.style(style_);
+   return cell;
+}
+
+/**
+ * @brief Renders a table cell by cell, as a reference for basic_table.
+ */
+std::string Reference(std::vector<column> const &columns_,
+                      std::vector<row> const &rows_,
+                      std::string const &separator_,
+                      ext::text_style const &header_style_) {
+   std::vector<std::size_t> widths;
+   bool header{false};
+   for (column const &col : columns_) {
+      widths.push_back(ext::display_width(std::string_view{col.header}));
+      header = header || !col.header.empty();
+   }
+   for (row const &cells : rows_) {
+      for (std::size_t i{0}; i != cells.size(); ++i) {
+         widths[i] = std::max(widths[i],
+                              ext::display_width(std::string_view{cells[i]}));
+      }
+   }
+
+   std::ostringstream oss;
+   if (header) {
+      for (std::size_t i{0}; i != columns_.size(); ++i) {
+         oss << (i == 0 ? "" : separator_)
+             << Cell(columns_[i].header, widths[i], columns_[i].align,
+                     header_style_);
+      }
+      oss << '\n';
+   }
+   for (row const &cells : rows_) {
+      for (std::size_t i{0}; i != cells.size(); ++i) {
+         oss << (i == 0 ? "" : separator_)
+             << Cell(cells[i], widths[i], columns_[i].align,
+                     columns_[i].style);
+      }
+      oss << '\n';
+   }
+   return oss.str();
+}
+
+void TestAgainstCells() {
+   // Test random tables, with wide and styled text, against the cells
+   std::mt19937 random{2023};
+   char const *const texts[]{"",      "a",    "Gato",  "ab cd",
+                             "x y z", "Pavão", "漢字", "12345",
+                             "a  b c", "\33[1mB\33[0m"};
+   ext::align_mode const aligns[]{ext::align_mode::left,
+                                  ext::align_mode::center,
+                                  ext::align_mode::right,
+                                  ext::align_mode::justify};
+   ext::text_style const styles[]{{},
+                                  {ext::cfg::red},
+                                  {ext::cfg::none, ext::cbg::blue},
+                                  {ext::cfg::green, ext::cbg::none, 1},
+                                  {12, 13, 14}};
+
+   for (int round{0}; round != 3000; ++round) {
+      std::string const separator{random() % 2 == 0 ? "" : " | "};
+      ext::text_style const header_style{styles[random() % 5]};
+      std::vector<column> columns;
+      std::vector<row> rows;
+
+      ext::table table{separator};
+      table.header_style(header_style);
+
+      for (auto count{1 + random() % 4}; count != 0; --count) {
+         columns.push_back(column{random() % 3 == 0 ? "" : texts[random() % 10],
+                                  aligns[random() % 4], styles[random() % 5]});
+         table.add_column(columns.back().header, columns.back().align,
+                          columns.back().style);
+      }
+
+      for (auto count{random() % 5}; count != 0; --count) {
+         row cells;
+         for (std::size_t i{0}; i != columns.size(); ++i) {
+            cells.push_back(texts[random() % 10]);
+         }
+         table.add_row(cells);
+         rows.push_back(cells);
+      }
+
+      std::string const expected{
+          Reference(columns, rows, separator.empty() ? " " : separator,
+                    header_style)};
+      assert(table.render() == expected);
+      assert(table.rendered_size() == expected.size());
+      assert(table.rows() == rows.size());
+
+      std::ostringstream oss;
+      oss << table;
+      assert(oss.str() == expected);
+   }
+}
+
+void TestErrors() {
+   // Test that a row needs one cell per column
+   ext::table table;
+   table.add_column("Animal").add_column("Patas", ext::align_mode::right);
+
+   bool thrown{false};
+   try {
+      table.add_row({"Cachorro"});
+   } catch (std::invalid_argument const &) {
+      thrown = true;
+   }
+   assert(thrown);
+
+   // Test that columns cannot be added after the rows
+   table.add_row({"Cachorro", "4"});
+   thrown = false;
+   try {
+      table.add_column("Cor");
+   } catch (std::logic_error const &) {
+      thrown = true;
+   }
+   assert(thrown);
+   assert(table.render() == "Animal   Patas\nCachorro     4\n");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstCells();
+   TestErrors();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
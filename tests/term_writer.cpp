@@ -0,0 +1,178 @@
+#include "../format/fstring.hpp"
+#include "../format/term_writer.hpp"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief What a terminal shows: each visible byte with its attributes, and
+ * the other escape sequences in between.
+ */
+struct cell {
+   std::string text;
+   ext::text_style style;
+
+   bool operator==(cell const &rhs_) const {
+      return text == rhs_.text && style == rhs_.style;
+   }
+};
+
+/**
+ * @brief Plays a byte stream on a model terminal, as a reference that does
+ * not care how the attributes were reached.
+ */
+std::vector<cell> Play(std::string_view stream_) {
+   std::vector<cell> screen;
+   ext::text_style style;
+
+   for (ext::ansi::segment const &segment : ext::ansi::segments(stream_)) {
+      if (segment.sgr()) {
+         ext::ansi::parse_sgr(segment.text, style);
+      } else if (segment.escape) {
+         screen.push_back({std::string(segment.text), ext::text_style{}});
+      } else {
+         for (char byte : segment.text) {
+            screen.push_back({std::string(1, byte), style});
+         }
+      }
+   }
+   return screen;
+}
+
+/**
+ * @brief A file descriptor backed by a temporary file, read back after a
+ * frame.
+ */
+class capture {
+ public:
+   capture() : m_file(std::tmpfile()) {}
+   ~capture() { std::fclose(m_file); }
+
+   int fd() const { return fileno(m_file); }
+
+   std::string read() const {
+      std::string out;
+      char buffer[4096];
+      lseek(fd(), 0, SEEK_SET);
+      for (ssize_t size; (size = ::read(fd(), buffer, sizeof(buffer))) > 0;) {
+         out.append(buffer, static_cast<std::size_t>(size));
+      }
+      return out;
+   }
+
+ private:
+   std::FILE *m_file;
+};
+
+void TestAgainstNaive() {
+   // Test random fragments of every kind against writing each one with its
+   // full sequence and a reset
+   std::mt19937 random{2023};
+   short const codes[]{-1, 1, 2, 3, 4, 7, 9, 21, 31, 37, 44, 92, 107, 12};
+   char const *const texts[]{"", "a", "Gato", " ", "xyz", "Pavão"};
+
+   for (int round{0}; round != 3000; ++round) {
+      capture out;
+      std::string naive;
+      {
+         ext::term_writer writer{out.fd(), 16};
+
+         for (auto count{random() % 12}; count != 0; --count) {
+            ext::text_style const style{codes[random() % 14],
+                                        codes[random() % 14],
+                                        codes[random() % 14]};
+            std::string const text{texts[random() % 6]};
+            ext::styled_text single;
+            single.append(text, style);
+
+            switch (random() % 4) {
+            case 0:
+               writer.write(text, style);
+               naive += single.render();
+               break;
+            case 1:
+               writer.write(std::string_view{single.render()});
+               naive += single.render();
+               break;
+            case 2: {
+               ext::styled_text styled;
+               styled.append(text, style).append(texts[random() % 6],
+                                                  {codes[random() % 14]});
+               writer.write(styled);
+               naive += styled.render();
+               break;
+            }
+            default:
+               writer.write(std::string_view{"\33[2J"});
+               naive += "\33[2J";
+               break;
+            }
+
+            if (random() % 4 == 0) {
+               writer.flush();
+            }
+         }
+
+         writer.reset().flush();
+         assert(writer.current() == ext::text_style{});
+         assert(writer.pending() == 0);
+
+         std::string const stream{out.read()};
+         assert(writer.bytes_written() == stream.size());
+         assert(writer.bytes_saved() ==
+                (naive.size() > stream.size() ? naive.size() - stream.size()
+                                              : 0));
+      }
+
+      std::string const stream{out.read()};
+      assert(Play(stream) == Play(naive));
+
+      // Test that the terminal is left plain and never told twice
+      ext::text_style state;
+      for (ext::ansi::segment const &segment : ext::ansi::segments(stream)) {
+         if (segment.sgr()) {
+            ext::text_style const before{state};
+            ext::ansi::parse_sgr(segment.text, state);
+            assert(!(state == before));
+         }
+      }
+      assert(state == ext::text_style{});
+   }
+}
+
+void TestShortestSequence() {
+   // Test that only the codes that change are written, or a reset when it is
+   // shorter
+   capture out;
+   {
+      ext::term_writer writer{out.fd()};
+      writer.write("a", {ext::cfg::red}).write("b", {ext::cfg::red});
+      writer.write("c", {ext::cfg::red, ext::cbg::none, ext::stl::bold});
+      writer.write("d", {ext::cfg::green, ext::cbg::none, ext::stl::bold});
+      writer.write("e", {ext::cfg::green, ext::cbg::blue, ext::stl::italic});
+      writer.write("f", {});
+
+      ext::fstring<char> colored{"g"};
+      colored.color(ext::cfg::green);
+      writer.write(std::string_view{colored});
+   }
+
+   assert(out.read() == "\33[31mab\33[1mc\33[32md\33[22;3;44me\33[0mf"
+                        "\33[32mg\33[0m");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstNaive();
+   TestShortestSequence();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
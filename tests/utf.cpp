@@ -0,0 +1,280 @@
+#include "../format/fstring.hpp"
+#include "../format/utf.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Checks if a code point is a Unicode scalar value.
+ */
+bool Scalar(char32_t code_) {
+   return code_ <= 0x10FFFF && (code_ < 0xD800 || code_ > 0xDFFF);
+}
+
+/**
+ * @brief Decodes UTF-8 a byte at a time, rejecting overlong forms by the
+ * value they decode to, as a reference for the lookup tables.
+ *
+ * @return True if the text is valid, false otherwise.
+ */
+bool Decode(std::string_view text_, std::u32string &codes_) {
+   char32_t const minimums[]{0, 0, 0x80, 0x800, 0x10000};
+
+   for (std::size_t pos{0}; pos != text_.size();) {
+      unsigned char const lead{static_cast<unsigned char>(text_[pos])};
+      std::size_t const size{lead < 0x80           ? 1u
+                             : (lead >> 5) == 0x6  ? 2u
+                             : (lead >> 4) == 0xE  ? 3u
+                             : (lead >> 3) == 0x1E ? 4u
+                                                   : 0u};
+      if (size == 0 || text_.size() - pos < size) {
+         return false;
+      }
+
+      char32_t code{size == 1 ? lead : lead & (0xFFu >> (size + 1))};
+      for (std::size_t index{1}; index != size; ++index) {
+         unsigned char const next{
+             static_cast<unsigned char>(text_[pos + index])};
+         if ((next & 0xC0) != 0x80) {
+            return false;
+         }
+         code = code << 6 | (next & 0x3F);
+      }
+
+      if (code < minimums[size] || !Scalar(code)) {
+         return false;
+      }
+      codes_ += code;
+      pos += size;
+   }
+   return true;
+}
+
+/**
+ * @brief Decodes UTF-16, pairing each high surrogate with a low one.
+ */
+bool Decode(std::u16string_view text_, std::u32string &codes_) {
+   for (std::size_t pos{0}; pos != text_.size(); ++pos) {
+      char32_t const high{text_[pos]};
+      if (high < 0xD800 || high > 0xDFFF) {
+         codes_ += high;
+         continue;
+      }
+
+      if (high > 0xDBFF || pos + 1 == text_.size() ||
+          text_[pos + 1] < 0xDC00 || text_[pos + 1] > 0xDFFF) {
+         return false;
+      }
+      codes_ += 0x10000 + (high - 0xD800) * 0x400 + (text_[++pos] - 0xDC00);
+   }
+   return true;
+}
+
+/**
+ * @brief Checks UTF-32 one code point at a time.
+ */
+bool Decode(std::u32string_view text_, std::u32string &codes_) {
+   for (char32_t code : text_) {
+      if (!Scalar(code)) {
+         return false;
+      }
+      codes_ += code;
+   }
+   return true;
+}
+
+/**
+ * @brief Encodes code points in UTF-8.
+ */
+std::string Utf8(std::u32string_view codes_) {
+   std::string out;
+   for (char32_t code : codes_) {
+      std::size_t const size{code < 0x80      ? 1u
+                             : code < 0x800   ? 2u
+                             : code < 0x10000 ? 3u
+                                              : 4u};
+      unsigned char const leads[]{0, 0x00, 0xC0, 0xE0, 0xF0};
+      std::string bytes(size, '\0');
+      for (std::size_t index{size - 1}; index != 0; --index, code >>= 6) {
+         bytes[index] = static_cast<char>(0x80 | (code & 0x3F));
+      }
+      bytes[0] = static_cast<char>(leads[size] | code);
+      out += bytes;
+   }
+   return out;
+}
+
+/**
+ * @brief Encodes code points in UTF-16.
+ */
+std::u16string Utf16(std::u32string_view codes_) {
+   std::u16string out;
+   for (char32_t code : codes_) {
+      if (code < 0x10000) {
+         out += static_cast<char16_t>(code);
+      } else {
+         out += static_cast<char16_t>(0xD800 + ((code - 0x10000) >> 10));
+         out += static_cast<char16_t>(0xDC00 + ((code - 0x10000) & 0x3FF));
+      }
+   }
+   return out;
+}
+
+/**
+ * @brief Checks if a call throws std::invalid_argument.
+ */
+template <class Call> bool Throws(Call const &call_) {
+   try {
+      call_();
+   } catch (std::invalid_argument const &) {
+      return true;
+   }
+   return false;
+}
+
+/**
+ * @brief Draws code points, mostly in ASCII runs longer than a vector
+ * block, with every sequence length and the bounds between them.
+ */
+std::u32string RandomCodes(std::mt19937 &random_) {
+   char32_t const bounds[]{0x0,     0x7F,     0x80,    0x7FF,   0x800,
+                           0xD7FF,  0xE000,   0xFFFD,  0xFFFF,  0x10000,
+                           0x10FFFF, 0x1F600, 0x3042,  0xE9};
+   std::u32string codes;
+
+   for (auto count{random_() % 12}; count != 0; --count) {
+      switch (random_() % 5) {
+      case 0:
+      case 1:
+         codes.append(random_() % 40,
+                      static_cast<char32_t>(' ' + random_() % 95));
+         break;
+      case 2:
+         codes += bounds[random_() % 14];
+         break;
+      default:
+         char32_t code{static_cast<char32_t>(random_() % 0x110000)};
+         codes += Scalar(code) ? code : 0xFFFD;
+         break;
+      }
+   }
+   return codes;
+}
+
+void TestUtf8() {
+   // Test valid and corrupted UTF-8 against the reference decoder, with
+   // lengths around the 16 and 32 byte blocks
+   std::mt19937 random{2023};
+   unsigned char const bad[]{0x80, 0xBF, 0xC0, 0xC1, 0xC2, 0xDF, 0xE0, 0xED,
+                             0xEF, 0xF0, 0xF4, 0xF5, 0xFF, 0xA0, 0x90, 0x8F};
+
+   for (int round{0}; round != 50000; ++round) {
+      std::string text{Utf8(RandomCodes(random))};
+
+      if (!text.empty()) {
+         switch (random() % 4) {
+         case 0:
+            text[random() % text.size()] =
+                static_cast<char>(bad[random() % 16]);
+            break;
+         case 1:
+            text.insert(random() % text.size(), 1,
+                        static_cast<char>(bad[random() % 16]));
+            break;
+         case 2:
+            text.erase(random() % text.size(), 1);
+            break;
+         default:
+            break;
+         }
+      }
+
+      std::u32string codes;
+      bool const expected{Decode(text, codes)};
+      assert(ext::utf::valid(text) == expected);
+      assert(ext::fstring<char>{text}.valid_utf() == expected);
+
+      if (expected) {
+         assert(ext::utf::to_utf32(text) == codes);
+         assert(ext::utf::to_utf16(text) == Utf16(codes));
+         assert(ext::fstring<char32_t>::from_utf8(text) == codes);
+         assert(ext::utf::to_utf8(codes) == text);
+      } else {
+         assert(Throws([&text] { ext::utf::to_utf32(text); }));
+         assert(Throws([&text] { ext::utf::to_utf16(text); }));
+         assert(Throws([&text] { ext::utf::to_wide(text); }));
+      }
+   }
+}
+
+void TestWideUnits() {
+   // Test UTF-16 and UTF-32 with stray surrogates and values out of range
+   std::mt19937 random{7};
+
+   for (int round{0}; round != 30000; ++round) {
+      std::u32string const source{RandomCodes(random)};
+      std::u16string units{Utf16(source)};
+      std::u32string points{source};
+
+      if (!units.empty() && random() % 2 == 0) {
+         units.insert(random() % units.size(), 1,
+                      static_cast<char16_t>(0xD800 + random() % 0x800));
+      }
+      if (!points.empty() && random() % 2 == 0) {
+         char32_t const wrong[]{0xD800, 0xDFFF, 0x110000, 0xFFFFFFFF};
+         points[random() % points.size()] = wrong[random() % 4];
+      }
+
+      std::u32string from_units;
+      bool const units_valid{Decode(units, from_units)};
+      assert(ext::utf::valid(units) == units_valid);
+      assert(ext::fstring<char16_t>{units}.valid_utf() == units_valid);
+      if (units_valid) {
+         assert(ext::utf::to_utf32(units) == from_units);
+         assert(ext::utf::to_utf8(units) == Utf8(from_units));
+      } else {
+         assert(Throws([&units] { ext::utf::to_utf8(units); }));
+         assert(Throws([&units] { ext::utf::to_utf32(units); }));
+      }
+
+      std::u32string from_points;
+      bool const points_valid{Decode(points, from_points)};
+      assert(ext::utf::valid(points) == points_valid);
+      if (points_valid) {
+         assert(ext::utf::to_utf16(points) == Utf16(points));
+         assert(ext::fstring<char32_t>{points}.to_utf8() == Utf8(points));
+      } else {
+         assert(Throws([&points] { ext::utf::to_utf16(points); }));
+         assert(Throws([&points] { ext::utf::to_utf8(points); }));
+      }
+   }
+}
+
+void TestUnchangedOnError() {
+   // Test that a failed conversion leaves the output as it was
+   std::u16string out{u"keep"};
+   assert(Throws([&out] {
+      ext::utf::convert(std::string_view{"ok \xE2\x82"}, out);
+   }));
+   assert(out == u"keep");
+
+   // Test the wide round trip through fstring
+   auto const wide{ext::fstring<wchar_t>::from_utf8("Ação: 日本 😀")};
+   assert(wide.valid_utf() && wide.to_utf8() == "Ação: 日本 😀");
+   assert(ext::utf::to_utf8(std::wstring_view{wide}) == "Ação: 日本 😀");
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestUtf8();
+   TestWideUnits();
+   TestUnchangedOnError();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}
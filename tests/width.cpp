@@ -0,0 +1,255 @@
+#include "../format/fstring.hpp"
+#include "../format/width.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Checks if a code point is in a table of ranges, one range at a
+ * time.
+ */
+template <std::size_t Size>
+bool Listed(ext::cols::range const (&table_)[Size], char32_t code_) {
+   for (ext::cols::range const &range : table_) {
+      if (code_ >= range.first && code_ <= range.last) {
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * @brief Gets the columns of a code point from the range tables, as a
+ * reference for the packed table of the plane.
+ */
+std::size_t Columns(char32_t code_) {
+   if (code_ < 0x20 || (code_ >= 0x7F && code_ < 0xA0)) {
+      return 0;
+   }
+   if (Listed(ext::cols::wide, code_)) {
+      return 2;
+   }
+   return Listed(ext::cols::zero_width, code_) ? 0 : 1;
+}
+
+/**
+ * @brief An indivisible piece of text: an escape sequence, a code point or
+ * an invalid code unit.
+ */
+struct token {
+   std::size_t size;
+   std::size_t columns;
+};
+
+/**
+ * @brief Gets the size of the escape sequence at the start of a text: CSI
+ * up to a final byte, OSC up to BEL or ESC '\', or two characters.
+ */
+template <typename CharType>
+std::size_t Escape(std::basic_string_view<CharType> text_) {
+   if (text_.size() < 2) {
+      return text_.size();
+   }
+
+   std::size_t pos{2};
+   if (text_[1] == CharType('[')) {
+      while (pos != text_.size() && (text_[pos] < 0x40 || text_[pos] > 0x7E)) {
+         ++pos;
+      }
+      return std::min(pos + 1, text_.size());
+   }
+   if (text_[1] == CharType(']')) {
+      for (bool escaped{false}; pos != text_.size(); ++pos) {
+         if (text_[pos] == 0x07 || (escaped && text_[pos] == CharType('\\'))) {
+            return pos + 1;
+         }
+         escaped = text_[pos] == 0x1B;
+      }
+   }
+   return pos;
+}
+
+/**
+ * @brief Cuts a text into its tokens.
+ */
+template <typename CharType>
+std::vector<token> Tokens(std::basic_string_view<CharType> text_) {
+   std::vector<token> tokens;
+   CharType const *const last{text_.data() + text_.size()};
+
+   for (CharType const *it{text_.data()}; it != last;) {
+      if (*it == 0x1B) {
+         std::size_t const size{Escape(
+             std::basic_string_view<CharType>(it, std::size_t(last - it)))};
+         tokens.push_back({size, 0});
+         it += size;
+         continue;
+      }
+
+      CharType const *next{it};
+      char32_t const code{ext::utf::decode(next, last)};
+      if (code == ext::utf::invalid) {
+         tokens.push_back({1, 1});
+         ++it;
+      } else {
+         tokens.push_back({std::size_t(next - it), Columns(code)});
+         it = next;
+      }
+   }
+   return tokens;
+}
+
+/**
+ * @brief Measures a text token by token, as a reference for display_width
+ * and display_prefix.
+ *
+ * @return The size of the longest prefix that fits in the columns.
+ */
+template <typename CharType>
+std::size_t Measure(std::basic_string_view<CharType> text_,
+                    std::size_t columns_, std::size_t &width_) {
+   std::size_t size{0};
+   width_ = 0;
+   for (token const &piece : Tokens(text_)) {
+      if (piece.columns > columns_ - width_) {
+         break;
+      }
+      width_ += piece.columns;
+      size += piece.size;
+   }
+   return size;
+}
+
+/**
+ * @brief Draws code points and escape sequences, with printable ASCII runs
+ * longer than a vector block between them.
+ *
+ * @param complete_ Whether to leave out the sequences that are cut short,
+ * which would swallow what follows them.
+ */
+std::u32string RandomCodes(std::mt19937 &random_, bool complete_) {
+   char32_t const samples[]{0x7,    0x9,    0x7F,    0x85,    0xAD,
+                            0xE9,   0x301,  0x1100,  0x200B,  0x3042,
+                            0x4E2D, 0xAC00, 0xFE0F,  0xFF21,  0xFFFD,
+                            0x1F600, 0x1F1E6, 0x20000, 0xE0001, 0x10FFFD};
+   std::u32string const escapes[]{U"\33[31m", U"\33[1;38;5;208m",
+                                  U"\33]0;title\7", U"\33]8;;x\33\\",
+                                  U"\33(", U"\33[0", U"\33"};
+   std::u32string codes;
+
+   for (auto count{random_() % 10}; count != 0; --count) {
+      switch (random_() % 6) {
+      case 0:
+      case 1:
+         for (auto run{random_() % 40}; run != 0; --run) {
+            codes += static_cast<char32_t>(' ' + random_() % 95);
+         }
+         break;
+      case 2:
+         codes += escapes[random_() % (complete_ ? 5 : 7)];
+         break;
+      case 3: {
+         char32_t const code{static_cast<char32_t>(random_() % 0x30000)};
+         codes += code >= 0xD800 && code <= 0xDFFF ? 0x20 : code;
+         break;
+      }
+      default:
+         codes += samples[random_() % 20];
+         break;
+      }
+   }
+   return codes;
+}
+
+/**
+ * @brief Checks the width and every prefix of a text against the reference.
+ */
+template <typename CharType>
+void Check(std::basic_string<CharType> const &text_) {
+   using view_type = std::basic_string_view<CharType>;
+   view_type const view{text_};
+
+   std::size_t width{0};
+   Measure(view, std::size_t(-1), width);
+   assert(ext::display_width(view) == width);
+
+   for (std::size_t columns{0}; columns <= width + 1; ++columns) {
+      std::size_t used{0};
+      assert(ext::display_prefix(view, columns) ==
+             Measure(view, columns, used));
+   }
+}
+
+void TestAgainstTables() {
+   // Test random texts in every encoding, with invalid units, against the
+   // range tables
+   std::mt19937 random{2023};
+
+   for (int round{0}; round != 20000; ++round) {
+      std::u32string const codes{RandomCodes(random, false)};
+      std::string utf8{ext::utf::to_utf8(codes)};
+      if (!utf8.empty() && random() % 4 == 0) {
+         utf8[random() % utf8.size()] = "\xFF\x80\xE3\xF0"[random() % 4];
+      }
+
+      Check(utf8);
+      Check(ext::utf::to_utf16(codes));
+      Check(codes);
+   }
+
+   // Test every code point of the plane against the tables
+   for (char32_t code{0}; code != 0x10000; ++code) {
+      if (code < 0xD800 || code > 0xDFFF) {
+         assert(ext::cols::width(code) == Columns(code));
+      }
+   }
+   for (char32_t code : {0x1F600, 0x20000, 0xE0001, 0xE0100, 0x10FFFD}) {
+      assert(ext::cols::width(code) == Columns(code));
+   }
+}
+
+void TestAlignment() {
+   // Test that the alignments pad to the width in columns
+   std::mt19937 random{7};
+
+   for (int round{0}; round != 5000; ++round) {
+      ext::fstring<char> const text{
+          ext::utf::to_utf8(RandomCodes(random, true))};
+      std::size_t const width{ext::display_width(std::string_view{text})};
+      std::size_t const size{random() % (width + 10)};
+      std::size_t const padding{size > width ? size - width : 0};
+
+      ext::fstring<char> left{text};
+      left.align_left(size, '.');
+      assert(left == text + std::string(padding, '.'));
+
+      ext::fstring<char> right{text};
+      right.align_right(size, '.');
+      assert(right == std::string(padding, '.') + text);
+
+      ext::fstring<char> center{text};
+      center.align_center(size, '.');
+      assert(center == std::string(padding / 2, '.') + text +
+                           std::string(padding - padding / 2, '.'));
+      assert(center.display_width() == std::max(size, width));
+   }
+
+   ext::fstring<char> cell{"\33[32mPavão 漢字\33[0m"};
+   cell.align_right(12);
+   assert(cell == "  \33[32mPavão 漢字\33[0m");
+   assert(cell.display_width() == 12);
+}
+
+int main() {
+   std::cout << "Running tests...\n";
+
+   TestAgainstTables();
+   TestAlignment();
+
+   std::cout << "All tests passed!\n";
+
+   return 0;
+}